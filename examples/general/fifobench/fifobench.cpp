@@ -0,0 +1,158 @@
+/**
+ * fifobench.cpp - microbenchmark for a single FIFO, one producer
+ * thread pushing, one consumer thread popping, no scheduler in
+ * the way. Reports items/s and, where perf counters are available
+ * (Linux, perf_event_paranoid permitting), cache misses per item
+ * which is mostly the producer and consumer bouncing lines
+ * between cores.
+ *
+ * usage: fifobench [items] [capacity]
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <thread>
+#include <raft>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * counter - process wide hardware cache miss counter, child
+ * threads are counted if it's opened before they're started.
+ */
+class counter
+{
+public:
+    counter()
+    {
+#ifdef __linux__
+        struct perf_event_attr attr;
+        std::memset( &attr, 0, sizeof( attr ) );
+        attr.type           = PERF_TYPE_HARDWARE;
+        attr.size           = sizeof( attr );
+        attr.config         = PERF_COUNT_HW_CACHE_MISSES;
+        attr.disabled       = 1;
+        attr.inherit        = 1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv     = 1;
+        fd = static_cast< int >(
+            syscall( __NR_perf_event_open, &attr, 0, -1, -1, 0 ) );
+#endif
+    }
+
+    ~counter()
+    {
+#ifdef __linux__
+        if( fd >= 0 )
+        {
+            close( fd );
+        }
+#endif
+    }
+
+    bool valid() const noexcept
+    {
+        return( fd >= 0 );
+    }
+
+    void start()
+    {
+#ifdef __linux__
+        if( fd >= 0 )
+        {
+            ioctl( fd, PERF_EVENT_IOC_RESET, 0 );
+            ioctl( fd, PERF_EVENT_IOC_ENABLE, 0 );
+        }
+#endif
+    }
+
+    std::uint64_t stop()
+    {
+        std::uint64_t val( 0 );
+#ifdef __linux__
+        if( fd >= 0 )
+        {
+            ioctl( fd, PERF_EVENT_IOC_DISABLE, 0 );
+            if( read( fd, &val, sizeof( val ) ) != sizeof( val ) )
+            {
+                val = 0;
+            }
+        }
+#endif
+        return( val );
+    }
+
+private:
+    int fd = -1;
+};
+
+template < Type::RingBufferType type >
+static void
+bench( const std::int64_t items, const std::size_t capacity )
+{
+    using type_t = std::int64_t;
+    auto *fifo( RingBuffer< type_t, type, false >::make_new_fifo( capacity,
+                                                                  64,
+                                                                  nullptr ) );
+    counter misses;
+    misses.start();
+    const auto start( std::chrono::steady_clock::now() );
+    std::thread producer( [&]()
+    {
+        for( type_t i( 0 ); i < items; i++ )
+        {
+            fifo->push( i );
+        }
+    } );
+    std::thread consumer( [&]()
+    {
+        type_t val( 0 );
+        for( type_t i( 0 ); i < items; i++ )
+        {
+            fifo->pop( val );
+            if( val != i )
+            {
+                std::cerr << "out of order item, expected " << i << " got "
+                    << val << "\n";
+                exit( EXIT_FAILURE );
+            }
+        }
+    } );
+    producer.join();
+    consumer.join();
+    const std::chrono::duration< double > elapsed(
+        std::chrono::steady_clock::now() - start );
+    const auto n_misses( misses.stop() );
+
+    std::cout << Type::type_prints[ type ] << "\t"
+        << ( items / elapsed.count() ) / 1e6 << " Mitems/s\t"
+        << ( elapsed.count() * 1e9 ) / items << " ns/item\t";
+    if( misses.valid() )
+    {
+        std::cout << static_cast< double >( n_misses ) / items
+            << " cache misses/item";
+    }
+    else
+    {
+        std::cout << "cache misses/item n/a";
+    }
+    std::cout << "\n";
+    delete( fifo );
+}
+
+int
+main( int argc, char **argv )
+{
+    const std::int64_t items( argc > 1 ? std::atoll( argv[ 1 ] ) : 10000000 );
+    const std::size_t  capacity( argc > 2 ? std::atoll( argv[ 2 ] ) : 1024 );
+    bench< Type::Heap >( items, capacity );
+    bench< Type::LockFreeSPSC >( items, capacity );
+    bench< Type::Segmented >( items, capacity );
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,145 @@
+/**
+ * hopbench.cpp - latency through a chain of kernels, each item
+ * carries the time it was pushed and the sink reports how long it
+ * took to get there divided by the number of hops. At a low rate
+ * every kernel is idle when an item arrives, so this is the cost of
+ * waking a kernel up, at the high rate the source pushes as fast as
+ * it can and queues build up.
+ *
+ * usage: hopbench [hops] [items] [low rate items/s]
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <raft>
+
+using clock_type = std::chrono::steady_clock;
+using stamp_t    = std::int64_t;
+
+static stamp_t now()
+{
+    return( std::chrono::duration_cast< std::chrono::nanoseconds >(
+        clock_type::now().time_since_epoch() ).count() );
+}
+
+class source : public raft::kernel
+{
+public:
+    source( const std::int64_t items, const double rate ) : raft::kernel(),
+                                                            items( items ),
+                                                            rate( rate )
+    {
+        output.addPort< stamp_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        if( rate > 0 )
+        {
+            const auto gap( std::chrono::nanoseconds(
+                static_cast< std::int64_t >( 1e9 / rate ) ) );
+            std::this_thread::sleep_for( gap );
+        }
+        output[ "0" ].push( now() );
+        return( ++sent == items ? raft::stop : raft::proceed );
+    }
+
+private:
+    const std::int64_t items;
+    const double       rate;
+    std::int64_t       sent = 0;
+};
+
+class pass : public raft::kernel
+{
+public:
+    pass() : raft::kernel()
+    {
+        input.addPort< stamp_t >( "0" );
+        output.addPort< stamp_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        stamp_t v( 0 );
+        input[ "0" ].pop( v );
+        output[ "0" ].push( v );
+        return( raft::proceed );
+    }
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< stamp_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        stamp_t v( 0 );
+        input[ "0" ].pop( v );
+        latency.emplace_back( now() - v );
+        return( raft::proceed );
+    }
+
+    std::vector< stamp_t > latency;
+};
+
+static void
+bench( const char * const name,
+       const int hops,
+       const std::int64_t items,
+       const double rate )
+{
+    source s( items, rate );
+    std::vector< pass > p( hops - 1 );
+    sink k;
+    raft::map m;
+    if( hops == 1 )
+    {
+        m += s >> k;
+    }
+    else
+    {
+        m += s >> p[ 0 ];
+        for( int i( 1 ); i < hops - 1; i++ )
+        {
+            m += p[ i - 1 ] >> p[ i ];
+        }
+        m += p[ hops - 2 ] >> k;
+    }
+    m.exe();
+    auto &l( k.latency );
+    std::sort( l.begin(), l.end() );
+    const auto per_hop( [&]( const double q )
+    {
+        const auto i( static_cast< std::size_t >( q * ( l.size() - 1 ) ) );
+        return( static_cast< double >( l[ i ] ) / hops / 1e3 );
+    } );
+    std::cout << name << "\t" << hops << " hops\t"
+        << "per hop us: p50 " << per_hop( 0.5 )
+        << "\tp99 " << per_hop( 0.99 )
+        << "\tmax " << per_hop( 1.0 ) << "\n";
+}
+
+int
+main( int argc, char **argv )
+{
+    const int          hops( argc > 1 ? std::atoi( argv[ 1 ] ) : 10 );
+    const std::int64_t items( argc > 2 ? std::atoll( argv[ 2 ] ) : 1000 );
+    const double       low( argc > 3 ? std::atof( argv[ 3 ] ) : 200 );
+    if( hops < 1 || items < 1 )
+    {
+        std::cerr << "usage: hopbench [hops] [items] [low rate items/s]\n";
+        return( EXIT_FAILURE );
+    }
+    bench( "low", hops, items, low );
+    bench( "high", hops, items * 100, 0 );
+    return( EXIT_SUCCESS );
+}
@@ -21,7 +21,6 @@ set( GIT_MODULES
 else()
 ##
 set( GIT_MODULES 
-        shm 
         cmdargs 
         demangle 
         affinity
@@ -1,5 +1,9 @@
 /**
- * cacheinfo.cpp - 
+ * cacheinfo.cpp - build time cache probe. With no arguments prints
+ * the L1D line size, with "l1d", "l2" or "llc" the size in bytes of
+ * that cache on the build machine (0 if unknown). The sizes are only
+ * fallbacks, the library reads the topology of the machine it runs
+ * on at runtime (see raftinc/cacheinfo.hpp).
  * @author: Jonathan Beard
  * @version: Mon Feb 15 06:15:54 2016
  * 
@@ -19,7 +23,9 @@
  */
 #include <stdint.h>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <string>
 
 #if __APPLE__
 #include <errno.h>
@@ -27,6 +33,7 @@
 
 #elif __linux
 #include <fstream>
+#include <sstream>
 #include <unistd.h>
 #elif ( defined _WIN64 || defined _WIN32 )
 #include <windows.h>
@@ -60,10 +67,125 @@ DWORD CountSetBits(ULONG_PTR bitMask)
 }
 #endif
 
+/**
+ * cache_size - bytes of the data (or unified) cache at level, the
+ * last level cache if level is 0.
+ */
+static int64_t
+cache_size( const int level )
+{
+#if __linux
+    int64_t val = -1;
+#if defined( _SC_LEVEL1_DCACHE_SIZE ) && defined( _SC_LEVEL2_CACHE_SIZE ) && defined( _SC_LEVEL3_CACHE_SIZE )
+    switch( level )
+    {
+        case( 1 ): val = sysconf( _SC_LEVEL1_DCACHE_SIZE ); break;
+        case( 2 ): val = sysconf( _SC_LEVEL2_CACHE_SIZE ); break;
+        default:
+        {
+            val = sysconf( _SC_LEVEL3_CACHE_SIZE );
+            if( val <= 0 )
+            {
+                val = sysconf( _SC_LEVEL2_CACHE_SIZE );
+            }
+        }
+    }
+#endif
+    if( val > 0 )
+    {
+        return( val );
+    }
+    /** same as the line size, sysconf isn't always filled in **/
+    int64_t best_level = 0;
+    for( int index = 0;; index++ )
+    {
+        const std::string dir( "/sys/devices/system/cpu/cpu0/cache/index" +
+                               std::to_string( index ) + "/" );
+        std::ifstream level_file( dir + "level" );
+        if( ! level_file.is_open() )
+        {
+            break;
+        }
+        int64_t this_level = 0;
+        level_file >> this_level;
+        std::string type, size;
+        std::ifstream( dir + "type" ) >> type;
+        std::ifstream( dir + "size" ) >> size;
+        if( type == "Instruction" || size.empty() )
+        {
+            continue;
+        }
+        int64_t bytes = 0;
+        char    unit  = '\0';
+        std::istringstream( size ) >> bytes >> unit;
+        bytes <<= ( unit == 'K' ? 10 : ( unit == 'M' ? 20 : ( unit == 'G' ? 30 : 0 ) ) );
+        if( this_level == level || ( level == 0 && this_level > best_level ) )
+        {
+            best_level = this_level;
+            val = bytes;
+        }
+    }
+    return( val > 0 ? val : 0 );
+#elif __APPLE__
+    const char *name = ( level == 1 ? "hw.l1dcachesize" :
+                       ( level == 2 ? "hw.l2cachesize"  : "hw.l3cachesize" ) );
+    uint64_t size =  0;
+    size_t   len  = sizeof( size );
+    if( sysctlbyname( name, &size, &len, NULL, 0 ) != 0 || size == 0 )
+    {
+        size = 0;
+        len  = sizeof( size );
+        /** no L3 on most Apple parts, the L2 is the last level **/
+        if( level == 0 &&
+            sysctlbyname( "hw.l2cachesize", &size, &len, NULL, 0 ) != 0 )
+        {
+            size = 0;
+        }
+    }
+    return( static_cast< int64_t >( size ) );
+#elif ( defined _WIN64 || defined _WIN32 )
+    int64_t size = 0;
+    DWORD   best_level = 0;
+    DWORD buffer_size = 0;
+    DWORD i = 0;
+    SYSTEM_LOGICAL_PROCESSOR_INFORMATION * buffer = 0;
+
+    GetLogicalProcessorInformation(0, &buffer_size);
+    buffer = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION *)malloc(buffer_size);
+    GetLogicalProcessorInformation(&buffer[0], &buffer_size);
+
+    for (i = 0; i != buffer_size / sizeof(SYSTEM_LOGICAL_PROCESSOR_INFORMATION); ++i) 
+    {
+        if( buffer[i].Relationship != RelationCache ||
+            buffer[i].Cache.Type == CacheInstruction )
+        {
+            continue;
+        }
+        const DWORD this_level = buffer[i].Cache.Level;
+        if( this_level == static_cast< DWORD >( level ) ||
+            ( level == 0 && this_level > best_level ) )
+        {
+            best_level = this_level;
+            size = buffer[i].Cache.Size;
+        }
+    }
+    free(buffer);
+    return( size );
+#else
+#error "Unknown platform"
+#endif
+}
 
 int 
 main( int argc, char **argv )
 {
+    if( argc > 1 )
+    {
+        const int level = ( std::strcmp( argv[ 1 ], "l1d" ) == 0 ? 1 :
+                          ( std::strcmp( argv[ 1 ], "l2"  ) == 0 ? 2 : 0 ) );
+        std::cout << cache_size( level );
+        return( EXIT_SUCCESS );
+    }
 #if __linux
 #ifdef _SC_LEVEL1_DCACHE_LINESIZE
     /** 
@@ -80,6 +80,15 @@ struct ext_alloc : std::integral_constant< bool,
          ext_class_alloc< T >::value ||
          ext_mem_alloc< T >::value >{};
 
+/**
+ * shm_alloc, items that can be handed to another process as
+ * raw bytes, i.e., stored inline and without pointers to
+ * anything the other side couldn't see.
+ */
+template < class T >
+struct shm_alloc : std::integral_constant< bool,
+         inline_alloc< T >::value &&
+         std::is_trivially_copyable< T >::value >{};
 
 
 /**
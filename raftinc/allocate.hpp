@@ -29,7 +29,13 @@
 #include "kernel.hpp"
 #include "port_info.hpp"
 #include "fifo.hpp"
+#include "profile.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
 #include <set>
+#include <ostream>
 
 /**
  * ALLOC_ALIGN_WIDTH - in previous versions we'd align based
@@ -52,6 +58,20 @@ namespace raft
 
 class basic_parallel;
 
+/**
+ * FIFOMemory - bytes of FIFO storage in a map, see
+ * MapBase::getFIFOMemoryUsage
+ */
+struct FIFOMemory
+{
+   /** storage of every FIFO as of the allocator's last pass **/
+   std::size_t used   = 0;
+   /** most used at any pass so far **/
+   std::size_t peak   = 0;
+   /** MapBase::setFIFOMemoryBudget, 0 if unbounded **/
+   std::size_t budget = 0;
+};
+
 class Allocate
 {
 public:
@@ -84,6 +104,31 @@ public:
     */
    void waitTillReady() ;
 
+   /**
+    * wake - call after setting exit_alloc, cuts a monitor
+    * sleep (see idle) short so the map doesn't wait out
+    * the rest of the pass before it can return.
+    */
+   void wake();
+
+   /**
+    * report_placement - one line per edge with the NUMA node its
+    * FIFO's storage was placed on and the node it's on now, see
+    * FIFO::get_placement, plus what it spilled to disk if anything
+    * (FIFO::get_spill_stats). Call once the map is done, the map does
+    * so itself when RAFT_FIFO_PLACEMENT names an output file.
+    * @param   stream - std::ostream&
+    */
+   void report_placement( std::ostream &stream );
+
+   /**
+    * profile - record what every edge learned, see profile.hpp.
+    * Call once the allocator is done, the map does so itself when
+    * a profile output is set.
+    * @param   learned - Profile&, bound to the map's kernels
+    */
+   void profile( Profile &learned );
+
    
 protected:
    /**
@@ -104,6 +149,45 @@ protected:
    
    virtual void allocate( PortInfo &a, PortInfo &b, void *data );
 
+   /**
+    * share - second and later links of a fan-in or fan-out port,
+    * one end already has a FIFO, give the other end a view of it.
+    * @param   a - PortInfo&, src
+    * @param   b - PortInfo&, dst
+    * @return  bool - true if b (fan-out) or a (fan-in) was set
+    * @throws  PortDoubleInitializeException - FIFO can't be shared
+    */
+   bool share( PortInfo &a, PortInfo &b );
+
+   /**
+    * account - total storage of every allocated FIFO (views of a
+    * shared FIFO count once), published to the map as current usage,
+    * see MapBase::getFIFOMemoryUsage. Call from the allocator thread.
+    * @return  std::size_t - bytes
+    */
+   std::size_t account();
+
+   /**
+    * describe - what an edge learned for the profile, here only its
+    * capacity, allocators that measure more fill in the rest.
+    * @param   fifo - FIFO*, the edge
+    * @param   edge - Profile::Edge&
+    */
+   virtual void describe( FIFO * const fifo, Profile::Edge &edge );
+
+   /**
+    * initial_capacity - items a new FIFO from a to b starts with when
+    * neither the link nor a profile sets it. The byte target is half
+    * the per-cpu share of the innermost cache both kernels' cores sit
+    * behind (see cacheinfo.hpp), half the consumer's L1D if they
+    * aren't pinned or share nothing, and never more than an even
+    * split of the memory budget. Rounded down to a power of two.
+    * @param   a - PortInfo&, src
+    * @param   b - PortInfo&, dst
+    * @return  std::size_t - items
+    */
+   std::size_t initial_capacity( PortInfo &a, PortInfo &b );
+
    /**
     * setReady - call within the implemented run function to signal
     * that the initial allocations have been completed.
@@ -119,6 +203,8 @@ protected:
     * set from within the initialize function.
     */
    std::set< FIFO*   > allocated_fifo;
+   /** views built by share(), their storage is another FIFO's **/
+   std::set< FIFO*   > shared_fifo;
 
    /**
     * exit_alloc - bool whose value is set by the map 
@@ -126,7 +212,32 @@ protected:
     * is exited.
     */
    volatile bool &exit_alloc;
+
+   /** map wide default, see MapBase::setWaitPolicy **/
+   const Wait::Policy wait_policy;
+   /** map wide, see MapBase::setHugePages **/
+   const bool         huge_pages;
+   /** map wide, see MapBase::setSpillBudget, builder data for Type::Infinite **/
+   Buffer::SpillConfig spill;
+   /** map wide, see MapBase::setFIFOMemoryBudget, 0 if unbounded **/
+   const std::size_t  memory_budget;
+   /** published usage, see account **/
+   std::atomic< std::size_t > &memory_used;
+   std::atomic< std::size_t > &memory_peak;
+   /** last run's profile, FIFOs start at the capacity it has for them **/
+   const Profile      &warm;
+   /** links in the map, counted for initial_capacity with a budget **/
+   std::size_t        edge_count = 0;
+
+   /**
+    * idle - sleep between monitor passes, returns early
+    * once exit_alloc is set and wake() is called.
+    * @param   dura - const std::chrono::microseconds
+    */
+   void idle( const std::chrono::microseconds dura );
 private:
+   std::mutex              idle_mutex;
+   std::condition_variable idle_cv;
    volatile bool ready = false;
    friend class basic_parallel;
 };
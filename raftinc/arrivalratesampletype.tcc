@@ -1,5 +1,8 @@
 /**
- * arrivalratesampletype.tcc - 
+ * arrivalratesampletype.tcc - rate items are written to a FIFO, the
+ * arrival rate of the queue. A frame where the producer blocked on a
+ * full queue was throttled by the consumer, it only bounds the rate
+ * the producer would write at from below.
  * @author: Jonathan Beard
  * @version: Thu Aug 21 12:49:40 2014
  * 
@@ -22,75 +25,45 @@
 
 #include <string>
 
-#include "ringbuffertypes.hpp"
 #include "ratesampletype.tcc"
 #include "blocked.hpp"
-#include "Clock.hpp"
-#include <cstdlib>
-#include <cassert>
 
-extern Clock *system_clock;
-
-template < class T, Type::RingBufferType type > class ArrivalRateSampleType : 
-   public RateSampleType< T, type >
+class ArrivalRateSampleType : public RateSampleType
 {
 public:
-ArrivalRateSampleType() : RateSampleType< T, type >(),
-                          arrival_started( false ),
-                          blocked( false ),
-                          finished( false ),
-                          prev_time( (sclock_t) 0 )
+ArrivalRateSampleType( const std::size_t item_size = 1 ) :
+   RateSampleType( item_size )
 {
 }
 
-virtual ~ArrivalRateSampleType()
-{
-}
+virtual ~ArrivalRateSampleType() = default;
 
 virtual void
-sample( RingBufferBase< T, type > &buffer,
-        bool                      &global_blocked )
+sample( FIFO &fifo, const double frame_width )
 {
-   /** nomenclature is a but funky but arrival = writes to queue **/ 
+   /** nomenclature is a bit funky but arrival = writes to queue **/ 
    Blocked arrival_copy;
-   buffer.get_zero_write_stats( arrival_copy );
+   fifo.get_zero_write_stats( arrival_copy );
    if( ! arrival_started )
    {
-      if( arrival_copy.count != 0 )
+      /** 
+       * the producer started somewhere inside this frame, 
+       * the next one is the first full frame
+       */
+      if( arrival_copy.bec.count != 0 )
       {
-         (this)->arrival_started = true;
-         global_blocked          = true;
+         arrival_started = true;
       }
       return;
    }
-
-   (this)->temp.items_copied = arrival_copy.count;
-   if( arrival_copy.blocked != 0 )
+   if( arrival_copy.bec.blocked != 0 )
    {
-      (this)->blocked = true;
-   }  
-   buffer.get_write_finished( finished );
-}
-
-
-/**
- * accept - take the current frame and add it to the overall
- * total, would be nice to have a single virtual function 
- * in the ratesampletype template, however I have a feeling
- * the logic will diverge significantly enough that this will
- * be less confusing.
- * @param   converged - true if the times have converged.
- */
-virtual void
-accept( volatile bool &converged )
-{
-   if( converged && ! (this)->blocked && (this)->arrival_started && ! (this)->finished )
+      (this)->reject( arrival_copy.bec.count, frame_width );
+   }
+   else
    {
-      (this)->real += (this)->temp;
+      (this)->accept( arrival_copy.bec.count, frame_width );
    }
-   (this)->temp.items_copied = 0;
-   (this)->blocked = false;
-   (this)->prev_time = system_clock->getTime();
 }
 
 protected:
@@ -101,9 +74,6 @@ printHeader()
 }
 
 private:
-   bool    arrival_started;
-   bool    blocked;
-   bool    finished;
-   sclock_t prev_time;
+   bool    arrival_started = false;
 };
 #endif /* END ARRIVALRATESAMPLETYPE_TCC */
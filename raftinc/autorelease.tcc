@@ -86,6 +86,16 @@ public:
    {
       return( item );
    }
+
+   /**
+    * steal - take the item over without copying it, it is still
+    * popped when this object goes out of scope.
+    * @return T, moved out of the queue
+    */
+   T steal()
+   {
+      return( std::move( item ) );
+   }
    
    /**
     * sig - get the current signal
@@ -113,13 +123,14 @@ public:
                    T * const      queue,
                 Buffer::Signal   * const sig,
                 const std::size_t curr_read_ptr,
-                const std::size_t n_items ) : autoreleasebase(),
+                const std::size_t n_items,
+                const std::size_t queue_size ) : autoreleasebase(),
                                               fifo( fifo ),
                                               queue( queue ),
                                               signal( sig ),
                                               crp  ( curr_read_ptr ),
                                               n_items( n_items ),
-                                              queue_size( fifo.capacity() )
+                                              queue_size( queue_size )
    {
       
    }
@@ -156,7 +167,8 @@ public:
       else
       {
          std::size_t ptr_val( (index + crp) % queue_size );
-         return( std::move( autopair< T >( queue[ ptr_val ], signal[ ptr_val ] ) ) );
+         /** signals are handed out relative to the start of the range **/
+         return( std::move( autopair< T >( queue[ ptr_val ], signal[ index ] ) ) );
       }
    }
 
@@ -19,6 +19,7 @@
  */
 #ifndef RAFTBUFFERDATA_TCC
 #define RAFTBUFFERDATA_TCC  1
+#include <algorithm>
 #include <cstdint>
 #include <cstddef>
 #include <cstring>
@@ -29,7 +30,6 @@
 #include <type_traits>
 #if defined __APPLE__ || defined __linux
 #include <sys/mman.h>
-#include <shm>
 #endif
 #include "signalvars.hpp"
 #include "pointer.hpp"
@@ -63,16 +63,8 @@ template < class T > struct Data< T,
    {
         assert( ptr != nullptr );
         (this)->store  = ptr;
-        (this)->signal = (Signal*)       calloc( 1,
-                                                 sizeof( Signal ) );
-        if( (this)->signal == nullptr )
-        {
-           perror( "Failed to allocate signal queue!" );
-           exit( EXIT_FAILURE );
-        }
-        
         /** set index to be start_position **/
-        (this)->signal[ 0 ].index  = start_position; 
+        (this)->start_index = start_position;
 
         /** allocate read and write pointers **/
         new ( &(this)->read_pt ) Pointer( max_cap );
@@ -85,52 +77,68 @@ template < class T > struct Data< T,
 
 
    Data( const std::size_t max_cap , 
-         const std::size_t align = 16 ) : DataBase< T >( max_cap )
+         const std::size_t align = 16 ) : DataBase< T >( round_capacity( max_cap ) )
    {
 
-#if (defined __linux ) || (defined __APPLE__ )
-      int ret_val( 0 );
-      ret_val = posix_memalign( (void**)&((this)->store), 
-                                 align, 
-                                (this)->length_store );
-      if( ret_val != 0 )
+      /** huge page alignment gets a mapping of its own, see pagemap.hpp **/
+      if( align < huge_page_size || ! (this)->map_pages() )
       {
-         std::cerr << "posix_memalign returned error code (" << ret_val << ")";
-         std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
-         exit( EXIT_FAILURE );
-      }
+#if (defined __linux ) || (defined __APPLE__ )
+         int ret_val( 0 );
+         ret_val = posix_memalign( (void**)&((this)->store), 
+                                    align, 
+                                   (this)->length_store );
+         if( ret_val != 0 )
+         {
+            std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+            std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+            exit( EXIT_FAILURE );
+         }
 #elif (defined _WIN64 ) || (defined _WIN32) 
-      (this)->store = reinterpret_cast< T* >(  _aligned_malloc( (this)->length_store, align ) );
+         (this)->store = reinterpret_cast< T* >(  _aligned_malloc( (this)->length_store, align ) );
 #else
-      /** 
-       * would use the array allocate, but well...we'd have to 
-       * figure out how to free it
-       */
-      (this)->store = reinterpret_cast< T* >( malloc( (this)->length_store ) );
+         /** 
+          * would use the array allocate, but well...we'd have to 
+          * figure out how to free it
+          */
+         (this)->store = reinterpret_cast< T* >( malloc( (this)->length_store ) );
 #endif
-      //FIXME - this should be an exception 
-      assert( (this)->store != nullptr );
+         //FIXME - this should be an exception 
+         assert( (this)->store != nullptr );
 #if (defined __linux ) || (defined __APPLE__ )
-      posix_madvise( (this)->store, 
-                     (this)->length_store,  
-                     POSIX_MADV_SEQUENTIAL );
+         posix_madvise( (this)->store, 
+                        (this)->length_store,  
+                        POSIX_MADV_SEQUENTIAL );
 #endif
-      (this)->signal = (Signal*)       calloc( (this)->max_cap,
-                                               sizeof( Signal ) );
-      if( (this)->signal == nullptr )
-      {
-         //FIXME - this should be an exception too
-         perror( "Failed to allocate signal queue!" );
-         exit( EXIT_FAILURE );
       }
       /** allocate read and write pointers **/
       /** TODO, see if there are optimizations to be made with sizing and alignment **/
-      new ( &(this)->read_pt ) Pointer( max_cap );
-      new ( &(this)->write_pt ) Pointer( max_cap ); 
+      new ( &(this)->read_pt ) Pointer( (this)->max_cap );
+      new ( &(this)->write_pt ) Pointer( (this)->max_cap ); 
       new ( &(this)->read_stats ) Blocked();
       new ( &(this)->write_stats ) Blocked();
    }
   
+   /**
+    * Data - grow in place, the new buffer uses the huge page
+    * mapping of grow_from, which has to have room for max_cap
+    * items. Ownership of the mapping moves over in copyFrom, only
+    * valid where the resize keeps every item at its index (see
+    * DataManager::make).
+    * @param   grow_from - DataBase< T >*, current buffer
+    * @param   max_cap   - const std::size_t, new capacity
+    */
+   Data( DataBase< T > * const grow_from,
+         const std::size_t max_cap ) : DataBase< T >( round_capacity( max_cap ) )
+   {
+      assert( grow_from->pages.length >= (this)->length_store );
+      (this)->share_pages( grow_from );
+      new ( &(this)->read_pt ) Pointer( (this)->max_cap );
+      new ( &(this)->write_pt ) Pointer( (this)->max_cap ); 
+      new ( &(this)->read_stats ) Blocked();
+      new ( &(this)->write_stats ) Blocked();
+   }
+
    /**
     * copyFrom - invoke this function when you want to duplicate
     * the FIFO's underlying data structure from one FIFO
@@ -155,15 +163,15 @@ template < class T > struct Data< T,
         UNUSED( ptr );
         (this)->is_valid = other->is_valid;
 
-        /** buffer is already alloc'd, copy **/
-        std::memcpy( (void*)(this)->store /* dst */,
-                     (void*)other->store  /* src */,
-                     other->length_store );
-        
-        /** copy signal buff **/
-        std::memcpy( (void*)(this)->signal /* dst */,
-                     (void*)other->signal  /* src */,
-                     other->length_signal );
+        /** buffer is already alloc'd, copy, unless it grew in place **/
+        if( ! (this)->take_pages( other ) )
+        {
+            /** a shrink only happens with every item below max_cap **/
+            std::memcpy( (void*)(this)->store /* dst */,
+                         (void*)other->store  /* src */,
+                         std::min( (this)->length_store,
+                                   other->length_store ) );
+        }
         /** stats objects are still valid, copy the ptrs over **/
         
         (this)->read_stats  = other->read_stats; 
@@ -179,7 +187,7 @@ template < class T > struct Data< T,
    virtual ~Data()
    {
       //FREE USED HERE
-      if( ! (this)->external_alloc )
+      if( ! (this)->external_alloc && ! (this)->release_pages() )
       {
 #if (defined _WIN64 ) || (defined _WIN32)
 		 _aligned_free( (this)->store );
@@ -187,7 +195,6 @@ template < class T > struct Data< T,
          free( (this)->store );
 #endif
       }
-      free( (this)->signal );
    }
 
 }; /** end heap < Line Size **/
@@ -208,15 +215,8 @@ template < class T >
    {
         assert( ptr != nullptr );
         (this)->store  = reinterpret_cast< type_t* >( ptr );
-        (this)->signal = (Signal*)       calloc( 1,
-                                                 sizeof( Signal ) );
-        if( (this)->signal == nullptr )
-        {
-           perror( "Failed to allocate signal queue!" );
-           exit( EXIT_FAILURE );
-        }
         /** set index to be start_position **/
-        (this)->signal[ 0 ].index  = start_position; 
+        (this)->start_index = start_position;
         /** allocate read and write pointers **/
         
         /** allocate read and write pointers **/
@@ -229,47 +229,55 @@ template < class T >
 
 
    Data( const std::size_t max_cap , 
-         const std::size_t align = 16 ) : ourtype_t( max_cap )
+         const std::size_t align = 16 ) : ourtype_t( round_capacity( max_cap ) )
    {
 
-#if (defined __linux ) || (defined __APPLE__ )
-      const auto ret_val = posix_memalign( (void**)&((this)->store), 
-                                           align, 
-                                           (this)->length_store );
-      if( ret_val != 0 )
+      /** huge page alignment gets a mapping of its own, see pagemap.hpp **/
+      if( align < huge_page_size || ! (this)->map_pages() )
       {
-         std::cerr << "posix_memalign returned error code (" << ret_val << ")";
-         std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
-         exit( EXIT_FAILURE );
-      }
+#if (defined __linux ) || (defined __APPLE__ )
+         const auto ret_val = posix_memalign( (void**)&((this)->store), 
+                                              align, 
+                                              (this)->length_store );
+         if( ret_val != 0 )
+         {
+            std::cerr << "posix_memalign returned error code (" << ret_val << ")";
+            std::cerr << " with message: \n" << strerror( ret_val ) << "\n";
+            exit( EXIT_FAILURE );
+         }
 #elif (defined _WIN64 ) || (defined _WIN32) 
-      (this)->store = reinterpret_cast< type_t* >(  _aligned_malloc( (this)->length_store, align ) );
+         (this)->store = reinterpret_cast< type_t* >(  _aligned_malloc( (this)->length_store, align ) );
 #else
-      /** 
-       * would use the array allocate, but well...we'd have to 
-       * figure out how to free it
-       */
-      (this)->store = reinterpret_cast< type_t* >( malloc( (this)->length_store ) );
+         /** 
+          * would use the array allocate, but well...we'd have to 
+          * figure out how to free it
+          */
+         (this)->store = reinterpret_cast< type_t* >( malloc( (this)->length_store ) );
 #endif
-      //FIXME - this should be an exception 
-      assert( (this)->store != nullptr );
+         //FIXME - this should be an exception 
+         assert( (this)->store != nullptr );
       
 #if (defined __linux ) || (defined __APPLE__ )
-      posix_madvise( (this)->store, 
-                     (this)->length_store,  
-                     POSIX_MADV_SEQUENTIAL );
+         posix_madvise( (this)->store, 
+                        (this)->length_store,  
+                        POSIX_MADV_SEQUENTIAL );
 #endif
-        errno = 0;
-        (this)->signal = (Signal*)       calloc( (this)->max_cap,
-                                                 sizeof( Signal ) );
-        if( (this)->signal == nullptr )
-        {
-           perror( "Failed to allocate signal queue!" );
-           exit( EXIT_FAILURE );
-        }
+      }
         /** allocate read and write pointers **/
-        new ( &(this)->read_pt ) Pointer( max_cap );
-        new ( &(this)->write_pt) Pointer( max_cap ); 
+        new ( &(this)->read_pt ) Pointer( (this)->max_cap );
+        new ( &(this)->write_pt) Pointer( (this)->max_cap ); 
+        new ( &(this)->read_stats ) Blocked();
+        new ( &(this)->write_stats ) Blocked();
+   }
+   
+   /** grow in place, see the inline spec **/
+   Data( ourtype_t * const grow_from,
+         const std::size_t max_cap ) : ourtype_t( round_capacity( max_cap ) )
+   {
+        assert( grow_from->pages.length >= (this)->length_store );
+        (this)->share_pages( grow_from );
+        new ( &(this)->read_pt ) Pointer( (this)->max_cap );
+        new ( &(this)->write_pt) Pointer( (this)->max_cap ); 
         new ( &(this)->read_stats ) Blocked();
         new ( &(this)->write_stats ) Blocked();
    }
@@ -289,14 +297,15 @@ template < class T >
                                            (this)->max_cap );
         (this)->is_valid = other->is_valid;
 
-        /** buffer is already alloc'd, copy **/
-        std::memcpy( (void*)(this)->store /* dst */,
-                     (void*)other->store  /* src */,
-                     other->length_store );
-        /** copy signal buff **/
-        std::memcpy( (void*)(this)->signal /* dst */,
-                     (void*)other->signal  /* src */,
-                     other->length_signal );
+        /** buffer is already alloc'd, copy, unless it grew in place **/
+        if( ! (this)->take_pages( other ) )
+        {
+            /** a shrink only happens with every item below max_cap **/
+            std::memcpy( (void*)(this)->store /* dst */,
+                         (void*)other->store  /* src */,
+                         std::min( (this)->length_store,
+                                   other->length_store ) );
+        }
         //copy over block stats objects
         (this)->read_stats  = other->read_stats; 
         (this)->write_stats = other->write_stats;
@@ -310,7 +319,7 @@ template < class T >
    virtual ~Data()
    {
       //FREE USED HERE
-      if( ! (this)->external_alloc )
+      if( ! (this)->external_alloc && ! (this)->release_pages() )
       {
 #if (defined _WIN64 ) || (defined _WIN32) 
 		 _aligned_free( (this)->store );
@@ -318,196 +327,11 @@ template < class T >
          free( (this)->store );
 #endif
       }
-      free( (this)->signal );
    }
 
 }; /** end heap > Line Size **/
 
 
-#if defined __APPLE__ || defined __linux
-
-template < class T > struct Data< T, Type::SharedMemory > : 
-   public DataBase< T > 
-{
-   /**
-    * Data - Constructor for SHM based ringbuffer.  Allocates store, signal and 
-    * ptr structures in separate SHM segments.  Could have been a single one but
-    * makes reading the ptr arithmatic a bit more difficult.  TODO, reevaluate
-    * if performance wise that might be a good idea, also decide how best to 
-    * align data elements.
-    * @param   max_cap, size_t with number of items to allocate queue for
-    * @param   shm_key, const std::string key for opening the SHM, 
-                        must be same for both ends of the queue
-    * @param   dir,     Direction enum for letting this queue know 
-                        which side we're allocating
-    * @param   alignment, size_t with alignment NOTE: haven't implemented yet
-    */
-   Data( size_t max_cap, 
-         const std::string shm_key,
-         Direction dir,
-         const size_t alignment ) : DataBase< T >( max_cap ),
-                                    store_key( shm_key + "_store" ),
-                                    signal_key( shm_key + "_key" ),
-                                    ptr_key( shm_key + "_ptr" ),
-                                    dir( dir )
-   {
-      UNUSED( alignment );
-      /** now work through opening SHM **/
-      switch( dir )
-      {
-         case( Direction::Producer ):
-         {
-            auto alloc_with_error = 
-            [&]( void **ptr, const size_t length, const char *key )
-            {
-               try
-               {
-                  *ptr = shm::init( key, length );
-               }catch( bad_shm_alloc &ex )
-               {
-                  std::cerr << 
-                  "Bad SHM allocate for key (" << 
-                     key << ") with length (" << length << ")\n";
-                  std::cerr << "Message: " << ex.what() << ", exiting.\n";
-                  exit( EXIT_FAILURE );
-               }
-               assert( *ptr != nullptr );
-            };
-            alloc_with_error( (void**)&(this)->store, 
-                              (this)->length_store, 
-                              store_key.c_str() );
-            alloc_with_error( (void**)&(this)->signal, 
-                              (this)->length_signal, 
-                              signal_key.c_str() );
-
-            new ( &(this)->write_pt ) Pointer( max_cap ); 
-            new ( &(this)->write_stats ) Blocked();
-            
-
-            (this)->cookie.producer = 0x1337;
-            
-            while( (this)->cookie.consumer != 0x1337 )
-            {
-               std::this_thread::yield();
-            }
-         }
-         break;
-         case( Direction::Consumer ):
-         {
-            auto retry_func = [&]( void **ptr, const char *str )
-            {
-               std::string error_copy;
-               std::int32_t timeout( 1000 );
-               while( timeout-- )
-               {
-                  try
-                  {
-                     *ptr = shm::open( str );
-                  }
-                  catch( bad_shm_alloc &ex )
-                  {
-                     //do nothing
-                     timeout--;
-                     error_copy = ex.what();
-                     std::this_thread::yield();
-                     continue;
-                  }
-                  goto SUCCESS;
-               }
-               /** timeout reached **/
-               std::cerr << "Failed to open shared memory for \"" << 
-                  str << "\", exiting!!\n";
-               std::cerr << "Error message: " << error_copy << "\n";
-               exit( EXIT_FAILURE );
-               SUCCESS:;
-            };
-            retry_func( (void**) &(this)->store,  store_key.c_str() );
-            retry_func( (void**) &(this)->signal, signal_key.c_str() );
-            
-            assert( (this)->store != nullptr );
-            assert( (this)->signal != nullptr );
-            
-            new ( &(this)->read_pt ) Pointer( max_cap );
-            new ( &(this)->read_stats ) Blocked();
-            
-
-            (this)->cookie.consumer = 0x1337;
-            while( (this)->cookie.producer != 0x1337 )
-            {
-               std::this_thread::yield();
-            }
-         }
-         break;
-         default:
-         {
-            //TODO, add signal handler to cleanup
-            std::cerr << "Invalid direction, exiting\n";
-            exit( EXIT_FAILURE );
-         }
-      }
-      /** should be all set now **/
-   }
-
-   virtual ~Data()
-   {
-      switch( dir )
-      {
-         case( Direction::Producer ):
-         {
-            delete( &(this)->write_pt ); 
-            delete( &(this)->write_stats );
-         }
-         break;
-         case( Direction::Consumer ):
-         { 
-            delete( &(this)->read_pt );
-            delete( &(this)->read_stats );
-         }
-         break;
-         default:
-            assert( false );
-      } /** end switch **/
-      
-       //FREE USED HERE
-       if( ! (this)->external_alloc )
-       {
-          /** three segments of SHM to close **/
-          shm::close( store_key.c_str(), 
-                      (void**) &(this)->store, 
-                      (this)->length_store,
-                      false,
-                      true );
-
-       }
-       shm::close( signal_key.c_str(),
-                   (void**) &(this)->signal,
-                   (this)->length_signal,
-                   false,
-                   true );
-       }
-
-       virtual void copyFrom( DataBase< T > *other )
-       {
-          UNUSED( other );
-          assert( false );
-          /** TODO, implement me **/
-       }
-
-       struct Cookie
-       {
-          std::int32_t producer;
-          std::int32_t consumer;
-       };
-
-   volatile Cookie         cookie;
-
-   /** process local key copies **/
-   const std::string store_key; 
-   const std::string signal_key;  
-   const std::string ptr_key; 
-   const Direction   dir;
-};
-#endif
 
 } //end namespace Buffer
 #endif /* END RAFTBUFFERDATA_TCC */
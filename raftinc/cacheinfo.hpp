@@ -0,0 +1,76 @@
+/**
+ * cacheinfo.hpp - cache topology of the machine the map runs on, read
+ * from sysfs once. The allocator sizes new FIFOs in bytes from it
+ * (see Allocate::initial_capacity): a FIFO between two kernels pinned
+ * to cores that share a cache should fit their share of that cache,
+ * anything else starts out fitting in half an L1D. Where sysfs isn't
+ * there the sizes the cache_info helper found at build time stand in
+ * (L1D_CACHE_SIZE, L2_CACHE_SIZE, LLC_CACHE_SIZE) and no two cores are
+ * known to share anything.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTCACHEINFO_HPP
+#define RAFTCACHEINFO_HPP  1
+#include <cstddef>
+#include "defs.hpp"
+
+namespace Cache
+{
+
+/** Level - one data (or unified) cache as seen from a core **/
+struct Level
+{
+    /** 0 if the core has no such cache or it is unknown **/
+    std::size_t bytes = 0;
+    /** cpus sharing it, 1 for a private cache **/
+    std::size_t cpus  = 1;
+
+    /** share - bytes each of the cpus gets **/
+    std::size_t share() const noexcept
+    {
+        return( bytes / ( cpus > 0 ? cpus : 1 ) );
+    }
+};
+
+/**
+ * data - data cache at level (1 is the L1D) of core, a core that is
+ * not assigned (-1) reads as cpu 0.
+ * @param   core  - const core_id_t
+ * @param   level - const int
+ * @return  Level
+ */
+Level data( const core_id_t core, const int level ) noexcept;
+
+/**
+ * last_level - deepest data cache level, at least 1
+ * @return  int
+ */
+int last_level() noexcept;
+
+/**
+ * shared_level - innermost data cache both cores are behind, the same
+ * core shares its L1D with itself.
+ * @param   a - const core_id_t
+ * @param   b - const core_id_t
+ * @return  int - level, 0 if either is unassigned or nothing is shared
+ */
+int shared_level( const core_id_t a, const core_id_t b ) noexcept;
+
+} /** end namespace Cache **/
+#endif /* END RAFTCACHEINFO_HPP */
@@ -25,6 +25,7 @@
 #include <cstddef>
 #include "blocked.hpp"
 #include "threadaccess.hpp"
+#include "pagemap.hpp"
 
 namespace raft
 {
@@ -34,6 +35,28 @@ namespace raft
 namespace Buffer
 {
 
+/**
+ * round_capacity - number of slots actually allocated for a
+ * FIFO asked to hold n items. With POW2_BUFFER defined this
+ * is the next power of two so the read/write Pointer objects
+ * run masked (see pointer.hpp), otherwise it's just n.
+ * @param   n - std::size_t, requested items
+ * @return  std::size_t
+ */
+static inline std::size_t round_capacity( const std::size_t n ) noexcept
+{
+#ifdef POW2_BUFFER
+    std::size_t cap( 1 );
+    while( cap < n )
+    {
+        cap <<= 1;
+    }
+    return( cap );
+#else
+    return( n );
+#endif
+}
+
 /**
  * DataBase - not quite the best name since we 
  * conjure up a relational database, but it is
@@ -43,7 +66,7 @@ template < class T > struct DataBase
 {
     DataBase( const std::size_t max_cap ) : max_cap ( max_cap ),
                                             length_store( sizeof( T ) * max_cap ),
-                                            length_signal( sizeof( T ) * max_cap ),
+                                            length_signal( sizeof( Signal ) * max_cap ),
                                             dynamic_alloc_size( length_store +
                                                                 length_signal )
                                             {}
@@ -58,6 +81,68 @@ template < class T > struct DataBase
      */
     virtual void copyFrom( DataBase< T > *other ) = 0;
 
+    /**
+     * map_pages - take store from a new huge page mapping
+     * @return  bool - false if there's no mapping, store is untouched
+     */
+    bool map_pages() noexcept
+    {
+        if( ! pages.map( length_store ) )
+        {
+            return( false );
+        }
+        store      = reinterpret_cast< T* >( pages.base );
+        owns_pages = true;
+        return( true );
+    }
+
+    /**
+     * share_pages - use other's mapping for store, other keeps
+     * owning it until take_pages.
+     * @param   other - const DataBase< T >*, with a mapping
+     */
+    void share_pages( const DataBase< T > * const other ) noexcept
+    {
+        store      = other->store;
+        pages      = other->pages;
+        numa_node  = other->numa_node;
+        owns_pages = false;
+    }
+
+    /**
+     * take_pages - called from copyFrom, if other shares our mapping
+     * it hands over ownership and there is nothing to copy.
+     * @return  bool - true if the store is other's
+     */
+    bool take_pages( DataBase< T > * const other ) noexcept
+    {
+        if( pages.base == nullptr || store != other->store )
+        {
+            return( false );
+        }
+        owns_pages        = other->owns_pages;
+        other->owns_pages = false;
+        return( true );
+    }
+
+    /**
+     * release_pages - from the destructor, unmaps the store if it is
+     * a mapping we own.
+     * @return  bool - true if store was a mapping, nothing left to free
+     */
+    bool release_pages() noexcept
+    {
+        if( pages.base == nullptr )
+        {
+            return( false );
+        }
+        if( owns_pages )
+        {
+            pages.unmap();
+        }
+        return( true );
+    }
+
 
     const std::size_t       max_cap;
     /** sizes, might need to define a local type **/
@@ -79,8 +164,24 @@ template < class T > struct DataBase
     Pointer                 write_pt;
     
     T                       *store          = nullptr;
+    /**
+     * per-slot signal array, heap FIFOs carry signals out of
+     * band in their Buffer::SignalChannel, SharedMemory FIFOs
+     * keep theirs in the segment (see shmsegment.hpp).
+     */
     Signal                  *signal         = nullptr;
+    /** start index for buffers handed in externally (for_each) **/
+    std::size_t             start_index     = 0;
     bool                    external_alloc  = false;
+    /** node the storage was bound to (see numaplace.hpp), -1 if not **/
+    int                     numa_node       = -1;
+    /**
+     * set if store lives in a huge page mapping (see pagemap.hpp),
+     * a buffer grown in place shares it with the one it replaces,
+     * only one of them owns it.
+     */
+    PageMap                 pages;
+    bool                    owns_pages      = false;
     /** variable set by scheduler, used for shutdown **/
     bool                    is_valid        = true;
     
@@ -22,12 +22,14 @@
 #include <cassert>
 #include <cstddef>
 #include <array>
+#include <chrono>
 #include <thread>
 #include <atomic>
 #include <cstdint>
 
 #include "ringbuffertypes.hpp"
 #include "bufferdata.tcc"
+#include "numaplace.hpp"
 #include "defs.hpp"
 
 
@@ -57,6 +59,86 @@ public:
        * kept as an array here so, only one ptr.
        */
       thread_access = buffer->thread_access;
+      place( buffer );
+   }
+
+   /**
+    * set_node - home NUMA node for the storage, the current
+    * buffer is moved there and every buffer installed after it
+    * (set, resize) is placed there before it is used.
+    * @param   node - const int, -1 leaves placement to the OS
+    */
+   void set_node( const int node ) noexcept
+   {
+      home_node = node;
+      if( buffer != nullptr )
+      {
+         prepare( buffer );
+      }
+   }
+
+   inline int get_node() const noexcept
+   {
+      return( home_node );
+   }
+
+   /**
+    * place - bind buff's storage to the home node, no-op without
+    * one, for storage we didn't allocate and for shared memory
+    * (the other process has its own idea of where that goes).
+    * @param   buff - Buffer::Data< T, B >*
+    */
+   void place( Buffer::Data< T, B > * const buff ) noexcept
+   {
+      if( home_node < 0 || B == Type::SharedMemory ||
+          buff->external_alloc || buff->numa_node == home_node )
+      {
+         return;
+      }
+      if( Placement::place( buff->store, buff->length_store, home_node ) )
+      {
+         buff->numa_node = home_node;
+      }
+   }
+
+   /**
+    * prepare - get buff ready to be installed, placed and, if
+    * it's a huge page mapping, faulted in so neither side takes
+    * the first-touch faults.
+    * @param   buff - Buffer::Data< T, B >*
+    */
+   void prepare( Buffer::Data< T, B > * const buff ) noexcept
+   {
+      place( buff );
+      buff->pages.prefault();
+   }
+
+   /**
+    * make - storage for a resize to n items, the same kind of
+    * memory as the current buffer. A huge page mapping that still
+    * has room is reused if in_place is set, only resize() may ask
+    * for that as it keeps every item at the index it's at.
+    * @param   n        - const std::size_t, items
+    * @param   align    - const std::size_t, alignment if not mapped
+    * @param   in_place - const bool
+    * @return  Buffer::Data< T, B >*
+    */
+   Buffer::Data< T, B >* make( const std::size_t n,
+                               const std::size_t align,
+                               const bool in_place )
+   {
+      using value_t = typename Buffer::Data< T, B >::value_type;
+      auto * const current( get() );
+      if( current->pages.base == nullptr )
+      {
+         return( new Buffer::Data< T, B >( n, align ) );
+      }
+      if( in_place && current->owns_pages &&
+          Buffer::round_capacity( n ) * sizeof( value_t ) <= current->pages.length )
+      {
+         return( new Buffer::Data< T, B >( current, n ) );
+      }
+      return( new Buffer::Data< T, B >( n, Buffer::huge_page_size ) );
    }
 
    inline bool is_resizeable() noexcept 
@@ -66,8 +148,11 @@ public:
 
    /**
     * resize - resize the buffer currently held by this
-    * object.  It is expected that the buffer passed in
-    * by the parameter is larger than the current buffer.
+    * object.  The buffer passed in by the parameter is
+    * normally larger than the current buffer, a smaller
+    * one (shrink) is only installed once every item sits
+    * below its capacity, if that doesn't happen within
+    * shrink_timeout the shrink is abandoned.
     * a second param exit_buffer is also required and
     * should be available from the allocator object calling
     * this function.  When exit_buffer is set to exit, the
@@ -76,8 +161,14 @@ public:
     * @param buffer, - Buffer::Data< T, B>
     * @param exit_alloc, - set to false initially, true
     * when the application is complete
+    * @param installed, - called once neither side is in the
+    * buffer, just before new_buffer is published, so the FIFO
+    * can drop any state cached against the old buffer
     */
-   void resize( Buffer::Data< T, B > *new_buffer, volatile bool &exit_buffer )
+   template < class Installed >
+   void resize( Buffer::Data< T, B > *new_buffer, 
+                volatile bool &exit_buffer,
+                Installed &&installed )
    {
       /**
        * allclear - call this function to see
@@ -108,7 +199,7 @@ public:
        * current buffer state is amenable to
        * expanding.
        */
-      auto buffercondition( []( Buffer::Data< T, B > * const buff_ptr ) noexcept -> bool
+      auto buffercondition( [ new_buffer ]( Buffer::Data< T, B > * const buff_ptr ) noexcept -> bool
       {
          /** 
           * there's only a few conditions that you can copy
@@ -123,15 +214,21 @@ public:
           */
          const auto rpt( Pointer::val( buff_ptr->read_pt  ) );
          const auto wpt( Pointer::val( buff_ptr->write_pt ) );
-         return( rpt < wpt );
+         /** shrinking, the items keep their index **/
+         return( rpt < wpt && wpt <= new_buffer->max_cap );
       } );
       
+      /** bind before the copy faults the pages in **/
+      prepare( new_buffer );
       auto *old_buffer( get() );
+      const bool shrink( new_buffer->max_cap < old_buffer->max_cap );
+      const auto deadline( std::chrono::steady_clock::now() + shrink_timeout );
       for(;;)
       {
          /** check to see if program is done **/
          if( exit_buffer /** comes from allocator **/ |
-             ! old_buffer->is_valid  /** comes indirectly from scheduler **/ )
+             ! old_buffer->is_valid  /** comes indirectly from scheduler **/ |
+             ( shrink && std::chrono::steady_clock::now() > deadline ) )
          {
             /** get rid of newly allocated buff, don't need **/
             delete( new_buffer );
@@ -167,6 +264,7 @@ public:
        * the old buff, free to copy.
        */
       new_buffer->copyFrom( old_buffer );
+      installed();
       set( new_buffer );
       delete( old_buffer );
       resizing = false;
@@ -224,10 +322,15 @@ public:
    
 
 private:
+   /** how long resize waits for a shrink to become possible **/
+   static constexpr auto shrink_timeout = std::chrono::milliseconds( 2 );
+
    Buffer::Data< T, B > *buffer              = nullptr; 
    volatile bool         resizing            =  false;
 
    bool                  resizeable          = true;
+   /** see set_node **/
+   int                   home_node           = -1;
    
    /** defined in threadaccess.hpp **/
    ThreadAccess *thread_access = nullptr;
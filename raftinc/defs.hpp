@@ -113,12 +113,6 @@ namespace raft
     }
 #endif
 
-template < typename T > 
-    using set_t = std::set< T >;
-
-using ptr_set_t = set_t< std::uintptr_t >;
-using recyclefunc_t = std::function< void( void * ) >;
-using ptr_map_t = std::map< std::uintptr_t, recyclefunc_t >;
 using ptr_t = std::uintptr_t;
 
 using core_id_t = std::int64_t;
@@ -1,5 +1,8 @@
 /**
- * departureratesampletype.tcc - 
+ * departureratesampletype.tcc - rate items are read from a FIFO.
+ * Over a frame where the consumer never waited on an empty queue
+ * that is its service rate. A frame where it did was throttled by
+ * the producer and only bounds the service rate from below.
  * @author: Jonathan Beard
  * @version: Thu Aug 21 12:49:40 2014
  * 
@@ -21,113 +24,39 @@
 #define DEPARTURERATESAMPLETYPE_TCC  1
 #include <string>
 
-#include <queue>
-#ifdef _EXP_
-#include <array>
-#include <cinttypes>
-#endif
-
-#include "ringbuffertypes.hpp"
 #include "ratesampletype.tcc"
 #include "blocked.hpp"
-#include "Clock.hpp"
-
-extern Clock *system_clock;
 
-template < class T, Type::RingBufferType type > 
-   class DepartureRateSampleType : public RateSampleType< T, type >
+class DepartureRateSampleType : public RateSampleType
 {
 public:
-DepartureRateSampleType() : RateSampleType< T, type >(),
-                            blocked( false ),
-                            finished( false )
+DepartureRateSampleType( const std::size_t item_size = 1 ) :
+   RateSampleType( item_size )
 {
 }
 
-virtual ~DepartureRateSampleType()
-{
-}
+virtual ~DepartureRateSampleType() = default;
 
 virtual void
-sample( RingBufferBase< T, type > &buffer, bool &global_blocked )
+sample( FIFO &fifo, const double frame_width )
 {
    Blocked departure_copy;
-   buffer.get_zero_read_stats( departure_copy );
-
-#ifdef _EXP_
-   (this)->temp.items_copied = departure_copy.count;
-#endif
-   
-   if( departure_copy.blocked != 0 )
+   fifo.get_zero_read_stats( departure_copy );
+   if( departure_copy.bec.blocked != 0 )
    {
-      (this)->blocked = true;
-      global_blocked  = true;
+      (this)->reject( departure_copy.bec.count, frame_width );
    }
-   buffer.get_write_finished( (this)->finished );
-}
-
-virtual void
-accept( volatile bool &converged )
-{
-   
-   if( converged &&  ! (this)->blocked && ! (this)->finished )
+   else
    {
-      (this)->real += (this)->temp;
-
-#ifdef _EXP_      
-      if( item_index < 100000 )
-      {
-         item_log[ item_index ].items = (this)->temp.items_copied;
-         item_log[ item_index++ ].time  = system_clock->getTime();
-      }
-#endif
+      (this)->accept( departure_copy.bec.count, frame_width );
    }
-   (this)->temp.items_copied  = 0;
-   (this)->blocked            = false;
 }
 
 protected:
 virtual std::string
 printHeader()
 {
-/** below code for experimental purposes **/
-#ifdef _EXP_
-   std::cerr.precision( 20 );
-   std::cerr << "{" << (this)->frame_width << ",{"; 
-   for( auto i( 0 ); i < item_index; i++ )
-   {
-      if( i != (item_index - 1) )
-      {
-         std::cerr << "{" << item_log[ i ].time
-         << "," << 
-         item_log[ i ].items << "},";
-      }
-      else
-      {
-         std::cerr << "{" << item_log[ i ].time
-         << "," << 
-         item_log[ i ].items << "}";
-      }
-   }
-   std::cerr << "}";
-#endif
    return( "departure_rate" );
 }
-
-private:
-bool  blocked;
-bool  finished;
-
-
-/** below code for experimental purposes **/
-#ifdef __EXP__
-struct ITEM
-{
-   std::int64_t items;
-   double       time;
-};
-std::array< ITEM , 100000 > item_log;
-std::int64_t item_index = 0;
-#endif
 };
 #endif /* END DEPARTURERATESAMPLETYPE_TCC */
@@ -0,0 +1,128 @@
+/**
+ * doorbell.hpp - lets a kernel thread with nothing to read sleep
+ * until one of its input FIFOs gets data. The kernel's ready set
+ * (readyset.hpp) rings it when a port goes from empty to having
+ * items, or when an input is invalidated. The
+ * thread only pays for a wakeup if it actually went to sleep, ring()
+ * is a single relaxed load otherwise.
+ *
+ * Producers don't fence between publishing and checking for a
+ * sleeper, that would cost every push. The rare wakeup lost to that
+ * race is covered by bounding each sleep to timeout, which is the
+ * polling interval schedulers used before.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTDOORBELL_HPP
+#define RAFTDOORBELL_HPP  1
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "defs.hpp"
+#include "internaldefs.hpp"
+
+namespace Buffer
+{
+
+class Doorbell
+{
+public:
+   /** polls before sleeping, only with more than one core **/
+   static constexpr std::uint32_t spin_limit = 256;
+   /** upper bound on a single sleep **/
+   static constexpr auto timeout = std::chrono::milliseconds( 5 );
+
+   Doorbell() = default;
+
+   Doorbell( const Doorbell &other ) = delete;
+   Doorbell& operator = ( const Doorbell &other ) = delete;
+
+   /** ring - producer side, call after publishing **/
+   inline void ring() noexcept
+   {
+      if( R_UNLIKELY( armed.load( std::memory_order_relaxed ) != 0 ) &&
+          armed.exchange( 0, std::memory_order_acq_rel ) != 0 )
+      {
+         wake();
+      }
+   }
+
+   /**
+    * wait_for - consumer side, returns once ready() is true,
+    * after a wakeup or after timeout, whichever comes first.
+    * Callers re-check their condition either way.
+    * @param   ready - callable returning bool
+    */
+   template < class F >
+   void wait_for( F &&ready )
+   {
+      if( spin() )
+      {
+         for( std::uint32_t i( 0 ); i < spin_limit; i++ )
+         {
+            if( ready() )
+            {
+               return;
+            }
+            pause();
+         }
+      }
+      const auto e( epoch.load( std::memory_order_acquire ) );
+      armed.store( 1, std::memory_order_relaxed );
+      /** pairs with the producer's publish, see the note up top **/
+      std::atomic_thread_fence( std::memory_order_seq_cst );
+      if( ! ready() )
+      {
+         sleeps++;
+         sleep( e );
+      }
+      armed.store( 0, std::memory_order_relaxed );
+   }
+
+   /** sleeps - times the owner went to sleep, owner only **/
+   std::uint64_t get_sleeps() const noexcept
+   {
+      return( sleeps );
+   }
+
+private:
+   static inline void pause() noexcept
+   {
+#if __x86_64
+      __asm__ volatile("\
+        pause"
+        :
+        :
+        : );
+#endif
+   }
+
+   /** spin - false on a single core, the producer needs it **/
+   static bool spin() noexcept;
+
+   void sleep( const std::uint32_t e );
+   void wake() noexcept;
+
+   std::atomic< std::uint32_t >   armed  = { 0 };
+   /** futex word, bumped on every wakeup **/
+   std::atomic< std::uint32_t >   epoch  = { 0 };
+   std::uint64_t                  sleeps = 0;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTDOORBELL_HPP */
@@ -19,13 +19,34 @@
  */
 #ifndef RAFTDYNALLOC_HPP
 #define RAFTDYNALLOC_HPP  1
+#include <map>
+#include <set>
+#include <vector>
 #include "allocate.hpp"
+#include "arrivalratesampletype.tcc"
+#include "departureratesampletype.tcc"
+#include "meansampletype.tcc"
 
 namespace raft
 {
     class map;
 }
 
+/**
+ * dynalloc - sizes each FIFO from what flows through it. Every
+ * monitor pass the arrival rate (writes), service rate (reads) and
+ * occupancy of each edge are sampled and the edge is treated as an
+ * M/M/1/K queue. Its load follows from the mean occupancy L, rho =
+ * L / ( 1 + L ), unless the producer found the queue full, then the
+ * consumer was busy the whole frame and arrival over service rate
+ * shows how far past saturation it is. The target capacity is the
+ * smallest K at which the producer finds the queue full at most loss
+ * of the time. A FIFO grows toward its target once the target has
+ * been above its capacity for grow_passes passes in a row and shrinks
+ * once the target has been at or below a quarter of its capacity for
+ * shrink_passes, so a fast consumer keeps a small, cache resident
+ * buffer and a slow one gets only as much as helps.
+ */
 class dynalloc : public Allocate
 {
 public:
@@ -41,22 +62,92 @@ public:
      */
     virtual void run();
 
+protected:
+    /** 
+     * describe - largest capacity the edge held during the run 
+     * and its measured rates 
+     */
+    virtual void describe( FIFO * const fifo, Profile::Edge &edge );
+
+public:
+
+    /**
+     * target_capacity - smallest M/M/1/K capacity (in items) at
+     * which an arriving item finds the queue full with probability
+     * at most loss, rounded up to a power of two and clamped to
+     * [ floor, ceiling ]. At or past saturation (load >= 1) no
+     * capacity gets there, the queue gets what a critically loaded
+     * one needs, 1 / loss, enough to ride out bursts.
+     * @param   load     - const double, arrival over service rate
+     * @param   loss     - const double, (0,1)
+     * @param   floor    - const std::size_t, smallest capacity
+     * @param   ceiling  - const std::size_t, largest capacity
+     * @return  std::size_t
+     */
+    static std::size_t target_capacity( const double      load,
+                                        const double      loss,
+                                        const std::size_t floor,
+                                        const std::size_t ceiling );
+
+    /** target blocking probability **/
+    static constexpr double      loss            = 1.0 / 1024.0;
+    /** passes the target has to sit above the capacity to grow **/
+    static constexpr int         grow_passes     = 3;
+    /** passes it has to sit at or below a quarter of it to shrink **/
+    static constexpr int         shrink_passes   = 16;
+
 private:
+    /** what the monitor knows about one FIFO, keyed by the FIFO **/
+    struct edge_state
+    {
+        ArrivalRateSampleType   arrival;
+        DepartureRateSampleType departure;
+        MeanSampleType          occupancy;
+        int                     grow    = 0;
+        int                     shrink  = 0;
+        /** capacity it needed at most, for the profile **/
+        std::size_t             largest = 0;
+        /** never shrunk below, see Allocate::initial_capacity **/
+        std::size_t             floor   = 0;
+    };
+
+    /** a FIFO the monitor wants to resize this pass **/
+    struct candidate
+    {
+        FIFO        *fifo;
+        std::size_t target;
+        /** arrival over service rate **/
+        double      load;
+        bool        critical;
+    };
+
+    /**
+     * critical_path - FIFOs on the longest source to sink path of
+     * the graph (in edges, there is no per kernel cost to go by),
+     * with the budget tight these grow first.
+     * @return std::set< FIFO* >
+     */
+    std::set< FIFO* > critical_path();
+
     /**
-     * hash - simple hash function to quickly
-     * look-up stats on individual FIFO objects
-     * within the streaming app, based on 
-     * addresses of each queue, one consequence
-     * obviously is that the info is trash once
-     * the FIFO is re-allocated, but this is a 
-     * good thing since we don't typically want
-     * stats to hang around.
-     * @param a, PortInfo& - src portinfo
-     * @param b, PortInfo& - dst portinfo
-     * @return std::size_t
+     * grow_within_budget - grow the FIFOs in wanted, critical ones
+     * and the most loaded first, as far as the budget allows. FIFOs
+     * in spare are above their target but haven't waited out the
+     * shrink passes, they are shrunk to it, largest first, to make
+     * room or to get back under the budget. A FIFO that can't have
+     * its target gets doubled if that fits, otherwise it keeps its
+     * count and asks again the next pass.
+     * @param wanted - std::vector< candidate >&, FIFOs to grow
+     * @param spare  - std::vector< candidate >&, FIFOs that could shrink
+     */
+    void grow_within_budget( std::vector< candidate > &wanted,
+                             std::vector< candidate > &spare );
+
+    /** 
+     * FIFOs never move once allocated, resizes swap their storage,
+     * only touched by run() until it returns
      */
-    static std::size_t hash( PortInfo &a, 
-                             PortInfo &b );
+    std::map< FIFO*, edge_state > edges;
 };
 
 #endif /* END RAFTDYNALLOC_HPP */
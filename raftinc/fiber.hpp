@@ -0,0 +1,81 @@
+/**
+ * fiber.hpp - a function with its own stack that runs on the calling
+ * thread, resume() runs it until it calls yield() (or returns), the
+ * next resume() picks up where it left off. Lets one thread run
+ * several kernels that each may block in a FIFO, a blocked kernel
+ * yields instead of holding the thread (see fusion.hpp).
+ *
+ * Stacks are reserved, not committed, pages are only backed once
+ * touched, with a guard page at the bottom. Not available on
+ * Windows, supported() says so and fusion stays off there.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTFIBER_HPP
+#define RAFTFIBER_HPP  1
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+namespace raft
+{
+
+class fiber
+{
+public:
+   /** same as a default thread stack, reserved only **/
+   static constexpr std::size_t stack_size = ( 1 << 23 );
+
+   using body_t = std::function< void() >;
+
+   explicit fiber( body_t body );
+
+   fiber( const fiber &other ) = delete;
+   fiber& operator = ( const fiber &other ) = delete;
+
+   ~fiber();
+
+   /**
+    * resume - run the body until it yields or returns, an
+    * exception it throws is rethrown here.
+    * @return bool - false once the body returned
+    */
+   bool resume();
+
+   /**
+    * yield - call from a body, back to the resume() that
+    * started this slice.
+    * @return bool - false when not called from a fiber
+    */
+   static bool yield();
+
+   /** supported - fibers work on this platform **/
+   static bool supported() noexcept;
+
+private:
+   struct context;
+   /** entry point of every fiber, runs current's body **/
+   static void trampoline();
+
+   std::unique_ptr< context > ctx;
+   /** the fiber running on this thread, nullptr outside of one **/
+   static thread_local context *current;
+};
+
+} /** end namespace raft **/
+#endif /* END RAFTFIBER_HPP */
@@ -31,16 +31,26 @@
 #include <cassert>
 #include <type_traits>
 #include <stdexcept>
+#include <algorithm>
 #include "bufferdata.tcc"
 #include "blocked.hpp"
 #include "signalvars.hpp"
 #include "alloc_traits.tcc"
+#include "span.hpp"
+#include "waitstrategy.hpp"
+#include "numaplace.hpp"
+#include "spillfile.hpp"
+#include "ringbuffertypes.hpp"
 
 
 #include "defs.hpp"
 
 /** pre-declare Schedule class **/
 class Schedule;
+namespace Buffer
+{
+   class Reclaimer;
+}
 class Allocate;
 
 namespace raft
@@ -129,9 +139,9 @@ public:
    allocate( Args&&... params )
    {
       T **ptr( nullptr );
-      /** call blocks till an element is available **/
+      /** call blocks till an element is available, *ptr is a pool slot **/
       local_allocate( (void**) &ptr );
-      *ptr = new T( std::forward< Args >( params )... );
+      new ( *ptr ) T( std::forward< Args >( params )... );
       return( **ptr );
    }
 
@@ -194,9 +204,9 @@ public:
    auto allocate_s( Args&&... params ) -> autorelease< T, allocatetype >
    {
       T **ptr( nullptr );
-      /** call blocks till an element is available **/
+      /** call blocks till an element is available, *ptr is a pool slot **/
       local_allocate( (void**) &ptr );
-      *ptr = new T( std::forward< Args >( params )... );
+      new ( *ptr ) T( std::forward< Args >( params )... );
       return( autorelease< T, allocatetype >( 
          reinterpret_cast< T* >( *ptr ), (*this) ) );
    }
@@ -231,6 +241,46 @@ public:
             std::reference_wrapper< T > > >( output ) );
    }
 
+   /**
+    * allocate_span - reserve n slots on the queue and get them
+    * back as at most two contiguous spans, the slots before the
+    * wrap point (first) and after it (second). Blocks until n
+    * slots are free. Release the items with send_range, as with
+    * allocate_range. Slots are raw storage so the type must be
+    * trivially copyable.
+    * @param   n - const std::size_t, # items to allocate
+    * @return  raft::span_pair< T >
+    */
+   template < class T,
+              typename std::enable_if< inline_alloc< T >::value &&
+                 std::is_trivially_copyable< T >::value >::type* = nullptr >
+   raft::span_pair< T > allocate_span( const std::size_t n )
+   {
+      void *store( nullptr );
+      std::size_t count( n ), start( 0 ), queue_size( 0 );
+      local_allocate_span( &store, count, start, queue_size, false );
+      return( split_span< T >( store, start, count, queue_size ) );
+   }
+
+   /**
+    * allocate_contiguous - like allocate_span, but only returns
+    * the slots up to the wrap point so the result is a single
+    * span of at least one and at most n items. Release the items
+    * with send_range, the size of the span is what gets sent.
+    * @param   n - const std::size_t, max # items to allocate
+    * @return  raft::span< T >
+    */
+   template < class T,
+              typename std::enable_if< inline_alloc< T >::value &&
+                 std::is_trivially_copyable< T >::value >::type* = nullptr >
+   raft::span< T > allocate_contiguous( const std::size_t n )
+   {
+      void *store( nullptr );
+      std::size_t count( n ), start( 0 ), queue_size( 0 );
+      local_allocate_span( &store, count, start, queue_size, true );
+      return( raft::span< T >( reinterpret_cast< T* >( store ) + start, count ) );
+   }
+
    //FIXME, implement allocate_range for object types
    /**
     * send - releases the last item allocated by allocate() to the 
@@ -268,24 +318,51 @@ public:
    }
    
    /**
-    * push - function which takes an object of type T and a 
-    * signal, makes a copy of the object using the copy 
-    * constructor and passes it to the FIFO along with the
-    * signal which is guaranteed to be delivered at the 
-    * same time as the object (if of course the receiving 
-    * object is responding to signals).
+    * push - rvalue version, the object is moved into the FIFO,
+    * strings, vectors and the like hand over their storage
+    * instead of being deep copied. Lvalues and const rvalues
+    * take the copying push above.
     * @param   item -  T&&
     * @param   signal -  raft::signal, default raft::none
     */
-   template < class T >
-   void push( const T &&item, const raft::signal signal = raft::none )
+   template < class T,
+              typename std::enable_if< 
+                 ! std::is_lvalue_reference< T >::value &&
+                 ! std::is_const< T >::value >::type* = nullptr >
+   void push( T &&item, const raft::signal signal = raft::none )
    {
       void * const ptr( (void*) &item );
-      /** call blocks till element is written and released to queue **/
-      local_push( ptr, signal );
+      /** call blocks till element is moved in and released to queue **/
+      local_push_move( ptr, signal );
       return;
    }
 
+   /**
+    * emplace - construct the item in place at the tail of the
+    * FIFO from params and release it, nothing is copied or moved.
+    * Use allocate and send to attach a signal.
+    * @param   params - Args&&..., constructor arguments of T
+    */
+   template < class T,
+              class ... Args,
+              typename std::enable_if< 
+                 inline_nonclass_alloc< T >::value >::type* = nullptr >
+   void emplace( Args&&... params )
+   {
+      allocate< T >() = T( std::forward< Args >( params )... );
+      send();
+   }
+
+   template < class T,
+              class ... Args,
+              typename std::enable_if< 
+                 ! inline_nonclass_alloc< T >::value >::type* = nullptr >
+   void emplace( Args&&... params )
+   {
+      allocate< T >( std::forward< Args >( params )... );
+      send();
+   }
+
 
    /**
     * insert - inserts the range from begin to end in the FIFO,
@@ -313,9 +390,9 @@ public:
    }
    
    /**
-    * pop - pops the head of the queue.  If the receiving
-    * object wants to watch use the signal, then the signal
-    * parameter should not be null.
+    * pop - pops the head of the queue, moving it into item.  
+    * If the receiving object wants to watch use the signal, 
+    * then the signal parameter should not be null.
     * @param   item - T&
     * @param   signal - raft::signal
     */
@@ -357,7 +434,8 @@ public:
     * peek - returns a reference to the head of the
     * queue.  unpeek() must be called after this to 
     * tell the runtime that the reference is no longer
-    * being used.  
+    * being used.  The item may be moved out of before
+    * it is recycled, recycle destroys what is left.
     * @param   signal - raft::signal, default: nullptr
     * @return T&
     */
@@ -401,7 +479,8 @@ public:
          reinterpret_cast< T * const >( ptr ),
          reinterpret_cast< Buffer::Signal* >( sig ),
          curr_pointer_loc,
-         n ) );
+         n,
+         local_peek_capacity() ) );
    }
    
    template< class T,
@@ -420,10 +499,49 @@ public:
          reinterpret_cast< T * const >( ptr ),
          reinterpret_cast< Buffer::Signal* >( sig ),
          curr_pointer_loc,
-         n ) );
+         n,
+         local_peek_capacity() ) );
    }
 
 
+   /**
+    * peek_span - analogous to peek_range, the next n items are
+    * returned as at most two contiguous spans (before and after
+    * the wrap point) that can be handed straight to memcpy or
+    * vector code. No signals, use peek_range if you need them.
+    * Call unpeek() when done with the spans and recycle( n ) to
+    * remove the items.
+    * @param   n - const std::size_t, number of items to peek
+    * @return  raft::span_pair< T >
+    */
+   template < class T,
+              typename std::enable_if< inline_alloc< T >::value >::type* = nullptr >
+   raft::span_pair< T > peek_span( const std::size_t n )
+   {
+      void *store( nullptr );
+      std::size_t start( 0 ), queue_size( 0 );
+      local_peek_span( &store, n, start, queue_size );
+      return( split_span< T >( store, start, n, queue_size ) );
+   }
+
+   /**
+    * peek_contiguous - waits for n items like peek_span, returns
+    * those up to the wrap point as a single span (at least one,
+    * at most n items). Release as with peek_span.
+    * @param   n - const std::size_t, max number of items to peek
+    * @return  raft::span< T >
+    */
+   template < class T,
+              typename std::enable_if< inline_alloc< T >::value >::type* = nullptr >
+   raft::span< T > peek_contiguous( const std::size_t n )
+   {
+      void *store( nullptr );
+      std::size_t start( 0 ), queue_size( 0 );
+      local_peek_span( &store, n, start, queue_size );
+      return( raft::span< T >( reinterpret_cast< T* >( store ) + start,
+                               std::min( n, queue_size - start ) ) );
+   }
+
    /**
     * unpeek - call after peek to let the runtime know that 
     * all references to the returned value are no longer in
@@ -475,6 +593,74 @@ public:
     */
    virtual void get_zero_write_stats( Blocked &copy );
 
+   /**
+    * set_wait_policy - what the producer/consumer do when the
+    * queue is full/empty, see waitstrategy.hpp. Set by the
+    * allocator before any thread touches the FIFO.
+    * @param   policy - const Wait::Policy
+    */
+   virtual void set_wait_policy( const Wait::Policy policy ) = 0;
+
+   virtual Wait::Policy get_wait_policy() = 0;
+
+   /**
+    * get_wait_stats - current wait policy and how often each
+    * side yielded/parked so far, counts are not reset.
+    * @param   copy - Wait::Stats&
+    */
+   virtual void get_wait_stats( Wait::Stats &copy ) = 0;
+
+   /**
+    * set_home_node - NUMA node the storage should live on, set by
+    * the allocator from the consumer kernel's core, buffers that
+    * later resizes install are placed there as well. Huge page
+    * storage (see pagemap.hpp) is faulted in once it's placed.
+    * @param   node - const int, -1 for no preference
+    */
+   virtual void set_home_node( const int node ) = 0;
+
+   /**
+    * get_placement - home node, node the storage is currently on
+    * and its size, see numaplace.hpp. Not synchronized with resize,
+    * call from the allocator thread or once the map is done.
+    * @param   copy - Placement::Info&
+    */
+   virtual void get_placement( Placement::Info &copy ) = 0;
+
+   /**
+    * get_storage_bytes - memory the FIFO's storage takes right
+    * now, used by the allocator to keep the map within its FIFO
+    * memory budget (see MapBase::setFIFOMemoryBudget).
+    * @return  std::size_t
+    */
+   virtual std::size_t get_storage_bytes() = 0;
+
+   /**
+    * get_spill_stats - memory and spill file use of a FIFO that
+    * overflows to disk (Type::Infinite, see ringbufferinfinite.tcc),
+    * all zero for every other FIFO.
+    * @param   copy - Buffer::SpillStats&
+    */
+   virtual void get_spill_stats( Buffer::SpillStats &copy );
+
+   /**
+    * share - FIFOs that take more than one producer or consumer
+    * port (Type::MPMC) return a new view of the same queue for an
+    * extra output (side == Producer) or input port (side ==
+    * Consumer). Called by the allocator for fan-in/fan-out links.
+    * @param   side - const Direction
+    * @return  FIFO*, nullptr if this FIFO can't be shared
+    */
+   virtual FIFO* share( const Direction side );
+
+   /**
+    * is_shared - true if more than one port uses this FIFO on
+    * side, i.e., a Type::MPMC FIFO handed out by share().
+    * @param   side - const Direction
+    * @return  bool
+    */
+   virtual bool is_shared( const Direction side );
+
    /**
     * resize - called from the dynamic allocator  to 
     * resize the queue.  The function itself is 
@@ -536,21 +722,33 @@ public:
    virtual bool is_invalid() = 0;
 protected:
    /**
-    * setPtrMap - 
-    */
-   virtual void setPtrMap( ptr_map_t * const in );
-   /**
-    * setPtrSet - 
+    * setReclaimer - per kernel thread tracking of out-of-line
+    * items, see reclaimer.hpp. Set once by the producer's and
+    * once by the consumer's thread. No-op for FIFOs that don't
+    * store items out of line.
+    * @param reclaimer - Buffer::Reclaimer*, owned by the thread
+    * @param side      - Direction, the end that thread uses
     */
-   virtual void setPtrSet( ptr_set_t * const out );
+   virtual void setReclaimer( Buffer::Reclaimer * const reclaimer,
+                              const Direction side );
    /**
-    * setInPeekSet -
+    * setReadySet - consumer kernel's ready set (readyset.hpp),
+    * bit is set whenever items become visible and the set is
+    * poked when the FIFO is invalidated. No-op for FIFOs
+    * without a wait strategy.
+    * @param ready - raft::ready_set*, owned by the consumer's scheduler
+    * @param bit   - const std::size_t, this port's bit
     */
-   virtual void setInPeekSet( ptr_set_t * const peekset );
+   virtual void setReadySet( raft::ready_set * const ready,
+                             const std::size_t bit );
+
    /**
-    * setOutPeekSet -
+    * quiesce - called by the consumer's thread while it isn't
+    * using the FIFO, i.e., before it sleeps waiting for data,
+    * so a pending resize doesn't have to wait for its next pop.
+    * No-op for FIFOs that don't need the consumer to check in.
     */
-   virtual void setOutPeekSet( ptr_set_t * const peekset );
+   virtual void quiesce();
    /**
     * signal_peek - special function for the scheduler
     * to peek at a signal on the head of the queue.
@@ -604,6 +802,19 @@ protected:
     */
    virtual void local_push( void *ptr, const raft::signal &signal ) = 0;
 
+   /**
+    * local_push_move - as local_push, the object at ptr is an
+    * rvalue, its resources are moved into the queue and it is
+    * left moved-from. FIFOs that can't do better (plain old data,
+    * FIFOs that serialize) copy.
+    * @param   ptr - void* 
+    * @param   signal - raft::signal reference
+    */
+   virtual void local_push_move( void *ptr, const raft::signal &signal )
+   {
+      local_push( ptr, signal );
+   }
+
    /**
     * local_insert - inserts a range from ptr_begin to ptr_end
     * and inserts the signal at the last element inserted, the 
@@ -618,8 +829,8 @@ protected:
                               const std::size_t iterator_type ) = 0;
   
    /**
-    * local_pop - makes a copy, pops an item from the queue and 
-    * stores the copy at memory located at *ptr.
+    * local_pop - pops an item from the queue and move-assigns it
+    * to the object at *ptr, the slot is done with it.
     * @param   ptr    - void*
     * @param   signal - raft::signal* 
     */
@@ -656,6 +867,65 @@ protected:
                                   void **sig,
                                   const std::size_t n_items,
                                   std::size_t &curr_pointer_loc ) = 0;
+
+   /**
+    * local_allocate_span - reserve n slots, returns the start of
+    * the buffer they are in, the index of the first one and the
+    * buffer size. If contiguous is set n is reduced to the slots
+    * left before the wrap point.
+    * @param   store      - void**, buffer base
+    * @param   n          - std::size_t&, slots wanted/reserved
+    * @param   start      - std::size_t&, index of first slot
+    * @param   queue_size - std::size_t&, slots in the buffer
+    * @param   contiguous - const bool
+    */
+   virtual void local_allocate_span( void **store,
+                                     std::size_t &n,
+                                     std::size_t &start,
+                                     std::size_t &queue_size,
+                                     const bool contiguous ) = 0;
+
+   /**
+    * local_peek_span - wait for n items, return where they are
+    * as above. The consumer side stays in the buffer until 
+    * unpeek is called.
+    * @param   store      - void**, buffer base
+    * @param   n          - const std::size_t, items wanted
+    * @param   start      - std::size_t&, index of first item
+    * @param   queue_size - std::size_t&, slots in the buffer
+    */
+   virtual void local_peek_span( void **store,
+                                 const std::size_t n,
+                                 std::size_t &start,
+                                 std::size_t &queue_size ) = 0;
+
+   /**
+    * split_span - cut n items starting at start in a ring of
+    * queue_size slots into the part before and after the wrap.
+    */
+   template < class T >
+   static raft::span_pair< T > split_span( void * const store,
+                                           const std::size_t start,
+                                           const std::size_t n,
+                                           const std::size_t queue_size )
+   {
+      auto * const base( reinterpret_cast< T* >( store ) );
+      const auto n_first( std::min( n, queue_size - start ) );
+      return( raft::span_pair< T >{ raft::span< T >( base + start, n_first ),
+                                    raft::span< T >( base, n - n_first ) } );
+   }
+
+   /**
+    * local_peek_capacity - number of slots in the buffer the
+    * last local_peek_range call pointed into, the peek range
+    * wraps its indices around this. Same as capacity() unless
+    * the FIFO can hold more than one buffer at once.
+    * @return  std::size_t
+    */
+   virtual std::size_t local_peek_capacity()
+   {
+      return( capacity() );
+   }
    
    /**
     * local_recycle - called by template recycle function
@@ -669,6 +939,7 @@ protected:
     * needed to keep as a friend for signalling access 
     */
    friend class Schedule;
+   friend class raft::ready_set;
    friend class Allocate;
 };
 
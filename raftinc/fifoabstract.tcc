@@ -26,8 +26,13 @@
 #include "blocked.hpp"
 #include "fifo.hpp"
 #include "datamanager.tcc"
+#include "signalchannel.hpp"
+#include "reclaimer.hpp"
+#include "waitstrategy.hpp"
 #include "defs.hpp"
 #include "internaldefs.hpp"
+#include <cstdint>
+#include <vector>
 
 template < class T, Type::RingBufferType type > 
    class FIFOAbstract : public FIFO
@@ -35,6 +40,45 @@ template < class T, Type::RingBufferType type >
 public:
    FIFOAbstract() : FIFO(){}
 
+   virtual void set_wait_policy( const Wait::Policy policy )
+   {
+      waiter.set_policy( policy );
+   }
+
+   virtual Wait::Policy get_wait_policy()
+   {
+      return( waiter.get_policy() );
+   }
+
+   virtual void get_wait_stats( Wait::Stats &copy )
+   {
+      waiter.get_stats( copy );
+   }
+
+   virtual void setReadySet( raft::ready_set * const ready,
+                             const std::size_t bit )
+   {
+      waiter.set_ready( ready, bit );
+   }
+
+   virtual void set_home_node( const int node )
+   {
+      datamanager.set_node( node );
+   }
+
+   virtual void get_placement( Placement::Info &copy )
+   {
+      auto * const buffer( datamanager.get() );
+      copy.home_node     = datamanager.get_node();
+      copy.resident_node = Placement::node_of( buffer->store );
+      copy.bytes         = buffer->length_store;
+   }
+
+   virtual std::size_t get_storage_bytes()
+   {
+      return( datamanager.get()->length_store );
+   }
+
 protected:
 
     inline void init() noexcept
@@ -49,12 +93,11 @@ protected:
         volatile bool            allocate_called = false;
         Blocked::value_type      n_allocated     = 1;
         /**
-         * these pointers are set by the scheduler which 
-         * calls the garbage collection function. these
-         * two capture the addresses of output pointers
+         * set by the scheduler which closes the reclaim
+         * epochs, tracks items forwarded zero copy from a
+         * peek on one of the kernel's inputs
          */
-        ptr_set_t                   *out         = nullptr;
-        ptr_set_t                   *out_peek    = nullptr;
+        Buffer::Reclaimer           *reclaim     = nullptr;
         /** 
          * this is set via init callback on fifo construction
          * this prevents the re-calculating of the address
@@ -62,18 +105,43 @@ protected:
          * for cache performance.
          */
         Blocked                     *write_stats = nullptr;
+        /**
+         * lower bound on free slots as of the last time the
+         * producer looked at the read side, only the producer
+         * ever takes space away so this stays valid until it
+         * runs out, then it's refreshed. Keeps the producer off
+         * the consumer's cache lines on most calls. A resize
+         * zeroes it, a smaller buffer takes space away too.
+         */
+        std::size_t                 cached_space = 0;
+        /**
+         * number of items ever written, never reset on resize,
+         * this is what signals are keyed on in the signal channel.
+         */
+        std::uint64_t               position     = 0;
     } producer_data;
    
    
     struct  ALIGN( L1D_CACHE_LINE_SIZE ) {
         /**
-         * these pointers are set by the scheduler which 
-         * calls the garbage collection function. these
-         * two capture the addresses of output pointers
+         * set by the scheduler which closes the reclaim
+         * epochs, recycled out-of-line items are retired
+         * here, peeked ones recorded
          */
-        ptr_map_t                   *in         = nullptr;
-        ptr_set_t                   *in_peek    = nullptr;
+        Buffer::Reclaimer           *reclaim    = nullptr;
         Blocked                     *read_stats = nullptr;
+        /** same as cached_space, lower bound on items to read **/
+        std::size_t                 cached_items = 0;
+        /** number of items ever read, matches producer position **/
+        std::uint64_t               position     = 0;
+        /** 
+         * scratch signals handed out by peek_range, only the 
+         * consumer touches these so they live here instead of
+         * beside every element in the buffer.
+         */
+        std::vector< Buffer::Signal > range_signals;
+        /** entries of range_signals that may not be raft::none **/
+        std::size_t                   range_dirty  = 0;
     } consumer_data;
     
     /** 
@@ -82,5 +150,20 @@ protected:
      * lock free buffer resizing and re-alignment.
      */
     DataManager< T, type >       datamanager;
+
+    /** 
+     * sparse (position, signal) side channel, only elements 
+     * that carry something other than raft::none have an 
+     * entry so signal-free traffic never touches it. Lives
+     * with the FIFO, not the buffer, so it survives resizing.
+     */
+    Buffer::SignalChannel        signals;
+
+    /** 
+     * blocked producer/consumer behavior, both sides call
+     * produced()/consumed() after publishing so a parked
+     * opposite side can be woken.
+     */
+    Buffer::WaitStrategy         waiter;
 };
 #endif /* END RAFTFIFOABSTRACT_TCC */
@@ -0,0 +1,90 @@
+/**
+ * fusion.hpp - finds linear chains in the graph so a thread per
+ * kernel scheduler can run each chain on one thread instead of a
+ * thread per stage. Two kernels are fused when the producer has a
+ * single output port, the consumer a single input port, the link
+ * is a plain in-process one (no fan out, no out of order link the
+ * parallelism monitor might split, no shared memory or TCP end) and
+ * both sit in the same affinity group on the same core. Either
+ * kernel can opt out with kernel::setFusion( false ), the whole map
+ * with MapBase::setFusion( false ).
+ *
+ * The FIFO between fused kernels stays, kernels still push and pop,
+ * but both ends are on one thread so it stays at its initial, cache
+ * sized capacity and in that thread's cache. Each stage runs as a
+ * raft::fiber (fiber.hpp) for as long as it has input, a stage that
+ * blocks in a FIFO yields to the others (raft::blocked_hook). Without
+ * fibers on the platform nothing is fused.
+ *
+ * Fused links show up in the GEN_DOT output as a dashed cluster per
+ * chain and fused=true on the edge.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTFUSION_HPP
+#define RAFTFUSION_HPP  1
+#include "kernelkeeper.tcc"
+#include "kernel.hpp"
+
+struct PortInfo;
+
+namespace raft
+{
+
+class fusion
+{
+public:
+   fusion() = delete;
+
+   /**
+    * mark - link the kernels of every chain, clears the links
+    * of an earlier mark first. Call once the partitioner ran,
+    * cores are compared.
+    * @param source  - kernelkeeper&, source kernels of the map
+    * @param all     - kernelkeeper&, all kernels of the map
+    * @param enabled - const bool, false just clears
+    */
+   static void mark( kernelkeeper &source,
+                     kernelkeeper &all,
+                     const bool   enabled );
+
+   /** head - k starts a chain, or isn't fused at all **/
+   static bool head( const raft::kernel * const k ) noexcept
+   {
+      return( k->fused_prev == nullptr );
+   }
+
+   /** fused - k is part of a chain of two or more **/
+   static bool fused( const raft::kernel * const k ) noexcept
+   {
+      return( k->fused_prev != nullptr || k->fused_next != nullptr );
+   }
+
+   /** next - k's consumer in its chain, nullptr at the end **/
+   static raft::kernel* next( const raft::kernel * const k ) noexcept
+   {
+      return( k->fused_next );
+   }
+
+private:
+   /** fusable - can the link a -> b be fused **/
+   static bool fusable( const PortInfo &a, const PortInfo &b );
+};
+
+} /** end namespace raft **/
+#endif /* END RAFTFUSION_HPP */
@@ -32,6 +32,7 @@
 #include "port.hpp"
 #include "signalvars.hpp"
 #include "rafttypes.hpp"
+#include "waittypes.hpp"
 #include "kernel_wrapper.hpp"
 
 /** pre-declare for friends **/ 
@@ -184,6 +185,77 @@ public:
         return;
     }
 
+    /**
+     * setBufferType - FIFO implementation to use for the
+     * output ports of this kernel, resolved by the allocator
+     * when the FIFOs are built. Usually set through the
+     * raft::fifo::type manipulator.
+     * @param type - Type::RingBufferType
+     */
+    constexpr void setBufferType( const Type::RingBufferType type )
+    {
+        buffer_type = type;
+        return;
+    }
+
+    Type::RingBufferType getBufferType() const noexcept
+    {
+        return( buffer_type );
+    }
+
+    /**
+     * setWaitPolicy - how the output FIFOs of this kernel
+     * block when full/empty, overrides the map wide policy.
+     * Usually set through the raft::fifo::wait manipulator.
+     * @param policy - Wait::Policy
+     */
+    constexpr void setWaitPolicy( const Wait::Policy policy )
+    {
+        wait_policy = policy;
+        return;
+    }
+
+    /** @return Wait::Policy, Wait::N if unset (use the map's) **/
+    Wait::Policy getWaitPolicy() const noexcept
+    {
+        return( wait_policy );
+    }
+
+    /**
+     * setHugePages - back the output FIFOs of this kernel with
+     * huge pages, faulted in before the run starts (see
+     * pagemap.hpp). Usually set through the raft::fifo::huge_pages
+     * manipulator.
+     * @param huge - bool
+     */
+    constexpr void setHugePages( const bool huge )
+    {
+        huge_pages = huge;
+        return;
+    }
+
+    bool getHugePages() const noexcept
+    {
+        return( huge_pages );
+    }
+
+    /**
+     * setFusion - false keeps this kernel on a thread of its own,
+     * it's never fused into a chain with its neighbours (see
+     * fusion.hpp). Fusion is allowed by default.
+     * @param fuse - bool
+     */
+    constexpr void setFusion( const bool fuse )
+    {
+        fusion = fuse;
+        return;
+    }
+
+    bool getFusion() const noexcept
+    {
+        return( fusion );
+    }
+
 protected:
     /**
      * 
@@ -201,6 +273,7 @@ protected:
     
     /** in namespace raft **/
     friend class map;
+    friend class fusion;
     /** in global namespace **/
     friend class ::MapBase;
     friend class ::Schedule;
@@ -246,6 +319,17 @@ protected:
     core_id_t   core_assign       = -1;
     core_id_t   affinity_group    = -1;
 
+    /** FIFO type for output ports, see setBufferType **/
+    Type::RingBufferType    buffer_type = Type::Heap;
+    /** FIFO wait policy for output ports, Wait::N means unset **/
+    Wait::Policy            wait_policy = Wait::N;
+    /** huge page FIFO storage for output ports, see setHugePages **/
+    bool                    huge_pages  = false;
+    /** see setFusion, links are set by raft::fusion::mark **/
+    bool                    fusion      = true;
+    raft::kernel           *fused_prev  = nullptr;
+    raft::kernel           *fused_next  = nullptr;
+
 
     raft::schedule_behavior     sched_behav = raft::any_port;
 private:
@@ -21,6 +21,8 @@
 #define KERNELMANIP_TCC  1
 #include "defs.hpp"
 #include "kernel.hpp"
+#include "ringbuffertypes.hpp"
+#include "waittypes.hpp"
 
 namespace raft
 {
@@ -63,5 +65,56 @@ template < device_t D, _size_t N > struct device
 
 } /** end namespace vm **/
 
+namespace fifo
+{
+
+/**
+ * type - select the FIFO implementation used for the
+ * output ports of the bound kernel(s), e.g.,
+ * raft::manip< raft::fifo::type< Type::LockFreeSPSC > >::bind( k );
+ */
+template < Type::RingBufferType B > struct type
+{
+    constexpr static Type::RingBufferType value = B;
+
+    constexpr static void invoke( raft::kernel &&k )
+    {
+        k.setBufferType( value );
+    }
+};
+
+/**
+ * wait - select what the FIFOs on the output ports of the
+ * bound kernel(s) do when blocked, e.g., for mostly idle
+ * kernels:
+ * raft::manip< raft::fifo::wait< Wait::Park > >::bind( k );
+ */
+template < Wait::Policy P > struct wait
+{
+    constexpr static Wait::Policy value = P;
+
+    constexpr static void invoke( raft::kernel &&k )
+    {
+        k.setWaitPolicy( value );
+    }
+};
+
+/**
+ * huge_pages - huge page backed storage for the FIFOs on the
+ * output ports of the bound kernel(s), for large queues, e.g.,
+ * raft::manip< raft::fifo::huge_pages >::bind( reader );
+ */
+struct huge_pages
+{
+    constexpr static bool value = true;
+
+    constexpr static void invoke( raft::kernel &&k )
+    {
+        k.setHugePages( value );
+    }
+};
+
+} /** end namespace fifo **/
+
 } /** end namespace raft **/
 #endif /* END KERNELMANIP_TCC */
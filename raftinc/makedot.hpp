@@ -22,6 +22,7 @@
 #include <ostream>
 #include <sstream>
 #include "kernelkeeper.tcc"
+#include "waittypes.hpp"
 
 namespace raft
 {
@@ -116,6 +117,8 @@ private:
      */
     kernelkeeper &all_kernels; 
     kernelkeeper &source_kernels; 
+    /** map wide FIFO wait policy, per kernel ones override **/
+    const Wait::Policy wait_policy;
 };
 
 } /** end namespace raft **/
@@ -36,11 +36,14 @@
 #include "stdalloc.hpp"
 #include "mapbase.hpp"
 #include "poolschedule.hpp"
+#include "workstealschedule.hpp"
+#include "threadcache.hpp"
 #include "basicparallel.hpp"
 #include "noparallel.hpp"
 /** includes all partitioners **/
 #include "partitioners.hpp"
 #include "makedot.hpp"
+#include "fusion.hpp"
 
 namespace raft
 {
@@ -108,6 +111,12 @@ public:
       checkEdges();
       partition pt;
       pt.partition( all_kernels );
+      /** warm start, cores from the last run replace the partitioner's **/
+      loadProfile();
+      /** after the cores are final, fused kernels share one **/
+      raft::fusion::mark( source_kernels,
+                          all_kernels,
+                          fuse_chains && scheduler::fuses );
         
       auto *dot_graph_env = std::getenv( "GEN_DOT" );
       if( dot_graph_env != nullptr )
@@ -131,9 +140,14 @@ public:
       //enableDuplication( source_kernels, all_kernels );
       volatile bool exit_alloc( false );
       allocator alloc( (*this), exit_alloc );
-      /** launch allocator in a thread **/
-      std::thread mem_thread( [&](){
+      /** 
+       * the allocator, scheduler and monitor run on cached threads
+       * (see threadcache.hpp), back to back maps don't start new ones
+       */
+      raft::latch alloc_done( 1 ), sched_done( 1 ), para_done( 1 );
+      raft::thread_cache::run( [&](){
          alloc.run();
+         alloc_done.count_down();
       });
       
       try
@@ -147,9 +161,10 @@ public:
       scheduler sched( (*this) );
       sched.init();
       
-      /** launch scheduler in thread **/
-      std::thread sched_thread( [&](){
+      /** launch scheduler **/
+      raft::thread_cache::run( [&](){
          sched.start();
+         sched_done.count_down();
       });
 
       volatile bool exit_para( false );
@@ -158,18 +173,29 @@ public:
                               alloc       /** allocator      **/,
                               sched       /** scheduler      **/,
                               exit_para   /** exit parameter **/);
-      std::thread parallel_mon( [&](){
+      raft::thread_cache::run( [&](){
          pm.start();
+         para_done.count_down();
       });
-      /** join scheduler first **/
-      sched_thread.join();
+      /** wait on the scheduler first **/
+      sched_done.wait();
 
       /** scheduler done, cleanup alloc **/
       exit_alloc = true;
-      mem_thread.join();
+      alloc.wake();
+      alloc_done.wait();
       /** no more need to duplicate kernels **/
       exit_para = true;
-      parallel_mon.join();
+      para_done.wait();
+
+      auto *placement_env = std::getenv( "RAFT_FIFO_PLACEMENT" );
+      if( placement_env != nullptr )
+      {
+          std::ofstream of( placement_env );
+          alloc.report_placement( of );
+          of.close();
+      }
+      saveProfile( alloc );
 
       /** all fifo's deallocated when alloc goes out of scope **/
       return; 
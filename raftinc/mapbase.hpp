@@ -28,6 +28,7 @@
  */
 #ifndef RAFTMAPBASE_HPP
 #define RAFTMAPBASE_HPP  1
+#include <atomic>
 #include <typeinfo>
 #include <cassert>
 #include <vector>
@@ -45,6 +46,9 @@
 #include "stdalloc.hpp"
 #include "kpair.hpp"
 #include "kernel_pair_t.hpp"
+#include "waittypes.hpp"
+#include "spillfile.hpp"
+#include "profile.hpp"
 
 namespace raft
 {
@@ -74,6 +78,12 @@ public:
      * @param   a_port - const raft::port_key_type, output port name
      * @param   b - raft::kernel*, with input port named b_port
      * @param   b_port - const raft::port_key_type, input port name.
+     * @param   buffer - const std::size_t, fixed FIFO size, 0 lets the
+     *          allocator pick and resize
+     * @param   type - const Type::RingBufferType, FIFO type for this
+     *          link, Type::N uses the source kernel's. Linking a port
+     *          a second time (fan-in to b_port, fan-out from a_port) is
+     *          only allowed if the edges are Type::MPMC.
      * @throws  PortNotFoundException - exception thrown if either kernel
      *          is missing port a_port or b_port.
      * @return  kernel_pair_t - references to src, dst kernels.
@@ -83,7 +93,8 @@ public:
                            raft::port_key_type a_port, 
                            raft::kernel *b, 
                            raft::port_key_type b_port,
-                           const std::size_t buffer = 0 )
+                           const std::size_t buffer = 0,
+                           const Type::RingBufferType type = Type::N )
     {
         updateKernels( a, b );
         /**
@@ -107,7 +118,15 @@ public:
         {
             port_info_a =  &a->output.getPortInfoFor( a_port );
         }
-        port_info_a->fixed_buffer_size = buffer;
+        /** a shared port keeps what its first link set **/
+        if( buffer != 0 || port_info_a->other_kernel == nullptr )
+        {
+            port_info_a->fixed_buffer_size = buffer;
+        }
+        if( type != Type::N )
+        {
+            port_info_a->fifo_type = type;
+        }
         /**
          * START dst port discovery
          */
@@ -130,7 +149,10 @@ public:
         {
             port_info_b = &b->input.getPortInfoFor( b_port );
         }
-        port_info_b->fixed_buffer_size = buffer;
+        if( buffer != 0 || port_info_b->other_kernel == nullptr )
+        {
+            port_info_b->fixed_buffer_size = buffer;
+        }
         
         assert( port_info_a != nullptr );
         assert( port_info_b != nullptr );
@@ -142,6 +164,151 @@ public:
         return( kernel_pair_t( a, b ) );
     }
 
+    /**
+     * setWaitPolicy - default wait policy for every FIFO in
+     * this map, kernels bound with the raft::fifo::wait
+     * manipulator keep their own. Call before exe().
+     * @param   policy - const Wait::Policy
+     */
+    void setWaitPolicy( const Wait::Policy policy ) noexcept
+    {
+        wait_policy = policy;
+    }
+
+    Wait::Policy getWaitPolicy() const noexcept
+    {
+        return( wait_policy );
+    }
+
+    /**
+     * setHugePages - huge page backed storage for every FIFO in
+     * this map, or just for those of kernels bound with the
+     * raft::fifo::huge_pages manipulator (the default). Call
+     * before exe().
+     * @param   huge - const bool
+     */
+    void setHugePages( const bool huge ) noexcept
+    {
+        huge_pages = huge;
+    }
+
+    bool getHugePages() const noexcept
+    {
+        return( huge_pages );
+    }
+
+    /**
+     * setSpillBudget - bytes of segments each Type::Infinite FIFO
+     * keeps in memory, past that its segments go to a spill file
+     * (see ringbufferinfinite.tcc). Call before exe().
+     * @param   bytes - const std::size_t
+     */
+    void setSpillBudget( const std::size_t bytes ) noexcept
+    {
+        spill.ram_budget = bytes;
+    }
+
+    std::size_t getSpillBudget() const noexcept
+    {
+        return( spill.ram_budget );
+    }
+
+    /**
+     * setSpillDirectory - where Type::Infinite FIFOs create their
+     * spill files, default is $TMPDIR or /tmp. Call before exe().
+     * @param   directory - const std::string&
+     */
+    void setSpillDirectory( const std::string &directory )
+    {
+        spill.directory = directory;
+    }
+
+    const std::string& getSpillDirectory() const noexcept
+    {
+        return( spill.directory );
+    }
+
+    /**
+     * setFIFOMemoryBudget - bytes of storage all FIFOs of this map
+     * may take together, the dynamic allocator doesn't grow a FIFO
+     * past it. With the budget tight, edges on the graph's critical
+     * path grow first and idle FIFOs are shrunk to make room. 0 (the
+     * default) is unbounded. Call before exe().
+     * @param   bytes - const std::size_t
+     */
+    void setFIFOMemoryBudget( const std::size_t bytes ) noexcept
+    {
+        fifo_budget = bytes;
+    }
+
+    std::size_t getFIFOMemoryBudget() const noexcept
+    {
+        return( fifo_budget );
+    }
+
+    /**
+     * getFIFOMemoryUsage - FIFO storage as of the allocator's last
+     * pass against the budget, safe to call from any thread while
+     * exe() runs and after it returns.
+     * @return  FIFOMemory
+     */
+    FIFOMemory getFIFOMemoryUsage() const noexcept
+    {
+        FIFOMemory usage;
+        usage.used   = fifo_used.load( std::memory_order_relaxed );
+        usage.peak   = fifo_peak.load( std::memory_order_relaxed );
+        usage.budget = fifo_budget;
+        return( usage );
+    }
+
+    /**
+     * setProfileOutput - at the end of exe() write what the run
+     * learned, the capacity each edge settled on, its measured
+     * rates and the core each kernel ran on, to path (see
+     * profile.hpp). RAFT_PROFILE_SAVE does the same if this isn't
+     * set.
+     * @param   path - const std::string&
+     */
+    void setProfileOutput( const std::string &path )
+    {
+        profile_output = path;
+    }
+
+    /**
+     * setProfileInput - start exe() from a profile a previous run
+     * saved, edges it knows are built at the capacity they ended up
+     * at and kernels go back to their cores. A missing file is a
+     * cold start, so input and output can be the same file.
+     * RAFT_PROFILE_LOAD does the same if this isn't set.
+     * @param   path - const std::string&
+     */
+    void setProfileInput( const std::string &path )
+    {
+        profile_input = path;
+    }
+
+    /**
+     * setSchedulerThreads - worker threads for schedulers that run
+     * kernels on a pool (work_steal_schedule), 0 (the default) is
+     * one per online core. Call before exe().
+     * @param   n - const std::size_t
+     */
+    void setSchedulerThreads( const std::size_t n ) noexcept
+    {
+        scheduler_threads = n;
+    }
+
+    /**
+     * setFusion - run linear chains of kernels on one thread with
+     * schedulers that otherwise give each kernel its own thread
+     * (simple_schedule), see fusion.hpp. On by default, single
+     * kernels opt out with kernel::setFusion. Call before exe().
+     * @param   fuse - const bool
+     */
+    void setFusion( const bool fuse ) noexcept
+    {
+        fuse_chains = fuse;
+    }
 
 
 protected:
@@ -158,10 +325,20 @@ protected:
     * @param name_b - name for port on kernel b
     * @param b_info - PortInfo struct for kernel b
     * @throws PortTypeMismatchException
+    * @throws PortDoubleInitializeException - if either port is already
+    *         linked and the links can't share a Type::MPMC FIFO
     */
    static void join( raft::kernel &a, const raft::port_key_type name_a, PortInfo &a_info, 
                      raft::kernel &b, const raft::port_key_type name_b, PortInfo &b_info );
    
+   /**
+    * edge_type - FIFO type the allocator will build for the
+    * link out of the output port src.
+    * @param src - PortInfo&, output port
+    * @return Type::RingBufferType
+    */
+   static Type::RingBufferType edge_type( PortInfo &src );
+
    static void insert( raft::kernel *a,  PortInfo &a_out, 
                        raft::kernel *b,  PortInfo &b_in,
                        raft::kernel *i );
@@ -229,6 +406,21 @@ protected:
         }
     }
 
+   /**
+    * loadProfile - load the profile named by setProfileInput (or
+    * RAFT_PROFILE_LOAD) if there is one and put kernels back on
+    * their cores, call once the partitioner ran and before the
+    * allocator starts.
+    */
+   void loadProfile();
+
+   /**
+    * saveProfile - write the profile named by setProfileOutput (or
+    * RAFT_PROFILE_SAVE) if any, call once the allocator is done.
+    * @param   alloc - Allocate&, knows what each edge learned
+    */
+   void saveProfile( Allocate &alloc );
+
    static void portNotFound( const bool src, 
                              const AmbiguousPortAssignmentException &ex, 
                              raft::kernel * const k );
@@ -239,6 +431,25 @@ protected:
    kernelkeeper              dst_kernels;
    /** and keep a list of all kernels **/
    kernelkeeper              all_kernels;
+   /** wait policy for FIFOs whose producer didn't set one **/
+   Wait::Policy              wait_policy = Wait::Spin;
+   /** map wide huge page FIFO storage, see setHugePages **/
+   bool                      huge_pages  = false;
+   /** map wide spill budget and directory, see setSpillBudget **/
+   Buffer::SpillConfig       spill;
+   /** see setFIFOMemoryBudget, usage is written by the allocator **/
+   std::size_t                 fifo_budget = 0;
+   std::atomic< std::size_t >  fifo_used   = { 0 };
+   std::atomic< std::size_t >  fifo_peak   = { 0 };
+   /** see setProfileInput/setProfileOutput **/
+   std::string                 profile_input;
+   std::string                 profile_output;
+   /** loaded by loadProfile, the allocator sizes FIFOs from it **/
+   Profile                     warm_profile;
+   /** see setSchedulerThreads **/
+   std::size_t                 scheduler_threads = 0;
+   /** see setFusion **/
+   bool                        fuse_chains = true;
    
 
    /**
@@ -1,5 +1,6 @@
 /**
- * meansampletype.tcc - 
+ * meansampletype.tcc - mean number of items sitting in a FIFO, one
+ * observation per frame, smoothed so recent frames count the most.
  * @author: Jonathan Beard
  * @version: Thu Aug 21 12:49:40 2014
  * 
@@ -19,40 +20,40 @@
  */
 #ifndef RAFTMEANSAMPLETYPE_TCC
 #define RAFTMEANSAMPLETYPE_TCC  1
+#include <cstdint>
 #include <string>
 
-#include "ringbuffertypes.hpp"
 #include "sampletype.tcc"
-template< class T, Type::RingBufferType type > 
-   class MeanSampleType : public SampleType< T, type >
+#include "defs.hpp"
+
+class MeanSampleType : public SampleType
 {
 public:
-MeanSampleType() : SampleType< T, type >()
-{
-
-}
-
-virtual ~MeanSampleType()
+/**
+ * MeanSampleType - 
+ * @param   weight - const double, weight of the newest frame
+ */
+MeanSampleType( const double weight = 0.25 ) : SampleType(),
+                                               weight( weight )
 {
 }
 
+virtual ~MeanSampleType() = default;
 
 virtual void
-sample( RingBufferBase< T, type > &buffer,
-        bool                      &global_blocked )
+sample( FIFO &fifo, const double frame_width )
 {
-   (this)->temp.occupancy    += buffer.size();
+   UNUSED( frame_width );
+   const auto observed( static_cast< double >( fifo.size() ) );
+   occupancy = ( frames_count == 0 ? observed :
+                                     occupancy + weight * ( observed - occupancy ) );
+   frames_count++;
 }
 
-virtual void
-accept( volatile bool &converged )
+/** mean - items in the queue, zero before the first frame **/
+double mean() const noexcept
 {
-   if( converged )
-   {
-      (this)->real += (this)->temp;
-   }
-   /** TODO, change this if I change the struct to a union **/
-   (this)->temp.occupancy        = 0;
+   return( occupancy );
 }
 
 protected:
@@ -63,35 +64,15 @@ printHeader()
 }
 
 virtual std::string
-printData( Unit unit = Unit::Byte )
+printData( raft::unit unit = raft::unit::byte )
 {
-   if( (this)->real.occupancy == 0 )
-   {
-      return( "0" );
-   }
-   return( std::to_string( 
-      (double) (this)->real.occupancy / ( (double) (this)->real.frames_count ) ) );
+   UNUSED( unit );
+   return( std::to_string( (this)->mean() ) );
 }
 
 private:
-/* I want to keep the additions to these from getting optimized out */
-/** TODO, maybe change to a union **/
-struct stats{
-   stats() : occupancy( 0 ),
-             frames_count( 0 )
-   {
-   }
-
-   stats&
-   operator += ( const stats &rhs )
-   {
-      (this)->occupancy    += rhs.occupancy;
-      (this)->frames_count += 1;
-      return( *this );
-   }
-   
-   volatile std::int64_t occupancy;
-   volatile std::int64_t frames_count;
-} real, temp;
+const double  weight;
+double        occupancy    = 0.0;
+std::uint64_t frames_count = 0;
 };
 #endif /* END RAFTMEANSAMPLETYPE_TCC */
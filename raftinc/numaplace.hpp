@@ -0,0 +1,83 @@
+/**
+ * numaplace.hpp - NUMA placement of FIFO storage. Buffers are
+ * allocated by the allocator thread, left alone every page would be
+ * faulted in on that thread's node no matter where the kernels run.
+ * The allocator instead gives each FIFO a home node, the node of the
+ * core its consumer kernel is pinned to, and the storage is bound
+ * there (preferred policy, pages already faulted in are moved) when
+ * the FIFO is built and again for every buffer a resize installs.
+ *
+ * Only whole pages inside the buffer are placed, a small buffer that
+ * shares its pages with other heap objects is left where it is. On
+ * machines (or builds) without NUMA support every call here is a
+ * no-op that reports node -1.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTNUMAPLACE_HPP
+#define RAFTNUMAPLACE_HPP  1
+#include <cstddef>
+#include "defs.hpp"
+
+namespace Placement
+{
+
+/** Info - per-FIFO placement as reported by FIFO::get_placement **/
+struct Info
+{
+    /** node the allocator picked for the storage, -1 if none **/
+    int         home_node       = -1;
+    /** node the first page of the storage is on right now, -1 if unknown **/
+    int         resident_node   = -1;
+    /** bytes of storage (current buffer) **/
+    std::size_t bytes           = 0;
+};
+
+/**
+ * node_of_core - NUMA node of a core as numbered by the OS, the
+ * topology is read once.
+ * @param   core - const core_id_t, e.g. kernel::getCoreAssignment()
+ * @return  int - node, -1 if core is unassigned or unknown
+ */
+int node_of_core( const core_id_t core ) noexcept;
+
+/**
+ * node_count - number of NUMA nodes with cpus, 0 if unknown
+ * @return  int
+ */
+int node_count() noexcept;
+
+/**
+ * place - bind the whole pages in [ addr, addr + length ) to node,
+ * pages already faulted in are migrated.
+ * @param   addr   - void*, start of the buffer
+ * @param   length - const std::size_t, bytes
+ * @param   node   - const int
+ * @return  bool - true if at least one page was bound
+ */
+bool place( void * const addr, const std::size_t length, const int node ) noexcept;
+
+/**
+ * node_of - node the page holding addr is on
+ * @param   addr - const void*
+ * @return  int - node, -1 if unknown
+ */
+int node_of( const void * const addr ) noexcept;
+
+} /** end namespace Placement **/
+#endif /* END RAFTNUMAPLACE_HPP */
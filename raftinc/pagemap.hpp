@@ -0,0 +1,72 @@
+/**
+ * pagemap.hpp - huge page backed storage for heap FIFOs. Large queues
+ * allocated with posix_memalign are faulted in 4 KiB at a time while
+ * the application runs, which shows up as first-touch stalls and TLB
+ * misses early in every run. A buffer asked for with huge_page_size
+ * alignment (the allocator does that for edges opted in through
+ * raft::fifo::huge_pages or map.setHugePages) gets its own mapping
+ * instead: explicit huge pages (MAP_HUGETLB) if the system has any
+ * reserved, else a 2 MiB aligned anonymous mapping advised for
+ * transparent huge pages. The whole mapping is faulted in up front,
+ * by the allocator before the scheduler starts, or for a resize before
+ * the buffer is installed.
+ *
+ * Mappings are rounded up to whole huge pages, so a buffer grown by
+ * the heap FIFO often still fits the mapping it already has, in that
+ * case the new buffer takes the mapping over instead of mapping (and
+ * copying to) a new one.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTPAGEMAP_HPP
+#define RAFTPAGEMAP_HPP  1
+#include <cstddef>
+
+namespace Buffer
+{
+
+/** alignment that selects a huge page mapping, and its granularity **/
+constexpr std::size_t huge_page_size = ( 1 << 21 );
+
+struct PageMap
+{
+    /** start of the mapping, nullptr if the store isn't a mapping **/
+    void        *base       = nullptr;
+    /** bytes mapped, a multiple of huge_page_size **/
+    std::size_t length      = 0;
+    /** true if backed by reserved huge pages, else THP advised **/
+    bool        hugetlb     = false;
+    /** true once every page has been touched **/
+    bool        prefaulted  = false;
+
+    /**
+     * map - new mapping of at least bytes, nothing is touched yet
+     * @param   bytes - const std::size_t
+     * @return  bool - false if no mapping could be made, base is nullptr
+     */
+    bool map( const std::size_t bytes ) noexcept;
+
+    /** prefault - fault in every page of the mapping, once **/
+    void prefault() noexcept;
+
+    /** unmap - release the mapping, base is nullptr after **/
+    void unmap() noexcept;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTPAGEMAP_HPP */
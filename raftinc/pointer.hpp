@@ -32,14 +32,17 @@ class ALIGN( L1D_CACHE_LINE_SIZE ) Pointer
     using wrap_t = std::size_t;
 
 public:
-   Pointer() : max_cap( 0 ){}
+   Pointer() : max_cap( 0 ), mask( 0 ){}
 
    /**
     * Pointer - used to synchronize read and write
     * pointers for the ring buffer.  This class encapsulates
-    * wrapping.
+    * wrapping. If cap is a power of two the pointer runs in
+    * masked mode, a is a free running 64b counter and the
+    * index is a & mask, no modulo and no wrap_a bookkeeping.
     */
-   Pointer( const std::size_t cap ) : max_cap( cap ){}
+   Pointer( const std::size_t cap ) : max_cap( cap ),
+                                      mask( is_pow2( cap ) ? cap - 1 : 0 ){}
    
    Pointer( const std::size_t cap, 
             const wrap_t wrap_set );
@@ -57,14 +60,55 @@ public:
     * val - returns the current value of val.
     * @return std::size_t, current 'true' value of the pointer
     */
-   static std::size_t val( Pointer &ptr ) ;
+   static inline std::size_t val( Pointer &ptr ) 
+   {
+#ifdef JVEC_MACHINE
+      struct{
+         std::uint64_t a;
+         std::uint64_t b;
+      }copy;
+      do{
+         copy.a = ptr.a;
+         copy.b = ptr.b;
+      }while( copy.a !=  copy.b );
+      return( ptr.mask != 0 ? copy.b & ptr.mask : copy.b );
+#else
+      const std::uint64_t copy( ptr.a );
+      return( ptr.mask != 0 ? copy & ptr.mask : copy );
+#endif
+   }
 
    /**
     * inc - increments the pointer, takes care of wrapping
     * the pointers as well so you don't run off the page
     * @return  std::size_t, current value of pointer after increment
     */
-   static void inc( Pointer &ptr ) ;
+   static inline void inc( Pointer &ptr ) 
+   {
+      if( R_LIKELY( ptr.mask != 0 ) )
+      {
+         ptr.a = ptr.a + 1;
+#ifdef JVEC_MACHINE
+         ptr.b = ptr.b + 1;
+#endif
+         return;
+      }
+#ifdef JVEC_MACHINE
+      ptr.a = ( ptr.a + 1 ) % ptr.max_cap;
+      ptr.b = ( ptr.b + 1 ) % ptr.max_cap;
+      if( ptr.b == 0 )
+      {
+         ptr.wrap_a++;
+         ptr.wrap_b++;
+      }
+#else
+      ptr.a = ( ptr.a + 1 ) % ptr.max_cap;
+      if( ptr.a == 0 )
+      {
+         ptr.wrap_a++;
+      }
+#endif
+   }
    
    /**
     * incBy - increments the current pointer poisition
@@ -74,8 +118,33 @@ public:
     * @param  in - const std::size_t
     * @return void
     */
-   static void incBy( Pointer &ptr,
-                      const std::size_t in );
+   static inline void incBy( Pointer &ptr,
+                             const std::size_t in )
+   {
+      if( R_LIKELY( ptr.mask != 0 ) )
+      {
+         ptr.a = ptr.a + in;
+#ifdef JVEC_MACHINE
+         ptr.b = ptr.b + in;
+#endif
+         return;
+      }
+#ifdef JVEC_MACHINE
+      ptr.a = ( ptr.a + in ) % ptr.max_cap;
+      ptr.b = ( ptr.b + in ) % ptr.max_cap;
+      if( ptr.b < in )
+      {
+         ptr.wrap_a++;
+         ptr.wrap_b++;
+      }
+#else
+      ptr.a = ( ptr.a + in ) % ptr.max_cap;
+      if( ptr.a < in )
+      {
+         ptr.wrap_a++;
+      }
+#endif
+   }
 
    
    /**
@@ -83,10 +152,74 @@ public:
     * the read should never be ahead of the write, and 
     * at best they should be equal.  This is used when
     * determining to return max_cap or zero for the current
-    * queue size.  
+    * queue size. In masked mode the wrap count is implicit
+    * in the counter.
     * @return  std::size_t
     */
-   static std::size_t wrapIndicator( Pointer &ptr ) ;
+   static inline std::size_t wrapIndicator( Pointer &ptr ) 
+   {
+#ifdef JVEC_MACHINE
+       struct{
+          std::uint64_t a;
+          std::uint64_t b;
+       }copy;
+       if( ptr.mask != 0 )
+       {
+          do{
+             copy.a = ptr.a;
+             copy.b = ptr.b;
+          }while( copy.a != copy.b );
+          return( copy.b / ptr.max_cap );
+       }
+       do{
+          copy.a = ptr.wrap_a;
+          copy.b = ptr.wrap_b;
+       }while( copy.a != copy.b );
+       return( copy.b );
+#else
+       if( ptr.mask != 0 )
+       {
+          return( ptr.a / ptr.max_cap );
+       }
+       return( ptr.wrap_a );
+#endif
+   }
+
+   /**
+    * masked - true if both pointers run in masked mode, in
+    * which case distance() can be used for the item count.
+    */
+   static inline bool masked( Pointer &write, Pointer &read ) noexcept
+   {
+      return( ( write.mask & read.mask ) != 0 );
+   }
+
+   /**
+    * distance - number of items between the read and write
+    * counters, only valid in masked mode. The read side is
+    * loaded first, it can only move towards the write side so
+    * the difference can't go negative. A thread that is neither
+    * reader nor writer might see more than max_cap if both move
+    * between the loads, so it is clamped.
+    * @param   write - Pointer&
+    * @param   read  - Pointer&
+    * @return  std::size_t
+    */
+   static inline std::size_t distance( Pointer &write, Pointer &read ) noexcept
+   {
+      const std::uint64_t r( *reinterpret_cast< volatile std::uint64_t* >( &read.a ) );
+      const std::uint64_t w( *reinterpret_cast< volatile std::uint64_t* >( &write.a ) );
+      const std::uint64_t d( w - r );
+      return( d > write.max_cap ? write.max_cap : static_cast< std::size_t >( d ) );
+   }
+
+   /**
+    * is_pow2 - pointer runs in masked mode for these caps
+    */
+   static constexpr bool is_pow2( const std::size_t cap ) noexcept
+   {
+      return( cap != 0 && ( cap & ( cap - 1 ) ) == 0 );
+   }
    
 private:
      std::uint64_t           a  = 0;
@@ -107,5 +240,7 @@ private:
      wrap_t    wrap_b  = 0;
 #endif    
     const    std::size_t      max_cap;
+    /** max_cap - 1 if max_cap is a power of two, else zero **/
+    const    std::uint64_t    mask;
 };
 #endif /* END RAFTPOINTER_HPP */
@@ -37,6 +37,7 @@ using aligned_t = std::uint64_t;
 #endif
 #include "schedule.hpp"
 #include "internaldefs.hpp"
+#include "threadcache.hpp"
 
 namespace raft{
    class kernel;
@@ -97,11 +98,12 @@ protected:
        raft::kernel *k         = nullptr;
        bool          finished  = false;
        core_id_t     loc       = -1;
+       raft::latch  *done      = nullptr;
 #pragma pack( pop )       
     };
     std::mutex                  thread_data_mutex;
     std::vector< thread_data* > thread_data_pool;
-    std::mutex                  tail_mutex;
-    std::vector< thread_data* > tail;
+    /** one count per kernel still running **/
+    raft::latch                 running;
 };
 #endif /* END RAFTPOOLSSCHEDULE_HPP */
@@ -51,6 +51,8 @@ namespace raft
    class map;
    class kernel;
    class parallel_k;
+   class shm_endpoint;
+   class socket_endpoint;
    template < class T, class method > class join;
    template < class T, class method > class split;
 }
@@ -178,6 +180,7 @@ public:
                       inc + ( index == (n_ports - 1) ? adder : 0 ),
                       start_index );
          pi.my_kernel = kernel;
+         pi.item_size = sizeof( T );
          /**
           * To change to "any" efficient name type for 
           * RaftLib, we need to make a generic function to 
@@ -306,6 +309,7 @@ public:
        */
       PortInfo pi( typeid( T ) );
       pi.my_kernel = kernel;
+      pi.item_size = sizeof( T );
       
       pi.my_name   = 
 #ifdef STRING_NAMES
@@ -374,10 +378,41 @@ protected:
          std::make_pair( true /** yes instrumentation **/,
                          RingBuffer< T, Type::Heap, true >::make_new_fifo ) );
 
-      //pi.const_map.insert( std::make_pair( Type::SharedMemory, new instr_map_t() ) );
-      //pi.const_map[ Type::SharedMemory ]->insert(
-      //   std::make_pair( false /** no instrumentation **/,
-      //                   RingBuffer< T, Type::SharedMemory >::make_new_fifo ) );
+      pi.const_map.insert(
+         std::make_pair( Type::LockFreeSPSC, std::make_shared< instr_map_t >() ) );
+      pi.const_map[ Type::LockFreeSPSC ]->insert(
+         std::make_pair( false /** no instrumentation **/,
+                         RingBuffer< T, Type::LockFreeSPSC, false >::make_new_fifo ) );
+
+      pi.const_map.insert(
+         std::make_pair( Type::Segmented, std::make_shared< instr_map_t >() ) );
+      pi.const_map[ Type::Segmented ]->insert(
+         std::make_pair( false /** no instrumentation **/,
+                         RingBuffer< T, Type::Segmented, false >::make_new_fifo ) );
+
+      pi.const_map.insert(
+         std::make_pair( Type::Infinite, std::make_shared< instr_map_t >() ) );
+      pi.const_map[ Type::Infinite ]->insert(
+         std::make_pair( false /** no instrumentation **/,
+                         RingBuffer< T, Type::Infinite, false >::make_new_fifo ) );
+
+      pi.const_map.insert(
+         std::make_pair( Type::MPMC, std::make_shared< instr_map_t >() ) );
+      pi.const_map[ Type::MPMC ]->insert(
+         std::make_pair( false /** no instrumentation **/,
+                         RingBuffer< T, Type::MPMC, false >::make_new_fifo ) );
+
+      pi.const_map.insert(
+         std::make_pair( Type::SharedMemory, std::make_shared< instr_map_t >() ) );
+      pi.const_map[ Type::SharedMemory ]->insert(
+         std::make_pair( false /** no instrumentation **/,
+                         RingBuffer< T, Type::SharedMemory, false >::make_new_fifo ) );
+
+      pi.const_map.insert(
+         std::make_pair( Type::TCP, std::make_shared< instr_map_t >() ) );
+      pi.const_map[ Type::TCP ]->insert(
+         std::make_pair( false /** no instrumentation **/,
+                         RingBuffer< T, Type::TCP, false >::make_new_fifo ) );
       /**
        * NOTE: If you define more port resource types, they have
        * to be defined here...otherwise the allocator won't be
@@ -468,6 +503,8 @@ protected:
    friend class GraphTools;
    friend class basic_parallel;
    friend class raft::parallel_k;
+   friend class raft::shm_endpoint;
+   friend class raft::socket_endpoint;
 };
 
 
@@ -25,8 +25,11 @@
 #include <map>
 #include <functional>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <cassert>
+#include <utility>
+#include <vector>
 
 #include "alloc_defs.hpp"
 #include "ringbuffertypes.hpp"
@@ -103,6 +106,15 @@ struct PortInfo
    
    raft::kernel     *other_kernel    = nullptr;
    raft::port_key_type       other_name      = raft::null_port_value;
+
+   /**
+    * fan_out - output ports only, destinations linked after the
+    * first one (other_kernel/other_name), they all share one
+    * Type::MPMC FIFO. Fan-in needs nothing extra, each producer's
+    * port points at the consumer, which keeps its first producer.
+    */
+   std::vector< std::pair< raft::kernel*,
+                           raft::port_key_type > > fan_out;
    
    /** runtime settings **/
    bool              use_my_allocator= false;
@@ -112,5 +124,34 @@ struct PortInfo
    std::size_t       nitems          = 0;
    std::size_t       start_index     = 0;
    std::size_t       fixed_buffer_size = 0;   
+   /** sizeof the port's type, new FIFOs are sized in bytes from it **/
+   std::size_t       item_size       = 0;
+   /** 
+    * fused - producer and consumer run on one thread, set on
+    * both ends by raft::fusion::mark, the FIFO is never resized.
+    */
+   bool              fused           = false;
+   /** 
+    * FIFO type for this link, set from the source side via 
+    * MapBase::link, Type::N means use the producer kernel's
+    * buffer type (see raft::fifo::type manipulator).
+    */
+   Type::RingBufferType fifo_type   = Type::N;
+
+   /**
+    * shm_key - set on the port of a raft::shm_out/raft::shm_in
+    * kernel, the edge to it becomes the local end of a
+    * Type::SharedMemory FIFO to/from another process.
+    */
+   std::string          shm_key     = "";
+
+   /**
+    * socket_address/socket_channel - set on the port of a
+    * raft::socket_out/raft::socket_in kernel, the edge to it
+    * becomes the local end of a Type::TCP FIFO to/from another
+    * process, multiplexed on the link to socket_address.
+    */
+   std::string          socket_address = "";
+   std::uint32_t        socket_channel = 0;
 };
 #endif /* END RAFTPORT_INFO_HPP */
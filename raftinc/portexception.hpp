@@ -99,4 +99,12 @@ using PortAlreadyExists
 using PortUnconnectedException
     = PortExceptionBase< 7 >;
 
+/**
+ * SharedPortAccessException - an access pattern a port sharing its
+ * FIFO with other producer or consumer ports (Type::MPMC) can't
+ * support, e.g., growing a peek that another consumer cut short.
+ */
+using SharedPortAccessException
+    = PortExceptionBase< 8 >;
+
 #endif
@@ -0,0 +1,136 @@
+/**
+ * profile.hpp - what a run of a map learned about its edges and
+ * kernels, saved at the end of exe() and loaded by a later run of
+ * the same map to start from there: FIFOs are built at the capacity
+ * the dynamic allocator settled on instead of INITIAL_ALLOC_SIZE and
+ * kernels go back to the cores they ran on. Set with
+ * MapBase::setProfileOutput/setProfileInput or the RAFT_PROFILE_SAVE
+ * and RAFT_PROFILE_LOAD environment variables.
+ *
+ * Kernels are named by class and, for several of one class, by the
+ * order they were constructed in (e.g., "sum#1"), edges by the
+ * kernels and port names on both ends, so a profile carries over to
+ * any run that builds the same graph. The file is text, one tab
+ * separated record per line:
+ *
+ *   kernel <name> <core>
+ *   edge   <src> <src port> <dst> <dst port> <capacity> <arrival> <service>
+ *
+ * capacity in items, arrival and service rates in items per second
+ * (0 if not measured).
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTPROFILE_HPP
+#define RAFTPROFILE_HPP  1
+#include <cstddef>
+#include <map>
+#include <string>
+#include "defs.hpp"
+#include "kernelkeeper.tcc"
+
+namespace raft
+{
+    class kernel;
+}
+
+struct PortInfo;
+
+class Profile
+{
+public:
+    /** what's kept per edge **/
+    struct Edge
+    {
+        /** items **/
+        std::size_t capacity = 0;
+        /** items per second **/
+        double      arrival  = 0.0;
+        double      service  = 0.0;
+    };
+
+    Profile() = default;
+
+    /**
+     * load - read a saved profile, replaces what's here.
+     * @param   path - const std::string&
+     * @return  bool - false if it can't be read, e.g., the first run
+     */
+    bool load( const std::string &path );
+
+    /**
+     * save - write the profile out.
+     * @param   path - const std::string&
+     * @return  bool - false if it can't be written
+     */
+    bool save( const std::string &path ) const;
+
+    /**
+     * bind - name the kernels of a map, needed before any of the
+     * calls below.
+     * @param   kernels - kernelkeeper&, every kernel of the map
+     */
+    void bind( kernelkeeper &kernels );
+
+    /**
+     * capacity - what the edge from a to b settled on last time.
+     * @param   a - PortInfo&, src
+     * @param   b - PortInfo&, dst
+     * @return  std::size_t - items, 0 if the edge isn't known
+     */
+    std::size_t capacity( PortInfo &a, PortInfo &b ) const;
+
+    /**
+     * set_edge - record the edge from a to b.
+     * @param   a    - PortInfo&, src
+     * @param   b    - PortInfo&, dst
+     * @param   edge - const Edge&
+     */
+    void set_edge( PortInfo &a, PortInfo &b, const Edge &edge );
+
+    /**
+     * record_cores - keep the core each bound kernel is assigned.
+     * @param   kernels - kernelkeeper&
+     */
+    void record_cores( kernelkeeper &kernels );
+
+    /**
+     * apply_cores - assign kernels the cores they had last time,
+     * kernels the profile doesn't know or that weren't pinned keep
+     * what they have.
+     * @param   kernels - kernelkeeper&
+     */
+    void apply_cores( kernelkeeper &kernels ) const;
+
+    /** true if nothing was loaded or recorded **/
+    bool empty() const noexcept
+    {
+        return( edges.empty() && cores.empty() );
+    }
+
+private:
+    /** name - class and instance, empty if not bound **/
+    std::string name( raft::kernel * const k ) const;
+
+    std::string key( PortInfo &a, PortInfo &b ) const;
+
+    std::map< raft::kernel*, std::string >  names;
+    std::map< std::string, Edge >           edges;
+    std::map< std::string, core_id_t >      cores;
+};
+
+#endif /* END RAFTPROFILE_HPP */
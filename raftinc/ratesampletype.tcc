@@ -1,5 +1,10 @@
 /**
- * ratesampletype.tcc - 
+ * ratesampletype.tcc - items per second through one end of a FIFO,
+ * smoothed over the frames it accepts. A frame where that end waited
+ * on the other (producer on a full queue, consumer on an empty one)
+ * measures the other end, not this one. Those frames aren't folded
+ * in, the rate seen during the last of them is kept as a lower bound
+ * instead.
  * @author: Jonathan Beard
  * @version: Sat Aug 23 16:56:48 2014
  * 
@@ -19,83 +24,115 @@
  */
 #ifndef RAFTRATESAMPLETYPE_TCC
 #define RAFTRATESAMPLETYPE_TCC  1
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <string>
-#include "ringbufferbase.tcc"
-#include "ringbuffertypes.hpp"
+#include "sampletype.tcc"
 
-#if __MMX__ == 1
-typedef std::int64_t _v2di __attribute__((vector_size (16)));
-#endif 
-
-template < class T, Type::RingBufferType type > class RateSampleType : 
-   public SampleType< T, type >
+class RateSampleType : public SampleType
 {
 public:
-RateSampleType() : SampleType< T, type >()
+/**
+ * RateSampleType - 
+ * @param   item_size - const std::size_t, bytes per item, only used
+ *                      to print the rate in bytes
+ * @param   weight    - const double, weight of the newest frame in
+ *                      the smoothed rate
+ */
+RateSampleType( const std::size_t item_size = 1,
+                const double      weight    = 0.25 ) : SampleType(),
+                                                       item_size( item_size ),
+                                                       weight( weight )
 {
 }
 
-virtual ~RateSampleType()
-{
+virtual ~RateSampleType() = default;
 
-}
-
-protected:
 /**
- * print_data - basic virtual function that can be used for service
- * and arrival rate functions.  
+ * rate - smoothed items per second over the accepted frames,
+ * zero before the first one.
+ * @return double
  */
-virtual std::string
-printData( Unit unit = Unit::Byte )
+double rate() const noexcept
 {
-   return( 
-   std::to_string(  
-      ( (double) (this)->real.items_copied * (double) sizeof( T ) *  
-         unit_conversion[ unit ] ) / 
-            ( (double) (this)->real.frame_count * (double) (this)->frame_width )
-   )
-   );
+   return( smoothed );
 }
 
-/** stats struct for rates type samples **/
-struct stats
+/**
+ * estimate - best guess at the rate right now, the smoothed rate
+ * unless the last frame was censored and saw more than that.
+ * @return double
+ */
+double estimate() const noexcept
 {
-   stats() : items_copied( 0 ),
-             frame_count( 0 )
-   {
-   }
-   
-   stats( const std::int64_t frame_init ) : 
-             items_copied( 0 ),
-             frame_count( frame_init )
+   if( censored )
    {
+      return( std::max( smoothed, bound ) );
    }
+   return( smoothed );
+}
+
+/** valid - true once a frame has been accepted **/
+bool valid() const noexcept
+{
+   return( frames > 0 );
+}
+
+/** blocked - true if the last frame was censored **/
+bool blocked() const noexcept
+{
+   return( censored );
+}
 
-   stats&
-   operator += (const stats &rhs )
+protected:
+/**
+ * accept - fold a frame into the smoothed rate.
+ * @param   items       - const std::uint64_t, items in the frame
+ * @param   frame_width - const double, seconds
+ */
+void accept( const std::uint64_t items, const double frame_width )
+{
+   censored = false;
+   if( frame_width <= 0.0 )
    {
-#if __MMX__ == 1
-      (this)->all += rhs.all;
-#else
-      (this)->items_copied += rhs.items_copied;
-      (this)->frame_count  += 1;
-#endif
-      return( *this );
+      return;
    }
+   const auto observed( static_cast< double >( items ) / frame_width );
+   smoothed = ( frames == 0 ? observed :
+                              smoothed + weight * ( observed - smoothed ) );
+   frames++;
+}
 
-#if __MMX__ == 1
-   union
-   {
-#endif   
-      struct
-      {
-         std::int64_t items_copied;
-         std::int64_t frame_count;
-      };
-#if __MMX__ == 1
-      _v2di all;
-   };
-#endif
-} real, temp = { 1 };
+/**
+ * reject - the frame only bounds the rate from below, keep it
+ * as that until the next frame.
+ * @param   items       - const std::uint64_t, items in the frame
+ * @param   frame_width - const double, seconds
+ */
+void reject( const std::uint64_t items, const double frame_width )
+{
+   censored = true;
+   bound    = ( frame_width > 0.0 ?
+                static_cast< double >( items ) / frame_width : 0.0 );
+}
+
+/**
+ * printData - rate in the given unit per second.
+ */
+virtual std::string
+printData( raft::unit unit = raft::unit::byte )
+{
+   return( std::to_string( smoothed * static_cast< double >( item_size ) *
+                           raft::unit_conversion[ unit ] ) );
+}
+
+private:
+const std::size_t item_size;
+const double      weight;
+double            smoothed = 0.0;
+double            bound    = 0.0;
+std::uint64_t     frames   = 0;
+bool              censored = false;
 };
 #endif /* END RAFTRATESAMPLETYPE_TCC */
@@ -0,0 +1,203 @@
+/**
+ * readyset.hpp - which of a kernel's input ports have data, kept up
+ * to date by the FIFOs instead of asking every port before every
+ * run. A FIFO sets its port's bit when items become visible, the
+ * kernel's thread clears the bits of ports it emptied after each run
+ * (only those with the bit set are checked). Whether the kernel can
+ * run is then a check of a few words, whatever its port count.
+ *
+ * Setting a bit that was clear notifies the kernel's doorbell and
+ * the scheduler's listener, e.g., to put a parked kernel back on a
+ * run queue. Invalidating a FIFO (or anything else its consumer has
+ * to look at without data being there) pokes the set instead.
+ *
+ * The producer doesn't fence between publishing and checking the
+ * bit, so a bit cleared at the same moment can hide a push. Users
+ * must fall back to asking the ports now and then, the doorbell's
+ * timeout does that for thread per kernel schedulers.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTREADYSET_HPP
+#define RAFTREADYSET_HPP  1
+#include <array>
+#include <atomic>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "defs.hpp"
+#include "internaldefs.hpp"
+#include "doorbell.hpp"
+
+class FIFO;
+
+namespace raft
+{
+
+class kernel;
+
+class ready_set
+{
+public:
+   /** kernels with more input ports are polled port by port **/
+   static constexpr std::size_t max_ports = 256;
+
+   /** listener - called on the producer's thread, keep it short **/
+   using listener_t = void (*)( void *arg );
+
+   ready_set() = default;
+
+   ready_set( const ready_set &other ) = delete;
+   ready_set& operator = ( const ready_set &other ) = delete;
+
+   /**
+    * set - producer side, port bit has items.
+    * @param   bit - const std::size_t, from bind()
+    */
+   inline void set( const std::size_t bit ) noexcept
+   {
+      auto &w( words[ bit >> 6 ] );
+      const auto m( std::uint64_t( 1 ) << ( bit & 63 ) );
+      if( R_LIKELY( ( w.load( std::memory_order_relaxed ) & m ) != 0 ) )
+      {
+         return;
+      }
+      if( ( w.fetch_or( m, std::memory_order_seq_cst ) & m ) == 0 )
+      {
+         notify();
+      }
+   }
+
+   /** poke - the consumer has to look at its ports, no data needed **/
+   inline void poke() noexcept
+   {
+      poked.store( true, std::memory_order_seq_cst );
+      notify();
+   }
+
+   /**
+    * bind - give every input port of k a bit, call on the
+    * kernel's thread before the first runnable() and again
+    * whenever stale() says ports were added.
+    * @param   k - raft::kernel*
+    */
+   void bind( raft::kernel * const k );
+
+   /**
+    * sync - set the bit of every port that has items, for
+    * when a bit was lost to the race described up top.
+    */
+   void sync();
+
+   /** stale - k has a different number of input ports than bound **/
+   bool stale( raft::kernel * const k );
+
+   /** tracked - false with more than max_ports inputs **/
+   bool tracked() const noexcept
+   {
+      return( ports <= max_ports );
+   }
+
+   /**
+    * runnable - enough ports have data for the kernel's
+    * scheduling behavior (any_port or all_port).
+    * @param   behavior - raft::schedule_behavior
+    */
+   inline bool runnable( const raft::schedule_behavior behavior ) const noexcept
+   {
+      if( behavior == raft::any_port )
+      {
+         for( std::size_t i( 0 ); i < used_words; i++ )
+         {
+            if( words[ i ].load( std::memory_order_acquire ) != 0 )
+            {
+               return( true );
+            }
+         }
+         return( false );
+      }
+      std::size_t n( 0 );
+      for( std::size_t i( 0 ); i < used_words; i++ )
+      {
+         n += std::bitset< 64 >(
+            words[ i ].load( std::memory_order_acquire ) ).count();
+      }
+      return( n == ports );
+   }
+
+   /** was_poked - consumer side, clears the poke **/
+   inline bool was_poked() noexcept
+   {
+      return( poked.load( std::memory_order_relaxed ) &&
+              poked.exchange( false, std::memory_order_acq_rel ) );
+   }
+
+   inline bool poke_pending() const noexcept
+   {
+      return( poked.load( std::memory_order_acquire ) );
+   }
+
+   /**
+    * refresh - consumer side after a run, clear the bits
+    * of ports that are empty now. Only ports whose bit is
+    * set are asked.
+    */
+   void refresh();
+
+   void set_doorbell( Buffer::Doorbell * const b ) noexcept
+   {
+      bell = b;
+   }
+
+   /**
+    * set_listener - called whenever a clear bit is set or
+    * the set is poked, set before bind().
+    */
+   void set_listener( const listener_t l, void * const arg ) noexcept
+   {
+      listener     = l;
+      listener_arg = arg;
+   }
+
+private:
+   inline void notify() noexcept
+   {
+      if( bell != nullptr )
+      {
+         bell->ring();
+      }
+      if( listener != nullptr )
+      {
+         listener( listener_arg );
+      }
+   }
+
+   std::array< std::atomic< std::uint64_t >, max_ports / 64 >  words = {};
+   std::atomic< bool >   poked        = { false };
+   /** consumer only from here down **/
+   std::size_t           ports        = 0;
+   std::size_t           used_words   = 0;
+   std::vector< FIFO* >  fifos;
+   Buffer::Doorbell     *bell         = nullptr;
+   listener_t            listener     = nullptr;
+   void                 *listener_arg = nullptr;
+};
+
+} /** end namespace raft **/
+#endif /* END RAFTREADYSET_HPP */
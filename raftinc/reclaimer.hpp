@@ -0,0 +1,124 @@
+/**
+ * reclaimer.hpp - per kernel thread bookkeeping for out-of-line
+ * (ext_alloc) items. The consumer side of a FIFO retires an item on
+ * recycle instead of freeing it right away: the kernel may have
+ * peeked it and pushed it on to an output, zero copy, in which case
+ * the item now belongs to the next FIFO and must not be freed here.
+ * Peek references are only valid within a kernel run, so the
+ * scheduler closes an epoch after one or more runs (end_epoch), at
+ * that point no peek from the epoch can still point at an item and
+ * everything retired in it that wasn't forwarded is freed.
+ *
+ * All of it is flat vectors that keep their capacity across epochs,
+ * after the first few runs retiring/peeking/forwarding is a store
+ * into already allocated memory, no nodes, no std::function.
+ *
+ * One per kernel thread, every FIFO of the kernel shares it, they
+ * are accessed sequentially by that thread so nothing is atomic.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTRECLAIMER_HPP
+#define RAFTRECLAIMER_HPP  1
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Buffer
+{
+
+class Reclaimer
+{
+public:
+    /** frees one retired item, set by the FIFO that retired it **/
+    using reclaim_func_t = void (*)( void * );
+
+    Reclaimer();
+    /** frees whatever the last epoch left behind **/
+    ~Reclaimer();
+
+    Reclaimer( const Reclaimer &other ) = delete;
+    Reclaimer& operator = ( const Reclaimer &other ) = delete;
+
+    /** retire - consumer recycled ptr, free with func at epoch end **/
+    inline void retire( void * const ptr, const reclaim_func_t func )
+    {
+        retired.push_back( { ptr, func } );
+    }
+
+    /** peeked - the kernel holds a peek reference to ptr **/
+    inline void peeked( const void * const ptr )
+    {
+        peeks.push_back( ptr );
+    }
+
+    /**
+     * was_peeked - true if ptr was peeked in this epoch, i.e. it
+     * is an item living in one of our input FIFOs. Newest first,
+     * the item being pushed on is almost always the last peeked.
+     * @param   ptr - const void*
+     * @return  bool
+     */
+    inline bool was_peeked( const void * const ptr ) const noexcept
+    {
+        for( auto it( peeks.crbegin() ); it != peeks.crend(); ++it )
+        {
+            if( *it == ptr )
+            {
+                return( true );
+            }
+        }
+        return( false );
+    }
+
+    /** forwarded - ptr now lives in an output FIFO, don't free it **/
+    inline void forwarded( const void * const ptr )
+    {
+        kept.push_back( ptr );
+    }
+
+    /**
+     * end_epoch - no peek reference of this epoch is live anymore,
+     * free every retired item that wasn't forwarded and start over.
+     */
+    void end_epoch();
+
+    /** epoch - number of epochs closed so far **/
+    std::uint64_t epoch() const noexcept
+    {
+        return( current );
+    }
+
+private:
+    struct retired_t
+    {
+        void           *ptr;
+        reclaim_func_t  reclaim;
+    };
+
+    /** enough for a handful of runs without reallocating **/
+    static constexpr std::size_t initial_capacity = 64;
+
+    std::vector< retired_t >    retired;
+    std::vector< const void* >  peeks;
+    std::vector< const void* >  kept;
+    std::uint64_t               current = 0;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTRECLAIMER_HPP */
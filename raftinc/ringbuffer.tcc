@@ -27,6 +27,7 @@
 #include <cstring>
 #include <fstream>
 #include <iostream>
+#include <memory>
 #include <thread>
 #include <utility>
 #include <vector>
@@ -123,8 +124,8 @@ public:
     {
         if((this)->datamanager.is_resizeable())
         {
-            (this)->datamanager.resize(
-                new Buffer::Data<T, type>(size, align), exit_alloc);
+            (this)->resize_buffer(
+                (this)->datamanager.make(size, align, true), exit_alloc);
         }
         /** else, not resizeable..just return **/
         return;
@@ -186,8 +187,8 @@ public:
     {
         if((this)->datamanager.is_resizeable())
         {
-            (this)->datamanager.resize(
-                new Buffer::Data<T, type>(size, align), exit_alloc);
+            (this)->resize_buffer(
+                (this)->datamanager.make(size, align, true), exit_alloc);
         }
         /** else, not resizeable..just return **/
         return;
@@ -226,103 +227,259 @@ public:
     }
 };
 
-/** specialization for dummy one **/
+/**
+ * Infinite, segmented FIFO that only blocks the producer once the
+ * disk is full, cold segments spill to a file, see
+ * ringbufferinfinite.tcc
+ */
 template <class T>
-class RingBuffer<T, Type::Infinite, true /* monitor */>
-    : public RingBufferBaseMonitor<T, Type::Infinite>
+class RingBuffer< T, Type::Infinite, false >
+    : public RingBufferBase< T, Type::Infinite >
 {
 public:
+    RingBuffer( const std::size_t n,
+                const std::size_t align = 16,
+                const Buffer::SpillConfig &config = Buffer::SpillConfig() )
+        : RingBufferBase< T, Type::Infinite >()
+    {
+        assert( n != 0 );
+        (this)->start( n, align, config );
+    }
+
+    /** segments are owned and freed by the base **/
+    virtual ~RingBuffer() = default;
+
     /**
-     * RingBuffer - default constructor, initializes basic
-     * data structures.
+     * make_new_fifo - builder function to dynamically
+     * allocate FIFO's at the time of execution. The
+     * data ptr points to the Buffer::SpillConfig for
+     * the map, nullptr for the defaults.
+     * @param   n_items - std::size_t
+     * @param   align   - memory alignment
+     * @return  FIFO*
      */
-    RingBuffer( const std::size_t n, 
+    static FIFO* make_new_fifo( const std::size_t n_items,
+                                const std::size_t align,
+                                void * const data )
+    {
+        if( data == nullptr )
+        {
+            return( new RingBuffer< T, Type::Infinite, false >( n_items, align ) );
+        }
+        return( new RingBuffer< T, Type::Infinite, false >(
+            n_items,
+            align,
+            *reinterpret_cast< Buffer::SpillConfig* >( data ) ) );
+    }
+};
+
+
+/**
+ * LockFreeSPSC, heap storage with lock-free indices, see
+ * ringbufferspsc.tcc
+ */
+template <class T>
+class RingBuffer< T, Type::LockFreeSPSC, false >
+    : public RingBufferBase< T, Type::LockFreeSPSC >
+{
+public:
+    RingBuffer( const std::size_t n,
                 const std::size_t align = 16 )
-        : RingBufferBaseMonitor<T, Type::Infinite>(1, align)
+        : RingBufferBase< T, Type::LockFreeSPSC >()
     {
-        UNUSED( n );
+        assert( n != 0 );
+        (this)->set_buffer( new Buffer::Data< T, Type::Heap >( n, align ) );
     }
 
-    virtual ~RingBuffer() = default;
+    virtual ~RingBuffer()
+    {
+        delete((this)->datamanager.get());
+    }
 
-    static FIFO* make_new_fifo( const std::size_t n_items, 
-                                const std::size_t align, 
-                                void const * data )
+    /**
+     * make_new_fifo - builder function to dynamically
+     * allocate FIFO's at the time of execution. FIFOs
+     * built over an existing buffer aren't resizeable
+     * and keep their start offset, so those are simply
+     * built as heap FIFOs.
+     * @param   n_items - std::size_t
+     * @param   align   - memory alignment
+     * @return  FIFO*
+     */
+    static FIFO* make_new_fifo( const std::size_t n_items,
+                                const std::size_t align,
+                                void * const data )
     {
-        UNUSED( data );
-        assert(data == nullptr);
-        return (new RingBuffer<T, Type::Infinite, true>(n_items, align));
+        if( data != nullptr )
+        {
+            return( RingBuffer< T, Type::Heap, false >::make_new_fifo( n_items,
+                                                                      align,
+                                                                      data ) );
+        }
+        return( new RingBuffer< T, Type::LockFreeSPSC, false >( n_items, align ) );
+    }
+
+    virtual void resize( const std::size_t size,
+                         const std::size_t align,
+                         volatile bool& exit_alloc )
+    {
+        if( (this)->datamanager.is_resizeable() )
+        {
+            (this)->quiescent_resize(
+                (this)->datamanager.make( size, align, false ), exit_alloc );
+        }
+        /** else, not resizeable..just return **/
+        return;
     }
 };
 
-/** specialization for dummy with no instrumentation **/
+
+
+/**
+ * Segmented, lock-free indices over a chain of heap segments,
+ * grows without copying, see ringbuffersegmented.tcc
+ */
 template <class T>
-class RingBuffer< T, Type::Infinite, false >
-    : public RingBufferBase< T, Type::Infinite >
+class RingBuffer< T, Type::Segmented, false >
+    : public RingBufferBase< T, Type::Segmented >
 {
 public:
+    RingBuffer( const std::size_t n,
+                const std::size_t align = 16 )
+        : RingBufferBase< T, Type::Segmented >()
+    {
+        assert( n != 0 );
+        (this)->set_buffer( new Buffer::Data< T, Type::Heap >( n, align ) );
+    }
+
+    /** segments are owned and freed by the base **/
+    virtual ~RingBuffer() = default;
+
     /**
-     * RingBuffer - default constructor, initializes basic
-     * data structures.
+     * make_new_fifo - builder function to dynamically
+     * allocate FIFO's at the time of execution. FIFOs
+     * built over an existing buffer can't grow, those
+     * are simply built as heap FIFOs.
+     * @param   n_items - std::size_t
+     * @param   align   - memory alignment
+     * @return  FIFO*
      */
-    RingBuffer( const std::size_t n, 
-                const std::size_t align = 16)
-        : RingBufferBase<T, Type::Infinite>()
+    static FIFO* make_new_fifo( const std::size_t n_items,
+                                const std::size_t align,
+                                void * const data )
     {
-        UNUSED( n );
-        (this)->datamanager.set(new Buffer::Data<T, Type::Heap>( 1, align ));
+        if( data != nullptr )
+        {
+            return( RingBuffer< T, Type::Heap, false >::make_new_fifo( n_items,
+                                                                      align,
+                                                                      data ) );
+        }
+        return( new RingBuffer< T, Type::Segmented, false >( n_items, align ) );
     }
 
-    virtual ~RingBuffer()
+    /**
+     * resize - doesn't wait on either side, the new segment
+     * is picked up by the producer on its next access.
+     */
+    virtual void resize( const std::size_t size,
+                         const std::size_t align,
+                         volatile bool& exit_alloc )
     {
-        delete((this)->datamanager.get());
+        (this)->grow( (this)->datamanager.make( size, align, false ), exit_alloc );
+        return;
+    }
+};
+
+
+
+/**
+ * MPMC, heap storage shared by several producer and/or consumer
+ * ports, see ringbuffermpmc.tcc
+ */
+template <class T>
+class RingBuffer< T, Type::MPMC, false >
+    : public RingBufferBase< T, Type::MPMC >
+{
+public:
+    RingBuffer( const std::size_t n,
+                const std::size_t align = 16 )
+        : RingBufferBase< T, Type::MPMC >()
+    {
+        assert( n != 0 );
+        (this)->set_buffer( new Buffer::Data< T, Type::Heap >( n, align ) );
     }
 
+    /**
+     * RingBuffer - another view of the queue q, built by share()
+     * for the extra producer or consumer port.
+     */
+    RingBuffer( const std::shared_ptr< Buffer::MPMCQueue< T > > &q,
+                const Direction side )
+        : RingBufferBase< T, Type::MPMC >()
+    {
+        (this)->set_queue( q, side );
+    }
+
+    /** the buffer is owned by the queue, or the base for ext_alloc **/
+    virtual ~RingBuffer() = default;
+
     /**
      * make_new_fifo - builder function to dynamically
-     * allocate FIFO's at the time of execution.  The
-     * first two parameters are self explanatory.  The
-     * data ptr is a data struct that is dependent on the
-     * type of FIFO being built.  In there really is no
-     * data necessary so it is expacted to be set to nullptr
+     * allocate FIFO's at the time of execution. FIFOs
+     * built over an existing buffer can't be shared,
+     * those are simply built as heap FIFOs.
      * @param   n_items - std::size_t
      * @param   align   - memory alignment
      * @return  FIFO*
      */
-    static FIFO* make_new_fifo( const std::size_t n_items, 
-                                const std::size_t align, 
+    static FIFO* make_new_fifo( const std::size_t n_items,
+                                const std::size_t align,
                                 void * const data )
     {
-        assert(data == nullptr);
-        UNUSED( data );
-        return (new RingBuffer<T, Type::Infinite, false>(n_items, align));
+        if( data != nullptr )
+        {
+            return( RingBuffer< T, Type::Heap, false >::make_new_fifo( n_items,
+                                                                      align,
+                                                                      data ) );
+        }
+        return( new RingBuffer< T, Type::MPMC, false >( n_items, align ) );
     }
 
-    virtual void resize(
-        const std::size_t size, 
-        const std::size_t align, 
-        bool& exit_alloc)
+    /**
+     * resize - capacity is fixed, every view points at the
+     * same buffer and any of them could be mid access.
+     */
+    virtual void resize( const std::size_t size,
+                         const std::size_t align,
+                         volatile bool& exit_alloc )
     {
         UNUSED( size );
         UNUSED( align );
         UNUSED( exit_alloc );
-
-        /** should never really be calling this function **/
-        assert(false);
+        return;
     }
-
 };
 
 
 
 /**
- * SharedMemory
+ * SharedMemory, one end of a FIFO between two processes, see
+ * ringbuffershm.tcc
  */
 template <class T>
 class RingBuffer< T, Type::SharedMemory, false >
     : public RingBufferBase< T, Type::SharedMemory >
 {
 public:
+    /**
+     * RingBuffer - the producer creates the segment for nitems,
+     * the consumer waits for the producer's and takes its size.
+     * @param   nitems - std::size_t
+     * @param   key    - const std::string, same for both ends
+     * @param   dir    - Direction, end held by this process
+     * @param   alignment - std::size_t, the store is always cache
+     *                      line aligned, ignored
+     */
     RingBuffer( const std::size_t nitems, 
                 const std::string key, 
                 const Direction   dir,
@@ -331,36 +488,25 @@ public:
                                       Type::SharedMemory >() ,
                       shm_key( key )
     {
-        //TODO this needs to be an shm::open
-        //TODO once open, needs to be an in-place allocate for
-        //the first object to get the open, otherwise..use cookie
-        //technique...all sub-keys will follow main key
-        (this)->datamanager.set( 
-            new Buffer::Data< T, Type::SharedMemory >( nitems, 
-                                                       key, 
-                                                       dir, 
-                                                       alignment )
-        );
+        UNUSED( alignment );
+        assert( nitems != 0 );
+        (this)->attach( new Buffer::SHMSegment( key,
+                                                dir,
+                                                sizeof( T ),
+                                                Buffer::round_capacity( nitems ) ),
+                        dir );
     }
 
-    virtual ~RingBuffer()
-    {
-        delete((this)->datamanager.get());
-    }
+    virtual ~RingBuffer() = default;
 
-    struct Data
-    {
-        const std::string key;
-        Direction dir;
-    };
+    using Data = Buffer::SHMSegment::endpoint_t;
 
     /**
      * make_new_fifo - builder function to dynamically
      * allocate FIFO's at the time of execution.  The
      * first two parameters are self explanatory.  The
-     * data ptr is a data struct that is dependent on the
-     * type of FIFO being built.  In there really is no
-     * data necessary so it is expacted to be set to nullptr
+     * data ptr points to a RingBuffer::Data struct with
+     * the key and the end of the queue to build.
      * @param   n_items - std::size_t
      * @param   align   - memory alignment
      * @return  FIFO*
@@ -369,16 +515,16 @@ public:
                                 const std::size_t align, 
                                 void * const data )
     {
-        auto * const data_ptr(reinterpret_cast<Data*>(data) );
-        return( new RingBuffer< T, 
-                                Type::SharedMemory, 
-                                false>( n_items, 
-                                        data_ptr->key, 
-                                        data_ptr->dir, 
-                                        align )
-        );
+        assert( data != nullptr );
+        return( build( n_items, 
+                       align, 
+                       *reinterpret_cast< Data* >( data ) ) );
     }
 
+    /**
+     * resize - capacity is fixed, the other process has the
+     * segment mapped.
+     */
     virtual void resize( const std::size_t size, 
                          const std::size_t align,
                          volatile bool& exit_alloc )
@@ -386,59 +532,112 @@ public:
         UNUSED( size );
         UNUSED( align );
         UNUSED( exit_alloc );
-        assert(false);
-        /** TODO, implement me **/
         return;
     }
 
 
 protected:
+    template < class U = T >
+    static typename std::enable_if< shm_alloc< U >::value, FIFO* >::type
+    build( const std::size_t n_items, 
+           const std::size_t align, 
+           const Data &data )
+    {
+        return( new RingBuffer< T, 
+                                Type::SharedMemory, 
+                                false>( n_items, 
+                                        data.key, 
+                                        data.dir, 
+                                        align ) );
+    }
+
+    template < class U = T >
+    static typename std::enable_if< ! shm_alloc< U >::value, FIFO* >::type
+    build( const std::size_t n_items, 
+           const std::size_t align, 
+           const Data &data )
+    {
+        UNUSED( n_items );
+        UNUSED( align );
+        std::cerr << "shared memory FIFO \"" << data.key << "\": type "
+            << "can't be copied between processes (must be trivially "
+            << "copyable and fit in a cache line), exiting!\n";
+        exit( EXIT_FAILURE );
+        return( nullptr );
+    }
+
     const std::string shm_key;
 };
 
 
-#if 0
 /**
- * TCP w/ multiplexing
+ * TCP, one end of a FIFO between two processes over a stream
+ * socket (AF_UNIX or TCP), several FIFOs share a connection, see
+ * ringbuffertcp.tcc and socketlink.hpp
  */
 template <class T>
-class RingBuffer<T, Type::TCP, false /* no monitoring yet */>
-    : public RingBufferBase<T, Type::Heap>
+class RingBuffer< T, Type::TCP, false /* no monitoring yet */ >
+    : public RingBufferBase< T, Type::TCP >
 {
 public:
+    /**
+     * RingBuffer - builds the local ring and registers it as
+     * channel with the link to address, the link is shared with
+     * every other FIFO going to the same address the same way.
+     * @param   nitems  - std::size_t
+     * @param   address - const std::string, "unix:/path" or "tcp:host:port"
+     * @param   channel - std::uint32_t, same on both ends
+     * @param   dir     - Direction, end held by this process
+     * @param   alignment - std::size_t
+     */
     RingBuffer( const std::size_t   nitems, 
-                const std::string   dns_name,
+                const std::string   address,
+                const std::uint32_t channel,
                 const Direction     dir, 
                 const std::size_t   alignment = 16 ) 
-                    : RingBufferBase<T, Type::Heap>()
+                    : RingBufferBase< T, Type::TCP >(),
+                      channel( channel )
     {
-        // TODO, fill in stuff here, perhaps from original....
+        assert( nitems != 0 );
+        (this)->set_buffer( new Buffer::Data< T, Type::Heap >( nitems, alignment ) );
+        link = Buffer::SocketLink::get( address, dir );
+        link->add( channel, this );
     }
 
-    virtual ~RingBuffer() = default;
-
-    struct Data
+    /** sending side waits here till the channel is drained **/
+    virtual ~RingBuffer()
     {
-        Direction dir;
-        std::string dns_name;
-    };
+        link->remove( channel );
+        link.reset();
+        delete( (this)->datamanager.get() );
+    }
 
+    using Data = Buffer::SocketLink::endpoint_t;
+
+    /**
+     * make_new_fifo - builder function to dynamically
+     * allocate FIFO's at the time of execution.  The
+     * data ptr points to a RingBuffer::Data struct with
+     * the address, channel and the end of the queue to
+     * build.
+     * @param   n_items - std::size_t
+     * @param   align   - memory alignment
+     * @return  FIFO*
+     */
     static FIFO* make_new_fifo( const std::size_t n, 
                                 const std::size_t align, 
                                 void * const data )
     {
-        auto * const  cast_data( reinterpret_cast< RingBuffer< T, 
-                                                               Type::TCP, 
-                                                               false >::Data* >(data) );
-
-        return( new RingBuffer< T, 
-                                Type::TCP, 
-                                false >( n /** n_items **/, 
-                                         cast_data->dns_name, 
-                                         cast_data->dir, 
-                                         align ) );
+        assert( data != nullptr );
+        return( build( n, 
+                       align, 
+                       *reinterpret_cast< Data* >( data ) ) );
     }
 
+    /**
+     * resize - capacity is fixed, the link thread holds
+     * the other end of the ring.
+     */
     virtual void resize(    const std::size_t size, 
                             const std::size_t align,
                             volatile bool& exit_alloc)
@@ -446,14 +645,43 @@ public:
         UNUSED( size );
         UNUSED( align );
         UNUSED( exit_alloc );
-        assert(false);
-        /** TODO implement me **/
         return;
     }
 
 
 protected:
+    template < class U = T >
+    static typename std::enable_if< shm_alloc< U >::value, FIFO* >::type
+    build( const std::size_t n_items, 
+           const std::size_t align, 
+           const Data &data )
+    {
+        return( new RingBuffer< T, 
+                                Type::TCP, 
+                                false >( n_items, 
+                                         data.address, 
+                                         data.channel,
+                                         data.dir, 
+                                         align ) );
+    }
+
+    template < class U = T >
+    static typename std::enable_if< ! shm_alloc< U >::value, FIFO* >::type
+    build( const std::size_t n_items, 
+           const std::size_t align, 
+           const Data &data )
+    {
+        UNUSED( n_items );
+        UNUSED( align );
+        std::cerr << "socket FIFO \"" << data.address << "\": type "
+            << "can't be sent as raw bytes (must be trivially "
+            << "copyable and fit in a cache line), exiting!\n";
+        exit( EXIT_FAILURE );
+        return( nullptr );
+    }
+
+    const std::uint32_t                    channel;
+    std::shared_ptr< Buffer::SocketLink >  link;
 };
-#endif //TCP 
 
 #endif /* END RAFTRINGBUFFER_TCC */
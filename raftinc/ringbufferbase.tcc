@@ -63,8 +63,16 @@ protected:
 
 /** implementation that uses malloc/jemalloc/tcmalloc **/
 #include "ringbufferheap.tcc"
+/** heap storage, lock-free single producer/single consumer indices **/
+#include "ringbufferspsc.tcc"
+/** lock-free indices, grows by chaining heap segments **/
+#include "ringbuffersegmented.tcc"
+/** heap storage, several producer and/or consumer ports per queue **/
+#include "ringbuffermpmc.tcc"
 /** heap implementation, uses thread shared memory or SHM **/
 #include "ringbuffershm.tcc"
+/** lock-free SPSC ring per end, stream socket between processes **/
+#include "ringbuffertcp.tcc"
 /** infinite dummy implementation, can use shared memory or SHM **/
 #include "ringbufferinfinite.tcc"
 
@@ -25,6 +25,7 @@
 #include "defs.hpp"
 #include "alloc_traits.tcc"
 #include "prefetch.hpp"
+#include "slabpool.tcc"
 #include "defs.hpp"
 /** for yield **/
 #include "sysschedutil.hpp"
@@ -71,11 +72,13 @@ public:
       }
       /** should be the end of the write, regardless of which allocate called **/
       auto * const buff_ptr( (this)->datamanager.get() );
-      const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-      buff_ptr->signal[ write_index ] = signal;
+      (this)->signals.send( (this)->producer_data.position, signal );
       (this)->producer_data.write_stats->bec.count++;
       (this)->producer_data.allocate_called = false;
       Pointer::inc( buff_ptr->write_pt );
+      (this)->waiter.produced();
+      (this)->producer_data.cached_space--;
+      (this)->producer_data.position++;
       (this)->datamanager.exitBuffer( dm::allocate );
    }
 
@@ -92,12 +95,14 @@ public:
         return;
       }
       /** should be the end of the write, regardless of which allocate called **/
-      const size_t write_index( Pointer::val( (this)->datamanager.get()->write_pt ) );
-      (this)->datamanager.get()->signal[ write_index ] = signal;
+      (this)->signals.send( (this)->producer_data.position, signal );
       /* only need to inc one more **/
       auto &n_allocated( (this)->producer_data.n_allocated );
       Pointer::incBy( (this)->datamanager.get()->write_pt,
                       n_allocated );
+      (this)->waiter.produced();
+      (this)->producer_data.cached_space -= n_allocated;
+      (this)->producer_data.position += n_allocated;
       (this)->producer_data.write_stats->bec.count += n_allocated;
       (this)->producer_data.allocate_called = false;
       n_allocated     = 0;
@@ -130,7 +135,7 @@ protected:
             (this)->datamanager.enterBuffer( dm::recycle );
             if( (this)->datamanager.notResizing() )
             {
-               if( (this)->size() > 0 )
+               if( (this)->consumer_items( 1 ) )
                {
                   break;
                }
@@ -141,14 +146,18 @@ protected:
                }
             }
             (this)->datamanager.exitBuffer( dm::recycle );
-            raft::yield();
+            (this)->waiter.consumer_block();
          }
          auto * const buff_ptr( (this)->datamanager.get() );
          /**
           * TODO, this whole func can be optimized a bit more
           * using the incBy func of Pointer
           */
+         (this)->signals.pop( (this)->consumer_data.position );
          Pointer::inc( buff_ptr->read_pt );
+         (this)->waiter.consumed();
+         (this)->consumer_data.cached_items--;
+         (this)->consumer_data.position++;
          (this)->datamanager.exitBuffer( dm::recycle );
       }while( --range > 0 );
       return;
@@ -168,7 +177,7 @@ protected:
       for(;;)
       {
          (this)->datamanager.enterBuffer( dm::allocate );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() > 0  )
+         if( (this)->datamanager.notResizing() && (this)->producer_space( 1 )  )
          {
             break;
          }
@@ -179,14 +188,7 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
@@ -200,7 +202,7 @@ protected:
       for( ;; )
       {
          (this)->datamanager.enterBuffer( dm::allocate_range );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() >= n )
+         if( (this)->datamanager.notResizing() && (this)->producer_space( n ) )
          {
             break;
          }
@@ -221,14 +223,7 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-       __asm__ volatile("\
-         pause"
-         :
-         :
-         : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto *container(
          reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
@@ -246,8 +241,10 @@ protected:
           * not here
           */
          container->emplace_back( buff_ptr->store[ write_index ] );
-         buff_ptr->signal[ write_index ] = raft::none;
-         write_index = ( write_index + 1 ) % buff_ptr->max_cap;
+         if( ++write_index == buff_ptr->max_cap )
+         {
+            write_index = 0;
+         }
       }
       (this)->producer_data.n_allocated = 
         static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
@@ -274,7 +271,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::push );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->space_avail() > 0 )
+            if( (this)->producer_space( 1 ) )
             {
                break;
             }
@@ -286,14 +283,7 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
        const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
@@ -303,11 +293,14 @@ protected:
           buff_ptr->store[ write_index ]          = *item;
           (this)->producer_data.write_stats->bec.count++;
        }
-      buff_ptr->signal[ write_index ]         = signal;
+      (this)->signals.send( (this)->producer_data.position, signal );
 #if defined(__aarch64__)
       asm volatile( "dmb ishst" : : : "memory" ); /** memory write barrier **/
 #endif
        Pointer::inc( buff_ptr->write_pt );
+       (this)->waiter.produced();
+       (this)->producer_data.cached_space--;
+       (this)->producer_data.position++;
 #if 0       
       if( signal == raft::quit )
       {
@@ -332,7 +325,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::pop );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() > 0 )
+            if( (this)->consumer_items( 1 ) )
             {
                break;
             }
@@ -352,13 +345,15 @@ protected:
                rd_stats  = 1;
             }
          }
-         raft::yield();
+         (this)->waiter.consumer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const std::size_t read_index( Pointer::val( buff_ptr->read_pt ) );
+      /** always consume the entry, even if the caller doesn't want it **/
+      const auto sig( (this)->signals.pop( (this)->consumer_data.position ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = sig;
       }
       assert( ptr != nullptr );
       /** gotta dereference pointer and copy **/
@@ -367,6 +362,9 @@ protected:
       /** only increment here b/c we're actually reading an item **/
       (this)->consumer_data.read_stats->bec.count++;
       Pointer::inc( buff_ptr->read_pt );
+      (this)->waiter.consumed();
+      (this)->consumer_data.cached_items--;
+      (this)->consumer_data.position++;
       (this)->datamanager.exitBuffer( dm::pop );
    }
 
@@ -386,7 +384,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::peek );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() > 0  )
+            if( (this)->consumer_items( 1 ) )
             {
                break;
             }
@@ -397,20 +395,13 @@ protected:
             }
          }
          (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.consumer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const auto read_index( Pointer::val( buff_ptr->read_pt ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = (this)->signals.peek( (this)->consumer_data.position );
       }
       *ptr = reinterpret_cast< void* >( &( buff_ptr->store[ read_index ] ) );
       return;
@@ -432,7 +423,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::peek );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() >= n  )
+            if( (this)->consumer_items( n ) )
             {
                break;
             }
@@ -447,14 +438,7 @@ protected:
             }
          }
          (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-          raft::yield();
+          (this)->waiter.consumer_block();
       }
 
       /**
@@ -465,7 +449,8 @@ protected:
       auto * const buff_ptr( (this)->datamanager.get() );
       const std::size_t cpl( Pointer::val( buff_ptr->read_pt ) );
       curr_pointer_loc = cpl;
-      *sig =  reinterpret_cast< void* >(  &buff_ptr->signal[ cpl ] );
+      *sig =  reinterpret_cast< void* >( (this)->range_signals( 
+                                          (this)->consumer_data.position, n ) );
       *ptr =  buff_ptr->store;
       return;
    }
@@ -515,11 +500,13 @@ public:
         }
         /** should be the end of the write, regardless of which allocate called **/
         auto * const buff_ptr( (this)->datamanager.get() );
-        const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-        buff_ptr->signal[ write_index ] = signal;
+        (this)->signals.send( (this)->producer_data.position, signal );
         (this)->producer_data.write_stats->bec.count++;
         (this)->producer_data.allocate_called = false;
         Pointer::inc( buff_ptr->write_pt );
+        (this)->waiter.produced();
+        (this)->producer_data.cached_space--;
+        (this)->producer_data.position++;
         (this)->datamanager.exitBuffer( dm::allocate );
     }
 
@@ -537,12 +524,14 @@ public:
         }
         auto * const buff_ptr( (this)->datamanager.get() );
         /** should be the end of the write, regardless of which allocate called **/
-        const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-        buff_ptr->signal[ write_index ] = signal;
+        (this)->signals.send( (this)->producer_data.position, signal );
         /* only need to inc one more, the rest have already**/
         auto &n_allocated( (this)->producer_data.n_allocated );
         Pointer::incBy( buff_ptr->write_pt,
                         n_allocated );
+        (this)->waiter.produced();
+        (this)->producer_data.cached_space -= n_allocated;
+        (this)->producer_data.position += n_allocated;
         
         (this)->producer_data.write_stats->bec.count += n_allocated;
         /** cleanup **/
@@ -576,7 +565,7 @@ protected:
             (this)->datamanager.enterBuffer( dm::recycle );
             if( (this)->datamanager.notResizing() )
             {
-               if( (this)->size() > 0 )
+               if( (this)->consumer_items( 1 ) )
                {
                   break;
                }
@@ -587,7 +576,7 @@ protected:
                }
             }
             (this)->datamanager.exitBuffer( dm::recycle );
-            raft::yield();
+            (this)->waiter.consumer_block();
          }
          auto * const buff_ptr( (this)->datamanager.get() );
          const size_t read_index( Pointer::val( buff_ptr->read_pt ) );
@@ -595,7 +584,11 @@ protected:
             reinterpret_cast< T* >( &( buff_ptr->store[ read_index ] ) );
          /** call destructor direct, faster than recyle func **/
          ptr->~T();
+         (this)->signals.pop( (this)->consumer_data.position );
          Pointer::inc( buff_ptr->read_pt );
+         (this)->waiter.consumed();
+         (this)->consumer_data.cached_items--;
+         (this)->consumer_data.position++;
          (this)->datamanager.exitBuffer( dm::recycle );
       }while( --range > 0 );
       return;
@@ -615,7 +608,7 @@ protected:
       for(;;)
       {
          (this)->datamanager.enterBuffer( dm::allocate );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() > 0  )
+         if( (this)->datamanager.notResizing() && (this)->producer_space( 1 )  )
          {
             break;
          }
@@ -626,14 +619,7 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
@@ -647,7 +633,7 @@ protected:
       for( ;; )
       {
          (this)->datamanager.enterBuffer( dm::allocate_range );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() >= n )
+         if( (this)->datamanager.notResizing() && (this)->producer_space( n ) )
          {
             break;
          }
@@ -658,14 +644,7 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-       __asm__ volatile("\
-         pause"
-         :
-         :
-         : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto *container(
          reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
@@ -683,8 +662,10 @@ protected:
           * not here
           */
          container->emplace_back( buff_ptr->store[ write_index ] );
-         buff_ptr->signal[ write_index ] = raft::none;
-         write_index = ( write_index + 1 ) % buff_ptr->max_cap;
+         if( ++write_index == buff_ptr->max_cap )
+         {
+            write_index = 0;
+         }
       }
       (this)->producer_data.n_allocated = 
         static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
@@ -705,13 +686,24 @@ protected:
     * @param   signal, const raft::signal&
     */
    virtual void  local_push( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, false );
+   }
+
+   /** local_push_move - as local_push, the item is moved in **/
+   virtual void  local_push_move( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, true );
+   }
+
+   void push_item( void *ptr, const raft::signal &signal, const bool move )
    {
       for(;;)
       {
          (this)->datamanager.enterBuffer( dm::push );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->space_avail() > 0 )
+            if( (this)->producer_space( 1 ) )
             {
                break;
             }
@@ -723,30 +715,31 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
        const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
       if( ptr != nullptr )
       {
           T *item( reinterpret_cast< T* >( ptr ) );
-          new (
-            &buff_ptr->store[ write_index ]
-          ) T( *item  );
+          if( move )
+          {
+             new ( &buff_ptr->store[ write_index ] ) T( std::move( *item ) );
+          }
+          else
+          {
+             new ( &buff_ptr->store[ write_index ] ) T( *item );
+          }
           (this)->producer_data.write_stats->bec.count++;
        }
-      buff_ptr->signal[ write_index ]         = signal;
+      (this)->signals.send( (this)->producer_data.position, signal );
 #if defined(__aarch64__)
       asm volatile( "dmb ishst" : : : "memory" ); /** memory write barrier **/
 #endif
        Pointer::inc( buff_ptr->write_pt );
+       (this)->waiter.produced();
+       (this)->producer_data.cached_space--;
+       (this)->producer_data.position++;
       (this)->datamanager.exitBuffer( dm::push );
    }
 
@@ -765,7 +758,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::pop );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() > 0 )
+            if( (this)->consumer_items( 1 ) )
             {
                break;
             }
@@ -785,18 +778,20 @@ protected:
                rd_stats  = 1;
             }
          }
-         raft::yield();
+         (this)->waiter.consumer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const std::size_t read_index( Pointer::val( buff_ptr->read_pt ) );
+      /** always consume the entry, even if the caller doesn't want it **/
+      const auto sig( (this)->signals.pop( (this)->consumer_data.position ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = sig;
       }
       assert( ptr != nullptr );
-      /** gotta dereference pointer and copy **/
+      /** slot is destroyed right after, move out of it **/
       T *item( reinterpret_cast< T* >( ptr ) );
-      *item = buff_ptr->store[ read_index ];
+      *item = std::move( buff_ptr->store[ read_index ] );
       /** 
        * we know the object is inline constructed, 
        * we should inline destruct it to fix bug
@@ -807,6 +802,9 @@ protected:
       /** only increment here b/c we're actually reading an item **/
       (this)->consumer_data.read_stats->bec.count++;
       Pointer::inc( buff_ptr->read_pt );
+      (this)->waiter.consumed();
+      (this)->consumer_data.cached_items--;
+      (this)->consumer_data.position++;
       (this)->datamanager.exitBuffer( dm::pop );
    }
 
@@ -826,7 +824,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::peek );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() > 0  )
+            if( (this)->consumer_items( 1 ) )
             {
                break;
             }
@@ -837,20 +835,13 @@ protected:
             }
          }
          (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.consumer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const size_t read_index( Pointer::val( buff_ptr->read_pt ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = (this)->signals.peek( (this)->consumer_data.position );
       }
       *ptr = (void*) &( buff_ptr->store[ read_index ] );
       return;
@@ -872,7 +863,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::peek );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() >= n  )
+            if( (this)->consumer_items( n ) )
             {
                break;
             }
@@ -887,14 +878,7 @@ protected:
             }
          }
          (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.consumer_block();
       }
 
       /**
@@ -905,7 +889,8 @@ protected:
       auto * const buff_ptr( (this)->datamanager.get() );
       const auto cpl( Pointer::val( buff_ptr->read_pt ) );
       curr_pointer_loc = cpl;
-      *sig =  reinterpret_cast< void* >(  &buff_ptr->signal[ cpl ] );
+      *sig =  reinterpret_cast< void* >( (this)->range_signals( 
+                                          (this)->consumer_data.position, n ) );
       *ptr =  buff_ptr->store;
       return;
    }
@@ -937,13 +922,12 @@ public:
       auto *ptr(
         reinterpret_cast< T* >( buff_ptr->store[ write_index ] )
       );
-      /** call local delete on obj **/
       /** 
        * bugfix for issue #37, memory leak, copy paste
        * error resulted in destructor being called, but
        * no deallocate. - jcb 15 July 2017
        */
-      delete( ptr );
+      pool_t::destroy( ptr );
       (this)->producer_data.allocate_called = false;
       (this)->datamanager.exitBuffer( dm::allocate );
    }
@@ -962,11 +946,13 @@ public:
       }
       /** should be the end of the write, regardless of which allocate called **/
       auto * const buff_ptr( (this)->datamanager.get() );
-      const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-      buff_ptr->signal[ write_index ] = signal;
+      (this)->signals.send( (this)->producer_data.position, signal );
       (this)->producer_data.write_stats->bec.count++;
       (this)->producer_data.allocate_called = false;
       Pointer::inc( buff_ptr->write_pt );
+      (this)->waiter.produced();
+      (this)->producer_data.cached_space--;
+      (this)->producer_data.position++;
       (this)->datamanager.exitBuffer( dm::allocate );
    }
 
@@ -980,11 +966,13 @@ public:
    {
       if( ! (this)->producer_data.allocate_called ) return;
       /** should be the end of the write, regardless of which allocate called **/
-      const size_t write_index( Pointer::val( (this)->datamanager.get()->write_pt ) );
-      (this)->datamanager.get()->signal[ write_index ] = signal;
+      (this)->signals.send( (this)->producer_data.position, signal );
       auto &n_allocated( (this)->producer_data.n_allocated );
       Pointer::incBy( (this)->datamanager.get()->write_pt,
                       n_allocated );
+      (this)->waiter.produced();
+      (this)->producer_data.cached_space -= n_allocated;
+      (this)->producer_data.position += n_allocated;
       /** cleanup **/
       (this)->producer_data.write_stats->bec.count += n_allocated;
       (this)->producer_data.allocate_called = false;
@@ -1017,7 +1005,7 @@ protected:
             (this)->datamanager.enterBuffer( dm::recycle );
             if( (this)->datamanager.notResizing() )
             {
-               if( (this)->size() > 0 )
+               if( (this)->consumer_items( 1 ) )
                {
                   break;
                }
@@ -1028,7 +1016,7 @@ protected:
                }
             }
             (this)->datamanager.exitBuffer( dm::recycle );
-            raft::yield();
+            (this)->waiter.consumer_block();
          }
          auto * const buff_ptr( (this)->datamanager.get() );
          const size_t read_index( Pointer::val( buff_ptr->read_pt ) );
@@ -1036,21 +1024,17 @@ protected:
          auto **ptr( reinterpret_cast< void** >( &( buff_ptr->store[ read_index ] ) )
          );
 
-         (this)->consumer_data.in->insert(
-            std::make_pair( reinterpret_cast< std::uintptr_t >( *ptr ),
+         (this)->consumer_data.reclaim->retire( *ptr,
                             []( void * ptr )
                             {
-                                auto *actual_ptr(
-                                    reinterpret_cast< T* >( ptr )
-                                );
-                                /** 
-                                 * bugfix for issue #37, memory leak, copy paste
-                                 * error resulted in destructor being called, but
-                                 * no deallocate. - jcb 15 July 2017
-                                 */
-                                delete( actual_ptr );
-                            } ) );
+                                /** back to whichever pool it came from **/
+                                pool_t::destroy( reinterpret_cast< T* >( ptr ) );
+                            } );
+         (this)->signals.pop( (this)->consumer_data.position );
          Pointer::inc( buff_ptr->read_pt );
+         (this)->waiter.consumed();
+         (this)->consumer_data.cached_items--;
+         (this)->consumer_data.position++;
          (this)->datamanager.exitBuffer( dm::recycle );
       }while( --range > 0 );
       return;
@@ -1070,7 +1054,7 @@ protected:
       for(;;)
       {
          (this)->datamanager.enterBuffer( dm::allocate );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() > 0  )
+         if( (this)->datamanager.notResizing() && (this)->producer_space( 1 )  )
          {
             break;
          }
@@ -1081,17 +1065,12 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
+      /** caller constructs the item in place, see FIFO::allocate **/
+      buff_ptr->store[ write_index ] = reinterpret_cast< T* >( pool.get() );
       *ptr = (void*)&( buff_ptr->store[ write_index ] );
       (this)->producer_data.allocate_called = true;
       /** call exitBuffer during push call **/
@@ -1102,7 +1081,7 @@ protected:
       for( ;; )
       {
          (this)->datamanager.enterBuffer( dm::allocate_range );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() >= n )
+         if( (this)->datamanager.notResizing() && (this)->producer_space( n ) )
          {
             break;
          }
@@ -1116,14 +1095,7 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-       __asm__ volatile("\
-         pause"
-         :
-         :
-         : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto *container(
          reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
@@ -1142,8 +1114,10 @@ protected:
           */
          container->emplace_back(
             *reinterpret_cast< T* >( buff_ptr->store[ write_index ] ) );
-         buff_ptr->signal[ write_index ] = raft::none;
-         write_index = ( write_index + 1 ) % buff_ptr->max_cap;
+         if( ++write_index == buff_ptr->max_cap )
+         {
+            write_index = 0;
+         }
       }
       (this)->producer_data.allocate_called = true;
       /** exitBuffer() called by push_range **/
@@ -1162,13 +1136,24 @@ protected:
     * @param   signal, const raft::signal&
     */
    virtual void  local_push( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, false );
+   }
+
+   /** local_push_move - as local_push, the item is moved in **/
+   virtual void  local_push_move( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, true );
+   }
+
+   void push_item( void *ptr, const raft::signal &signal, const bool move )
    {
       for(;;)
       {
          (this)->datamanager.enterBuffer( dm::push );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->space_avail() > 0 )
+            if( (this)->producer_space( 1 ) )
             {
                break;
             }
@@ -1179,14 +1164,7 @@ protected:
          {
             wr_stats = 1;
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.producer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
        const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
@@ -1196,25 +1174,30 @@ protected:
          T *item( reinterpret_cast< T* >( ptr ) );
          auto **b_ptr( reinterpret_cast< T** >( &buff_ptr->store[ write_index ] ) );
 
-         if( (this)->producer_data.out_peek->find(
-            reinterpret_cast< std::uintptr_t >( item ) ) != 
-                (this)->producer_data.out_peek->cend() )
+         if( (this)->producer_data.reclaim->was_peeked( item ) )
          {
             //this was from a previous peek call
-            (this)->producer_data.out->insert( reinterpret_cast< std::uintptr_t >( item ) );
+            (this)->producer_data.reclaim->forwarded( item );
             *b_ptr = item;
          }
-         else /** hope we have a move/copy constructor **/
+         else if( move )
          {
-            *b_ptr = new T( *item );
+            *b_ptr = new ( pool.get() ) T( std::move( *item ) );
+         }
+         else /** hope we have a copy constructor **/
+         {
+            *b_ptr = new ( pool.get() ) T( *item );
          }
          (this)->producer_data.write_stats->bec.count++;
        }
-      buff_ptr->signal[ write_index ]         = signal;
+      (this)->signals.send( (this)->producer_data.position, signal );
 #if defined(__aarch64__)
       asm volatile( "dmb ishst" : : : "memory" ); /** memory write barrier **/
 #endif
        Pointer::inc( buff_ptr->write_pt );
+       (this)->waiter.produced();
+       (this)->producer_data.cached_space--;
+       (this)->producer_data.position++;
 #if 0       
       if( signal == raft::quit )
       {
@@ -1239,7 +1222,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::pop );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() > 0 )
+            if( (this)->consumer_items( 1 ) )
             {
                break;
             }
@@ -1258,27 +1241,32 @@ protected:
             {
                rd_stats  = 1;
             }
-            raft::yield();
+            (this)->waiter.consumer_block();
          }
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const std::size_t read_index( Pointer::val( buff_ptr->read_pt ) );
+      /** always consume the entry, even if the caller doesn't want it **/
+      const auto sig( (this)->signals.pop( (this)->consumer_data.position ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = sig;
       }
       assert( ptr != nullptr );
-      /** gotta dereference pointer and copy **/
+      /** object goes back to the pool right after, move out of it **/
       T *item( reinterpret_cast< T* >( ptr ) );
       auto *head( reinterpret_cast< T* >( buff_ptr->store[ read_index ] ) );
-      *item = *head;
+      *item = std::move( *head );
       /** only increment here b/c we're actually reading an item **/
       (this)->consumer_data.read_stats->bec.count++;
       Pointer::inc( buff_ptr->read_pt );
+      (this)->waiter.consumed();
+      (this)->consumer_data.cached_items--;
+      (this)->consumer_data.position++;
       /**
        * fix for bug #76 - jcb 18Nov2018
        */
-      head->~T();
+      pool_t::destroy( head );
       (this)->datamanager.exitBuffer( dm::pop );
    }
 
@@ -1298,7 +1286,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::peek );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() > 0  )
+            if( (this)->consumer_items( 1 ) )
             {
                break;
             }
@@ -1309,20 +1297,13 @@ protected:
             }
          }
          (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.consumer_block();
       }
       auto * const buff_ptr( (this)->datamanager.get() );
       const size_t read_index( Pointer::val( buff_ptr->read_pt ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = (this)->signals.peek( (this)->consumer_data.position );
       }
       //actual pointer
       auto ***real_ptr( reinterpret_cast< T*** >( ptr ) );
@@ -1335,7 +1316,7 @@ protected:
                       sizeof( T ) < sizeof( std::uintptr_t ) << 7 ?
                       sizeof( T ) : sizeof( std::uintptr_t ) << 7
                       >( **real_ptr );
-      (this)->consumer_data.in_peek->insert( reinterpret_cast< ptr_t >( **real_ptr ) );
+      (this)->consumer_data.reclaim->peeked( **real_ptr );
       return;
       /**
        * exitBuffer() called when recycle is called, can't be sure the
@@ -1355,7 +1336,7 @@ protected:
          (this)->datamanager.enterBuffer( dm::peek );
          if( (this)->datamanager.notResizing() )
          {
-            if( (this)->size() >= n  )
+            if( (this)->consumer_items( n ) )
             {
                break;
             }
@@ -1372,14 +1353,7 @@ protected:
             }
          }
          (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         (this)->waiter.consumer_block();
       }
 
       /**
@@ -1390,12 +1364,18 @@ protected:
       auto * const buff_ptr( (this)->datamanager.get() );
       const auto cpl( Pointer::val( buff_ptr->read_pt ) );
       curr_pointer_loc = cpl;
-      *sig =  reinterpret_cast< void* >(  &buff_ptr->signal[ cpl ] );
+      *sig =  reinterpret_cast< void* >( (this)->range_signals( 
+                                          (this)->consumer_data.position, n ) );
       *ptr =  buff_ptr->store;
       return;
    }
 
-
+   using pool_t = Buffer::SlabPool< T >;
+   /**
+    * items live in slots of this pool instead of on the heap,
+    * outlives resizes since it belongs to the FIFO, not the buffer
+    */
+   pool_t pool;
 };
 
 #endif /* END RAFTRINGBUFFERHEAP_TCC */
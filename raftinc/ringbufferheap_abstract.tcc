@@ -20,6 +20,7 @@
 #ifndef RAFTRINGBUFFERHEAP_ABSTRACT_TCC
 #define RAFTRINGBUFFERHEAP_ABSTRACT_TCC  1
 
+#include <algorithm>
 #include "portexception.hpp"
 #include "defs.hpp"
 #include "sysschedutil.hpp"
@@ -50,6 +51,15 @@ public:
          if( (this)->datamanager.notResizing() )
          {
             auto * const buff_ptr( (this)->datamanager.get() );
+            if( R_LIKELY( Pointer::masked( buff_ptr->write_pt,
+                                           buff_ptr->read_pt ) ) )
+            {
+               /** power of two capacity, counters never wrap **/
+               const auto count( Pointer::distance( buff_ptr->write_pt,
+                                                    buff_ptr->read_pt ) );
+               (this)->datamanager.exitBuffer( dm::size );
+               return( count );
+            }
 TOP:      
             const auto   wrap_write( Pointer::wrapIndicator( buff_ptr->write_pt  ) ),
                          wrap_read(  Pointer::wrapIndicator( buff_ptr->read_pt   ) );
@@ -115,6 +125,8 @@ TOP:
    {
       auto * const ptr( (this)->datamanager.get() );
       ptr->is_valid = false;
+      /** a parked consumer would only notice on its next timeout **/
+      (this)->waiter.wake_all();
       return;
    }
    
@@ -211,34 +223,188 @@ TOP:
 
 protected:
    /**
-    * setPtrMap
+    * resize_buffer - install new_buffer through the data manager,
+    * the producer's cached free space counts slots of the old
+    * buffer (too many of them after a shrink) so it is dropped
+    * while both sides are still locked out. Either side may have
+    * parked while it was locked out, nobody else wakes them.
+    * @param   new_buffer - Buffer::Data< T, Type::Heap >*
+    * @param   exit_alloc - set by the allocator when the app is done
     */
-   virtual void setPtrMap( ptr_map_t * const in )
+   void resize_buffer( Buffer::Data< T, Type::Heap > * const new_buffer,
+                       volatile bool &exit_alloc )
    {
-       assert( in != nullptr );
-       (this)->consumer_data.in = in;
+      (this)->datamanager.resize( new_buffer, exit_alloc, [ this ]() noexcept
+      {
+         (this)->producer_data.cached_space = 0;
+      } );
+      (this)->waiter.wake_all();
    }
 
+   /**
+    * producer_space - producer side check for n free slots,
+    * uses the cached lower bound and only re-reads the
+    * read pointer (via space_avail) if that isn't enough.
+    * @param   n - std::size_t, slots needed
+    * @return  bool - true if there is room for n items
+    */
+   inline bool producer_space( const std::size_t n )
+   {
+      auto &cached( (this)->producer_data.cached_space );
+      if( R_LIKELY( cached >= n ) )
+      {
+         return( true );
+      }
+      cached = (this)->space_avail();
+      return( cached >= n );
+   }
 
    /**
-    * setPtrSet
+    * consumer_items - consumer side version of the above,
+    * only re-reads the write pointer (via size) once the
+    * cached item count is used up.
+    * @param   n - std::size_t, items needed
+    * @return  bool - true if at least n items can be read
     */
-   virtual void setPtrSet( ptr_set_t * const out )
+   inline bool consumer_items( const std::size_t n )
    {
-       assert( out != nullptr );
-       (this)->producer_data.out = out;
+      auto &cached( (this)->consumer_data.cached_items );
+      if( R_LIKELY( cached >= n ) )
+      {
+         return( true );
+      }
+      cached = (this)->size();
+      return( cached >= n );
    }
 
-   virtual void setInPeekSet( ptr_set_t * const peekset )
+   /**
+    * range_signals - signals for the next n items to be read,
+    * expanded from the signal channel into consumer owned
+    * scratch space for peek_range. Entry zero also carries 
+    * the start index of the underlying buffer.
+    * @param   pos - std::uint64_t, position of the first item
+    * @param   n   - std::size_t, items peeked
+    * @return  Buffer::Signal*, valid until the next call
+    */
+   Buffer::Signal* range_signals( const std::uint64_t pos, 
+                                  const std::size_t n )
    {
-       assert( peekset != nullptr );
-       (this)->consumer_data.in_peek = peekset;
+      auto &scratch( (this)->consumer_data.range_signals );
+      if( scratch.size() < n || scratch.empty() )
+      {
+         scratch.resize( std::max( n, std::size_t( 1 ) ) );
+      }
+      /** 
+       * only reset what the last call tagged, keeps the common
+       * signal-free peek_range from being O(n) in the width
+       */
+      auto &dirty( (this)->consumer_data.range_dirty );
+      for( std::size_t i( 0 ); i < dirty; i++ )
+      {
+         scratch[ i ] = raft::none;
+      }
+      dirty = (this)->signals.fill( pos, n, scratch.data() );
+      scratch[ 0 ].index = (this)->datamanager.get()->start_index;
+      return( scratch.data() );
    }
-   
-   virtual void setOutPeekSet( ptr_set_t * const peekset )
+
+   /**
+    * local_allocate_span - reserve n slots for allocate_span, if
+    * contiguous is set n is cut back to the slots left before the
+    * wrap point. Released to the queue by send_range, same as
+    * allocate_range.
+    */
+   virtual void local_allocate_span( void **store,
+                                     std::size_t &n,
+                                     std::size_t &start,
+                                     std::size_t &queue_size,
+                                     const bool contiguous )
    {
-       assert( peekset != nullptr );
-       (this)->producer_data.out_peek = peekset;
+      for( ;; )
+      {
+         (this)->datamanager.enterBuffer( dm::allocate_range );
+         if( (this)->datamanager.notResizing() && (this)->producer_space( n ) )
+         {
+            break;
+         }
+         if( (this)->capacity() < n )
+         {
+            ((this)->datamanager.get()->force_resize) = n;
+         }
+         (this)->datamanager.exitBuffer( dm::allocate_range );
+         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
+         if( wr_stats == 0 )
+         {
+            wr_stats = 1;
+         }
+         (this)->waiter.producer_block();
+      }
+      auto * const buff_ptr( (this)->datamanager.get() );
+      start      = Pointer::val( buff_ptr->write_pt );
+      queue_size = buff_ptr->max_cap;
+      if( contiguous )
+      {
+         n = std::min( n, queue_size - start );
+      }
+      *store = reinterpret_cast< void* >( buff_ptr->store );
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
+      /** exitBuffer() called by send_range **/
+   }
+
+   /**
+    * local_peek_span - same wait as peek_range, but hands back
+    * only where the items are, signals aren't expanded.
+    */
+   virtual void local_peek_span( void **store,
+                                 const std::size_t n,
+                                 std::size_t &start,
+                                 std::size_t &queue_size )
+   {
+      for( ;; )
+      {
+         (this)->datamanager.enterBuffer( dm::peek );
+         if( (this)->datamanager.notResizing() )
+         {
+            if( (this)->consumer_items( n ) )
+            {
+               break;
+            }
+            else if( (this)->is_invalid() && (this)->size() < n )
+            {
+               const auto remaining( (this)->size() );
+               (this)->datamanager.exitBuffer( dm::peek );
+               if( remaining == 0 )
+               {
+                  throw ClosedPortAccessException(
+                     "Accessing closed port with peek_span call, exiting!!" );
+               }
+               throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+            }
+         }
+         (this)->datamanager.exitBuffer( dm::peek );
+         (this)->waiter.consumer_block();
+      }
+      auto * const buff_ptr( (this)->datamanager.get() );
+      start      = Pointer::val( buff_ptr->read_pt );
+      queue_size = buff_ptr->max_cap;
+      *store     = reinterpret_cast< void* >( buff_ptr->store );
+      /** exitBuffer() called by unpeek **/
+   }
+
+   virtual void setReclaimer( Buffer::Reclaimer * const reclaimer,
+                              const Direction side )
+   {
+       assert( reclaimer != nullptr );
+       if( side == Direction::Producer )
+       {
+           (this)->producer_data.reclaim = reclaimer;
+       }
+       else
+       {
+           (this)->consumer_data.reclaim = reclaimer;
+       }
    }
 
    /**
@@ -258,9 +424,7 @@ protected:
        * this value since the elements all remain in their 
        * location relative to the start of the queue.
        */
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const size_t read_index( Pointer::val( buff_ptr->read_pt ) );
-      return( buff_ptr->signal[ read_index ] /* make copy */ ); 
+      return( (this)->signals.peek( (this)->consumer_data.position ) );
    }
    /**
     * signal_pop - special function fo rthe scheduler to 
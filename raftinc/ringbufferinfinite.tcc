@@ -1,10 +1,30 @@
 /**
- * ringbufferinfinite.tcc - 
+ * ringbufferinfinite.tcc - unbounded FIFO that spills to disk. Built
+ * on the segmented FIFO (ringbuffersegmented.tcc): when the queue is
+ * full the producer doesn't wait, it posts a segment twice the size
+ * (or larger if it asked for more) and continues there. Segments stop
+ * growing at a quarter of the RAM budget, past that the producer
+ * chains segments of the same size. Segments stay in memory while
+ * the FIFO's segments total less than the RAM budget, past that they
+ * are regions of a temporary file mapped shared (see spillfile.hpp).
+ * A spilled segment is written back and dropped from memory once the
+ * producer moves on, the consumer reads it back sequentially with
+ * readahead and frees it once drained. The producer only blocks once
+ * the disk is full, a stalled consumer costs disk, not memory.
+ *
+ * Once drained segments have given their memory back the producer
+ * leaves the file for a new segment in memory, a consumer that keeps
+ * up doesn't stay on file pages. Picked per edge with Type::Infinite,
+ * the budget and the spill directory are set map wide
+ * (MapBase::setSpillBudget and MapBase::setSpillDirectory). Out of
+ * line items (ext_alloc) can't be spilled, for those this is a plain
+ * segmented FIFO.
+ *
  * @author: Jonathan Beard
  * @version: Sun Sep  7 07:39:56 2014
- * 
+ *
  * Copyright 2014 Jonathan Beard
- * 
+ *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
  * You may obtain a copy of the License at:
@@ -19,241 +39,286 @@
  */
 #ifndef RAFTRINGBUFFERINFINITE_TCC
 #define RAFTRINGBUFFERINFINITE_TCC  1
-#include "alloc_traits.tcc"
 
-//TODO -> fixme
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+#include "ringbuffersegmented.tcc"
+#include "spillfile.hpp"
+#include "alloc_traits.tcc"
+#include "defs.hpp"
 
 template < class T >
-class RingBufferBase< T, Type::Infinite, 
-           typename std::enable_if< inline_nonclass_alloc< T >::value >::type >
-: public FIFOAbstract< T, Type::Infinite >
+class RingBufferBase<
+    T,
+    Type::Infinite,
+    typename std::enable_if< inline_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::Segmented >
 {
-public:
+   using index_t  = std::uint64_t;
+   using buffer_t = Buffer::Data< T, Type::Heap >;
+
    /**
-    * RingBuffer - default constructor, initializes basic
-    * data structures.
+    * spill_state - shared with every segment, segments are freed by
+    * the segmented base after this class is gone.
     */
-   RingBufferBase() : FIFOAbstract< T, Type::Infinite >()
+   struct spill_state
    {
-   }
-   
-   virtual ~RingBufferBase() = default;
+      explicit spill_state( const Buffer::SpillConfig &config ) :
+         budget( config.ram_budget ),
+         file( config.directory )
+      {
+      }
 
+      const std::size_t               budget;
+      Buffer::SpillFile               file;
+      std::atomic< std::size_t >      ram_bytes       = { 0 };
+      std::atomic< std::uint64_t >    spilled_bytes   = { 0 };
+      std::atomic< std::uint64_t >    spill_segments  = { 0 };
+   };
 
-   /**
-    * size - as you'd expect it returns the number of 
-    * items currently in the queue.
-    * @return size_t
-    */
-   virtual std::size_t   size()
+   /** segment storage that knows where it lives **/
+   struct segment_data : public buffer_t
    {
-      return( 1 );
-   }
+      /** in memory **/
+      segment_data( const std::size_t n,
+                    const std::size_t align,
+                    const std::shared_ptr< spill_state > &state ) :
+         buffer_t( n, align ),
+         state( state )
+      {
+         state->ram_bytes += (this)->length_store;
+      }
+
+      /** region [offset, offset + length) of the spill file **/
+      segment_data( void * const base,
+                    const std::size_t n,
+                    const std::size_t offset,
+                    const std::size_t length,
+                    const std::shared_ptr< spill_state > &state ) :
+         buffer_t( reinterpret_cast< T* >( base ), n, 0 ),
+         state( state ),
+         offset( offset ),
+         length( length )
+      {
+      }
+
+      virtual ~segment_data()
+      {
+         if( spilled() )
+         {
+            state->file.release( (this)->store, offset, length );
+         }
+         else
+         {
+            state->ram_bytes -= (this)->length_store;
+         }
+      }
+
+      bool spilled() const noexcept
+      {
+         return( length > 0 );
+      }
+
+      const std::shared_ptr< spill_state >  state;
+      const std::size_t                     offset = 0;
+      const std::size_t                     length = 0;
+      /** position of the first item written here **/
+      index_t                               begin  = 0;
+   };
 
-   virtual raft::signal get_signal() 
+public:
+   RingBufferBase() : RingBufferBase< T, Type::Segmented >()
    {
-#if 0   
-      /** FIXME, reimplement this function **/
-#endif      
-      return( raft::none );
    }
 
-   virtual bool send_signal( const raft::signal   &signal )
+   virtual ~RingBufferBase() = default;
+
+   /** resize - nothing to do, the producer grows the queue itself **/
+   virtual void resize( const std::size_t size,
+                        const std::size_t align,
+                        volatile bool &exit_alloc )
    {
-      UNUSED( signal );
-      return( true );
+      UNUSED( size );
+      UNUSED( align );
+      UNUSED( exit_alloc );
    }
 
-   /**
-    * space_avail - returns the amount of space currently
-    * available in the queue.  This is the amount a user
-    * can expect to write without blocking
-    * @return  size_t
-    */
-   virtual std::size_t   space_avail()
+   /** get_storage_bytes - segments in memory, the file doesn't count **/
+   virtual std::size_t get_storage_bytes()
    {
-      return( (this)->datamanager.get()->max_cap );
+      return( state->ram_bytes.load( std::memory_order_relaxed ) );
    }
 
-  
-   /**
-    * capacity - returns the capacity of this queue which is 
-    * set at compile time by the constructor.
-    * @return size_t
-    */
-   virtual std::size_t   capacity()
+   virtual void get_spill_stats( Buffer::SpillStats &copy )
    {
-      return( (this)->datamanager.get()->max_cap );
+      copy.ram_bytes      = state->ram_bytes.load( std::memory_order_relaxed );
+      copy.file_bytes     = state->file.mapped();
+      copy.spilled_bytes  = state->spilled_bytes.load( std::memory_order_relaxed );
+      copy.spill_segments = state->spill_segments.load( std::memory_order_relaxed );
    }
 
-   
-
+protected:
    /**
-    * send - releases the last item allocated by allocate() to
-    * the queue.  Function will imply return if allocate wasn't
-    * called prior to calling this function.
-    * @param signal - const raft::signal signal, default: raft::signal::none
+    * start - install the first segment, always in memory.
+    * @param   n      - const std::size_t, items
+    * @param   align  - const std::size_t, alignment of memory segments
+    * @param   config - const Buffer::SpillConfig&
     */
-   virtual void send( const raft::signal signal = raft::none )
+   void start( const std::size_t n,
+               const std::size_t align,
+               const Buffer::SpillConfig &config )
    {
-      if( ! (this)->allocate_called ) return;
-      (this)->datamanager.get()->signal[ 0 ].sig = signal;
-      (this)->write_stats.count += (this)->n_allocated;
-      (this)->allocate_called = false;
-      (this)->n_allocated = 1;
+      state = std::make_shared< spill_state >( config );
+      alignment = align;
+      seg_limit = std::max( n, config.ram_budget / 4 / sizeof( T ) );
+      current   = new segment_data( n, align, state );
+      (this)->set_buffer( current );
    }
 
-   /** TODO, add send_range func to match fifo.hpp **/
-
    /**
-    * recycle - remove ``range'' items from the head of the
-    * queue and discard them.  Can be used in conjunction with
-    * the peek operator.
-    * @param   range - const size_t, default = 1
+    * overflow - the queue is full, continue in a segment at least
+    * twice the size up to the segment limit, past that in a chained
+    * one of the same size.
     */
-   virtual void recycle( const std::size_t range = 1 )
+   virtual bool overflow( const std::size_t needed,
+                          const std::size_t n,
+                          const index_t tail )
    {
-      (this)->read_stats.count += range;
-   }
-
-   virtual void get_zero_read_stats( Blocked &copy )
-   {
-      copy.all       = (this)->read_stats.all;
-      (this)->read_stats.all = 0;
-   }
-
-   virtual void get_zero_write_stats( Blocked &copy )
-   {
-      copy.all       = (this)->write_stats.all;
-      (this)->write_stats.all = 0;
+      if( (this)->is_invalid() )
+      {
+         return( false );
+      }
+      std::size_t cap( (this)->capacity() );
+      while( cap < needed && ( cap < seg_limit || cap < n ) )
+      {
+         cap <<= 1;
+      }
+      return( post_segment( cap, tail, cap < needed ) );
    }
 
-protected:
-   
-   virtual void  local_allocate( void **ptr )
+   /**
+    * refreshed - the producer is in the file, move back to memory
+    * as soon as drained segments have made room in the budget.
+    */
+   virtual bool refreshed( const index_t tail )
    {
-      (this)->allocate_called = true;
-      *ptr = (void*)&((this)->datamanager.get()->store[ 0 ]);
+      if( R_LIKELY( ! current->spilled() ) || (this)->is_invalid() )
+      {
+         return( false );
+      }
+      const auto cap( current->max_cap );
+      if( state->ram_bytes.load( std::memory_order_relaxed ) +
+             cap * sizeof( T ) > state->budget )
+      {
+         return( false );
+      }
+      return( post_segment( cap, tail, true ) );
    }
 
-   virtual std::size_t local_allocate_n( void *ptr, const std::size_t n )
+   /** sealed - a spilled segment is complete, push it out **/
+   virtual void sealed( buffer_t * const buffer )
    {
-      std::size_t output( n <= (this)->capacity() ? n : (this)->capacity() );
-      auto *container( reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
-      for( std::size_t index( 0 ); index < output; index++ )
+      auto * const seg( static_cast< segment_data* >( buffer ) );
+      if( seg->spilled() )
       {
-         container->push_back( (this)->datamanager.get()->store[ 0 ] );
+         state->spilled_bytes.fetch_add( ( sealed_at - seg->begin ) * sizeof( T ),
+                                         std::memory_order_relaxed );
+         Buffer::SpillFile::write_back( seg->store, seg->length );
       }
-      (this)->allocate_called = true;
-      (this)->n_allocated     = output;
-      return( output );
-   }
-   
-   virtual void  local_push( void *ptr, const raft::signal &signal )
-   {
-      T *item (reinterpret_cast< T* >( ptr ) );
-      (this)->datamanager.get()->store [ 0 ]  = *item;
-      /** a bit awkward since it gives the same behavior as the actual queue **/
-      (this)->datamanager.get()->signal[ 0 ].sig  = signal;
-      (this)->write_stats.count++;
    }
 
-   template< class iterator_type >
-   void local_insert_helper( iterator_type begin, 
-                             iterator_type end, 
-                             const raft::signal signal )
+   /** entered - consumer starts on a segment, read a spilled one back **/
+   virtual void entered( buffer_t * const buffer )
    {
-      while( begin != end )
+      auto * const seg( static_cast< segment_data* >( buffer ) );
+      if( seg->spilled() )
       {
-         (this)->datamanager.get()->store[ 0 ] = (*begin);
-         begin++;
-         (this)->write_stats.count++;
+         Buffer::SpillFile::read_back( seg->store, seg->length );
       }
-      (this)->datamanager.get()->signal[ 0 ].sig = signal;
-      return;
    }
-   
 
-   virtual void local_insert( void *begin_ptr,
-                              void *end_ptr,
-                              const raft::signal  &signal,
-                              const std::size_t iterator_type )
+private:
+   /**
+    * post_segment - new producer segment of cap items starting at
+    * tail, in memory if it fits the budget, otherwise in the file.
+    * False if the disk is full, the producer then waits for the
+    * consumer to make room.
+    */
+   bool post_segment( const std::size_t cap,
+                      const index_t tail,
+                      const bool chained )
    {
-      typedef typename std::list< T >::iterator   it_list;
-      typedef typename std::vector< T >::iterator it_vec;
-         
-      const std::map< std::size_t, 
-                std::function< void (void*,void*,const raft::signal&) > > func_map
-                  = {{ typeid( it_list ).hash_code(), 
-                       [ & ]( void *b_ptr, void *e_ptr, const raft::signal &sig )
-                       {
-                           it_list *begin( reinterpret_cast< it_list* >( b_ptr ) );
-                           it_list *end  ( reinterpret_cast< it_list* >( e_ptr   ) );
-                           local_insert_helper( *begin, *end, sig );
-                       } },
-                     { typeid( it_vec ).hash_code(),
-                       [ & ]( void *b_ptr, void *e_ptr, const raft::signal &sig )
-                       {
-                           it_vec *begin( reinterpret_cast< it_vec* >( b_ptr ) );
-                           it_vec *end  ( reinterpret_cast< it_vec* >( e_ptr   ) );
-                           local_insert_helper( *begin, *end, sig );
-
-                       } } };
-      auto f( func_map.find( iterator_type ) );
-      if( f != func_map.end() )
+      const auto bytes( cap * sizeof( T ) );
+      segment_data *buffer( nullptr );
+      if( state->ram_bytes.load( std::memory_order_relaxed ) + bytes <= state->budget )
       {
-         (*f).second( begin_ptr, end_ptr, signal );
+         buffer = new segment_data( cap, alignment, state );
       }
       else
       {
-         /** TODO, throw exception **/
+         std::size_t offset( 0 ), length( 0 );
+         auto * const base( state->file.map( bytes, offset, length ) );
+         if( base == nullptr )
+         {
+            return( false );
+         }
+         buffer = new segment_data( base, cap, offset, length, state );
+         state->spill_segments.fetch_add( 1, std::memory_order_relaxed );
       }
-      return;
+      buffer->begin = tail;
+      sealed_at     = tail;
+      current       = buffer;
+      (this)->post( buffer, chained );
+      return( true );
    }
 
-   virtual void local_pop( void *ptr, raft::signal *signal )
+   std::shared_ptr< spill_state >   state;
+   std::size_t                      alignment = 16;
+   /** segments grow up to this many items, then chain **/
+   std::size_t                      seg_limit = 0;
+   /** segment the producer writes, or is about to **/
+   segment_data                     *current  = nullptr;
+   /** position the current producer segment ends at once sealed **/
+   index_t                          sealed_at = 0;
+};
+
+/**
+ * out of line items point to objects allocated elsewhere, spilling
+ * the pointers saves nothing, these are plain segmented FIFOs grown
+ * by the allocator.
+ */
+template < class T >
+class RingBufferBase<
+    T,
+    Type::Infinite,
+    typename std::enable_if< ext_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::Segmented >
+{
+public:
+   RingBufferBase() : RingBufferBase< T, Type::Segmented >()
    {
-      T *item( reinterpret_cast< T* >( ptr ) );
-      *item  = (this)->datamanager.get()->store[ 0 ];
-      if( signal != nullptr )
-      {
-         *signal = (this)->datamanager.get()->signal[ 0 ].sig;
-      }
-      (this)->read_stats.count++;
    }
-  
-   virtual void local_pop_range( void *ptr_data,
-                                 const std::size_t n_items )
-   {
-      UNUSED( ptr_data );
-      UNUSED( n_items );
-      //assert( ptr_data != nullptr );
-      //auto *items( reinterpret_cast< T* >( ptr_data ) );
 
-      //if( signal != nullptr )
-      //{
-      //   for( size_t i( 0 ); i < n_items; i++ )
-      //   {
-      //      items [ i ]  = (this)->datamanager.get()->store [ 0 ];
-      //   }
-      //}
-      //else
-      //{
-      //   for( size_t i( 0 ); i < n_items; i++ )
-      //   {
-      //      items [ i ]  = (this)->datamanager.get()->store [ 0 ];
-      //   }
-      //}
-   }
+   virtual ~RingBufferBase() = default;
 
+   virtual void resize( const std::size_t size,
+                        const std::size_t align,
+                        volatile bool &exit_alloc )
+   {
+      (this)->grow( (this)->datamanager.make( size, align, false ), exit_alloc );
+   }
 
-   virtual void local_peek( void **ptr, raft::signal  *signal )
+protected:
+   void start( const std::size_t n,
+               const std::size_t align,
+               const Buffer::SpillConfig &config )
    {
-      *ptr = (void*)&( (this)->datamanager.get()->store[ 0 ] );
-      if( signal != nullptr )
-      {
-         *signal = (this)->datamanager.get()->signal[  0  ].sig;
-      }
+      UNUSED( config );
+      (this)->set_buffer( new Buffer::Data< T, Type::Heap >( n, align ) );
    }
 };
 #endif /* END RAFTRINGBUFFERINFINITE_TCC */
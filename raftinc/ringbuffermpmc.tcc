@@ -0,0 +1,747 @@
+/**
+ * ringbuffermpmc.tcc - bounded multi-producer, multi-consumer ring
+ * buffer (sequence numbered slots, Vyukov style) that more than one
+ * output port can feed (fan-in) or more than one input port can
+ * drain (fan-out). Items live in the same contiguous
+ * Buffer::Data< T, Type::Heap > store as the heap FIFO so peek_range
+ * and the span calls keep working, each slot additionally has a
+ * sequence number and a signal in a side array.
+ *
+ * Every port gets its own view (FIFO object) of one shared queue,
+ * see share(). Per-port state, i.e., items handed out by allocate
+ * and items claimed by peek, lives in the view so each view is only
+ * ever used by a single kernel. Producers build items in view local
+ * scratch space and copy them in on send, consumers claim items
+ * (dequeue) on first access, peek/unpeek keep the claim so the
+ * next pop on the same port returns the same item.
+ *
+ * Restrictions: the capacity is fixed at allocation time (resize is
+ * a no-op, size the edge with the link buffer parameter), the Park
+ * wait policy degrades to Yield (a wakeup only reaches the opposite
+ * side of the same view) and blocked/count stats aren't kept.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTRINGBUFFERMPMC_TCC
+#define RAFTRINGBUFFERMPMC_TCC  1
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "portexception.hpp"
+#include "ringbufferheap_lessabstract.tcc"
+#include "alloc_traits.tcc"
+#include "defs.hpp"
+#include "internaldefs.hpp"
+
+/** defined in ringbuffer.tcc, share() hands out more of them **/
+template < class T, Type::RingBufferType type, bool monitor > class RingBuffer;
+
+namespace Buffer
+{
+
+/**
+ * MPMCQueue - the part of an MPMC FIFO shared by all of its views,
+ * freed with the last view.
+ */
+template < class T > struct MPMCQueue
+{
+   using index_t  = std::uint64_t;
+   using buffer_t = Data< T, Type::Heap >;
+
+   struct cell
+   {
+      /** == pos: free for write pos, == pos + 1: readable at pos **/
+      std::atomic< index_t >      seq;
+      std::atomic< raft::signal > sig = { raft::none };
+   };
+
+   MPMCQueue( buffer_t * const buffer ) : buffer( buffer ),
+                                          cells( new cell[ buffer->max_cap ] )
+   {
+      for( index_t i( 0 ); i < buffer->max_cap; i++ )
+      {
+         cells[ i ].seq.store( i, std::memory_order_relaxed );
+      }
+   }
+
+   ~MPMCQueue()
+   {
+      delete[]( cells );
+      delete( buffer );
+   }
+
+   MPMCQueue( const MPMCQueue &other ) = delete;
+   MPMCQueue& operator = ( const MPMCQueue &other ) = delete;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      std::atomic< index_t >      pos = { 0 };
+   } enqueue;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      std::atomic< index_t >      pos = { 0 };
+   } dequeue;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      /** producer views that haven't invalidated yet **/
+      std::atomic< std::size_t >  producers = { 1 };
+      /** consumer views, only ever grows **/
+      std::atomic< std::size_t >  consumers = { 1 };
+      std::atomic< bool >         valid     = { true };
+   } control;
+
+   buffer_t * const buffer;
+   cell     * const cells;
+};
+
+} /** end namespace Buffer **/
+
+template < class T >
+class RingBufferBase<
+    T,
+    Type::MPMC,
+    typename std::enable_if< inline_alloc< T >::value >::type >
+: public RingBufferBaseHeapAbstract< T, Type::Heap >
+{
+   using queue_t   = Buffer::MPMCQueue< T >;
+   using index_t   = typename queue_t::index_t;
+   using buffer_t  = typename queue_t::buffer_t;
+   using storage_t = typename std::aligned_storage< sizeof( T ),
+                                                    alignof( T ) >::type;
+public:
+   RingBufferBase() : RingBufferBaseHeapAbstract< T, Type::Heap >()
+   {
+   }
+
+   virtual ~RingBufferBase() = default;
+
+   /**
+    * size - items in the queue plus the ones this port has
+    * claimed but not consumed yet, items claimed by other
+    * consumer ports aren't counted.
+    * @return std::size_t
+    */
+   virtual std::size_t size() noexcept
+   {
+      const auto d( queue->dequeue.pos.load( std::memory_order_acquire ) );
+      const auto e( queue->enqueue.pos.load( std::memory_order_acquire ) );
+      const auto n( static_cast< std::size_t >( ( e > d ? e - d : 0 ) +
+                                                ( held_end - held_begin ) ) );
+      const auto c( (this)->capacity() );
+      return( n > c ? c : n );
+   }
+
+   virtual std::size_t space_avail()
+   {
+      return( (this)->capacity() - (this)->size() );
+   }
+
+   virtual std::size_t capacity()
+   {
+      return( queue->buffer->max_cap );
+   }
+
+   /**
+    * invalidate - the queue goes invalid once every producer
+    * port has invalidated its view, each view only counts
+    * once no matter how often it is called.
+    */
+   virtual void invalidate()
+   {
+      if( producer_view && ! closed )
+      {
+         closed = true;
+         if( queue->control.producers.fetch_sub( 1, std::memory_order_acq_rel ) == 1 )
+         {
+            queue->control.valid.store( false, std::memory_order_release );
+         }
+      }
+      (this)->waiter.wake_all();
+   }
+
+   virtual bool is_invalid()
+   {
+      return( ! queue->control.valid.load( std::memory_order_acquire ) );
+   }
+
+   virtual void deallocate()
+   {
+      destroy( scratch_item( 0 ) );
+      (this)->producer_data.allocate_called = false;
+   }
+
+   /**
+    * send - moves the item built by allocate() into the queue.
+    * Returns right away if allocate wasn't called first.
+    * @param signal - const raft::signal signal, default: NONE
+    */
+   virtual void send( const raft::signal signal = raft::none )
+   {
+      if( R_UNLIKELY( ! (this)->producer_data.allocate_called ) )
+      {
+         return;
+      }
+      (this)->producer_data.allocate_called = false;
+      enqueue( scratch_item( 0 ), signal, true );
+      destroy( scratch_item( 0 ) );
+   }
+
+   /**
+    * send_range - moves the items from allocate_range() or
+    * allocate_span() into the queue, signal goes with the first
+    * one as it does on the heap FIFO. Other producers may
+    * interleave with the range.
+    * @param signal - const raft::signal signal, default: NONE
+    */
+   virtual void send_range( const raft::signal signal = raft::none )
+   {
+      if( ! (this)->producer_data.allocate_called )
+      {
+         return;
+      }
+      (this)->producer_data.allocate_called = false;
+      auto &n_allocated( (this)->producer_data.n_allocated );
+      for( std::size_t i( 0 ); i < n_allocated; i++ )
+      {
+         enqueue( scratch_item( i ),
+                  i == 0 ? signal : raft::none,
+                  true );
+         destroy( scratch_item( i ) );
+      }
+      n_allocated = 0;
+   }
+
+   /** claimed items stay with this port until consumed **/
+   virtual void unpeek()
+   {
+   }
+
+   /**
+    * set_wait_policy - Park needs the opposite side to wake it,
+    * which only works within a single view, so it degrades to
+    * Yield here.
+    * @param   policy - const Wait::Policy
+    */
+   virtual void set_wait_policy( const Wait::Policy policy )
+   {
+      (this)->waiter.set_policy( policy == Wait::Park ? Wait::Yield : policy );
+   }
+
+   /**
+    * share - new view of this queue for another producer or
+    * consumer port, freed by the allocator like any other FIFO.
+    * @param   side - const Direction
+    * @return  FIFO*
+    */
+   virtual FIFO* share( const Direction side )
+   {
+      auto * const view( new RingBuffer< T, Type::MPMC, false >( queue, side ) );
+      view->set_wait_policy( (this)->waiter.get_policy() );
+      return( view );
+   }
+
+   virtual bool is_shared( const Direction side )
+   {
+      const auto &views( side == Producer ? queue->control.producers :
+                                            queue->control.consumers );
+      return( views.load( std::memory_order_relaxed ) > 1 );
+   }
+
+protected:
+   /**
+    * set_buffer - first view, takes ownership of buffer
+    */
+   void set_buffer( buffer_t * const buffer )
+   {
+      queue = std::make_shared< queue_t >( buffer );
+      (this)->datamanager.set( buffer );
+      (this)->init();
+   }
+
+   /**
+    * set_queue - extra view of an existing queue, producer views
+    * keep the queue valid until they invalidate.
+    */
+   void set_queue( const std::shared_ptr< queue_t > &q, const Direction side )
+   {
+      queue         = q;
+      producer_view = ( side == Producer );
+      if( producer_view )
+      {
+         queue->control.producers.fetch_add( 1, std::memory_order_relaxed );
+      }
+      else
+      {
+         queue->control.consumers.fetch_add( 1, std::memory_order_relaxed );
+      }
+      (this)->datamanager.set( queue->buffer );
+      (this)->init();
+   }
+
+   virtual void local_recycle( std::size_t range )
+   {
+      while( range-- > 0 )
+      {
+         if( ! hold( 1 ) )
+         {
+            break;
+         }
+         const auto pos( held_begin++ );
+         destroy( &queue->buffer->store[ slot( pos ) ] );
+         release( pos );
+      }
+   }
+
+   virtual void local_allocate( void **ptr )
+   {
+      reserve_scratch( 1 );
+      *ptr = reinterpret_cast< void* >( scratch_item( 0 ) );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   virtual void local_allocate_n( void *ptr, const std::size_t n )
+   {
+      reserve_scratch( n );
+      auto *container(
+         reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
+      for( std::size_t index( 0 ); index < n; index++ )
+      {
+         container->emplace_back( *scratch_item( index ) );
+      }
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   /**
+    * local_push - if ptr is null only the signal is
+    * pushed, the item slot is left as is.
+    * @param   item, void ptr
+    * @param   signal, const raft::signal&
+    */
+   virtual void local_push( void *ptr, const raft::signal &signal )
+   {
+      enqueue( reinterpret_cast< T* >( ptr ), signal, false );
+   }
+
+   /** local_push_move - as local_push, the item is moved in **/
+   virtual void local_push_move( void *ptr, const raft::signal &signal )
+   {
+      enqueue( reinterpret_cast< T* >( ptr ), signal, true );
+   }
+
+   /**
+    * local_pop - read one item from the ring buffer,
+    * will block till there is data to be read.  If
+    * ptr == nullptr then the item is just thrown away.
+    */
+   virtual void local_pop( void *ptr, raft::signal *signal )
+   {
+      if( R_UNLIKELY( ! hold( 1 ) ) )
+      {
+         throw ClosedPortAccessException(
+            "Accessing closed port with pop call, exiting!!" );
+      }
+      const auto pos( held_begin++ );
+      auto &item( queue->buffer->store[ slot( pos ) ] );
+      if( signal != nullptr )
+      {
+         *signal = cell( pos ).sig.load( std::memory_order_relaxed );
+      }
+      if( ptr != nullptr )
+      {
+         *reinterpret_cast< T* >( ptr ) = std::move( item );
+         destroy( &item );
+      }
+      release( pos );
+   }
+
+   virtual void local_peek( void **ptr, raft::signal *signal )
+   {
+      if( R_UNLIKELY( ! hold( 1 ) ) )
+      {
+         throw ClosedPortAccessException(
+            "Accessing closed port with local_peek call, exiting!!" );
+      }
+      if( signal != nullptr )
+      {
+         *signal = cell( held_begin ).sig.load( std::memory_order_relaxed );
+      }
+      *ptr = reinterpret_cast< void* >(
+         &( queue->buffer->store[ slot( held_begin ) ] ) );
+   }
+
+   virtual void local_peek_range( void **ptr,
+                                  void **sig,
+                                  const std::size_t n,
+                                  std::size_t &curr_pointer_loc )
+   {
+      if( R_UNLIKELY( ! hold( n ) ) )
+      {
+         if( held_begin == held_end )
+         {
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_range call, exiting!!" );
+         }
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+      }
+      curr_pointer_loc = slot( held_begin );
+      *sig = reinterpret_cast< void* >( held_signals( n ) );
+      *ptr = reinterpret_cast< void* >( queue->buffer->store );
+   }
+
+   /**
+    * local_allocate_span - the items are built in scratch space
+    * and copied in by send_range, so the span never wraps.
+    */
+   virtual void local_allocate_span( void **store,
+                                     std::size_t &n,
+                                     std::size_t &start,
+                                     std::size_t &queue_size,
+                                     const bool contiguous )
+   {
+      UNUSED( contiguous );
+      reserve_scratch( n );
+      start      = 0;
+      queue_size = n;
+      *store = reinterpret_cast< void* >( scratch.data() );
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   virtual void local_peek_span( void **store,
+                                 const std::size_t n,
+                                 std::size_t &start,
+                                 std::size_t &queue_size )
+   {
+      if( R_UNLIKELY( ! hold( n ) ) )
+      {
+         if( held_begin == held_end )
+         {
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_span call, exiting!!" );
+         }
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+      }
+      start      = slot( held_begin );
+      queue_size = queue->buffer->max_cap;
+      *store = reinterpret_cast< void* >( queue->buffer->store );
+   }
+
+   /**
+    * signal_peek - a signalled item at the head is claimed so
+    * that the signal_pop which follows takes that very item and
+    * not one another consumer port left behind.
+    * @return raft::signal
+    */
+   virtual raft::signal signal_peek()
+   {
+      if( held_begin == held_end )
+      {
+         auto pos( queue->dequeue.pos.load( std::memory_order_relaxed ) );
+         auto &c( cell( pos ) );
+         if( c.seq.load( std::memory_order_acquire ) != pos + 1 ||
+             c.sig.load( std::memory_order_relaxed ) == raft::none )
+         {
+            return( raft::none );
+         }
+         if( ! queue->dequeue.pos.compare_exchange_strong( pos,
+                                                           pos + 1,
+                                                           std::memory_order_relaxed ) )
+         {
+            return( raft::none );
+         }
+         held_begin = pos;
+         held_end   = pos + 1;
+      }
+      return( cell( held_begin ).sig.load( std::memory_order_relaxed ) );
+   }
+
+private:
+   /**
+    * enqueue - claim the next free slot, copy (or move) item in
+    * (if not null) and publish it. Blocks while the queue is full.
+    */
+   void enqueue( T * const item, const raft::signal signal, const bool move )
+   {
+      auto &tail( queue->enqueue.pos );
+      auto pos( tail.load( std::memory_order_relaxed ) );
+      for( ;; )
+      {
+         const auto seq( cell( pos ).seq.load( std::memory_order_acquire ) );
+         const auto dif( static_cast< std::int64_t >( seq - pos ) );
+         if( dif == 0 )
+         {
+            if( tail.compare_exchange_weak( pos,
+                                            pos + 1,
+                                            std::memory_order_relaxed ) )
+            {
+               break;
+            }
+         }
+         else if( dif < 0 )
+         {
+            /** slot still holds the item from one lap ago, full **/
+            (this)->waiter.producer_block();
+            pos = tail.load( std::memory_order_relaxed );
+         }
+         else
+         {
+            pos = tail.load( std::memory_order_relaxed );
+         }
+      }
+      if( item != nullptr )
+      {
+         if( move )
+         {
+            construct( &queue->buffer->store[ slot( pos ) ], std::move( *item ) );
+         }
+         else
+         {
+            construct( &queue->buffer->store[ slot( pos ) ], *item );
+         }
+      }
+      auto &c( cell( pos ) );
+      c.sig.store( signal, std::memory_order_relaxed );
+      c.seq.store( pos + 1, std::memory_order_release );
+      (this)->waiter.produced();
+   }
+
+   /**
+    * hold - make sure this port has claimed at least n items,
+    * claims are taken as one contiguous block so they can be
+    * handed out as a range. Blocks until enough items show up.
+    * @param   n - std::size_t, items needed
+    * @return  bool, false if the queue is invalid and fewer
+    *          than n items will ever be available
+    * @throws  SharedPortAccessException - a partial claim can't be
+    *          extended because another consumer port took the
+    *          items right after it
+    */
+   bool hold( const std::size_t n )
+   {
+      const auto have( static_cast< std::size_t >( held_end - held_begin ) );
+      if( R_LIKELY( have >= n ) )
+      {
+         return( true );
+      }
+      if( queue->buffer->max_cap < n )
+      {
+         queue->buffer->force_resize = n;
+      }
+      const auto need( n - have );
+      auto &head( queue->dequeue.pos );
+      bool last_look( false );
+      for( ;; )
+      {
+         auto pos( head.load( std::memory_order_relaxed ) );
+         if( have != 0 && pos != held_end )
+         {
+            throw SharedPortAccessException(
+               "Can't extend peek on shared port, another consumer took the "
+               "next items, recycle what was peeked before peeking more." );
+         }
+         std::size_t ready( 0 );
+         bool stale( false );
+         for( ; ready < need; ready++ )
+         {
+            const auto p( pos + ready );
+            const auto seq( cell( p ).seq.load( std::memory_order_acquire ) );
+            if( seq != p + 1 )
+            {
+               /** ahead means another consumer already took p **/
+               stale = static_cast< std::int64_t >( seq - ( p + 1 ) ) > 0;
+               break;
+            }
+         }
+         if( ready == need )
+         {
+            if( head.compare_exchange_weak( pos,
+                                            pos + need,
+                                            std::memory_order_relaxed ) )
+            {
+               if( have == 0 )
+               {
+                  held_begin = pos;
+               }
+               held_end = pos + need;
+               return( true );
+            }
+            continue;
+         }
+         if( stale )
+         {
+            continue;
+         }
+         if( last_look )
+         {
+            return( false );
+         }
+         if( (this)->is_invalid() )
+         {
+            /** every push happens before the last invalidate, look once more **/
+            last_look = true;
+            continue;
+         }
+         (this)->waiter.consumer_block();
+      }
+   }
+
+   /** release - slot at pos can take the item one lap ahead **/
+   inline void release( const index_t pos ) noexcept
+   {
+      cell( pos ).seq.store( pos + queue->buffer->max_cap,
+                             std::memory_order_release );
+      (this)->waiter.consumed();
+   }
+
+   /**
+    * held_signals - signals for the first n claimed items in
+    * the consumer scratch space handed out by peek_range.
+    */
+   Buffer::Signal* held_signals( const std::size_t n )
+   {
+      auto &scratch_sigs( (this)->consumer_data.range_signals );
+      if( scratch_sigs.size() < n || scratch_sigs.empty() )
+      {
+         scratch_sigs.resize( std::max( n, std::size_t( 1 ) ) );
+      }
+      for( std::size_t i( 0 ); i < n; i++ )
+      {
+         scratch_sigs[ i ] = cell( held_begin + i ).sig.load( std::memory_order_relaxed );
+      }
+      scratch_sigs[ 0 ].index = queue->buffer->start_index;
+      return( scratch_sigs.data() );
+   }
+
+   inline void reserve_scratch( const std::size_t n )
+   {
+      if( scratch.size() < n )
+      {
+         scratch.resize( n );
+      }
+   }
+
+   inline T* scratch_item( const std::size_t i ) noexcept
+   {
+      return( reinterpret_cast< T* >( &scratch[ i ] ) );
+   }
+
+   inline typename queue_t::cell& cell( const index_t pos ) noexcept
+   {
+      return( queue->cells[ slot( pos ) ] );
+   }
+
+   /**
+    * slot - buffer index for free running counter i, mask
+    * rather than divide for POW2_BUFFER buffers.
+    */
+   inline std::size_t slot( const index_t i ) const noexcept
+   {
+#ifdef POW2_BUFFER
+      return( static_cast< std::size_t >( i & ( queue->buffer->max_cap - 1 ) ) );
+#else
+      return( static_cast< std::size_t >( i % queue->buffer->max_cap ) );
+#endif
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   construct( U * const slot, const U &item )
+   {
+      new ( slot ) U( item );
+   }
+
+   /** the item is an rvalue, take over what it holds **/
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   construct( U * const slot, U &&item )
+   {
+      new ( slot ) U( std::move( item ) );
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_nonclass_alloc< U >::value >::type
+   construct( U * const slot, const U &item )
+   {
+      *slot = item;
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   destroy( U * const slot )
+   {
+      slot->~U();
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_nonclass_alloc< U >::value >::type
+   destroy( U * const slot )
+   {
+      UNUSED( slot );
+   }
+
+   std::shared_ptr< queue_t > queue;
+   /** counts toward queue producers, first view always does **/
+   bool                       producer_view = true;
+   bool                       closed        = false;
+   /** claimed by this consumer port, [held_begin, held_end) **/
+   index_t                    held_begin    = 0;
+   index_t                    held_end      = 0;
+   /** items handed out by allocate/allocate_range/allocate_span **/
+   std::vector< storage_t >   scratch;
+};
+
+/**
+ * ext_alloc types carry pointers to out-of-band objects that come
+ * from the FIFO's slab pool (slabpool.tcc) and are retired through
+ * the kernel's Buffer::Reclaimer on recycle, these keep the heap
+ * implementation and can't be shared.
+ */
+template < class T >
+class RingBufferBase<
+    T,
+    Type::MPMC,
+    typename std::enable_if< ext_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::Heap >
+{
+public:
+   RingBufferBase() : RingBufferBase< T, Type::Heap >()
+   {
+   }
+
+   virtual ~RingBufferBase()
+   {
+      delete( (this)->datamanager.get() );
+   }
+
+protected:
+   void set_buffer( Buffer::Data< T, Type::Heap > * const buffer ) noexcept
+   {
+      (this)->datamanager.set( buffer );
+      (this)->init();
+   }
+};
+
+#endif /* END RAFTRINGBUFFERMPMC_TCC */
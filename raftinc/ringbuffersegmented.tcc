@@ -0,0 +1,907 @@
+/**
+ * ringbuffersegmented.tcc - single producer, single consumer FIFO
+ * that grows without copying or stopping either side. Items live
+ * in a chain of heap ring buffers (segments), read/write positions
+ * are free-running 64b counters like the lock-free SPSC FIFO. A
+ * resize only posts a larger segment, the producer links it the
+ * next time it enters the queue and writes everything after that
+ * point into it. The consumer drains the old segment, follows the
+ * link once it reaches the point the producer switched and frees
+ * the drained segment. The only items ever moved are those of a
+ * peek_range that straddles the switch point, they're pulled back
+ * into the segment being drained (or, for a range wider than it,
+ * pushed forward into the next one).
+ *
+ * A segment posted as chained (see post) doesn't have to hold what
+ * is still queued in older segments, the producer only keeps from
+ * overwriting its own unread slots. That's how a FIFO that extends
+ * itself (Type::Infinite) keeps its segments at a bounded size.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTRINGBUFFERSEGMENTED_TCC
+#define RAFTRINGBUFFERSEGMENTED_TCC  1
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+#include "portexception.hpp"
+#include "ringbufferheap_lessabstract.tcc"
+#include "alloc_traits.tcc"
+#include "blocked.hpp"
+#include "defs.hpp"
+#include "internaldefs.hpp"
+/** for yield **/
+#include "sysschedutil.hpp"
+
+template < class T >
+class RingBufferBase<
+    T,
+    Type::Segmented,
+    typename std::enable_if< inline_alloc< T >::value >::type >
+: public RingBufferBaseHeapAbstract< T, Type::Heap >
+{
+   using index_t  = std::uint64_t;
+   using buffer_t = Buffer::Data< T, Type::Heap >;
+
+   struct segment
+   {
+      segment( buffer_t * const buffer, const bool chained ) :
+         buffer( buffer ),
+         chained( chained )
+      {
+      }
+
+      ~segment()
+      {
+         delete( buffer );
+      }
+
+      buffer_t * const           buffer;
+      /** only its own slots limit the producer, see post **/
+      const bool                 chained;
+      /**
+       * position of the first item that is not in this segment,
+       * written once by the producer when it links next.
+       */
+      std::atomic< index_t >     end  = { std::numeric_limits< index_t >::max() };
+      std::atomic< segment* >    next = { nullptr };
+   };
+
+public:
+   RingBufferBase() : RingBufferBaseHeapAbstract< T, Type::Heap >()
+   {
+   }
+
+   virtual ~RingBufferBase()
+   {
+      /** every live segment hangs off the oldest one **/
+      auto *seg( consumer.oldest );
+      while( seg != nullptr )
+      {
+         auto * const next( seg->next.load( std::memory_order_relaxed ) );
+         delete( seg );
+         seg = next;
+      }
+      delete( control.pending.load( std::memory_order_relaxed ) );
+   }
+
+   /**
+    * size - number of items currently in the queue, safe
+    * to call from any thread, never touches a segment.
+    * @return std::size_t
+    */
+   virtual std::size_t size() noexcept
+   {
+      const auto h( consumer.head.load( std::memory_order_acquire ) );
+      const auto t( producer.tail.load( std::memory_order_acquire ) );
+      return( static_cast< std::size_t >( t - h ) );
+   }
+
+   virtual std::size_t space_avail()
+   {
+      const auto cap( (this)->capacity() );
+      const auto n( (this)->size() );
+      return( n > cap ? 0 : cap - n );
+   }
+
+   /**
+    * capacity - capacity of the newest linked segment, unless
+    * it is chained the producer never lets more than this many
+    * items be in the queue regardless of how many segments
+    * they're spread over.
+    * @return std::size_t
+    */
+   virtual std::size_t capacity()
+   {
+      return( control.cap.load( std::memory_order_relaxed ) );
+   }
+
+   /**
+    * get_storage_bytes - size of the newest segment, the consumer
+    * frees older ones as it drains them.
+    * @return std::size_t
+    */
+   virtual std::size_t get_storage_bytes()
+   {
+      return( (this)->capacity() * sizeof( T ) );
+   }
+
+   virtual void invalidate()
+   {
+      control.valid.store( false, std::memory_order_release );
+      (this)->waiter.wake_all();
+   }
+
+   virtual bool is_invalid()
+   {
+      return( ! control.valid.load( std::memory_order_acquire ) );
+   }
+
+   /**
+    * the stats live with the FIFO rather than in a segment as
+    * the monitor thread reads them while segments come and go.
+    */
+   virtual void get_zero_read_stats( Blocked &copy )
+   {
+      copy.all                 = consumer.read_stats.all;
+      consumer.read_stats.all  = 0;
+   }
+
+   virtual void get_zero_write_stats( Blocked &copy )
+   {
+      copy.all                 = producer.write_stats.all;
+      producer.write_stats.all = 0;
+   }
+
+   virtual float get_frac_write_blocked()
+   {
+      const auto copy( producer.write_stats );
+      producer.write_stats.all = 0;
+      if( copy.bec.blocked == 0 || copy.bec.count == 0 )
+      {
+         return( 0.0 );
+      }
+      return( (float) copy.bec.blocked / (float) copy.bec.count );
+   }
+
+   virtual std::size_t get_suggested_count()
+   {
+      return( producer.force_resize );
+   }
+
+   virtual void deallocate()
+   {
+      auto * const buff_ptr( producer.seg->buffer );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      destroy( &buff_ptr->store[ slot( t, buff_ptr ) ] );
+      (this)->producer_data.allocate_called = false;
+   }
+
+   /**
+    * send- releases the last item allocated by allocate() to
+    * the queue.  Function will imply return if allocate wasn't
+    * called prior to calling this function.
+    * @param signal - const raft::signal signal, default: NONE
+    */
+   virtual void send( const raft::signal signal = raft::none )
+   {
+      if( R_UNLIKELY( ! (this)->producer_data.allocate_called ) )
+      {
+         return;
+      }
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      (this)->signals.send( t, signal );
+      (this)->producer_data.write_stats->bec.count++;
+      (this)->producer_data.allocate_called = false;
+      producer.tail.store( t + 1, std::memory_order_release );
+      (this)->waiter.produced();
+   }
+
+   /**
+    * send_range - releases the items allocated by allocate_range()
+    * to the queue, signal goes with the first item of the range
+    * as it does on the heap FIFO.
+    * @param signal - const raft::signal signal, default: NONE
+    */
+   virtual void send_range( const raft::signal signal = raft::none )
+   {
+      if( ! (this)->producer_data.allocate_called )
+      {
+         return;
+      }
+      auto &n_allocated( (this)->producer_data.n_allocated );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      (this)->signals.send( t, signal );
+      (this)->producer_data.write_stats->bec.count += n_allocated;
+      (this)->producer_data.allocate_called = false;
+      producer.tail.store( t + n_allocated, std::memory_order_release );
+      (this)->waiter.produced();
+      n_allocated = 0;
+   }
+
+   virtual void unpeek()
+   {
+      consumer.busy = false;
+   }
+
+protected:
+
+   /**
+    * grow - hand the producer a larger segment to continue in,
+    * never blocks. A segment that is no larger than the current
+    * capacity is dropped, as is an older one that was posted but
+    * not yet picked up by the producer.
+    * @param   buffer     - buffer_t*, new segment storage, owned from here
+    * @param   exit_alloc - set by the allocator when the app is done
+    */
+   void grow( buffer_t * const buffer, volatile bool &exit_alloc )
+   {
+      if( exit_alloc || (this)->is_invalid() ||
+          buffer->max_cap <= (this)->capacity() )
+      {
+         delete( buffer );
+         return;
+      }
+      (this)->post( buffer, false );
+   }
+
+   /**
+    * post - hand the producer buffer as its next segment, no size
+    * checks. A chained segment may be smaller than what is queued,
+    * the producer then only keeps from overwriting the unread slots
+    * of that segment itself. It must be at least as large as every
+    * range the consumer peeks at once.
+    * @param   buffer  - buffer_t*, new segment storage, owned from here
+    * @param   chained - const bool
+    */
+   void post( buffer_t * const buffer, const bool chained )
+   {
+      (this)->datamanager.prepare( buffer );
+      auto * const seg( new segment( buffer, chained ) );
+      delete( control.pending.exchange( seg, std::memory_order_acq_rel ) );
+      /** a producer parked on a full queue picks the segment up now **/
+      (this)->waiter.wake_all();
+   }
+
+   /**
+    * set_buffer - install the first segment, called before
+    * either side is running.
+    */
+   void set_buffer( buffer_t * const buffer )
+   {
+      auto * const seg( new segment( buffer, false ) );
+      producer.seg    = seg;
+      consumer.seg    = seg;
+      consumer.oldest = seg;
+      (this)->datamanager.set( buffer );
+      (this)->init();
+      (this)->producer_data.write_stats = &producer.write_stats;
+      (this)->consumer_data.read_stats  = &consumer.read_stats;
+      control.cap.store( buffer->max_cap, std::memory_order_relaxed );
+   }
+
+   virtual std::size_t local_peek_capacity()
+   {
+      return( consumer.seg->buffer->max_cap );
+   }
+
+   /**
+    * overflow - producer side, called when the queue is full
+    * instead of blocking right away. Return true after posting a
+    * segment (grow() or post()) the n items fit, by default the
+    * producer waits for the consumer (or the allocator).
+    * @param   needed - const std::size_t, items outstanding plus requested
+    * @param   n      - const std::size_t, items requested
+    * @param   tail   - const index_t, position the next item goes to
+    * @return  bool
+    */
+   virtual bool overflow( const std::size_t needed,
+                          const std::size_t n,
+                          const index_t tail )
+   {
+      UNUSED( needed );
+      UNUSED( n );
+      UNUSED( tail );
+      return( false );
+   }
+
+   /**
+    * refreshed - producer side, called each time the producer has
+    * re-read the consumer's position (about once a lap when the
+    * consumer keeps up). Return true after posting a segment to
+    * move on to, e.g., one that lives somewhere better.
+    * @param   tail - const index_t, position the next item goes to
+    * @return  bool
+    */
+   virtual bool refreshed( const index_t tail )
+   {
+      UNUSED( tail );
+      return( false );
+   }
+
+   /** sealed - producer side, buffer won't be written to again **/
+   virtual void sealed( buffer_t * const buffer )
+   {
+      UNUSED( buffer );
+   }
+
+   /** entered - consumer side, reads continue in buffer **/
+   virtual void entered( buffer_t * const buffer )
+   {
+      UNUSED( buffer );
+   }
+
+   /**
+    * removes range items from the buffer, ignores
+    * them without the copy overhead.
+    */
+   virtual void local_recycle( std::size_t range )
+   {
+      while( range-- > 0 )
+      {
+         auto * const buff_ptr( consumer_wait( 1 ) );
+         if( buff_ptr == nullptr )
+         {
+            break;
+         }
+         const auto h( consumer.head.load( std::memory_order_relaxed ) );
+         destroy( &buff_ptr->store[ slot( h, buff_ptr ) ] );
+         (this)->signals.pop( h );
+         consumer.head.store( h + 1, std::memory_order_release );
+         (this)->waiter.consumed();
+      }
+      consumer.busy = false;
+   }
+
+   virtual void local_allocate( void **ptr )
+   {
+      auto * const buff_ptr( producer_wait( 1 ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      *ptr = (void*)&( buff_ptr->store[ slot( t, buff_ptr ) ] );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   virtual void local_allocate_n( void *ptr, const std::size_t n )
+   {
+      auto * const buff_ptr( producer_wait( n ) );
+      auto *container(
+         reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      for( std::size_t index( 0 ); index < n; index++ )
+      {
+         container->emplace_back( buff_ptr->store[ slot( t + index, buff_ptr ) ] );
+      }
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   /**
+    * local_push - if ptr is null only the signal is
+    * pushed, the item slot is left as is.
+    * @param   item, void ptr
+    * @param   signal, const raft::signal&
+    */
+   virtual void local_push( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, false );
+   }
+
+   /** local_push_move - as local_push, the item is moved in **/
+   virtual void local_push_move( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, true );
+   }
+
+   void push_item( void *ptr, const raft::signal &signal, const bool move )
+   {
+      auto * const buff_ptr( producer_wait( 1 ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      if( ptr != nullptr )
+      {
+         auto &item( *reinterpret_cast< T* >( ptr ) );
+         if( move )
+         {
+            construct( &buff_ptr->store[ slot( t, buff_ptr ) ], std::move( item ) );
+         }
+         else
+         {
+            construct( &buff_ptr->store[ slot( t, buff_ptr ) ], item );
+         }
+         (this)->producer_data.write_stats->bec.count++;
+      }
+      (this)->signals.send( t, signal );
+      producer.tail.store( t + 1, std::memory_order_release );
+      (this)->waiter.produced();
+   }
+
+   /**
+    * local_pop - read one item from the ring buffer,
+    * will block till there is data to be read.  If
+    * ptr == nullptr then the item is just thrown away.
+    */
+   virtual void local_pop( void *ptr, raft::signal *signal )
+   {
+      auto * const buff_ptr( consumer_wait( 1 ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         throw ClosedPortAccessException(
+            "Accessing closed port with pop call, exiting!!" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      const auto read_index( slot( h, buff_ptr ) );
+      const auto sig( (this)->signals.pop( h ) );
+      if( signal != nullptr )
+      {
+         *signal = sig;
+      }
+      if( ptr != nullptr )
+      {
+         *reinterpret_cast< T* >( ptr ) = std::move( buff_ptr->store[ read_index ] );
+         destroy( &buff_ptr->store[ read_index ] );
+         (this)->consumer_data.read_stats->bec.count++;
+      }
+      consumer.head.store( h + 1, std::memory_order_release );
+      (this)->waiter.consumed();
+   }
+
+   /**
+    * local_peek - the consumer is marked busy until unpeek
+    * or recycle is called, drained segments aren't freed
+    * while the user might hold a reference into one.
+    */
+   virtual void local_peek( void **ptr, raft::signal *signal )
+   {
+      auto * const buff_ptr( consumer_wait( 1 ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         throw ClosedPortAccessException(
+            "Accessing closed port with local_peek call, exiting!!" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      if( signal != nullptr )
+      {
+         *signal = (this)->signals.peek( h );
+      }
+      consumer.busy = true;
+      *ptr = reinterpret_cast< void* >(
+         &( buff_ptr->store[ slot( h, buff_ptr ) ] ) );
+   }
+
+   virtual void local_peek_range( void **ptr,
+                                  void **sig,
+                                  const std::size_t n,
+                                  std::size_t &curr_pointer_loc )
+   {
+      auto *buff_ptr( consumer_wait( n ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         if( (this)->size() == 0 )
+         {
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_range call, exiting!!" );
+         }
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      curr_pointer_loc = static_cast< std::size_t >( slot( h, buff_ptr ) );
+      consumer.busy = true;
+      *sig = reinterpret_cast< void* >( (this)->range_signals( h, n ) );
+      *ptr = reinterpret_cast< void* >( buff_ptr->store );
+   }
+
+   virtual void local_allocate_span( void **store,
+                                     std::size_t &n,
+                                     std::size_t &start,
+                                     std::size_t &queue_size,
+                                     const bool contiguous )
+   {
+      auto * const buff_ptr( producer_wait( n ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      start      = slot( t, buff_ptr );
+      queue_size = buff_ptr->max_cap;
+      if( contiguous )
+      {
+         n = std::min( n, queue_size - start );
+      }
+      *store = reinterpret_cast< void* >( buff_ptr->store );
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   virtual void local_peek_span( void **store,
+                                 const std::size_t n,
+                                 std::size_t &start,
+                                 std::size_t &queue_size )
+   {
+      auto * const buff_ptr( consumer_wait( n ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         if( (this)->size() == 0 )
+         {
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_span call, exiting!!" );
+         }
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      start      = slot( h, buff_ptr );
+      queue_size = buff_ptr->max_cap;
+      consumer.busy = true;
+      *store = reinterpret_cast< void* >( buff_ptr->store );
+   }
+
+   virtual raft::signal signal_peek()
+   {
+      return( (this)->signals.peek(
+         consumer.head.load( std::memory_order_relaxed ) ) );
+   }
+
+private:
+   /**
+    * producer_wait - pick up a posted segment if there is one,
+    * then wait until there are at least n free slots. Returns
+    * the segment buffer the next n items go into.
+    */
+   buffer_t* producer_wait( const std::size_t n )
+   {
+      for( ;; )
+      {
+         link_pending();
+         auto * const buff_ptr( producer.seg->buffer );
+         const auto t( producer.tail.load( std::memory_order_relaxed ) );
+         if( R_LIKELY( buff_ptr->max_cap - ( t - oldest_slot() ) >= n ) )
+         {
+            return( buff_ptr );
+         }
+         /** only touch the consumer's line once the cached copy says full **/
+         producer.cached_head = consumer.head.load( std::memory_order_acquire );
+         if( (this)->refreshed( t ) )
+         {
+            continue;
+         }
+         if( buff_ptr->max_cap - ( t - oldest_slot() ) >= n )
+         {
+            return( buff_ptr );
+         }
+         if( buff_ptr->max_cap < n )
+         {
+            producer.force_resize = n;
+         }
+         if( (this)->overflow( t - producer.cached_head + n, n, t ) )
+         {
+            /** a segment was posted, link_pending picks it up **/
+            continue;
+         }
+         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
+         if( wr_stats == 0 )
+         {
+            wr_stats = 1;
+         }
+         (this)->waiter.producer_block();
+      }
+   }
+
+   /**
+    * oldest_slot - producer side, position of the oldest item that
+    * may still be in the current segment's slots. Items in older
+    * segments count too unless the segment is chained.
+    */
+   inline index_t oldest_slot() const noexcept
+   {
+      if( R_UNLIKELY( producer.seg->chained ) )
+      {
+         return( std::max( producer.cached_head, producer.seg_begin ) );
+      }
+      return( producer.cached_head );
+   }
+
+   /**
+    * link_pending - producer side, if grow() posted a segment
+    * close off the current one at the tail and continue in the
+    * new one. next is published before end, the consumer only
+    * follows next once it has seen end.
+    */
+   inline void link_pending() noexcept
+   {
+      if( R_LIKELY( control.pending.load( std::memory_order_relaxed ) == nullptr ) )
+      {
+         return;
+      }
+      auto * const next(
+         control.pending.exchange( nullptr, std::memory_order_acquire ) );
+      if( next == nullptr )
+      {
+         return;
+      }
+      auto * const curr( producer.seg );
+      curr->next.store( next, std::memory_order_release );
+      curr->end.store( producer.tail.load( std::memory_order_relaxed ),
+                       std::memory_order_release );
+      producer.seg       = next;
+      producer.seg_begin = producer.tail.load( std::memory_order_relaxed );
+      control.cap.store( next->buffer->max_cap, std::memory_order_relaxed );
+      (this)->sealed( curr->buffer );
+   }
+
+   /**
+    * consumer_wait - wait until there are at least n items
+    * available, returns the segment buffer they're in or
+    * nullptr if the producer has gone away and fewer than n
+    * items remain.
+    */
+   buffer_t* consumer_wait( const std::size_t n )
+   {
+      for( ;; )
+      {
+         if( ! consumer.busy )
+         {
+            release_drained();
+         }
+         const auto h( consumer.head.load( std::memory_order_relaxed ) );
+         if( R_LIKELY( consumer.cached_tail - h >= n ) )
+         {
+            return( consumer_segment( h, n ) );
+         }
+         consumer.cached_tail = producer.tail.load( std::memory_order_acquire );
+         if( consumer.cached_tail - h >= n )
+         {
+            return( consumer_segment( h, n ) );
+         }
+         if( (this)->is_invalid() )
+         {
+            /** re-check, the last push happens before invalidate **/
+            consumer.cached_tail = producer.tail.load( std::memory_order_acquire );
+            if( consumer.cached_tail - h >= n )
+            {
+               return( consumer_segment( h, n ) );
+            }
+            return( nullptr );
+         }
+         auto &rd_stats( (this)->consumer_data.read_stats->bec.blocked );
+         if( rd_stats == 0 )
+         {
+            rd_stats = 1;
+         }
+         (this)->waiter.consumer_block();
+      }
+   }
+
+   /**
+    * consumer_segment - segment holding items [h, h + n), all
+    * of which are known to be published. Follows links past
+    * drained segments. If the range straddles a link the items
+    * past it are pulled back into the segment being drained,
+    * their slots there are free as no more than its capacity
+    * worth of positions are unread. A range wider than that
+    * segment instead moves the few items left behind forward
+    * into the next one, whose slots are free as the producer
+    * never lets more than a non-chained segment's capacity be
+    * outstanding.
+    */
+   buffer_t* consumer_segment( const index_t h, const std::size_t n )
+   {
+      auto *seg( consumer.seg );
+      /** items pulled back earlier live in consumer.seg too **/
+      auto end( std::max( seg->end.load( std::memory_order_acquire ),
+                          consumer.pulled ) );
+      bool pulled( false );
+      for( ;; )
+      {
+         if( R_LIKELY( h + n <= end ) )
+         {
+            break;
+         }
+         auto * const next( seg->next.load( std::memory_order_acquire ) );
+         assert( next != nullptr );
+         if( h < end && n <= seg->buffer->max_cap )
+         {
+            pull_back( seg, next, end, h + n );
+            end    = h + n;
+            pulled = true;
+            break;
+         }
+         /** the producer only keeps chained segments' own slots free **/
+         assert( h >= end || ! next->chained );
+         for( auto i( h ); i < end; i++ )
+         {
+            relocate( &next->buffer->store[ slot( i, next->buffer ) ],
+                      &seg->buffer->store[ slot( i, seg->buffer ) ] );
+         }
+         seg = next;
+         end = seg->end.load( std::memory_order_acquire );
+      }
+      if( R_UNLIKELY( seg != consumer.seg ) )
+      {
+         consumer.seg    = seg;
+         consumer.pulled = 0;
+         (this)->datamanager.set( seg->buffer );
+         (this)->entered( seg->buffer );
+      }
+      if( R_UNLIKELY( pulled ) )
+      {
+         consumer.pulled = end;
+      }
+      return( seg->buffer );
+   }
+
+   /**
+    * pull_back - move the items at positions [from, to) out of
+    * the segments starting at next into seg.
+    */
+   static void pull_back( segment * const seg,
+                          segment *next,
+                          const index_t from,
+                          const index_t to )
+   {
+      for( auto i( from ); i < to; i++ )
+      {
+         while( i >= next->end.load( std::memory_order_acquire ) )
+         {
+            next = next->next.load( std::memory_order_acquire );
+         }
+         relocate( &seg->buffer->store[ slot( i, seg->buffer ) ],
+                   &next->buffer->store[ slot( i, next->buffer ) ] );
+      }
+   }
+
+   /** release_drained - free segments the consumer has moved past **/
+   inline void release_drained() noexcept
+   {
+      while( R_UNLIKELY( consumer.oldest != consumer.seg ) )
+      {
+         auto * const next(
+            consumer.oldest->next.load( std::memory_order_relaxed ) );
+         delete( consumer.oldest );
+         consumer.oldest = next;
+      }
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   construct( U * const slot, const U &item )
+   {
+      new ( slot ) U( item );
+   }
+
+   /** the item is an rvalue, take over what it holds **/
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   construct( U * const slot, U &&item )
+   {
+      new ( slot ) U( std::move( item ) );
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_nonclass_alloc< U >::value >::type
+   construct( U * const slot, const U &item )
+   {
+      *slot = item;
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   destroy( U * const slot )
+   {
+      slot->~U();
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_nonclass_alloc< U >::value >::type
+   destroy( U * const slot )
+   {
+      UNUSED( slot );
+   }
+
+   /** relocate - move-construct into dst, destroy src **/
+   static inline void relocate( T * const dst, T * const src )
+   {
+      construct( dst, std::move( *src ) );
+      destroy( src );
+   }
+
+   /** slot - index in buffer for free running position i **/
+   static inline std::size_t slot( const index_t i,
+                                   const buffer_t * const buffer ) noexcept
+   {
+#ifdef POW2_BUFFER
+      return( static_cast< std::size_t >( i & ( buffer->max_cap - 1 ) ) );
+#else
+      return( static_cast< std::size_t >( i % buffer->max_cap ) );
+#endif
+   }
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      std::atomic< index_t >  tail         = { 0 };
+      /** producer's copy of head, refreshed when the queue looks full **/
+      index_t                 cached_head  = 0;
+      /** segment currently written, and the position it starts at **/
+      segment                 *seg         = nullptr;
+      index_t                 seg_begin    = 0;
+      Blocked                 write_stats;
+      std::size_t             force_resize = 0;
+   } producer;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      std::atomic< index_t >  head         = { 0 };
+      /** consumer's copy of tail, refreshed when the queue looks empty **/
+      index_t                 cached_tail  = 0;
+      /** segment currently read, and the oldest not yet freed **/
+      segment                 *seg         = nullptr;
+      segment                 *oldest      = nullptr;
+      /** seg also holds the items up to here, see consumer_segment **/
+      index_t                 pulled       = 0;
+      Blocked                 read_stats;
+      /** true between peek and unpeek/recycle **/
+      bool                    busy         = false;
+   } consumer;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      /** posted by grow(), taken by the producer **/
+      std::atomic< segment* >     pending = { nullptr };
+      std::atomic< std::size_t >  cap     = { 0 };
+      std::atomic< bool >         valid   = { true };
+   } control;
+};
+
+/**
+ * ext_alloc types carry pointers to out-of-band objects that come
+ * from the FIFO's slab pool (slabpool.tcc) and are retired through
+ * the kernel's Buffer::Reclaimer on recycle, these keep the heap
+ * implementation (only pointers are copied on resize).
+ */
+template < class T >
+class RingBufferBase<
+    T,
+    Type::Segmented,
+    typename std::enable_if< ext_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::Heap >
+{
+public:
+   RingBufferBase() : RingBufferBase< T, Type::Heap >()
+   {
+   }
+
+   virtual ~RingBufferBase()
+   {
+      delete( (this)->datamanager.get() );
+   }
+
+protected:
+   void grow( Buffer::Data< T, Type::Heap > * const buffer,
+              volatile bool &exit_alloc )
+   {
+      (this)->resize_buffer( buffer, exit_alloc );
+   }
+
+   void set_buffer( Buffer::Data< T, Type::Heap > * const buffer ) noexcept
+   {
+      (this)->datamanager.set( buffer );
+      (this)->init();
+   }
+};
+
+#endif /* END RAFTRINGBUFFERSEGMENTED_TCC */
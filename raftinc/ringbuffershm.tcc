@@ -1,10 +1,26 @@
 /**
- * ringbuffershm.tcc - 
+ * ringbuffershm.tcc - single producer, single consumer ring buffer
+ * whose ends live in different processes. Indices, per-slot signals
+ * and items all sit in one POSIX shared memory segment (see
+ * shmsegment.hpp), the FIFO object on each side is a process local
+ * view of it. Same free-running head/tail protocol as the lock-free
+ * SPSC FIFO, the indices are lock free atomics so they work across
+ * address spaces, each side keeps a cached copy of the other's
+ * index so the shared lines are only touched when the queue looks
+ * full/empty.
+ *
+ * Restrictions: items have to satisfy shm_alloc (inline, trivially
+ * copyable, anything else exits at allocation), the capacity is fixed
+ * when the producer creates the segment (resize is a no-op, size the
+ * edge with the link buffer parameter), one consumer per segment and
+ * the Park wait policy degrades to Yield since the futex wakeups
+ * are process local.
+ *
  * @author: Jonathan Beard
- * @version: Sun Sep 11 05:03:58 2016
- * 
- * Copyright 2016 Jonathan Beard
- * 
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
  * Licensed under the Apache License, Version 2.0 (the "License");
  * you may not use this file except in compliance with the License.
  * You may obtain a copy of the License at:
@@ -20,399 +36,253 @@
 #ifndef RAFTRINGBUFFERSHM_TCC
 #define RAFTRINGBUFFERSHM_TCC  1
 
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
 #include "portexception.hpp"
-#include "ringbufferheap_abstract.tcc"
-#include "defs.hpp"
+#include "ringbufferheap_lessabstract.tcc"
+#include "shmsegment.hpp"
 #include "alloc_traits.tcc"
-#include "prefetch.hpp"
 #include "defs.hpp"
-#include "sysschedutil.hpp"
+#include "internaldefs.hpp"
 
-
-/** inline alloc **/
 template < class T >
 class RingBufferBase<
     T,
     Type::SharedMemory,
-    typename std::enable_if< inline_nonclass_alloc< T >::value >::type >
-: public RingBufferBaseHeap< T, Type::SharedMemory >
+    typename std::enable_if< shm_alloc< T >::value >::type >
+: public RingBufferBaseHeapAbstract< T, Type::Heap >
 {
+   using index_t  = Buffer::SHMSegment::index_t;
+   using buffer_t = Buffer::Data< T, Type::Heap >;
 public:
-   RingBufferBase() : RingBufferBaseHeap< T, Type::SharedMemory >()
+   RingBufferBase() : RingBufferBaseHeapAbstract< T, Type::Heap >()
    {
    }
 
-   virtual ~RingBufferBase() = default;
+   /** the buffer only wraps the segment's store **/
+   virtual ~RingBufferBase()
+   {
+      delete( (this)->datamanager.get() );
+   }
 
-   virtual void deallocate()
+   virtual std::size_t size() noexcept
    {
-      /**
-       * at this point nothing has been allocated 
-       * externally, and the write pointer hasn't been
-       * incremented so just unset the allocate flag
-       * and then signal the data manager that we're
-       * exiting the buffer 
-       */
-      (this)->producer_data.allocate_called = false;
-      (this)->datamanager.exitBuffer( dm::allocate );
+      const auto h( header->consumer.head.load( std::memory_order_acquire ) );
+      const auto t( header->producer.tail.load( std::memory_order_acquire ) );
+      const auto n( static_cast< std::size_t >( t - h ) );
+      return( n > cap ? cap : n );
+   }
+
+   virtual std::size_t space_avail()
+   {
+      return( cap - (this)->size() );
+   }
+
+   virtual std::size_t capacity()
+   {
+      return( cap );
    }
 
    /**
-    * send- releases the last item allocated by allocate() to
-    * the queue.  Function will imply return if allocate wasn't
-    * called prior to calling this function.
-    * @param signal - const raft::signal signal, default: NONE
+    * invalidate - on the producer side this closes the queue for
+    * the other process as well, on the consumer side (called once
+    * the local reader of the queue is done) it's local only.
     */
+   virtual void invalidate()
+   {
+      closed.store( true, std::memory_order_release );
+      if( dir == Direction::Producer )
+      {
+         header->producer.valid.store( 0, std::memory_order_release );
+      }
+      (this)->waiter.wake_all();
+   }
+
+   /**
+    * is_invalid - consumer: the producer closed the queue or its
+    * process is gone, the items it published can still be read.
+    * producer: closed and the consumer has attached (from then on
+    * it doesn't need us, the data is in the segment) or the
+    * consumer process is gone.
+    * @return bool
+    */
+   virtual bool is_invalid()
+   {
+      if( dir == Direction::Producer )
+      {
+         if( header->attached.load( std::memory_order_acquire ) == 0 )
+         {
+            return( false );
+         }
+         return( closed.load( std::memory_order_acquire ) || peer_gone() );
+      }
+      return( closed.load( std::memory_order_acquire ) ||
+              header->producer.valid.load( std::memory_order_acquire ) == 0 ||
+              peer_gone() );
+   }
+
+   virtual void deallocate()
+   {
+      (this)->producer_data.allocate_called = false;
+   }
+
    virtual void send( const raft::signal signal = raft::none )
    {
       if( R_UNLIKELY( ! (this)->producer_data.allocate_called ) )
       {
          return;
       }
-      /** should be the end of the write, regardless of which allocate called **/
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-      buff_ptr->signal[ write_index ] = signal;
+      const auto t( header->producer.tail.load( std::memory_order_relaxed ) );
+      sigs[ slot( t ) ] = signal;
       (this)->producer_data.write_stats->bec.count++;
       (this)->producer_data.allocate_called = false;
-      Pointer::inc( buff_ptr->write_pt );
-      (this)->datamanager.exitBuffer( dm::allocate );
+      header->producer.tail.store( t + 1, std::memory_order_release );
+      (this)->waiter.produced();
    }
 
-   /**
-    * send_range - releases the last item allocated by allocate_range() to
-    * the queue.  Function will imply return if allocate wasn't
-    * called prior to calling this function.
-    * @param signal - const raft::signal signal, default: NONE
-    */
+   /** send_range - signal goes with the first item, as on the heap FIFO **/
    virtual void send_range( const raft::signal signal = raft::none )
    {
       if( ! (this)->producer_data.allocate_called )
       {
-        return;
+         return;
       }
-      /** should be the end of the write, regardless of which allocate called **/
-      const size_t write_index( Pointer::val( (this)->datamanager.get()->write_pt ) );
-      (this)->datamanager.get()->signal[ write_index ] = signal;
-      /* only need to inc one more **/
       auto &n_allocated( (this)->producer_data.n_allocated );
-      Pointer::incBy( (this)->datamanager.get()->write_pt,
-                      n_allocated );
+      const auto t( header->producer.tail.load( std::memory_order_relaxed ) );
+      for( index_t i( 0 ); i < n_allocated; i++ )
+      {
+         sigs[ slot( t + i ) ] = ( i == 0 ? signal : raft::none );
+      }
       (this)->producer_data.write_stats->bec.count += n_allocated;
       (this)->producer_data.allocate_called = false;
-      n_allocated     = 0;
-      (this)->datamanager.exitBuffer( dm::allocate_range );
+      header->producer.tail.store( t + n_allocated, std::memory_order_release );
+      (this)->waiter.produced();
+      n_allocated = 0;
    }
 
-
-
    virtual void unpeek()
    {
-      (this)->datamanager.exitBuffer( dm::peek );
    }
 
-protected:
+   /** parking needs a wakeup from the other process, yield instead **/
+   virtual void set_wait_policy( const Wait::Policy policy )
+   {
+      (this)->waiter.set_policy( policy == Wait::Park ? Wait::Yield : policy );
+   }
 
+protected:
    /**
-    * removes range items from the buffer, ignores
-    * them without the copy overhead.
+    * attach - take over segment, dir is the end of the queue
+    * this process holds.
     */
+   void attach( Buffer::SHMSegment * const seg, const Direction d )
+   {
+      segment.reset( seg );
+      dir    = d;
+      header = seg->header;
+      sigs   = seg->signals;
+      cap    = static_cast< std::size_t >( header->max_cap );
+      (this)->datamanager.set(
+         new buffer_t( reinterpret_cast< T* >( seg->store ), cap, 0 ) );
+      (this)->init();
+   }
+
    virtual void local_recycle( std::size_t range )
    {
-      if( range == 0 )
+      while( range > 0 && consumer_wait( 1 ) )
       {
-         /** do nothing **/
-         return;
+         const auto h( header->consumer.head.load( std::memory_order_relaxed ) );
+         const auto n( std::min( range,
+            static_cast< std::size_t >( consumer.cached_tail - h ) ) );
+         header->consumer.head.store( h + n, std::memory_order_release );
+         (this)->waiter.consumed();
+         range -= n;
       }
-      do{ /** at least one to remove **/
-         for( ;; )
-         {
-            (this)->datamanager.enterBuffer( dm::recycle );
-            if( (this)->datamanager.notResizing() )
-            {
-               if( (this)->size() > 0 )
-               {
-                  break;
-               }
-               else if( (this)->is_invalid() && (this)->size() == 0 )
-               {
-                  (this)->datamanager.exitBuffer( dm::recycle );
-                  return;
-               }
-            }
-            (this)->datamanager.exitBuffer( dm::recycle );
-            raft::yield();
-         }
-         auto * const buff_ptr( (this)->datamanager.get() );
-         /**
-          * TODO, this whole func can be optimized a bit more
-          * using the incBy func of Pointer
-          */
-         Pointer::inc( buff_ptr->read_pt );
-         (this)->datamanager.exitBuffer( dm::recycle );
-      }while( --range > 0 );
-      return;
    }
 
-
-
-   /**
-    * local_allocate - get a reference to an object of type T at the
-    * end of the queue.  Should be released to the queue using
-    * the push command once the calling thread is done with the
-    * memory.
-    * @return T&, reference to memory location at head of queue
-    */
    virtual void local_allocate( void **ptr )
    {
-      for(;;)
-      {
-         (this)->datamanager.enterBuffer( dm::allocate );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() > 0  )
-         {
-            break;
-         }
-         (this)->datamanager.exitBuffer( dm::allocate );
-         /** else, set stats,  spin **/
-         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
-         if( wr_stats == 0 )
-         {
-            wr_stats = 1;
-         }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
-      }
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-      *ptr = (void*)&( buff_ptr->store[ write_index ] );
+      producer_wait( 1 );
+      const auto t( header->producer.tail.load( std::memory_order_relaxed ) );
+      *ptr = (void*)&( store()[ slot( t ) ] );
       (this)->producer_data.allocate_called = true;
-      /** call exitBuffer during push call **/
    }
 
    virtual void local_allocate_n( void *ptr, const std::size_t n )
    {
-      for( ;; )
-      {
-         (this)->datamanager.enterBuffer( dm::allocate_range );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() >= n )
-         {
-            break;
-         }
-         /** 
-          * if capacity is in fact too little then:
-          * 1) signal exit buffer
-          * 2) spin
-          * 3) hope the resize thread hits soon
-          */
-         if( (this)->capacity() < n )
-         {
-            ((this)->datamanager.get()->force_resize) = n;
-         }
-         (this)->datamanager.exitBuffer( dm::allocate_range );
-         /** else, set stats,  spin **/
-         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
-         if( wr_stats == 0 )
-         {
-            wr_stats = 1;
-         }
-#if __x86_64
-       __asm__ volatile("\
-         pause"
-         :
-         :
-         : );
-#endif
-         raft::yield();
-      }
+      producer_wait( n );
       auto *container(
          reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
-      /**
-       * TODO, fix this condition where the user can ask for more,
-       * double buffer.
-       */
-      /** iterate over range, pause if not enough items **/
-      auto * const buff_ptr( (this)->datamanager.get() );
-      std::size_t write_index( Pointer::val( buff_ptr->write_pt ) );
+      const auto t( header->producer.tail.load( std::memory_order_relaxed ) );
       for( std::size_t index( 0 ); index < n; index++ )
       {
-         /**
-          * TODO, fix this logic here, write index must get iterated, but
-          * not here
-          */
-         container->emplace_back( buff_ptr->store[ write_index ] );
-         buff_ptr->signal[ write_index ] = raft::none;
-         write_index = ( write_index + 1 ) % buff_ptr->max_cap;
+         container->emplace_back( store()[ slot( t + index ) ] );
       }
-      (this)->producer_data.n_allocated = 
+      (this)->producer_data.n_allocated =
         static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
       (this)->producer_data.allocate_called = true;
-      /** exitBuffer() called by push_range **/
    }
 
-
-   /**
-    * local_push - implements the pure virtual function from the
-    * FIFO interface.  Takes a void ptr as the object which is
-    * cast into the correct form and an raft::signal signal. If
-    * the ptr is null, then the signal is pushed and the item
-    * is junk.  This is an internal method so the only case where
-    * ptr should be null is in the case of a system signal being
-    * sent.
-    * @param   item, void ptr
-    * @param   signal, const raft::signal&
-    */
-   virtual void  local_push( void *ptr, const raft::signal &signal )
+   /** local_push - if ptr is null only the signal is pushed **/
+   virtual void local_push( void *ptr, const raft::signal &signal )
    {
-      for(;;)
-      {
-         (this)->datamanager.enterBuffer( dm::push );
-         if( (this)->datamanager.notResizing() )
-         {
-            if( (this)->space_avail() > 0 )
-            {
-               break;
-            }
-         }
-         (this)->datamanager.exitBuffer( dm::push );
-         /** else, set stats,  spin **/
-         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
-         if( wr_stats == 0 )
-         {
-            wr_stats = 1;
-         }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
-      }
-      auto * const buff_ptr( (this)->datamanager.get() );
-       const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
+      producer_wait( 1 );
+      const auto t( header->producer.tail.load( std::memory_order_relaxed ) );
+      const auto write_index( slot( t ) );
       if( ptr != nullptr )
       {
-         T *item( reinterpret_cast< T* >( ptr ) );
-          buff_ptr->store[ write_index ]          = *item;
-          (this)->producer_data.write_stats->bec.count++;
-       }
-      buff_ptr->signal[ write_index ]         = signal;
-#if defined(__aarch64__)
-      asm volatile( "dmb ishst" : : : "memory" ); /** memory write barrier **/
-#endif
-       Pointer::inc( buff_ptr->write_pt );
-      (this)->datamanager.exitBuffer( dm::push );
+         std::memcpy( (void*)&store()[ write_index ], ptr, sizeof( T ) );
+         (this)->producer_data.write_stats->bec.count++;
+      }
+      sigs[ write_index ] = signal;
+      header->producer.tail.store( t + 1, std::memory_order_release );
+      (this)->waiter.produced();
    }
 
-   /**
-    * local_pop - read one item from the ring buffer,
-    * will block till there is data to be read.  If
-    * ptr == nullptr then the item is just thrown away.
-    * @return  T, item read.  It is removed from the
-    *          q as soon as it is read
-    */
-   virtual void
-   local_pop( void *ptr, raft::signal *signal )
+   virtual void local_pop( void *ptr, raft::signal *signal )
    {
-      for(;;)
+      if( R_UNLIKELY( ! consumer_wait( 1 ) ) )
       {
-         (this)->datamanager.enterBuffer( dm::pop );
-         if( (this)->datamanager.notResizing() )
-         {
-            if( (this)->size() > 0 )
-            {
-               break;
-            }
-            else if( (this)->is_invalid() && (this)->size() == 0 )
-            {
-               throw ClosedPortAccessException(
-                  "Accessing closed port with pop call, exiting!!" );
-            }
-         }
-         else
-         {
-            (this)->datamanager.exitBuffer( dm::pop );
-            /** handle stats **/
-            auto &rd_stats( (this)->consumer_data.read_stats->bec.blocked );
-            if( rd_stats == 0 )
-            {
-               rd_stats  = 1;
-            }
-            raft::yield();
-         }
+         throw ClosedPortAccessException(
+            "Accessing closed port with pop call, exiting!!" );
       }
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const std::size_t read_index( Pointer::val( buff_ptr->read_pt ) );
+      const auto h( header->consumer.head.load( std::memory_order_relaxed ) );
+      const auto read_index( slot( h ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = sigs[ read_index ];
+      }
+      if( ptr != nullptr )
+      {
+         std::memcpy( ptr, (void*)&store()[ read_index ], sizeof( T ) );
+         (this)->consumer_data.read_stats->bec.count++;
       }
-      assert( ptr != nullptr );
-      /** gotta dereference pointer and copy **/
-      T *item( reinterpret_cast< T* >( ptr ) );
-      *item = buff_ptr->store[ read_index ];
-      /** only increment here b/c we're actually reading an item **/
-      (this)->consumer_data.read_stats->bec.count++;
-      Pointer::inc( buff_ptr->read_pt );
-      (this)->datamanager.exitBuffer( dm::pop );
+      header->consumer.head.store( h + 1, std::memory_order_release );
+      (this)->waiter.consumed();
    }
 
-
-   /**
-    * local_peek() - look at a reference to the head of the
-    * ring buffer.  This doesn't remove the item, but it
-    * does give the user a chance to take a look at it without
-    * removing.
-    * @return T&
-    */
-   virtual void local_peek(  void **ptr, raft::signal *signal )
+   virtual void local_peek( void **ptr, raft::signal *signal )
    {
-      for(;;)
+      if( R_UNLIKELY( ! consumer_wait( 1 ) ) )
       {
-
-         (this)->datamanager.enterBuffer( dm::peek );
-         if( (this)->datamanager.notResizing() )
-         {
-            if( (this)->size() > 0  )
-            {
-               break;
-            }
-            else if( (this)->is_invalid() && (this)->size() == 0 )
-            {
-               throw ClosedPortAccessException(
-                  "Accessing closed port with local_peek call, exiting!!" );
-            }
-         }
-         (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         throw ClosedPortAccessException(
+            "Accessing closed port with local_peek call, exiting!!" );
       }
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const auto read_index( Pointer::val( buff_ptr->read_pt ) );
+      const auto read_index(
+         slot( header->consumer.head.load( std::memory_order_relaxed ) ) );
       if( signal != nullptr )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         *signal = sigs[ read_index ];
       }
-      *ptr = reinterpret_cast< void* >( &( buff_ptr->store[ read_index ] ) );
-      return;
-      /**
-       * exitBuffer() called when recycle is called, can't be sure the
-       * reference isn't being used until all outside accesses to it are
-       * invalidated from the buffer.
-       */
+      *ptr = reinterpret_cast< void* >( &( store()[ read_index ] ) );
    }
 
    virtual void local_peek_range( void **ptr,
@@ -420,489 +290,234 @@ protected:
                                   const std::size_t n,
                                   std::size_t &curr_pointer_loc )
    {
-      for(;;)
+      if( R_UNLIKELY( ! consumer_wait( n ) ) )
       {
-
-         (this)->datamanager.enterBuffer( dm::peek );
-         if( (this)->datamanager.notResizing() )
+         if( (this)->size() == 0 )
          {
-            if( (this)->size() >= n  )
-            {
-               break;
-            }
-            else if( (this)->is_invalid() && (this)->size() == 0 )
-            {
-               throw ClosedPortAccessException(
-                  "Accessing closed port with local_peek_range call, exiting!!" );
-            }
-            else if( (this)->is_invalid() && (this)->size() < n )
-            {
-               throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
-            }
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_range call, exiting!!" );
          }
-         (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
       }
-
-      /**
-       * TODO, fix this condition where the user can ask for more,
-       * double buffer.
-       */
-      /** iterate over range, pause if not enough items **/
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const std::size_t cpl( Pointer::val( buff_ptr->read_pt ) );
-      curr_pointer_loc = cpl;
-      *sig =  reinterpret_cast< void* >(  &buff_ptr->signal[ cpl ] );
-      *ptr =  buff_ptr->store;
-      return;
+      const auto h( header->consumer.head.load( std::memory_order_relaxed ) );
+      curr_pointer_loc = slot( h );
+      *sig = reinterpret_cast< void* >( range_signals( h, n ) );
+      *ptr = reinterpret_cast< void* >( store() );
    }
 
-};
-
-/*********************************
- FOR SHM, ALL CLASSES ARE ALLOCATED INLINE
- *********************************/
-template < class T >
-class RingBufferBase<
-    T,
-    Type::SharedMemory,
-    typename std::enable_if< ! inline_nonclass_alloc< T >::value >::type >
-: public RingBufferBaseHeap< T, Type::SharedMemory >
-{
-public:
-   RingBufferBase() : RingBufferBaseHeap< T, Type::SharedMemory >()
+   virtual void local_allocate_span( void **store_ptr,
+                                     std::size_t &n,
+                                     std::size_t &start,
+                                     std::size_t &queue_size,
+                                     const bool contiguous )
    {
+      producer_wait( n );
+      const auto t( header->producer.tail.load( std::memory_order_relaxed ) );
+      start      = slot( t );
+      queue_size = cap;
+      if( contiguous )
+      {
+         n = std::min( n, queue_size - start );
+      }
+      *store_ptr = reinterpret_cast< void* >( store() );
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
    }
 
-   virtual ~RingBufferBase() = default;
-
-   virtual void deallocate()
-   {
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const auto read_index( Pointer::val( buff_ptr->read_pt ) );
-      auto * const ptr = reinterpret_cast< T* >( &( buff_ptr->store[ read_index ] ) );
-      /** destruct **/
-      ptr->~T();
-      (this)->producer_data.allocate_called = false;
-      (this)->datamanager.exitBuffer( dm::allocate );
-   }
-
-    /**
-     * send- releases the last item allocated by allocate() to
-     * the queue.  Function will imply return if allocate wasn't
-     * called prior to calling this function.
-     * @param signal - const raft::signal signal, default: NONE
-     */
-    virtual void send( const raft::signal signal = raft::none )
-    {
-        if( R_UNLIKELY( ! (this)->producer_data.allocate_called ) )
-        {
-           return;
-        }
-        /** should be the end of the write, regardless of which allocate called **/
-        auto * const buff_ptr( (this)->datamanager.get() );
-        const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-        buff_ptr->signal[ write_index ] = signal;
-        (this)->producer_data.write_stats->bec.count++;
-        (this)->producer_data.allocate_called = false;
-        Pointer::inc( buff_ptr->write_pt );
-        (this)->datamanager.exitBuffer( dm::allocate );
-    }
-
-   /**
-    * send_range - releases the last item allocated by allocate_range() to
-    * the queue.  Function will imply return if allocate wasn't
-    * called prior to calling this function.
-    * @param signal - const raft::signal signal, default: NONE
-    */
-   virtual void send_range( const raft::signal signal = raft::none )
+   virtual void local_peek_span( void **store_ptr,
+                                 const std::size_t n,
+                                 std::size_t &start,
+                                 std::size_t &queue_size )
    {
-        if( ! (this)->producer_data.allocate_called )
-        {
-            return;
-        }
-        auto * const buff_ptr( (this)->datamanager.get() );
-        /** should be the end of the write, regardless of which allocate called **/
-        const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-        buff_ptr->signal[ write_index ] = signal;
-        /* only need to inc one more, the rest have already**/
-        auto &n_allocated( (this)->producer_data.n_allocated );
-        Pointer::incBy( buff_ptr->write_pt,
-                        n_allocated );
-        
-        (this)->producer_data.write_stats->bec.count += n_allocated;
-        /** cleanup **/
-        (this)->producer_data.allocate_called = false;
-        n_allocated     = 0;
-        (this)->datamanager.exitBuffer( dm::allocate_range );
+      if( R_UNLIKELY( ! consumer_wait( n ) ) )
+      {
+         if( (this)->size() == 0 )
+         {
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_span call, exiting!!" );
+         }
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+      }
+      start      = slot( header->consumer.head.load( std::memory_order_relaxed ) );
+      queue_size = cap;
+      *store_ptr = reinterpret_cast< void* >( store() );
    }
 
-
-   virtual void unpeek()
+   virtual raft::signal signal_peek()
    {
-      (this)->datamanager.exitBuffer( dm::peek );
-   }
-
-protected:
-
-   /**
-    * removes range items from the buffer, ignores
-    * them without the copy overhead.
-    */
-   virtual void local_recycle( std::size_t range )
-   {
-      if( range == 0 )
+      const auto h( header->consumer.head.load( std::memory_order_relaxed ) );
+      if( header->producer.tail.load( std::memory_order_acquire ) == h )
       {
-         /** do nothing **/
-         return;
+         return( raft::none );
       }
-      do{ /** at least one to remove **/
-         for( ;; )
-         {
-            (this)->datamanager.enterBuffer( dm::recycle );
-            if( (this)->datamanager.notResizing() )
-            {
-               if( (this)->size() > 0 )
-               {
-                  break;
-               }
-               else if( (this)->is_invalid() && (this)->size() == 0 )
-               {
-                  (this)->datamanager.exitBuffer( dm::recycle );
-                  return;
-               }
-            }
-            (this)->datamanager.exitBuffer( dm::recycle );
-            raft::yield();
-         }
-         auto * const buff_ptr( (this)->datamanager.get() );
-         const size_t read_index( Pointer::val( buff_ptr->read_pt ) );
-         auto *ptr =
-            reinterpret_cast< T* >( &( buff_ptr->store[ read_index ] ) );
-         /** call destructor direct, faster than recyle func **/
-         ptr->~T();
-         Pointer::inc( buff_ptr->read_pt );
-         (this)->datamanager.exitBuffer( dm::recycle );
-      }while( --range > 0 );
-      return;
+      return( sigs[ slot( h ) ] );
    }
 
-
+private:
+   /** blocked/invalid checks between two peer liveness syscalls **/
+   static constexpr std::uint32_t liveness_interval = 1024;
 
    /**
-    * local_allocate - get a reference to an object of type T at the
-    * end of the queue.  Should be released to the queue using
-    * the push command once the calling thread is done with the
-    * memory.
-    * @return T&, reference to memory location at head of queue
+    * producer_wait - wait until there are at least n free slots,
+    * throws if the consumer process went away in the meantime.
     */
-   virtual void local_allocate( void **ptr )
+   void producer_wait( const std::size_t n )
    {
-      for(;;)
+      for( ;; )
       {
-         (this)->datamanager.enterBuffer( dm::allocate );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() > 0  )
+         const auto t( header->producer.tail.load( std::memory_order_relaxed ) );
+         if( R_LIKELY( cap - ( t - producer.cached_head ) >= n ) )
          {
-            break;
+            return;
          }
-         (this)->datamanager.exitBuffer( dm::allocate );
-         /** else, set stats,  spin **/
-         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
-         if( wr_stats == 0 )
+         producer.cached_head = header->consumer.head.load( std::memory_order_acquire );
+         if( cap - ( t - producer.cached_head ) >= n )
          {
-            wr_stats = 1;
+            return;
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
-      }
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-      *ptr = (void*)&( buff_ptr->store[ write_index ] );
-      (this)->producer_data.allocate_called = true;
-      /** call exitBuffer during push call **/
-   }
-
-   virtual void local_allocate_n( void *ptr, const std::size_t n )
-   {
-      for( ;; )
-      {
-         (this)->datamanager.enterBuffer( dm::allocate_range );
-         if( (this)->datamanager.notResizing() && (this)->space_avail() >= n )
+         if( R_UNLIKELY( cap < n ) )
          {
-            break;
+            std::cerr << "request for " << n << " items on a shared memory "
+               << "FIFO with fixed capacity " << cap << ", exiting!\n";
+            exit( EXIT_FAILURE );
          }
-         (this)->datamanager.exitBuffer( dm::allocate_range );
-         /** else, set stats,  spin **/
          auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
          if( wr_stats == 0 )
          {
             wr_stats = 1;
          }
-#if __x86_64
-       __asm__ volatile("\
-         pause"
-         :
-         :
-         : );
-#endif
-         raft::yield();
-      }
-      auto *container(
-         reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
-      /**
-       * TODO, fix this condition where the user can ask for more,
-       * double buffer.
-       */
-      /** iterate over range, pause if not enough items **/
-      auto * const buff_ptr( (this)->datamanager.get() );
-      std::size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-      for( std::size_t index( 0 ); index < n; index++ )
-      {
-         /**
-          * TODO, fix this logic here, write index must get iterated, but
-          * not here
-          */
-         container->emplace_back( buff_ptr->store[ write_index ] );
-         buff_ptr->signal[ write_index ] = raft::none;
-         write_index = ( write_index + 1 ) % buff_ptr->max_cap;
+         if( R_UNLIKELY( peer_gone() ) )
+         {
+            throw ClosedPortAccessException(
+               "Consumer of shared memory FIFO is gone, exiting!!" );
+         }
+         (this)->waiter.producer_block();
       }
-      (this)->producer_data.n_allocated = 
-        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
-      (this)->producer_data.allocate_called = true;
-      /** exitBuffer() called by push_range **/
    }
 
-
    /**
-    * local_push - implements the pure virtual function from the
-    * FIFO interface.  Takes a void ptr as the object which is
-    * cast into the correct form and an raft::signal signal. If
-    * the ptr is null, then the signal is pushed and the item
-    * is junk.  This is an internal method so the only case where
-    * ptr should be null is in the case of a system signal being
-    * sent.
-    * @param   item, void ptr
-    * @param   signal, const raft::signal&
+    * consumer_wait - wait until there are at least n items
+    * available, false if the producer has gone away and fewer
+    * than n items remain.
     */
-   virtual void  local_push( void *ptr, const raft::signal &signal )
+   bool consumer_wait( const std::size_t n )
    {
-      for(;;)
+      for( ;; )
       {
-         (this)->datamanager.enterBuffer( dm::push );
-         if( (this)->datamanager.notResizing() )
+         const auto h( header->consumer.head.load( std::memory_order_relaxed ) );
+         if( R_LIKELY( consumer.cached_tail - h >= n ) )
          {
-            if( (this)->space_avail() > 0 )
-            {
-               break;
-            }
+            return( true );
          }
-         (this)->datamanager.exitBuffer( dm::push );
-         /** else, set stats,  spin **/
-         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
-         if( wr_stats == 0 )
+         consumer.cached_tail = header->producer.tail.load( std::memory_order_acquire );
+         if( consumer.cached_tail - h >= n )
          {
-            wr_stats = 1;
+            return( true );
          }
-#if __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
-      }
-      auto * const buff_ptr( (this)->datamanager.get() );
-       const size_t write_index( Pointer::val( buff_ptr->write_pt ) );
-      if( ptr != nullptr )
-      {
-          T *item( reinterpret_cast< T* >( ptr ) );
-          T * temp( new (
-            &buff_ptr->store[ write_index ]
-          ) T( *item  ) );
-          UNUSED( temp );
-          (this)->producer_data.write_stats->bec.count++;
-       }
-      buff_ptr->signal[ write_index ]         = signal;
-#if defined(__aarch64__)
-      asm volatile( "dmb ishst" : : : "memory" ); /** memory write barrier **/
-#endif
-       Pointer::inc( buff_ptr->write_pt );
-#if 0
-      if( signal == raft::quit )
-      {
-         (this)->write_finished = true;
+         if( (this)->is_invalid() )
+         {
+            /** re-check, the last push happens before invalidate **/
+            consumer.cached_tail =
+               header->producer.tail.load( std::memory_order_acquire );
+            return( consumer.cached_tail - h >= n );
+         }
+         auto &rd_stats( (this)->consumer_data.read_stats->bec.blocked );
+         if( rd_stats == 0 )
+         {
+            rd_stats = 1;
+         }
+         (this)->waiter.consumer_block();
       }
-#endif      
-      (this)->datamanager.exitBuffer( dm::push );
    }
 
    /**
-    * local_pop - read one item from the ring buffer,
-    * will block till there is data to be read.  If
-    * ptr == nullptr then the item is just thrown away.
-    * @return  T, item read.  It is removed from the
-    *          q as soon as it is read
+    * peer_gone - rate limited SHMSegment::peer_alive, called from
+    * both the kernel using the port and the scheduler.
     */
-   virtual void
-   local_pop( void *ptr, raft::signal *signal )
+   bool peer_gone() noexcept
    {
-      for(;;)
+      if( R_LIKELY( ( liveness_checks.fetch_add( 1, std::memory_order_relaxed ) %
+                      liveness_interval ) != 0 ) )
       {
-         (this)->datamanager.enterBuffer( dm::pop );
-         if( (this)->datamanager.notResizing() )
-         {
-            if( (this)->size() > 0 )
-            {
-               break;
-            }
-            else if( (this)->is_invalid() && (this)->size() == 0 )
-            {
-               throw ClosedPortAccessException(
-                  "Accessing closed port with pop call, exiting!!" );
-            }
-         }
-         else
-         {
-            (this)->datamanager.exitBuffer( dm::pop );
-            /** handle stats **/
-            auto &rd_stats( (this)->consumer_data.read_stats->bec.blocked );
-            if( rd_stats == 0 )
-            {
-               rd_stats  = 1;
-            }
-            raft::yield();
-         }
-      }
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const std::size_t read_index( Pointer::val( buff_ptr->read_pt ) );
-      if( signal != nullptr )
-      {
-         *signal = buff_ptr->signal[ read_index ];
+         return( false );
       }
-      assert( ptr != nullptr );
-      /** gotta dereference pointer and copy **/
-      T *item( reinterpret_cast< T* >( ptr ) );
-      *item = buff_ptr->store[ read_index ];
-      /** only increment here b/c we're actually reading an item **/
-      (this)->consumer_data.read_stats->bec.count++;
-      Pointer::inc( buff_ptr->read_pt );
-      (this)->datamanager.exitBuffer( dm::pop );
+      return( ! segment->peer_alive() );
    }
 
-
    /**
-    * local_peek() - look at a reference to the head of the
-    * ring buffer.  This doesn't remove the item, but it
-    * does give the user a chance to take a look at it without
-    * removing.
-    * @return T&
+    * range_signals - copy the signals for the next n items out of
+    * the segment into consumer scratch space for peek_range.
     */
-   virtual void local_peek(  void **ptr, raft::signal *signal )
+   Buffer::Signal* range_signals( const index_t pos, const std::size_t n )
    {
-      for(;;)
+      auto &scratch( (this)->consumer_data.range_signals );
+      if( scratch.size() < n || scratch.empty() )
       {
-
-         (this)->datamanager.enterBuffer( dm::peek );
-         if( (this)->datamanager.notResizing() )
-         {
-            if( (this)->size() > 0  )
-            {
-               break;
-            }
-            else if( (this)->is_invalid() && (this)->size() == 0 )
-            {
-               throw ClosedPortAccessException(
-                  "Accessing closed port with local_peek call, exiting!!" );
-            }
-         }
-         (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
-#endif
-         raft::yield();
+         scratch.resize( std::max( n, std::size_t( 1 ) ) );
       }
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const size_t read_index( Pointer::val( buff_ptr->read_pt ) );
-      if( signal != nullptr )
+      for( std::size_t i( 0 ); i < n; i++ )
       {
-         *signal = buff_ptr->signal[ read_index ];
+         scratch[ i ] = static_cast< raft::signal >( sigs[ slot( pos + i ) ] );
       }
-      *ptr = (void*) &( buff_ptr->store[ read_index ] );
-      return;
-      /**
-       * exitBuffer() called when recycle is called, can't be sure the
-       * reference isn't being used until all outside accesses to it are
-       * invalidated from the buffer.
-       */
+      scratch[ 0 ].index = (this)->datamanager.get()->start_index;
+      return( scratch.data() );
    }
 
-   virtual void local_peek_range( void **ptr,
-                                  void **sig,
-                                  const std::size_t n,
-                                  std::size_t &curr_pointer_loc )
+   inline T* store() noexcept
    {
-      for(;;)
-      {
+      return( (this)->datamanager.get()->store );
+   }
 
-         (this)->datamanager.enterBuffer( dm::peek );
-         if( (this)->datamanager.notResizing() )
-         {
-            if( (this)->size() >= n  )
-            {
-               break;
-            }
-            else if( (this)->is_invalid() && (this)->size() == 0 )
-            {
-               throw ClosedPortAccessException(
-                  "Accessing closed port with local_peek_range call, exiting!!" );
-            }
-            else if( (this)->is_invalid() && (this)->size() < n )
-            {
-               throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
-            }
-         }
-         (this)->datamanager.exitBuffer( dm::peek );
-#if  __x86_64
-         __asm__ volatile("\
-           pause"
-           :
-           :
-           : );
+   /** slot - cap is a power of two when POW2_BUFFER is set **/
+   inline std::size_t slot( const index_t i ) const noexcept
+   {
+#ifdef POW2_BUFFER
+      return( static_cast< std::size_t >( i & ( cap - 1 ) ) );
+#else
+      return( static_cast< std::size_t >( i % cap ) );
 #endif
-         raft::yield();
-      }
+   }
+
+   std::unique_ptr< Buffer::SHMSegment >  segment;
+   Buffer::SHMSegment::header_t          *header  = nullptr;
+   raft::signal                          *sigs    = nullptr;
+   std::size_t                            cap     = 0;
+   Direction                              dir     = Direction::Producer;
 
-      /**
-       * TODO, fix this condition where the user can ask for more,
-       * double buffer.
-       */
-      /** iterate over range, pause if not enough items **/
-      auto * const buff_ptr( (this)->datamanager.get() );
-      const auto cpl( Pointer::val( buff_ptr->read_pt ) );
-      curr_pointer_loc = cpl;
-      *sig =  reinterpret_cast< void* >(  &buff_ptr->signal[ cpl ] );
-      *ptr =  buff_ptr->store;
-      return;
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      /** producer's copy of head, refreshed when the queue looks full **/
+      index_t                 cached_head = 0;
+   } producer;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      /** consumer's copy of tail, refreshed when the queue looks empty **/
+      index_t                 cached_tail = 0;
+   } consumer;
+
+   std::atomic< bool >            closed          = { false };
+   std::atomic< std::uint32_t >   liveness_checks = { 0 };
+};
+
+/**
+ * anything else can't cross a process boundary as raw bytes, the
+ * spec only exists so every port type can register SharedMemory,
+ * RingBuffer< T, Type::SharedMemory >::make_new_fifo refuses to
+ * build these.
+ */
+template < class T >
+class RingBufferBase<
+    T,
+    Type::SharedMemory,
+    typename std::enable_if< ! shm_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::Heap >
+{
+public:
+   RingBufferBase() : RingBufferBase< T, Type::Heap >()
+   {
    }
 
+   virtual ~RingBufferBase() = default;
 };
 
 #endif /* END RAFTRINGBUFFERSHM_TCC */
@@ -0,0 +1,671 @@
+/**
+ * ringbufferspsc.tcc - lock-free single producer, single consumer
+ * ring buffer. Storage is the same Buffer::Data< T, Type::Heap >
+ * used by the heap FIFO, however the read/write positions are
+ * free-running 64b counters published with acquire/release
+ * semantics instead of Pointer objects guarded by the DataManager
+ * enter/exit handshake. Resizing is done through a quiescent state
+ * protocol, see quiescent_resize below.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTRINGBUFFERSPSC_TCC
+#define RAFTRINGBUFFERSPSC_TCC  1
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "portexception.hpp"
+#include "ringbufferheap_lessabstract.tcc"
+#include "alloc_traits.tcc"
+#include "defs.hpp"
+#include "internaldefs.hpp"
+/** for yield **/
+#include "sysschedutil.hpp"
+
+template < class T >
+class RingBufferBase<
+    T,
+    Type::LockFreeSPSC,
+    typename std::enable_if< inline_alloc< T >::value >::type >
+: public RingBufferBaseHeapAbstract< T, Type::Heap >
+{
+   using index_t  = std::uint64_t;
+   using buffer_t = Buffer::Data< T, Type::Heap >;
+public:
+   RingBufferBase() : RingBufferBaseHeapAbstract< T, Type::Heap >()
+   {
+   }
+
+   virtual ~RingBufferBase() = default;
+
+   /**
+    * size - number of items currently in the queue, safe
+    * to call from any thread, never touches the buffer. head
+    * is read first so that the tail read after it can't be
+    * behind it.
+    * @return std::size_t
+    */
+   virtual std::size_t size() noexcept
+   {
+      const auto h( consumer.head.load( std::memory_order_acquire ) );
+      const auto t( producer.tail.load( std::memory_order_acquire ) );
+      const auto c( control.cap.load( std::memory_order_relaxed ) );
+      const auto n( static_cast< std::size_t >( t - h ) );
+      return( n > c ? c : n );
+   }
+
+   virtual std::size_t space_avail()
+   {
+      return( (this)->capacity() - (this)->size() );
+   }
+
+   virtual std::size_t capacity()
+   {
+      return( control.cap.load( std::memory_order_relaxed ) );
+   }
+
+   /**
+    * invalidate - the valid flag lives in the FIFO object
+    * rather than in the buffer so that a producer exiting
+    * while a resize is in flight can't write it to a buffer
+    * that is about to be freed.
+    */
+   virtual void invalidate()
+   {
+      control.valid.store( false, std::memory_order_release );
+      (this)->waiter.wake_all();
+   }
+
+   virtual bool is_invalid()
+   {
+      return( ! control.valid.load( std::memory_order_acquire ) );
+   }
+
+   virtual void deallocate()
+   {
+      auto * const buff_ptr( (this)->datamanager.get() );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      destroy( &buff_ptr->store[ slot( t, buff_ptr ) ] );
+      (this)->producer_data.allocate_called = false;
+   }
+
+   /**
+    * send- releases the last item allocated by allocate() to
+    * the queue.  Function will imply return if allocate wasn't
+    * called prior to calling this function.
+    * @param signal - const raft::signal signal, default: NONE
+    */
+   virtual void send( const raft::signal signal = raft::none )
+   {
+      if( R_UNLIKELY( ! (this)->producer_data.allocate_called ) )
+      {
+         return;
+      }
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      (this)->signals.send( t, signal );
+      (this)->producer_data.write_stats->bec.count++;
+      (this)->producer_data.allocate_called = false;
+      producer.tail.store( t + 1, std::memory_order_release );
+      (this)->waiter.produced();
+   }
+
+   /**
+    * send_range - releases the items allocated by allocate_range()
+    * to the queue, signal goes with the first item of the range
+    * as it does on the heap FIFO.
+    * @param signal - const raft::signal signal, default: NONE
+    */
+   virtual void send_range( const raft::signal signal = raft::none )
+   {
+      if( ! (this)->producer_data.allocate_called )
+      {
+         return;
+      }
+      auto &n_allocated( (this)->producer_data.n_allocated );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      (this)->signals.send( t, signal );
+      (this)->producer_data.write_stats->bec.count += n_allocated;
+      (this)->producer_data.allocate_called = false;
+      producer.tail.store( t + n_allocated, std::memory_order_release );
+      (this)->waiter.produced();
+      n_allocated = 0;
+   }
+
+   virtual void unpeek()
+   {
+      consumer.busy = false;
+   }
+
+protected:
+
+   /** consumer about to sleep, don't hold up a resize until it pops **/
+   virtual void quiesce()
+   {
+      if( ! consumer.busy )
+      {
+         checkpoint( consumer.ack );
+      }
+   }
+
+   /**
+    * quiescent_resize - move the contents of the current buffer
+    * into new_buffer. A resize bumps the epoch to an odd value,
+    * each side acknowledges it the next time it enters the queue
+    * (or while it is spinning on a full/empty queue) and then waits
+    * for the epoch to move on. Once both sides have acknowledged
+    * the resizing thread owns the buffer outright. If exit_alloc is
+    * set, the queue is invalidated or the acks don't show up in a
+    * reasonable amount of time (e.g., the producer is blocked on
+    * another queue the consumer feeds from) the resize is abandoned,
+    * the allocator will simply try again later.
+    * @param   new_buffer - buffer_t*, new buffer, freed here if abandoned,
+    *                       smaller only if the items still fit
+    * @param   exit_alloc - set by the allocator when the app is done
+    */
+   void quiescent_resize( buffer_t * const new_buffer, volatile bool &exit_alloc )
+   {
+      /** bind before relocating faults the pages in **/
+      (this)->datamanager.prepare( new_buffer );
+      const auto e( control.epoch.fetch_add( 1, std::memory_order_acq_rel ) + 1 );
+      const auto deadline( std::chrono::steady_clock::now() + quiesce_timeout );
+      /** parked sides have to come out to acknowledge **/
+      (this)->waiter.wake_all();
+      while( producer.ack.load( std::memory_order_acquire ) != e ||
+             consumer.ack.load( std::memory_order_acquire ) != e )
+      {
+         if( exit_alloc || (this)->is_invalid() ||
+             std::chrono::steady_clock::now() > deadline )
+         {
+            control.epoch.store( e + 1, std::memory_order_release );
+            delete( new_buffer );
+            return;
+         }
+         std::this_thread::yield();
+      }
+      auto * const old_buffer( (this)->datamanager.get() );
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      if( new_buffer->max_cap < ( t - h ) )
+      {
+         /** shrink with more items than fit, try again later **/
+         control.epoch.store( e + 1, std::memory_order_release );
+         delete( new_buffer );
+         return;
+      }
+      for( auto i( h ); i != t; i++ )
+      {
+         const auto src( slot( i, old_buffer ) );
+         const auto dst( slot( i, new_buffer ) );
+         relocate( &new_buffer->store[ dst ], &old_buffer->store[ src ] );
+      }
+      new_buffer->read_stats   = old_buffer->read_stats;
+      new_buffer->write_stats  = old_buffer->write_stats;
+      new_buffer->force_resize = old_buffer->force_resize;
+      (this)->set_buffer( new_buffer );
+      delete( old_buffer );
+      /** 
+       * cached head is only good against the old capacity, after a
+       * shrink t - cached_head could exceed max_cap and the free
+       * slot count in producer_wait would wrap
+       */
+      producer.cached_head = h;
+      control.epoch.store( e + 1, std::memory_order_release );
+   }
+
+   /**
+    * set_buffer - install buffer as the active storage, both
+    * sides must be quiescent (or not yet running).
+    */
+   void set_buffer( buffer_t * const buffer ) noexcept
+   {
+      (this)->datamanager.set( buffer );
+      (this)->init();
+      control.cap.store( buffer->max_cap, std::memory_order_relaxed );
+   }
+
+   /**
+    * removes range items from the buffer, ignores
+    * them without the copy overhead.
+    */
+   virtual void local_recycle( std::size_t range )
+   {
+      while( range-- > 0 )
+      {
+         auto * const buff_ptr( consumer_wait( 1 ) );
+         if( buff_ptr == nullptr )
+         {
+            break;
+         }
+         const auto h( consumer.head.load( std::memory_order_relaxed ) );
+         destroy( &buff_ptr->store[ slot( h, buff_ptr ) ] );
+         (this)->signals.pop( h );
+         consumer.head.store( h + 1, std::memory_order_release );
+         (this)->waiter.consumed();
+      }
+      consumer.busy = false;
+   }
+
+   virtual void local_allocate( void **ptr )
+   {
+      auto * const buff_ptr( producer_wait( 1 ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      *ptr = (void*)&( buff_ptr->store[ slot( t, buff_ptr ) ] );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   virtual void local_allocate_n( void *ptr, const std::size_t n )
+   {
+      auto * const buff_ptr( producer_wait( n ) );
+      auto *container(
+         reinterpret_cast< std::vector< std::reference_wrapper< T > >* >( ptr ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      for( std::size_t index( 0 ); index < n; index++ )
+      {
+         const auto write_index( slot( t + index, buff_ptr ) );
+         container->emplace_back( buff_ptr->store[ write_index ] );
+      }
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   /**
+    * local_push - if ptr is null only the signal is
+    * pushed, the item slot is left as is.
+    * @param   item, void ptr
+    * @param   signal, const raft::signal&
+    */
+   virtual void local_push( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, false );
+   }
+
+   /** local_push_move - as local_push, the item is moved in **/
+   virtual void local_push_move( void *ptr, const raft::signal &signal )
+   {
+      push_item( ptr, signal, true );
+   }
+
+   void push_item( void *ptr, const raft::signal &signal, const bool move )
+   {
+      auto * const buff_ptr( producer_wait( 1 ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      const auto write_index( slot( t, buff_ptr ) );
+      if( ptr != nullptr )
+      {
+         auto &item( *reinterpret_cast< T* >( ptr ) );
+         if( move )
+         {
+            construct( &buff_ptr->store[ write_index ], std::move( item ) );
+         }
+         else
+         {
+            construct( &buff_ptr->store[ write_index ], item );
+         }
+         (this)->producer_data.write_stats->bec.count++;
+      }
+      (this)->signals.send( t, signal );
+      producer.tail.store( t + 1, std::memory_order_release );
+      (this)->waiter.produced();
+   }
+
+   /**
+    * local_pop - read one item from the ring buffer,
+    * will block till there is data to be read.  If
+    * ptr == nullptr then the item is just thrown away.
+    */
+   virtual void local_pop( void *ptr, raft::signal *signal )
+   {
+      auto * const buff_ptr( consumer_wait( 1 ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         throw ClosedPortAccessException(
+            "Accessing closed port with pop call, exiting!!" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      const auto read_index( slot( h, buff_ptr ) );
+      const auto sig( (this)->signals.pop( h ) );
+      if( signal != nullptr )
+      {
+         *signal = sig;
+      }
+      if( ptr != nullptr )
+      {
+         *reinterpret_cast< T* >( ptr ) = std::move( buff_ptr->store[ read_index ] );
+         destroy( &buff_ptr->store[ read_index ] );
+         (this)->consumer_data.read_stats->bec.count++;
+      }
+      consumer.head.store( h + 1, std::memory_order_release );
+      (this)->waiter.consumed();
+   }
+
+   /**
+    * local_peek - the consumer is marked busy until
+    * unpeek or recycle is called so that it won't
+    * acknowledge a resize while the user holds a
+    * reference into the buffer.
+    */
+   virtual void local_peek( void **ptr, raft::signal *signal )
+   {
+      auto * const buff_ptr( consumer_wait( 1 ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         throw ClosedPortAccessException(
+            "Accessing closed port with local_peek call, exiting!!" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      const auto read_index( slot( h, buff_ptr ) );
+      if( signal != nullptr )
+      {
+         *signal = (this)->signals.peek( h );
+      }
+      consumer.busy = true;
+      *ptr = reinterpret_cast< void* >( &( buff_ptr->store[ read_index ] ) );
+   }
+
+   virtual void local_peek_range( void **ptr,
+                                  void **sig,
+                                  const std::size_t n,
+                                  std::size_t &curr_pointer_loc )
+   {
+      auto *buff_ptr( consumer_wait( n ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         if( (this)->size() == 0 )
+         {
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_range call, exiting!!" );
+         }
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      curr_pointer_loc = static_cast< std::size_t >( slot( h, buff_ptr ) );
+      consumer.busy = true;
+      *sig = reinterpret_cast< void* >( (this)->range_signals( h, n ) );
+      *ptr = reinterpret_cast< void* >( buff_ptr->store );
+   }
+
+   virtual void local_allocate_span( void **store,
+                                     std::size_t &n,
+                                     std::size_t &start,
+                                     std::size_t &queue_size,
+                                     const bool contiguous )
+   {
+      auto * const buff_ptr( producer_wait( n ) );
+      const auto t( producer.tail.load( std::memory_order_relaxed ) );
+      start      = slot( t, buff_ptr );
+      queue_size = buff_ptr->max_cap;
+      if( contiguous )
+      {
+         n = std::min( n, queue_size - start );
+      }
+      *store = reinterpret_cast< void* >( buff_ptr->store );
+      (this)->producer_data.n_allocated =
+        static_cast< decltype( (this)->producer_data.n_allocated ) >( n );
+      (this)->producer_data.allocate_called = true;
+   }
+
+   virtual void local_peek_span( void **store,
+                                 const std::size_t n,
+                                 std::size_t &start,
+                                 std::size_t &queue_size )
+   {
+      auto * const buff_ptr( consumer_wait( n ) );
+      if( R_UNLIKELY( buff_ptr == nullptr ) )
+      {
+         if( (this)->size() == 0 )
+         {
+            throw ClosedPortAccessException(
+               "Accessing closed port with local_peek_span call, exiting!!" );
+         }
+         throw NoMoreDataException( "Too few items left on closed port, kernel exiting" );
+      }
+      const auto h( consumer.head.load( std::memory_order_relaxed ) );
+      start      = slot( h, buff_ptr );
+      queue_size = buff_ptr->max_cap;
+      consumer.busy = true;
+      *store = reinterpret_cast< void* >( buff_ptr->store );
+   }
+
+   virtual raft::signal signal_peek()
+   {
+      /** signals live outside the buffer, no checkpoint needed **/
+      return( (this)->signals.peek(
+         consumer.head.load( std::memory_order_relaxed ) ) );
+   }
+
+private:
+   /**
+    * producer_wait - checkpoint then wait until there are at least
+    * n free slots, returns the (possibly new) active buffer.
+    */
+   buffer_t* producer_wait( const std::size_t n )
+   {
+      for( ;; )
+      {
+         checkpoint( producer.ack );
+         auto * const buff_ptr( (this)->datamanager.get() );
+         const auto t( producer.tail.load( std::memory_order_relaxed ) );
+         if( R_LIKELY( buff_ptr->max_cap - ( t - producer.cached_head ) >= n ) )
+         {
+            return( buff_ptr );
+         }
+         /** only touch the consumer's line once the cached copy says full **/
+         producer.cached_head = consumer.head.load( std::memory_order_acquire );
+         if( buff_ptr->max_cap - ( t - producer.cached_head ) >= n )
+         {
+            return( buff_ptr );
+         }
+         if( buff_ptr->max_cap < n )
+         {
+            buff_ptr->force_resize = n;
+         }
+         auto &wr_stats( (this)->producer_data.write_stats->bec.blocked );
+         if( wr_stats == 0 )
+         {
+            wr_stats = 1;
+         }
+         (this)->waiter.producer_block();
+      }
+   }
+
+   /**
+    * consumer_wait - checkpoint then wait until there are at least
+    * n items available. returns nullptr if the producer has gone
+    * away and fewer than n items remain.
+    */
+   buffer_t* consumer_wait( const std::size_t n )
+   {
+      for( ;; )
+      {
+         if( ! consumer.busy )
+         {
+            checkpoint( consumer.ack );
+         }
+         const auto h( consumer.head.load( std::memory_order_relaxed ) );
+         if( R_LIKELY( consumer.cached_tail - h >= n ) )
+         {
+            return( (this)->datamanager.get() );
+         }
+         consumer.cached_tail = producer.tail.load( std::memory_order_acquire );
+         if( consumer.cached_tail - h >= n )
+         {
+            return( (this)->datamanager.get() );
+         }
+         if( (this)->is_invalid() )
+         {
+            /** re-check, the last push happens before invalidate **/
+            if( producer.tail.load( std::memory_order_acquire ) - h >= n )
+            {
+               return( (this)->datamanager.get() );
+            }
+            return( nullptr );
+         }
+         auto &rd_stats( (this)->consumer_data.read_stats->bec.blocked );
+         if( rd_stats == 0 )
+         {
+            rd_stats = 1;
+         }
+         (this)->waiter.consumer_block();
+      }
+   }
+
+   /**
+    * checkpoint - if a resize is pending (odd epoch) acknowledge
+    * it and wait for the resizing thread to finish.
+    */
+   inline void checkpoint( std::atomic< index_t > &ack ) noexcept
+   {
+      auto e( control.epoch.load( std::memory_order_acquire ) );
+      if( R_LIKELY( ( e & 1 ) == 0 ) )
+      {
+         return;
+      }
+      ack.store( e, std::memory_order_release );
+      while( control.epoch.load( std::memory_order_acquire ) == e )
+      {
+         raft::yield();
+      }
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   construct( U * const slot, const U &item )
+   {
+      new ( slot ) U( item );
+   }
+
+   /** the item is an rvalue, take over what it holds **/
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   construct( U * const slot, U &&item )
+   {
+      new ( slot ) U( std::move( item ) );
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_nonclass_alloc< U >::value >::type
+   construct( U * const slot, const U &item )
+   {
+      *slot = item;
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_class_alloc< U >::value >::type
+   destroy( U * const slot )
+   {
+      slot->~U();
+   }
+
+   template < class U = T >
+   static inline typename std::enable_if< inline_nonclass_alloc< U >::value >::type
+   destroy( U * const slot )
+   {
+      UNUSED( slot );
+   }
+
+   /** relocate - move-construct into dst, destroy src **/
+   static inline void relocate( T * const dst, T * const src )
+   {
+      construct( dst, std::move( *src ) );
+      destroy( src );
+   }
+
+   /**
+    * slot - buffer index for free running counter i, buffers
+    * from Buffer::Data are a power of two when POW2_BUFFER is
+    * set so this is a mask rather than a divide.
+    */
+   static inline std::size_t slot( const index_t i,
+                                   const buffer_t * const buffer ) noexcept
+   {
+#ifdef POW2_BUFFER
+      return( static_cast< std::size_t >( i & ( buffer->max_cap - 1 ) ) );
+#else
+      return( static_cast< std::size_t >( i % buffer->max_cap ) );
+#endif
+   }
+
+   static constexpr auto quiesce_timeout = std::chrono::milliseconds( 2 );
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      std::atomic< index_t >  tail    = { 0 };
+      std::atomic< index_t >  ack     = { 0 };
+      /** producer's copy of head, refreshed when the queue looks full **/
+      index_t                 cached_head = 0;
+   } producer;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      std::atomic< index_t >  head    = { 0 };
+      std::atomic< index_t >  ack     = { 0 };
+      /** consumer's copy of tail, refreshed when the queue looks empty **/
+      index_t                 cached_tail = 0;
+      /** true between peek and unpeek/recycle **/
+      bool                    busy    = false;
+   } consumer;
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+      /** odd while a resize is pending **/
+      std::atomic< index_t >      epoch   = { 0 };
+      std::atomic< std::size_t >  cap     = { 0 };
+      std::atomic< bool >         valid   = { true };
+   } control;
+};
+
+/**
+ * ext_alloc types carry pointers to out-of-band objects that come
+ * from the FIFO's slab pool (slabpool.tcc) and are retired through
+ * the kernel's Buffer::Reclaimer on recycle, these keep the heap
+ * implementation.
+ */
+template < class T >
+class RingBufferBase<
+    T,
+    Type::LockFreeSPSC,
+    typename std::enable_if< ext_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::Heap >
+{
+public:
+   RingBufferBase() : RingBufferBase< T, Type::Heap >()
+   {
+   }
+
+   virtual ~RingBufferBase() = default;
+
+protected:
+   void quiescent_resize( Buffer::Data< T, Type::Heap > * const new_buffer,
+                          volatile bool &exit_alloc )
+   {
+      (this)->resize_buffer( new_buffer, exit_alloc );
+   }
+
+   void set_buffer( Buffer::Data< T, Type::Heap > * const buffer ) noexcept
+   {
+      (this)->datamanager.set( buffer );
+      (this)->init();
+   }
+};
+
+#endif /* END RAFTRINGBUFFERSPSC_TCC */
@@ -0,0 +1,232 @@
+/**
+ * ringbuffertcp.tcc - one end of a FIFO between two processes over a
+ * stream socket (see socketlink.hpp). Each side is a plain lock-free
+ * SPSC ring in its own process: in the sending process the local
+ * kernel produces into it and the link's I/O thread is the consumer,
+ * in the receiving process the I/O thread is the producer. The I/O
+ * thread moves whole batches through the span API, items go from the
+ * ring onto the wire and off the wire into the ring without being
+ * touched one at a time, sparse signals ride along with their batch.
+ *
+ * Restrictions: items have to satisfy shm_alloc (anything else
+ * exits at allocation), the capacity is fixed (resize is a no-op,
+ * size the edge with the link buffer parameter). If the other process
+ * goes away the receiving side sees the FIFO close, the sending side's
+ * producer gets a ClosedPortAccessException on its next write.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTRINGBUFFERTCP_TCC
+#define RAFTRINGBUFFERTCP_TCC  1
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#include <sys/uio.h>
+
+#include "portexception.hpp"
+#include "ringbufferspsc.tcc"
+#include "socketlink.hpp"
+#include "alloc_traits.tcc"
+#include "defs.hpp"
+#include "internaldefs.hpp"
+
+template < class T >
+class RingBufferBase<
+    T,
+    Type::TCP,
+    typename std::enable_if< shm_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::LockFreeSPSC >, public Buffer::SocketChannel
+{
+   using index_t = std::uint64_t;
+public:
+   RingBufferBase() : RingBufferBase< T, Type::LockFreeSPSC >()
+   {
+   }
+
+   virtual ~RingBufferBase() = default;
+
+   virtual std::size_t item_size() const noexcept
+   {
+      return( sizeof( T ) );
+   }
+
+   virtual std::size_t channel_capacity()
+   {
+      return( (this)->capacity() );
+   }
+
+   virtual std::size_t outbound()
+   {
+      return( (this)->size() );
+   }
+
+   virtual bool closed()
+   {
+      return( (this)->is_invalid() );
+   }
+
+   virtual std::size_t gather( const std::size_t n,
+                               struct iovec * const iov,
+                               std::vector< Buffer::socket_signal_t > &sigs )
+   {
+      const auto spans( (this)->template peek_span< T >( n ) );
+      const auto * const s( (this)->range_signals( head, n ) );
+      for( std::size_t i( 0 ); i < n; i++ )
+      {
+         if( s[ i ].sig != raft::none )
+         {
+            sigs.push_back( { static_cast< std::uint32_t >( i ),
+                              static_cast< std::uint32_t >( s[ i ].sig ) } );
+         }
+      }
+      return( to_iovec( spans, iov ) );
+   }
+
+   /** sent - the link thread is the only consumer, head is its count **/
+   virtual void sent( const std::size_t n )
+   {
+      (this)->recycle( n );
+      head += n;
+   }
+
+   virtual std::size_t inbound_space()
+   {
+      return( (this)->space_avail() );
+   }
+
+   virtual std::size_t scatter( const std::size_t n,
+                                struct iovec * const iov )
+   {
+      return( to_iovec( (this)->template allocate_span< T >( n ), iov ) );
+   }
+
+   virtual void received( const std::size_t n,
+                          const Buffer::socket_signal_t * const sigs,
+                          const std::size_t n_sigs )
+   {
+      for( std::size_t i( 0 ); i < n_sigs; i++ )
+      {
+         (this)->signals.send( tail + sigs[ i ].offset,
+                               static_cast< raft::signal >( sigs[ i ].sig ) );
+      }
+      (this)->send_range( raft::none );
+      tail += n;
+   }
+
+   virtual void disconnect( const bool peer_gone )
+   {
+      if( peer_gone )
+      {
+         dead.store( true, std::memory_order_release );
+      }
+      (this)->invalidate();
+   }
+
+protected:
+   /**
+    * producer side overrides, once the link is down nothing written
+    * here goes anywhere, tell the kernel the same way a closed port
+    * does.
+    */
+   virtual void local_allocate( void **ptr )
+   {
+      check_link();
+      RingBufferBase< T, Type::LockFreeSPSC >::local_allocate( ptr );
+   }
+
+   virtual void local_allocate_n( void *ptr, const std::size_t n )
+   {
+      check_link();
+      RingBufferBase< T, Type::LockFreeSPSC >::local_allocate_n( ptr, n );
+   }
+
+   virtual void local_push( void *ptr, const raft::signal &signal )
+   {
+      check_link();
+      RingBufferBase< T, Type::LockFreeSPSC >::local_push( ptr, signal );
+   }
+
+   virtual void local_allocate_span( void **store,
+                                     std::size_t &n,
+                                     std::size_t &start,
+                                     std::size_t &queue_size,
+                                     const bool contiguous )
+   {
+      check_link();
+      RingBufferBase< T, Type::LockFreeSPSC >::local_allocate_span( store,
+                                                                    n,
+                                                                    start,
+                                                                    queue_size,
+                                                                    contiguous );
+   }
+
+private:
+   inline void check_link()
+   {
+      if( R_UNLIKELY( dead.load( std::memory_order_acquire ) ) )
+      {
+         throw ClosedPortAccessException(
+            "Other end of socket FIFO is gone, exiting!!" );
+      }
+   }
+
+   static std::size_t to_iovec( const raft::span_pair< T > &spans,
+                                struct iovec * const iov )
+   {
+      std::size_t n_iov( 0 );
+      for( const auto *s : { &spans.first, &spans.second } )
+      {
+         if( s->size() > 0 )
+         {
+            iov[ n_iov ].iov_base = reinterpret_cast< void* >( s->data() );
+            iov[ n_iov ].iov_len  = s->size() * sizeof( T );
+            n_iov++;
+         }
+      }
+      return( n_iov );
+   }
+
+   /** positions of the link thread's end, sender: head, receiver: tail **/
+   index_t               head = 0;
+   index_t               tail = 0;
+   std::atomic< bool >   dead = { false };
+};
+
+/**
+ * anything else can't go over the wire as raw bytes, the spec only
+ * exists so every port type can register TCP, RingBuffer< T,
+ * Type::TCP >::make_new_fifo refuses to build these.
+ */
+template < class T >
+class RingBufferBase<
+    T,
+    Type::TCP,
+    typename std::enable_if< ! shm_alloc< T >::value >::type >
+: public RingBufferBase< T, Type::Heap >
+{
+public:
+   RingBufferBase() : RingBufferBase< T, Type::Heap >()
+   {
+   }
+
+   virtual ~RingBufferBase() = default;
+};
+
+#endif /* END RAFTRINGBUFFERTCP_TCC */
@@ -8,11 +8,14 @@ namespace Type
                          SharedMemory, 
                          TCP, 
                          Infinite, 
+                         LockFreeSPSC,
+                         Segmented,
+                         MPMC,
                          N };
 
     static constexpr std::array<  const char[20] , 
                       Type::N > type_prints
-                             = {{ "Heap", "SharedMemory", "TCP", "Infinite"  }};
+                             = {{ "Heap", "SharedMemory", "TCP", "Infinite", "LockFreeSPSC", "Segmented", "MPMC"  }};
 }
    
    enum Direction { Producer, Consumer };
@@ -1,5 +1,5 @@
 /**
- * sample.hpp - 
+ * sample.hpp - runs a set of sample types over one FIFO.
  * @author: Jonathan Beard
  * @version: Thu Aug 21 09:44:44 2014
  * 
@@ -20,92 +20,54 @@
 #ifndef RAFTSAMPLE_HPP
 #define RAFTSAMPLE_HPP  1
 
-#include <functional>
-#include <vector>
+#include <cassert>
 #include <sstream>
+#include <string>
+#include <vector>
 
-#include "ringbuffertypes.hpp"
-#include "ringbufferbase.tcc"
+#include "fifo.hpp"
 #include "sampletype.tcc"
-#include "resolution.hpp"
 
 
-template < class T, Type::RingBufferType type > class Sample
+class Sample
 {
 public:
-Sample()
-{
-   sample_list = new std::vector< SampleType< T, type >* >();
-}
+Sample() = default;
 
-virtual ~Sample()
-{
-   delete( sample_list );
-   sample_list = nullptr;
-}
+virtual ~Sample() = default;
 
-void registerSample( SampleType< T, type >  *function )
+void registerSample( SampleType *function )
 {
    assert( function != nullptr );
-   sample_list->push_back( function );
+   sample_list.push_back( function );
 }
 
-std::string printAllData( const char delim )
+/**
+ * sample - run every registered sample type over the frame
+ * that just ended.
+ * @param   fifo        - FIFO&
+ * @param   frame_width - const double, seconds
+ */
+void sample( FIFO &fifo, const double frame_width )
 {
-   std::stringstream ss;
-   for( SampleType< T, type > *s : *sample_list )
+   for( SampleType *s : sample_list )
    {
-      s->print( ss ) << delim;
+      s->sample( fifo, frame_width );
    }
-   return( ss.str() );
 }
 
-static void 
-run( RingBufferBase< T, type > &buffer,
-     volatile bool                    &term,
-     Sample                           &self )
+std::string printAllData( const char delim )
 {
-   sclock_t prev_time( system_clock->getTime() );
-   bool converged( false );
-   bool blocked(   false );
-   frame_resolution  resolution;
-   while( ! term )
+   std::stringstream ss;
+   for( SampleType *s : sample_list )
    {
-      frame_resolution::waitForInterval( resolution );
-      for( SampleType< T, type > *s : *(self.sample_list) )
-      {
-         s->sample( buffer, blocked );
-      }
-      const auto end_time( system_clock->getTime() );
-      if( frame_resolution::acceptEntry( resolution,
-                                         ( end_time - prev_time ) ) )
-      {
-       for( SampleType< T, type > *s : *(self.sample_list) )
-       {
-          s->accept( converged );
-       }
-      }
-      if( ! converged )
-      {
-         converged = 
-            frame_resolution::updateResolution( resolution, 
-                                                prev_time,
-                                                blocked );
-         if( converged )
-         {
-            for( SampleType< T, type > *s : *(self.sample_list) )
-            {
-               s->setFrameWidth( resolution.getFrameWidth() );
-            }
-         }
-      }
-      prev_time = system_clock->getTime();
+      s->print( ss ) << delim;
    }
+   return( ss.str() );
 }
 
-
 private:
-/** pointer just in case I want to use it across processes **/
-std::vector< SampleType< T, type > * > *sample_list;
+/** not owned **/
+std::vector< SampleType* > sample_list;
 };
 #endif /* END RAFTSAMPLE_HPP */
@@ -1,5 +1,8 @@
 /**
- * sampletype.tcc - 
+ * sampletype.tcc - base for the per FIFO samplers the dynamic
+ * allocator (dynalloc.cpp) reads each monitor pass, see
+ * arrivalratesampletype.tcc, departureratesampletype.tcc and
+ * meansampletype.tcc.
  * @author: Jonathan Beard
  * @version: Sat 11 July 2020
  * 
@@ -20,33 +23,28 @@
 #ifndef RAFTSAMPLETYPE_TCC
 #define RAFTSAMPLETYPE_TCC  1
 
-#include <vector>
 #include <string>
 #include <ostream>
 #include <cstdlib>
-#include "ringbuffertypes.hpp"
-#include "ringbufferbase.tcc"
+#include "fifo.hpp"
 
 #include "units.hpp"
 
-template < class T, Type::RingBufferType type > class SampleType
+class SampleType
 {
 public:
 
-SampleType() : frame_width( 0 )
-{
-   
-}
+SampleType() = default;
 
 virtual ~SampleType() = default;
 
-virtual void sample( RingBufferBase< T, type >     &buffer,
-                     bool                          &global_blocked ) = 0;
-virtual void accept( volatile bool &converged ) = 0;
-virtual void setFrameWidth( const double  frame_width )
-{
-   (this)->frame_width = frame_width;
-}
+/**
+ * sample - take what the FIFO recorded over the frame that just
+ * ended, the FIFO's counters are zeroed for the next one.
+ * @param   fifo        - FIFO&
+ * @param   frame_width - const double, seconds since the last sample
+ */
+virtual void sample( FIFO &fifo, const double frame_width ) = 0;
 
 std::ostream&
 print( std::ostream &stream )
@@ -59,8 +57,6 @@ protected:
 virtual std::string printHeader() = 0;
 virtual std::string printData( raft::unit unit = raft::unit::byte )   = 0;
 
-double frame_width;
-
 };
 
 #endif /* END RAFTSAMPLETYPE_TCC */
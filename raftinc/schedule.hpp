@@ -26,6 +26,9 @@
 #include <set>
 #include "kernelkeeper.tcc"
 #include "defs.hpp"
+#include "reclaimer.hpp"
+#include "doorbell.hpp"
+#include "readyset.hpp"
 
 namespace raft {
    class kernel;
@@ -35,6 +38,11 @@ namespace raft {
 class Schedule
 {
 public:
+   /** 
+    * fuses - the scheduler runs fused chains (fusion.hpp) on
+    * one thread, map::exe only marks chains for those.
+    */
+   static constexpr bool fuses = false;
 
    /** 
     * Schedule - base constructor takes a map object
@@ -146,32 +154,87 @@ protected:
     */
    static bool kernelHasNoInputPorts( raft::kernel *kernel );
 
+   /**
+    * kernelHasSharedInput - true if any input port is one of
+    * several consumers of a shared (Type::MPMC) FIFO, those can
+    * be emptied by another kernel between the data check and 
+    * the kernel's read.
+    * @param   kernel - raft::kernel*
+    * @return  bool
+    */
+   static bool kernelHasSharedInput( raft::kernel *kernel );
+
    
    /**
-    * setPtrSets - add the tracking object from the
-    * sub-class to track input/output ptrs in flight 
-    * by the kernel. The structure will be the same
-    * across all in and output FIFOs, since from within
-    * a "kernel" each fifo is accessed with sequential
-    * consistency we won't need any fancy locking structures.
-    * on each kernel firing, these structures should be
-    * checked to see if any allocated objects (the only
-    * ones to be put in these sets, need to be "garbage
-    * collected"
-    * @param kernel - raft::kernel* the one we're registering
-    * @param in     - set_t*, the input set
-    * @param out    - set_t*, the output set
+    * setReclaimer - hand the thread's reclaimer to every
+    * in and output FIFO of kernel. The same object is used
+    * across all of them, since from within a "kernel" each
+    * fifo is accessed with sequential consistency we won't
+    * need any fancy locking structures.
+    * @param kernel    - raft::kernel* the one we're registering
+    * @param reclaimer - Buffer::Reclaimer*, owned by the thread
     * @return void
     */
-   static void setPtrSets( raft::kernel * const kernel,
-                           ptr_map_t    * const in,
-                           ptr_set_t    * const out,
-                           ptr_set_t    * const peekset );
+   static void setReclaimer( raft::kernel      * const kernel,
+                             Buffer::Reclaimer * const reclaimer );
 
-   
-   static void fifo_gc( ptr_map_t * const in,
-                        ptr_set_t * const out,
-                        ptr_set_t * const peekset );
+   /**
+    * fifo_gc - call between kernel runs, no peek reference
+    * is live then, closes the reclaimer's epoch which frees
+    * the out-of-line items recycled since the last call.
+    * @param reclaimer - Buffer::Reclaimer*
+    */
+   static void fifo_gc( Buffer::Reclaimer * const reclaimer );
+
+   /**
+    * kernelRun - same as above, except whether the kernel has
+    * data is read off its ready set instead of asking every
+    * input port. The ports are only asked when the set says
+    * there's nothing to do, which also re-syncs bits lost to
+    * the producer race (see readyset.hpp). Kernels with more
+    * than ready_set::max_ports inputs take the path above.
+    * @param kernel   - raft::kernel*
+    * @param finished - volatile bool&, set once kernel is done
+    * @param ready    - raft::ready_set&, owned by the thread
+    * @return bool    - true if kernel->run() was called
+    */
+   static bool kernelRun( raft::kernel    * const kernel,
+                          volatile bool   &finished,
+                          raft::ready_set &ready );
+
+   /**
+    * kernelReady - kernel should be run again, i.e., it has no
+    * inputs (a source), ready says enough inputs have data for
+    * its scheduling behavior or an input was invalidated. Only
+    * reads the set, never the ports.
+    * @param kernel - raft::kernel*
+    * @param ready  - raft::ready_set&, the one bound to kernel
+    * @return bool
+    */
+   static bool kernelReady( raft::kernel    * const kernel,
+                            raft::ready_set &ready );
+
+   /**
+    * kernelQuiesce - check in with each input FIFO before the
+    * kernel's thread sleeps, a resize waiting on the consumer
+    * would otherwise wait for it to wake up first.
+    * @param kernel - raft::kernel*
+    */
+   static void kernelQuiesce( raft::kernel * const kernel );
+
+   /**
+    * kernelWaitForData - after kernelRun returned false, block
+    * until kernel's ready set says it can run or an input is
+    * invalidated, or the doorbell's timeout passes.
+    * @param kernel   - raft::kernel*
+    * @param ready    - raft::ready_set&, the one bound to kernel
+    * @param bell     - Buffer::Doorbell&, the one set for ready
+    * @param finished - volatile bool&, stop waiting once true
+    */
+   static void kernelWaitForData( raft::kernel     * const kernel,
+                                  raft::ready_set  &ready,
+                                  Buffer::Doorbell &bell,
+                                  volatile bool    &finished );
    /**
     * signal handlers
     */
@@ -182,5 +245,7 @@ protected:
    kernelkeeper &source_kernels;      
    kernelkeeper &dst_kernels;
    kernelkeeper &internally_created_kernels;
+   /** see MapBase::setSchedulerThreads, 0 is one per core **/
+   const std::size_t scheduler_threads;
 };
 #endif /* END RAFTSCHEDULE_HPP */
@@ -0,0 +1,176 @@
+/**
+ * shmendpoint.tcc - kernels that splice a graph across two
+ * processes. Link the last kernel of the source side subgraph to a
+ * raft::shm_out< T >( key ) in one process and a raft::shm_in< T >(
+ * key ) to the first kernel of the sink side subgraph in the other,
+ * the two edges become the ends of one Type::SharedMemory FIFO (see
+ * ringbuffershm.tcc). Items go straight from the producing kernel's
+ * push into the segment and out of it with the consuming kernel's
+ * pop, the endpoint kernels themselves never touch data, they only
+ * keep their side of the graph alive until the edge is done.
+ *
+ * e.g.,
+ * process A: raft::shm_out< int > out( "edge" ); m.link( &source, &out );
+ * process B: raft::shm_in< int >  in( "edge" );  m.link( &in, &sink );
+ *
+ * The producer side creates the segment, the consumer side waits
+ * (SHMSegment::attach_timeout) for it to show up. A producer that
+ * finishes stays around until the consumer has attached, after
+ * that the data is in the segment and either side can exit. If the
+ * other process dies the graph on this side stops as if the edge
+ * was closed.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSHMENDPOINT_TCC
+#define RAFTSHMENDPOINT_TCC  1
+#include <chrono>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "kernel.hpp"
+#include "port.hpp"
+#include "port_info.hpp"
+#include "alloc_traits.tcc"
+
+namespace raft
+{
+
+class shm_endpoint : public raft::kernel
+{
+public:
+    shm_endpoint( const std::string &key ) : raft::kernel(),
+                                             key( key )
+    {
+    }
+
+    virtual ~shm_endpoint() = default;
+
+protected:
+    /**
+     * mark - tag the endpoint's single port so the allocator
+     * builds a shared memory FIFO for the edge attached to it.
+     * @param   port - Port&, input or output
+     */
+    void mark( Port &port )
+    {
+        port.getPortInfo().shm_key = key;
+    }
+
+    /** closed - the shared memory FIFO on port is done **/
+    static bool closed( Port &port )
+    {
+        return( port.getPortInfo().getFIFO()->is_invalid() );
+    }
+
+    /** idle - endpoints only poll, don't hog a core doing it **/
+    static raft::kstatus idle()
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        return( raft::proceed );
+    }
+
+    const std::string key;
+};
+
+/**
+ * shm_out - sink side of the local graph, the producer end
+ * of the shared memory FIFO.
+ */
+template < class T > class shm_out : public shm_endpoint
+{
+    static_assert( shm_alloc< T >::value,
+                   "shared memory FIFO items must be trivially copyable "
+                   "and fit in a cache line" );
+public:
+    shm_out( const std::string &key ) : shm_endpoint( key )
+    {
+#ifdef STRING_NAMES
+        input.addPort< T >( "0" );
+#else
+        input.addPort< T >( raft::port_key_name_t( 0, "0" ) );
+#endif
+        (this)->mark( input );
+    }
+
+    shm_out( const shm_out &other ) : shm_out( other.key )
+    {
+    }
+
+    CLONE();
+
+    /**
+     * run - only scheduled while items are waiting for the other
+     * process, stops once the edge is closed (or the consumer
+     * process is gone) so the rest doesn't have to be drained here.
+     * @return raft::kstatus
+     */
+    virtual raft::kstatus run()
+    {
+        if( (this)->closed( input ) )
+        {
+            return( raft::stop );
+        }
+        return( (this)->idle() );
+    }
+};
+
+/**
+ * shm_in - source side of the local graph, the consumer end
+ * of the shared memory FIFO.
+ */
+template < class T > class shm_in : public shm_endpoint
+{
+    static_assert( shm_alloc< T >::value,
+                   "shared memory FIFO items must be trivially copyable "
+                   "and fit in a cache line" );
+public:
+    shm_in( const std::string &key ) : shm_endpoint( key )
+    {
+#ifdef STRING_NAMES
+        output.addPort< T >( "0" );
+#else
+        output.addPort< T >( raft::port_key_name_t( 0, "0" ) );
+#endif
+        (this)->mark( output );
+    }
+
+    shm_in( const shm_in &other ) : shm_in( other.key )
+    {
+    }
+
+    CLONE();
+
+    /**
+     * run - once the producer has closed the edge (or its process
+     * is gone) stop, invalidating the port, the kernels downstream
+     * then drain what is left in the segment.
+     * @return raft::kstatus
+     */
+    virtual raft::kstatus run()
+    {
+        if( (this)->closed( output ) )
+        {
+            return( raft::stop );
+        }
+        return( (this)->idle() );
+    }
+};
+
+} /** end namespace raft **/
+#endif /* END RAFTSHMENDPOINT_TCC */
@@ -0,0 +1,138 @@
+/**
+ * shmsegment.hpp - named POSIX shared memory segment (shm_open +
+ * mmap) backing one Type::SharedMemory FIFO between two processes.
+ * Layout is a header with the process-shared indices followed by a
+ * per-slot signal array and the item store, each cache line aligned.
+ *
+ * The producer creates the segment, replacing anything left under
+ * the same key by an earlier run, the consumer waits for it to show
+ * up, attaches, then unlinks the name so nothing is left behind in
+ * /dev/shm once both sides unmap, even if one of them crashes. Each
+ * side holds a lock on its own byte of the file for as long as it is
+ * attached, the lock goes away when the process dies so the other
+ * side can tell a crash from a slow peer (see peer_alive).
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSHMSEGMENT_HPP
+#define RAFTSHMSEGMENT_HPP  1
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "defs.hpp"
+#include "internaldefs.hpp"
+#include "ringbuffertypes.hpp"
+#include "signalvars.hpp"
+
+namespace Buffer
+{
+
+class SHMSegment
+{
+public:
+   using index_t = std::uint64_t;
+
+   /** make_new_fifo data for Type::SharedMemory, which end to build **/
+   struct endpoint_t
+   {
+      const std::string key;
+      Direction         dir;
+   };
+
+   /** how long a consumer waits for its producer to create the segment **/
+   static constexpr auto attach_timeout = std::chrono::seconds( 10 );
+
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) header_t
+   {
+      /** set to ready_magic by the producer once the rest is valid **/
+      std::atomic< std::uint32_t >  ready     = { 0 };
+      std::atomic< std::uint32_t >  attached  = { 0 };
+      std::uint64_t                 item_size = 0;
+      std::uint64_t                 max_cap   = 0;
+
+      struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+         std::atomic< index_t >        tail  = { 0 };
+         /** cleared by the producer on invalidate **/
+         std::atomic< std::uint32_t >  valid = { 1 };
+      } producer;
+
+      struct ALIGN( L1D_CACHE_LINE_SIZE ) {
+         std::atomic< index_t >        head  = { 0 };
+      } consumer;
+   };
+
+   static_assert( std::atomic< index_t >::is_always_lock_free,
+                  "process shared indices must be lock free" );
+   static_assert( std::atomic< std::uint32_t >::is_always_lock_free,
+                  "process shared flags must be lock free" );
+
+   /**
+    * SHMSegment - producer creates a segment for max_cap items of
+    * item_size bytes, consumer attaches to the one the producer
+    * created (max_cap is taken from it, the param is ignored). Both
+    * print an error and exit if the segment can't be set up.
+    * @param   key       - const std::string&, same for both ends
+    * @param   dir       - Direction, which end of the FIFO this is
+    * @param   item_size - std::size_t, must match on both ends
+    * @param   max_cap   - std::size_t, items
+    */
+   SHMSegment( const std::string &key,
+               const Direction    dir,
+               const std::size_t  item_size,
+               const std::size_t  max_cap );
+
+   ~SHMSegment();
+
+   SHMSegment( const SHMSegment &other ) = delete;
+   SHMSegment& operator = ( const SHMSegment &other ) = delete;
+
+   /**
+    * peer_alive - false once the other process is known to be
+    * gone, a producer whose consumer hasn't attached yet counts
+    * as alive. Makes a syscall, only use on slow paths.
+    * @return bool
+    */
+   bool peer_alive() const noexcept;
+
+   /** name the segment is created under for key **/
+   static std::string name( const std::string &key );
+
+   header_t        *header  = nullptr;
+   raft::signal    *signals = nullptr;
+   void            *store   = nullptr;
+
+private:
+   static constexpr std::uint32_t ready_magic = 0x1337;
+
+   void create( const std::size_t item_size, const std::size_t max_cap );
+   void attach( const std::size_t item_size );
+   void map( const std::size_t max_cap, const std::size_t item_size );
+   /** byte of the file each side holds a lock on while attached **/
+   static off_t lock_byte( const Direction d ) noexcept;
+
+   const std::string seg_name;
+   const Direction   dir;
+   int               fd     = -1;
+   void             *base   = nullptr;
+   std::size_t       length = 0;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTSHMSEGMENT_HPP */
@@ -0,0 +1,165 @@
+/**
+ * signalchannel.hpp - sparse, out-of-band signal storage for a
+ * FIFO. Most traffic never carries a signal (raft::none), so
+ * instead of a Buffer::Signal slot beside every element the FIFO
+ * keeps a short position-ordered queue of (position, signal)
+ * pairs, only elements that actually carry a signal get an entry.
+ * Signal-free pushes and pops touch only the data array plus one
+ * shared counter that only changes when a signal is sent.
+ *
+ * Positions are the monotonic element counts kept by the FIFO
+ * (number of items ever written/read), not buffer indices, so
+ * entries stay valid across resizes and need no copying.
+ *
+ * One producer, one consumer, same as the FIFO it sits in.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSIGNALCHANNEL_HPP
+#define RAFTSIGNALCHANNEL_HPP  1
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include "signalvars.hpp"
+#include "signal.hpp"
+#include "internaldefs.hpp"
+
+namespace Buffer
+{
+
+class SignalChannel
+{
+public:
+    using position_t = std::uint64_t;
+
+    SignalChannel();
+    ~SignalChannel();
+
+    SignalChannel( const SignalChannel &other ) = delete;
+    SignalChannel& operator = ( const SignalChannel &other ) = delete;
+
+    /**
+     * send - producer side, tag the element at pos with sig. Must
+     * be called before the element itself is made visible to the
+     * consumer, and with non-decreasing positions.
+     * @param   pos - position_t, element count at time of write
+     * @param   sig - raft::signal, raft::none is a no-op
+     */
+    inline void send( const position_t pos, const raft::signal sig )
+    {
+        if( R_LIKELY( sig == raft::none ) )
+        {
+            return;
+        }
+        append( pos, sig );
+    }
+
+    /**
+     * peek - consumer side, signal carried by the element at pos
+     * without consuming it.
+     * @param   pos - position_t, element count at time of read
+     * @return  raft::signal, raft::none if no entry for pos
+     */
+    inline raft::signal peek( const position_t pos ) noexcept
+    {
+        if( R_LIKELY( empty() ) )
+        {
+            return( raft::none );
+        }
+        const auto &e( head() );
+        return( e.pos == pos ? e.sig : raft::none );
+    }
+
+    /**
+     * pop - consumer side, the element at pos is being consumed,
+     * drop its entry if it has one and return the signal.
+     * @param   pos - position_t, element count at time of read
+     * @return  raft::signal, raft::none if no entry for pos
+     */
+    inline raft::signal pop( const position_t pos ) noexcept
+    {
+        if( R_LIKELY( empty() ) )
+        {
+            return( raft::none );
+        }
+        return( take( pos ) );
+    }
+
+    /**
+     * fill - consumer side, write the signals for tagged elements
+     * in [pos, pos + n) into out[ 0 .. n ). Untagged entries of
+     * out are not touched, the caller is expected to hand in
+     * entries that are already raft::none. Nothing is consumed,
+     * used by peek_range.
+     * @param   pos - position_t, first element
+     * @param   n   - std::size_t, number of elements
+     * @param   out - Signal*, at least n entries
+     * @return  std::size_t, one past the last entry written, 0 if none
+     */
+    std::size_t fill( const position_t pos,
+               const std::size_t n,
+               Signal * const out ) noexcept;
+
+private:
+    struct entry
+    {
+        position_t   pos;
+        raft::signal sig;
+    };
+
+    /** entries per segment, segments are only allocated on signals **/
+    static constexpr std::size_t seg_entries = 32;
+
+    struct segment
+    {
+        entry             entries[ seg_entries ];
+        segment           *next = nullptr;
+    };
+
+    inline bool empty() noexcept
+    {
+        return( consumer.count ==
+                producer.published.load( std::memory_order_acquire ) );
+    }
+
+    /** producer slow path, only taken for real signals **/
+    void append( const position_t pos, const raft::signal sig );
+    /** consumer, oldest unconsumed entry, only valid if !empty() **/
+    const entry& head() noexcept;
+    /** consumer slow path of pop **/
+    raft::signal take( const position_t pos ) noexcept;
+
+    struct ALIGN( L1D_CACHE_LINE_SIZE )
+    {
+        segment                     *seg   = nullptr;
+        std::size_t                 index  = 0;
+        /** total entries written, release store after each **/
+        std::atomic< std::uint64_t > published = { 0 };
+    } producer;
+
+    struct ALIGN( L1D_CACHE_LINE_SIZE )
+    {
+        segment                     *seg   = nullptr;
+        std::size_t                 index  = 0;
+        /** total entries consumed, consumer private **/
+        std::uint64_t               count  = 0;
+    } consumer;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTSIGNALCHANNEL_HPP */
@@ -22,7 +22,14 @@
 #include <vector>
 #include <thread>
 #include <cstdint>
+#include <memory>
 #include "defs.hpp"
+#include "threadcache.hpp"
+#include "doorbell.hpp"
+#include "readyset.hpp"
+#include "fusion.hpp"
+#include "fiber.hpp"
+#include "reclaimer.hpp"
 
 namespace raft{
    class kernel;
@@ -32,10 +39,18 @@ namespace raft{
 class simple_schedule : public Schedule
 {
 public:
+   /** a fused chain is one thread, see fused_run **/
+   static constexpr bool fuses = true;
+
    simple_schedule( raft::map &map );
 
    virtual ~simple_schedule();
 
+   /**
+    * start - returns once every kernel is done, each kernel's
+    * thread counts down the latch as it finishes. Threads come
+    * from raft::thread_cache and go back there afterwards.
+    */
    virtual void start(); 
    
 protected:
@@ -43,34 +58,88 @@ protected:
                                 
    static void simple_run( void  *data );
 
+   /** 
+    * stage - a kernel the thread runs, a fused chain (fusion.hpp)
+    * has one per kernel in chain order, others just the one.
+    */
+   struct stage
+   {
+      stage( raft::kernel * const k ) : k( k ){}
+
+      raft::kernel                    *k         = nullptr;
+      bool                             finished  = false;
+      /** set by the fiber, the last slice called run() **/
+      bool                             ran       = false;
+      /** yielded from inside a FIFO, resume regardless of input **/
+      bool                             blocked   = false;
+      raft::ready_set                  ready;
+      /** per stage, a suspended one may still hold a peek **/
+      Buffer::Reclaimer                reclaimer;
+      std::unique_ptr< raft::fiber >   body;
+   };
+
+   using stages_t = std::vector< std::unique_ptr< stage > >;
+
    struct thread_data
    {
       constexpr thread_data( raft::kernel * const k,
                              bool *fin ) : k( k ),
                                            finished( fin ){}
 
-      raft::kernel *k         = nullptr;
-      bool         *finished  = nullptr;
-      core_id_t     loc       = -1;
+      raft::kernel     *k         = nullptr;
+      bool             *finished  = nullptr;
+      core_id_t         loc       = -1;
+      /** outlive the thread, producers may still hold them **/
+      Buffer::Doorbell *bell      = nullptr;
+      stages_t         *stages    = nullptr;
    };
    
    struct thread_info_t
    {
       thread_info_t( raft::kernel * const kernel ) : data( kernel, 
-                                                           &finished ),
-                                     th( simple_run,
-                                         reinterpret_cast< void* >( &data ) )
+                                                           &finished )
       {
+         for( auto *k( kernel ); k != nullptr; k = raft::fusion::next( k ) )
+         {
+            stages.emplace_back( new stage( k ) );
+         }
+         data.bell   = &bell;
+         data.stages = &stages;
       }
 
-      bool           finished = false;
-      bool           term     = false;
-      thread_data    data;
-      std::thread    th;
+      bool             finished = false;
+      thread_data      data;
+      Buffer::Doorbell bell;
+      stages_t         stages;
    };
 
+   /** runs of a fused stage before the next one gets a turn **/
+   static constexpr std::size_t fused_slice = 64;
+
+   /** 
+    * fused_run - simple_run for a chain, each stage is a fiber
+    * resumed in turn while it has input or is blocked.
+    */
+   static void fused_run( thread_data * const thread_d );
+
+   /** 
+    * help - raft::blocked_hook for fused chains, the blocked
+    * stage yields to the next one.
+    */
+   static bool help();
+   /** the stage this thread is in, for help() **/
+   static thread_local stage *fused_stage;
+
+   /** 
+    * wait_for_data - nothing ran, sleep until a stage can run
+    * or the doorbell's timeout passes.
+    */
+   static void wait_for_data( stages_t &stages, Buffer::Doorbell &bell );
+
    
    std::mutex                    thread_map_mutex;
    std::vector< thread_info_t* > thread_map;
+   /** one count per kernel still running **/
+   raft::latch                   running;
 };
 #endif /* END RAFTSIMPLESSCHEDULE_HPP */
@@ -0,0 +1,155 @@
+/**
+ * slabpool.tcc - per-FIFO object pool for ext_alloc element types.
+ * Those live outside the ring (the ring holds T*), without a pool
+ * every item costs a new on the producer side and a delete from
+ * wherever the item is finally consumed. The pool hands out
+ * fixed-size slots carved from slabs that are only ever allocated
+ * while the pool is growing, in steady state items cycle between
+ * the ring and the free list without touching the global allocator.
+ *
+ * Slots are taken by the FIFO's producer only, but can be returned
+ * from any thread: an item peeked on one edge may be pushed on as is
+ * to the next (see local_push) and is then freed by a kernel further
+ * downstream. Each slot carries its pool, returns go onto a lock-free
+ * stack (CAS push from any thread), the producer takes the whole
+ * stack at once with an exchange whenever its private list runs dry.
+ * There's only one taker so the usual ABA problem of lock-free
+ * stacks can't happen.
+ *
+ * Slots must be returned before the pool goes away, the runtime
+ * guarantees that since FIFOs are only destroyed once every kernel
+ * has exited. Items still queued then are dropped with the slabs.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSLABPOOL_TCC
+#define RAFTSLABPOOL_TCC  1
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "defs.hpp"
+#include "internaldefs.hpp"
+
+namespace Buffer
+{
+
+template < class T > class SlabPool
+{
+public:
+   /** slots in the first slab, each new slab doubles up to max **/
+   static constexpr std::size_t initial_slots = 16;
+   static constexpr std::size_t max_slots     = 1024;
+
+   SlabPool() = default;
+
+   ~SlabPool()
+   {
+      for( auto * const s : slabs )
+      {
+         ::operator delete( s, std::align_val_t( alignof( slot_t ) ) );
+      }
+   }
+
+   SlabPool( const SlabPool &other ) = delete;
+   SlabPool& operator = ( const SlabPool &other ) = delete;
+
+   /**
+    * get - uninitialized storage for one T, producer only.
+    * @return void*
+    */
+   void* get()
+   {
+      if( R_UNLIKELY( local == nullptr ) )
+      {
+         local = returned.exchange( nullptr, std::memory_order_acquire );
+         if( local == nullptr )
+         {
+            grow();
+         }
+      }
+      auto * const s( local );
+      local = s->next;
+      return( reinterpret_cast< void* >( s->storage ) );
+   }
+
+   /**
+    * put - return storage handed out by get() of whichever pool
+    * it came from, from any thread. ptr must not hold a live T.
+    * @param   ptr - T*, as returned by get
+    */
+   static void put( T * const ptr ) noexcept
+   {
+      auto * const s( reinterpret_cast< slot_t* >(
+         reinterpret_cast< char* >( ptr ) - offsetof( slot_t, storage ) ) );
+      auto * const pool( s->pool );
+      s->next = pool->returned.load( std::memory_order_relaxed );
+      while( ! pool->returned.compare_exchange_weak( s->next,
+                                                     s,
+                                                     std::memory_order_release,
+                                                     std::memory_order_relaxed ) );
+   }
+
+   /** destroy - run the destructor, return the slot **/
+   static void destroy( T * const ptr )
+   {
+      ptr->~T();
+      put( ptr );
+   }
+
+   /** slabs - number of slabs allocated so far **/
+   std::size_t slab_count() const noexcept
+   {
+      return( slabs.size() );
+   }
+
+private:
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) slot_t
+   {
+      SlabPool                        *pool;
+      slot_t                          *next;
+      alignas( T ) unsigned char       storage[ sizeof( T ) ];
+   };
+
+   /** grow - producer side, only called with an empty local list **/
+   void grow()
+   {
+      const auto n( std::min( max_slots, initial_slots << std::min(
+         slabs.size(), std::size_t( 6 ) ) ) );
+      auto * const slab( reinterpret_cast< slot_t* >(
+         ::operator new( n * sizeof( slot_t ),
+                         std::align_val_t( alignof( slot_t ) ) ) ) );
+      slabs.push_back( slab );
+      for( std::size_t i( 0 ); i < n; i++ )
+      {
+         slab[ i ].pool = this;
+         slab[ i ].next = ( i + 1 < n ? &slab[ i + 1 ] : nullptr );
+      }
+      local = slab;
+   }
+
+   /** producer private **/
+   slot_t                   *local = nullptr;
+   std::vector< slot_t* >   slabs;
+   /** stack of returned slots, pushed from anywhere **/
+   ALIGN( L1D_CACHE_LINE_SIZE ) std::atomic< slot_t* > returned = { nullptr };
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTSLABPOOL_TCC */
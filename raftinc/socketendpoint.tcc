@@ -0,0 +1,189 @@
+/**
+ * socketendpoint.tcc - kernels that splice a graph across two
+ * processes over a stream socket. Link the last kernel of the source
+ * side subgraph to a raft::socket_out< T >( address, channel ) in one
+ * process and a raft::socket_in< T >( address, channel ) to the first
+ * kernel of the sink side subgraph in the other, the two edges become
+ * the ends of one Type::TCP FIFO (see ringbuffertcp.tcc). All edges
+ * with the same address share one connection, the channel tells them
+ * apart, so a process can ship any number of edges to the other one
+ * over a single socket.
+ *
+ * e.g.,
+ * process A: raft::socket_out< int > out( "unix:/tmp/edge", 0 );
+ *            m.link( &source, &out );
+ * process B: raft::socket_in< int >  in( "unix:/tmp/edge", 0 );
+ *            m.link( &in, &sink );
+ *
+ * Addresses are "unix:/path" or "tcp:host:port", the receiving side
+ * listens, the sending side connects. As with the shared memory
+ * endpoints the kernels never touch data, they only keep their side
+ * of the graph alive until the edge is done, if the other process
+ * dies the graph on this side stops as if the edge was closed.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSOCKETENDPOINT_TCC
+#define RAFTSOCKETENDPOINT_TCC  1
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include "kernel.hpp"
+#include "port.hpp"
+#include "port_info.hpp"
+#include "alloc_traits.tcc"
+
+namespace raft
+{
+
+class socket_endpoint : public raft::kernel
+{
+public:
+    socket_endpoint( const std::string   &address,
+                     const std::uint32_t  channel ) : raft::kernel(),
+                                                      address( address ),
+                                                      channel( channel )
+    {
+    }
+
+    virtual ~socket_endpoint() = default;
+
+protected:
+    /**
+     * mark - tag the endpoint's single port so the allocator
+     * builds a socket FIFO for the edge attached to it.
+     * @param   port - Port&, input or output
+     */
+    void mark( Port &port )
+    {
+        auto &info( port.getPortInfo() );
+        info.socket_address = address;
+        info.socket_channel = channel;
+    }
+
+    /** closed - the socket FIFO on port is done **/
+    static bool closed( Port &port )
+    {
+        return( port.getPortInfo().getFIFO()->is_invalid() );
+    }
+
+    /** idle - endpoints only poll, don't hog a core doing it **/
+    static raft::kstatus idle()
+    {
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        return( raft::proceed );
+    }
+
+    const std::string   address;
+    const std::uint32_t channel;
+};
+
+/**
+ * socket_out - sink side of the local graph, the sending end
+ * of the socket FIFO.
+ */
+template < class T > class socket_out : public socket_endpoint
+{
+    static_assert( shm_alloc< T >::value,
+                   "socket FIFO items must be trivially copyable "
+                   "and fit in a cache line" );
+public:
+    socket_out( const std::string   &address,
+                const std::uint32_t  channel = 0 ) : socket_endpoint( address,
+                                                                      channel )
+    {
+#ifdef STRING_NAMES
+        input.addPort< T >( "0" );
+#else
+        input.addPort< T >( raft::port_key_name_t( 0, "0" ) );
+#endif
+        (this)->mark( input );
+    }
+
+    socket_out( const socket_out &other ) : socket_out( other.address,
+                                                        other.channel )
+    {
+    }
+
+    CLONE();
+
+    /**
+     * run - only scheduled while items wait for the link thread,
+     * stops once the edge is closed, whatever is left is drained
+     * (and the close sent) by the link before the FIFO goes away.
+     * @return raft::kstatus
+     */
+    virtual raft::kstatus run()
+    {
+        if( (this)->closed( input ) )
+        {
+            return( raft::stop );
+        }
+        return( (this)->idle() );
+    }
+};
+
+/**
+ * socket_in - source side of the local graph, the receiving
+ * end of the socket FIFO.
+ */
+template < class T > class socket_in : public socket_endpoint
+{
+    static_assert( shm_alloc< T >::value,
+                   "socket FIFO items must be trivially copyable "
+                   "and fit in a cache line" );
+public:
+    socket_in( const std::string   &address,
+               const std::uint32_t  channel = 0 ) : socket_endpoint( address,
+                                                                     channel )
+    {
+#ifdef STRING_NAMES
+        output.addPort< T >( "0" );
+#else
+        output.addPort< T >( raft::port_key_name_t( 0, "0" ) );
+#endif
+        (this)->mark( output );
+    }
+
+    socket_in( const socket_in &other ) : socket_in( other.address,
+                                                     other.channel )
+    {
+    }
+
+    CLONE();
+
+    /**
+     * run - once the sender has closed the edge (or its process
+     * is gone) stop, the kernels downstream then drain what is
+     * left in the ring.
+     * @return raft::kstatus
+     */
+    virtual raft::kstatus run()
+    {
+        if( (this)->closed( output ) )
+        {
+            return( raft::stop );
+        }
+        return( (this)->idle() );
+    }
+};
+
+} /** end namespace raft **/
+#endif /* END RAFTSOCKETENDPOINT_TCC */
@@ -0,0 +1,228 @@
+/**
+ * socketlink.hpp - one stream socket (AF_UNIX or TCP) between two
+ * processes that carries the items of any number of Type::TCP FIFOs
+ * (channels) in one direction. Each FIFO is an ordinary lock-free
+ * SPSC ring in its own process, the link's I/O thread is the far end
+ * of every ring: on the sending side it drains the rings, on the
+ * receiving side it fills them.
+ *
+ * On the wire a batch of items of one channel is a frame: a fixed
+ * header, the (sparse) signals of the batch, then the raw items. The
+ * sender gathers the frames of all channels that are ready into a
+ * single sendmsg, the items go straight from the rings (no copy),
+ * the receiver reads into a staging buffer and copies from there,
+ * anything larger than what's staged is read straight into the ring.
+ *
+ * Batching adapts per channel: a channel is flushed once it has
+ * batch items waiting or its oldest item has waited linger. A flush
+ * that found batch items doubles batch (the channel keeps up, fewer
+ * syscalls), one triggered by the timer with fewer than half halves
+ * it (keeps latency down at low rates).
+ *
+ * Addresses are "unix:/path" (or just "/path") and "tcp:host:port".
+ * The receiving side listens, the sending side connects, retrying
+ * for connect_timeout. Restrictions: items have to satisfy shm_alloc
+ * (raw bytes are sent), both ends have to be on hosts of the same
+ * byte order and ABI, data goes one way per address.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSOCKETLINK_HPP
+#define RAFTSOCKETLINK_HPP  1
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+#include "ringbuffertypes.hpp"
+
+namespace Buffer
+{
+
+/** sparse signal entry of a frame, offset is within the frame **/
+struct socket_signal_t
+{
+   std::uint32_t offset;
+   std::uint32_t sig;
+};
+
+/**
+ * SocketChannel - what the link's I/O thread needs from a FIFO,
+ * implemented by RingBufferBase< T, Type::TCP >. Only the sender
+ * or only the receiver half is ever called on a given channel.
+ */
+class SocketChannel
+{
+public:
+   virtual ~SocketChannel() = default;
+
+   virtual std::size_t item_size() const noexcept = 0;
+   virtual std::size_t channel_capacity() = 0;
+
+   /** sender: items waiting to be sent **/
+   virtual std::size_t outbound() = 0;
+   /**
+    * closed - sender: the producer is done, read before outbound().
+    * receiver: the local consumer is gone, the rest is dropped.
+    */
+   virtual bool        closed() = 0;
+   /**
+    * gather - sender: the next n items as up to two iovecs, signals
+    * among them appended to sigs. Items stay queued until sent().
+    * @return std::size_t, iovecs written
+    */
+   virtual std::size_t gather( const std::size_t n,
+                               struct iovec * const iov,
+                               std::vector< socket_signal_t > &sigs ) = 0;
+   virtual void        sent( const std::size_t n ) = 0;
+
+   /** receiver: free slots **/
+   virtual std::size_t inbound_space() = 0;
+   /**
+    * scatter - receiver: n free slots (n <= inbound_space()) as
+    * up to two iovecs to read items into.
+    * @return std::size_t, iovecs written
+    */
+   virtual std::size_t scatter( const std::size_t n,
+                                struct iovec * const iov ) = 0;
+   /** receiver: publish the n items scatter() handed out **/
+   virtual void        received( const std::size_t n,
+                                 const socket_signal_t * const sigs,
+                                 const std::size_t n_sigs ) = 0;
+
+   /**
+    * disconnect - nothing more will cross the link for this channel,
+    * either the producer closed it (receiver) or the peer is gone.
+    */
+   virtual void        disconnect( const bool peer_gone ) = 0;
+};
+
+class SocketLink
+{
+public:
+   /** how long a sender retries connecting, a receiver waits for it **/
+   static constexpr auto        connect_timeout = std::chrono::seconds( 10 );
+   /** longest an item waits for its batch to fill **/
+   static constexpr auto        linger          = std::chrono::microseconds( 100 );
+   static constexpr std::size_t initial_batch   = 64;
+   /** items per frame, also the upper bound for the adaptive batch **/
+   static constexpr std::size_t max_batch       = 4096;
+
+   /** make_new_fifo data for Type::TCP, which end to build **/
+   struct endpoint_t
+   {
+      const std::string   address;
+      const std::uint32_t channel;
+      Direction           dir;
+   };
+
+   /**
+    * get - the link for address in this process, created on first
+    * use, shared by all channels that go the same way.
+    * @param   address - const std::string&
+    * @param   dir     - Direction, Producer sends, Consumer receives
+    * @return  std::shared_ptr< SocketLink >
+    */
+   static std::shared_ptr< SocketLink > get( const std::string &address,
+                                             const Direction    dir );
+
+   ~SocketLink();
+
+   SocketLink( const SocketLink &other ) = delete;
+   SocketLink& operator = ( const SocketLink &other ) = delete;
+
+   /** add - register channel id, ids must be unique per link **/
+   void add( const std::uint32_t id, SocketChannel * const channel );
+
+   /**
+    * remove - unregister id, on the sending side this waits until
+    * everything queued on the channel has been sent.
+    */
+   void remove( const std::uint32_t id );
+
+private:
+   SocketLink( const std::string &address, const Direction dir );
+
+   struct channel_t
+   {
+      SocketChannel *channel   = nullptr;
+      std::size_t    batch     = initial_batch;
+      bool           waiting   = false;
+      std::chrono::steady_clock::time_point first;
+      /** sender: close frame is out, receiver: close frame is in **/
+      bool           done      = false;
+   };
+
+   /** frame header, followed by signals * socket_signal_t and the items **/
+   struct frame_t
+   {
+      std::uint32_t channel;
+      std::uint32_t items;
+      std::uint32_t signals;
+      std::uint16_t item_size;
+      std::uint16_t flags;
+   };
+
+   static constexpr std::uint16_t close_flag = 1;
+
+   void run_sender();
+   void run_receiver();
+
+   void open_listener();
+   void connect_peer();
+   void accept_peer();
+
+   /** sender, false if the peer is gone **/
+   bool write_all( std::vector< struct iovec > &iov );
+   /** receiver, false on EOF/error **/
+   bool read_exact( void *dst, const std::size_t n );
+   bool read_items( struct iovec * const iov, const std::size_t n_iov );
+   bool discard( std::size_t n );
+   /** receiver, waits for the channel to be registered, nullptr on stop **/
+   channel_t* lookup( const std::uint32_t id, std::unique_lock< std::mutex > &lk );
+
+   void peer_gone();
+   [[noreturn]] void fail( const char * const what ) const;
+
+   const std::string   address;
+   const Direction     dir;
+   int                 listen_fd = -1;
+   int                 fd        = -1;
+   std::string         unix_path = "";
+
+   std::mutex                          lock;
+   std::map< std::uint32_t, channel_t > channels;
+   std::atomic< bool >                 stop    = { false };
+   std::atomic< bool >                 dead    = { false };
+
+   /** receiver staging buffer **/
+   std::vector< char >  staging;
+   std::size_t          staged_begin = 0;
+   std::size_t          staged_end   = 0;
+
+   std::thread          io;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTSOCKETLINK_HPP */
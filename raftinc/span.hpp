@@ -0,0 +1,87 @@
+/**
+ * span.hpp - minimal non-owning view over contiguous FIFO
+ * storage, stands in for std::span (C++20) while the library
+ * builds as C++17. A ring buffer range wraps at most once, so
+ * span_pair holds the part before the wrap point (first) and
+ * the part after it (second), second is empty if it didn't wrap.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSPAN_HPP
+#define RAFTSPAN_HPP  1
+#include <cstddef>
+
+namespace raft
+{
+
+template < class T > class span
+{
+public:
+    using element_type = T;
+    using value_type   = T;
+    using size_type    = std::size_t;
+    using pointer      = T*;
+    using reference    = T&;
+    using iterator     = T*;
+
+    constexpr span() noexcept = default;
+
+    constexpr span( T * const ptr, const std::size_t count ) noexcept :
+        ptr( ptr ),
+        count( count )
+    {
+    }
+
+    constexpr T*          data()  const noexcept { return( ptr ); }
+    constexpr std::size_t size()  const noexcept { return( count ); }
+    constexpr bool        empty() const noexcept { return( count == 0 ); }
+    constexpr T*          begin() const noexcept { return( ptr ); }
+    constexpr T*          end()   const noexcept { return( ptr + count ); }
+
+    constexpr T& operator []( const std::size_t index ) const noexcept
+    {
+        return( ptr[ index ] );
+    }
+
+private:
+    T           *ptr   = nullptr;
+    std::size_t  count = 0;
+};
+
+template < class T > struct span_pair
+{
+    /** items up to the wrap point, never empty for n > 0 **/
+    span< T > first;
+    /** items after the wrap point, if any **/
+    span< T > second;
+
+    constexpr std::size_t size() const noexcept
+    {
+        return( first.size() + second.size() );
+    }
+
+    /** convenience for scalar code, SIMD code should walk the spans **/
+    constexpr T& operator []( const std::size_t index ) const noexcept
+    {
+        return( index < first.size() ? first[ index ] :
+                                       second[ index - first.size() ] );
+    }
+};
+
+} /** end namespace raft **/
+#endif /* END RAFTSPAN_HPP */
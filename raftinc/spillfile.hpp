@@ -0,0 +1,122 @@
+/**
+ * spillfile.hpp - backing file for the cold segments of a spilling
+ * Type::Infinite FIFO (see ringbufferinfinite.tcc). One unlinked
+ * temporary file per FIFO, created the first time a segment goes to
+ * disk, each segment is a page aligned region of it mapped shared.
+ * Once the producer is done with a segment its pages are written
+ * back and dropped from memory, when the consumer gets to it the
+ * region is read back sequentially with readahead, once drained its
+ * blocks are released (hole punched). When no region is live the
+ * file is truncated and offsets start over.
+ *
+ * Regions are mapped by the producer and released by the consumer,
+ * both slow paths, a lock keeps the file bookkeeping straight.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTSPILLFILE_HPP
+#define RAFTSPILLFILE_HPP  1
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+namespace Buffer
+{
+
+/**
+ * SpillConfig - handed to RingBuffer< T, Type::Infinite >::make_new_fifo
+ * by the allocator, see MapBase::setSpillBudget/setSpillDirectory.
+ */
+struct SpillConfig
+{
+    /** bytes of segments a FIFO keeps in memory before spilling **/
+    std::size_t ram_budget  = ( 64 << 20 );
+    /** where the spill file goes, empty for $TMPDIR or /tmp **/
+    std::string directory;
+};
+
+/** SpillStats - see FIFO::get_spill_stats **/
+struct SpillStats
+{
+    /** bytes of in-memory segments right now **/
+    std::size_t     ram_bytes       = 0;
+    /** bytes of spill file mapped right now **/
+    std::size_t     file_bytes      = 0;
+    /** bytes of items written out to the file so far **/
+    std::uint64_t   spilled_bytes   = 0;
+    /** segments placed in the file so far **/
+    std::uint64_t   spill_segments  = 0;
+};
+
+class SpillFile
+{
+public:
+    /** readahead window when the consumer enters a segment **/
+    static constexpr std::size_t readahead_bytes = ( 4 << 20 );
+
+    explicit SpillFile( const std::string &directory );
+
+    ~SpillFile();
+
+    SpillFile( const SpillFile &other ) = delete;
+    SpillFile& operator = ( const SpillFile &other ) = delete;
+
+    /**
+     * map - new region of at least bytes, its blocks reserved on
+     * disk. Exits if the file can't be created or mapped.
+     * @param   bytes  - const std::size_t
+     * @param   offset - std::size_t&, region start in the file
+     * @param   length - std::size_t&, region length, page multiple
+     * @return  void* - start of the mapping, nullptr if the disk
+     *                  has no room for it
+     */
+    void* map( const std::size_t bytes,
+               std::size_t &offset,
+               std::size_t &length );
+
+    /** release - unmap a region from map and free its blocks **/
+    void release( void * const base,
+                  const std::size_t offset,
+                  const std::size_t length ) noexcept;
+
+    /** mapped - bytes of live regions **/
+    std::size_t mapped() noexcept;
+
+    /** write_back - producer is done with the region, push it to disk **/
+    static void write_back( void * const base, const std::size_t length ) noexcept;
+
+    /** read_back - consumer starts on the region, sequential + readahead **/
+    static void read_back( void * const base, const std::size_t length ) noexcept;
+
+private:
+    void create();
+
+    [[noreturn]] void fail( const char * const what );
+
+    const std::string   directory;
+    std::string         path;
+    int                 fd          = -1;
+    /** end of the last region **/
+    std::size_t         end         = 0;
+    std::size_t         live        = 0;
+    std::mutex          lock;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTSPILLFILE_HPP */
@@ -49,6 +49,15 @@ static inline void yield()
     return;
 }
 
+/**
+ * blocked_hook - set by schedulers that run more than one kernel
+ * per thread, called by a FIFO side that is blocked. Returning true
+ * means the hook got other work done, the caller re-checks its
+ * queue right away instead of waiting.
+ */
+using blocked_hook_t = bool (*)();
+extern thread_local blocked_hook_t blocked_hook;
+
 } /** end namespace raft **/
 
 #endif /* END RAFTSYSSCHEDUTIL_HPP */
@@ -0,0 +1,106 @@
+/**
+ * threadcache.hpp - process wide cache of idle threads, so running
+ * many small maps one after another doesn't create and tear down a
+ * thread per kernel every time. run() hands the job to an idle
+ * thread or starts a new one, a thread that finishes a job waits up
+ * to linger for the next before it exits. Jobs get the thread back
+ * with the CPU affinity it started with, whatever the last job
+ * pinned it to.
+ *
+ * latch - countdown the caller waits on in place of joining the
+ * threads, the count can go up while it's being waited on (e.g.,
+ * kernels the parallelism monitor adds while the map runs).
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTTHREADCACHE_HPP
+#define RAFTTHREADCACHE_HPP  1
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace raft
+{
+
+class latch
+{
+public:
+   explicit latch( const std::size_t n = 0 ) : count( n )
+   {
+   }
+
+   latch( const latch &other ) = delete;
+   latch& operator = ( const latch &other ) = delete;
+
+   void add( const std::size_t n = 1 )
+   {
+      std::lock_guard< std::mutex > guard( lock );
+      count += n;
+   }
+
+   /** count_down - wakes the waiters once the count reaches 0 **/
+   void count_down()
+   {
+      std::lock_guard< std::mutex > guard( lock );
+      if( --count == 0 )
+      {
+         /** under the lock, the latch may be gone once wait() returns **/
+         cv.notify_all();
+      }
+   }
+
+   void wait()
+   {
+      std::unique_lock< std::mutex > guard( lock );
+      cv.wait( guard, [&](){ return( count == 0 ); } );
+   }
+
+private:
+   std::mutex              lock;
+   std::condition_variable cv;
+   std::size_t             count;
+};
+
+class thread_cache
+{
+public:
+   using job_t = std::function< void() >;
+
+   /** how long an idle thread waits for another job **/
+   static constexpr auto linger = std::chrono::seconds( 5 );
+
+   /**
+    * run - start job on a cached thread, never blocks on
+    * other jobs. The caller waits for it some other way,
+    * e.g., with a latch.
+    * @param   job - job_t
+    */
+   static void run( job_t job );
+
+   /** created - threads started since the process began **/
+   static std::uint64_t created() noexcept;
+
+   /** idle - threads waiting for a job right now **/
+   static std::size_t idle() noexcept;
+};
+
+} /** end namespace raft **/
+#endif /* END RAFTTHREADCACHE_HPP */
@@ -0,0 +1,241 @@
+/**
+ * waitstrategy.hpp - what a FIFO side does while it is blocked,
+ * i.e., the producer on a full queue or the consumer on an empty
+ * one. Spin is the classic behavior (pause, then raft::yield()
+ * which is a no-op unless NICE/USEQTHREADS is set). Yield spins
+ * for a bit then gives the core away. Park spins, yields, then
+ * sleeps on a futex that the opposite side wakes once it makes
+ * progress, so mostly idle graphs (or graphs with more kernels
+ * than cores) don't burn a core per blocked kernel.
+ *
+ * Parking is two-phase so a wakeup can't get lost: the first
+ * call registers the sleeper and returns so the caller re-checks
+ * its condition, only the next call actually sleeps. A park ends
+ * when the other side makes progress or the FIFO calls wake_all()
+ * (invalidate, resize), park_timeout is only a safety net so an
+ * idle side stays off the core.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTWAITSTRATEGY_HPP
+#define RAFTWAITSTRATEGY_HPP  1
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include "defs.hpp"
+#include "readyset.hpp"
+#include "internaldefs.hpp"
+#include "sysschedutil.hpp"
+#include "waittypes.hpp"
+
+namespace Buffer
+{
+
+class WaitStrategy
+{
+public:
+   /** pause iterations before a blocked side starts yielding **/
+   static constexpr std::uint32_t spin_limit  = 128;
+   /** yields before a blocked side parks (Park only) **/
+   static constexpr std::uint32_t yield_limit = 64;
+   /** upper bound on a single park, wakeups are what end it **/
+   static constexpr auto park_timeout = std::chrono::milliseconds( 50 );
+   /** no futex, how often a parked side looks for a wakeup **/
+   static constexpr auto park_nap     = std::chrono::milliseconds( 1 );
+
+   WaitStrategy() = default;
+
+   WaitStrategy( const WaitStrategy &other ) = delete;
+   WaitStrategy& operator = ( const WaitStrategy &other ) = delete;
+
+   /**
+    * set_policy - must be called before either side runs, the
+    * allocator does so right after building the FIFO.
+    * @param   p - Wait::Policy
+    */
+   void set_policy( const Wait::Policy p ) noexcept
+   {
+      policy = p;
+   }
+
+   Wait::Policy get_policy() const noexcept
+   {
+      return( policy );
+   }
+
+   /**
+    * set_ready - the consumer kernel's ready set, bit is set
+    * after every produced() and the set is poked on wake_all()
+    * whatever the policy.
+    * @param   r   - raft::ready_set*, nullptr for none
+    * @param   bit - const std::size_t, this FIFO's port
+    */
+   void set_ready( raft::ready_set * const r, const std::size_t bit ) noexcept
+   {
+      ready_bit = bit;
+      ready.store( r, std::memory_order_release );
+   }
+
+   /** blocked on a full queue, call once per failed attempt **/
+   inline void producer_block()
+   {
+      block( producer );
+   }
+
+   /** blocked on an empty queue, call once per failed attempt **/
+   inline void consumer_block()
+   {
+      block( consumer );
+   }
+
+   /**
+    * produced - producer made items visible to the consumer,
+    * call after the index store. Wakes a parked consumer.
+    */
+   inline void produced() noexcept
+   {
+      progress( producer, consumer );
+      ring();
+   }
+
+   /**
+    * consumed - consumer freed slots, call after the index
+    * store. Wakes a parked producer.
+    */
+   inline void consumed() noexcept
+   {
+      progress( consumer, producer );
+   }
+
+   /**
+    * wake_all - kick both sides out of a park, e.g., on
+    * invalidate or when a resize needs them to check in.
+    */
+   void wake_all() noexcept;
+
+   void get_stats( Wait::Stats &copy ) const noexcept;
+
+private:
+   struct ALIGN( L1D_CACHE_LINE_SIZE ) side_t
+   {
+      /** failed attempts since the last progress, owner only **/
+      std::uint32_t                  attempts  = 0;
+      /** registered to park, owner only **/
+      bool                           armed     = false;
+      std::uint32_t                  armed_epoch = 0;
+      /** parked (or about to), read by the other side **/
+      std::atomic< std::uint32_t >   sleepers  = { 0 };
+      /** futex word, bumped by the other side to wake us **/
+      std::atomic< std::uint32_t >   epoch     = { 0 };
+      std::uint64_t                  yields    = 0;
+      std::uint64_t                  parks     = 0;
+   };
+
+   inline void block( side_t &self )
+   {
+      if( R_UNLIKELY( raft::blocked_hook != nullptr ) && raft::blocked_hook() )
+      {
+         return;
+      }
+      if( R_LIKELY( policy == Wait::Spin ) )
+      {
+         pause();
+         raft::yield();
+         return;
+      }
+      const auto a( self.attempts++ );
+      if( a < spin_limit )
+      {
+         pause();
+         return;
+      }
+      if( policy == Wait::Yield || a < spin_limit + yield_limit )
+      {
+         self.yields++;
+         sys_yield();
+         return;
+      }
+      park( self );
+   }
+
+   inline void progress( side_t &self, side_t &other ) noexcept
+   {
+      if( R_LIKELY( policy != Wait::Park ) )
+      {
+         if( R_UNLIKELY( self.attempts != 0 ) )
+         {
+            self.attempts = 0;
+         }
+         return;
+      }
+      if( R_UNLIKELY( self.attempts != 0 ) )
+      {
+         self.attempts = 0;
+         disarm( self );
+      }
+      /**
+       * pairs with the seq_cst fetch_add in park, either we
+       * see the sleeper or it sees what we just published
+       */
+      std::atomic_thread_fence( std::memory_order_seq_cst );
+      if( R_UNLIKELY( other.sleepers.load( std::memory_order_relaxed ) != 0 ) )
+      {
+         wake( other );
+      }
+   }
+
+   inline void ring() noexcept
+   {
+      auto * const r( ready.load( std::memory_order_acquire ) );
+      if( r != nullptr )
+      {
+         r->set( ready_bit );
+      }
+   }
+
+   static inline void pause() noexcept
+   {
+#if __x86_64
+      __asm__ volatile("\
+        pause"
+        :
+        :
+        : );
+#endif
+   }
+
+   /**
+    * sys_yield - unlike raft::yield() this always gives up
+    * the core, that's the point of the Yield/Park policies.
+    */
+   static void sys_yield() noexcept;
+
+   void park( side_t &self );
+   static void disarm( side_t &self ) noexcept;
+   static void wake( side_t &s ) noexcept;
+
+   Wait::Policy policy = Wait::Spin;
+   side_t       producer;
+   side_t       consumer;
+   /** consumer kernel's ready set, set once its thread starts **/
+   std::atomic< raft::ready_set* > ready = { nullptr };
+   std::size_t                     ready_bit = 0;
+};
+
+} /** end namespace Buffer **/
+#endif /* END RAFTWAITSTRATEGY_HPP */
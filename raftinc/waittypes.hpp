@@ -0,0 +1,48 @@
+/**
+ * waittypes.hpp - wait policies for blocked FIFO operations,
+ * see waitstrategy.hpp for what each one does.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTWAITTYPES_HPP
+#define RAFTWAITTYPES_HPP  1
+#include <array>
+#include <cstdint>
+
+namespace Wait
+{
+   enum Policy { Spin, Yield, Park, N };
+
+   static constexpr std::array< const char[6], Wait::N > policy_prints
+                             = {{ "Spin", "Yield", "Park" }};
+
+   /**
+    * Stats - what a FIFO's blocked sides have been doing, counts
+    * are per side and only written by the thread owning that side.
+    */
+   struct Stats
+   {
+      Wait::Policy   policy          = Wait::Spin;
+      std::uint64_t  producer_yields = 0;
+      std::uint64_t  producer_parks  = 0;
+      std::uint64_t  consumer_yields = 0;
+      std::uint64_t  consumer_parks  = 0;
+   };
+}
+
+#endif /* END RAFTWAITTYPES_HPP */
@@ -0,0 +1,199 @@
+/**
+ * workstealschedule.hpp - thread pool scheduler that doesn't need
+ * qthreads. A fixed set of std::thread workers (one per online core
+ * unless MapBase::setSchedulerThreads says otherwise), each pinned to
+ * its core and owning a deque of kernels. A worker takes kernels from
+ * the front of its own deque, runs them for a slice (up to slice_runs
+ * runs, fewer once they run out of data) and puts them back at the
+ * end of the deque of their home worker, the one on the core the
+ * kernel is assigned to (getCoreAssignment() is a preference, not a
+ * rule). A worker with nothing to do steals from the back of another
+ * worker's deque. A kernel is in exactly one deque or running, never
+ * both, so it never runs concurrently with itself.
+ *
+ * A kernel that blocks inside a FIFO would hold its worker, with
+ * fewer workers than kernels the kernel it waits on might never get
+ * to run. Each kernel runs in its own raft::fiber, the wait strategy
+ * calls raft::blocked_hook while blocked and here that yields the
+ * fiber back to the worker, which queues the kernel again and goes
+ * on with the next one. Running the next one in place instead would
+ * freeze the blocked kernel underneath it, a deadlock as soon as the
+ * one on top waits for the one below. A kernel that yielded mid-run
+ * has its stack on the worker's thread, it isn't stolen until its
+ * slice ends. Without fibers (see fiber.hpp) a blocked worker does
+ * run queued kernels in place, up to help_depth deep.
+ *
+ * Only kernels that can run are queued. A kernel whose ready set
+ * (readyset.hpp) says none of its inputs have data after a run is
+ * parked instead of going back to a deque, the first push to one of
+ * its inputs (or an invalidate) queues it again from the producer's
+ * thread. Taking a kernel is then O(1) whatever the number of idle
+ * kernels, no worker walks their ports. Idle workers sweep the
+ * parked kernels with a full port check now and then, which covers
+ * the rare wakeup lost to the ready set's producer race.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef RAFTWORKSTEALSCHEDULE_HPP
+#define RAFTWORKSTEALSCHEDULE_HPP  1
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "schedule.hpp"
+#include "fiber.hpp"
+#include "reclaimer.hpp"
+#include "readyset.hpp"
+#include "threadcache.hpp"
+#include "defs.hpp"
+
+namespace raft{
+   class kernel;
+   class map;
+}
+
+class work_steal_schedule : public Schedule
+{
+public:
+   /** runs per turn on a worker, while the kernel has data **/
+   static constexpr std::size_t slice_runs = 64;
+   /** nested kernel runs a blocked worker may start, no fibers only **/
+   static constexpr int help_depth = 4;
+   /** empty picks in a row before an idle worker yields, then sleeps **/
+   static constexpr std::uint32_t spin_picks  = 64;
+   static constexpr std::uint32_t yield_picks = 128;
+
+   work_steal_schedule( raft::map &map );
+
+   virtual ~work_steal_schedule() = default;
+
+   virtual void start();
+
+   /** workers - number of worker threads in the pool **/
+   std::size_t workers() const noexcept
+   {
+      return( pool.size() );
+   }
+
+protected:
+   virtual void handleSchedule( raft::kernel * const kernel );
+
+   enum task_state : int { queued = 0, running, parked };
+
+   static constexpr std::size_t unpinned =
+      std::numeric_limits< std::size_t >::max();
+
+   /** one per kernel, moves between the deques **/
+   struct task
+   {
+      task( raft::kernel        * const k,
+            const std::size_t         home,
+            work_steal_schedule * const sched ) : k( k ),
+                                                  home( home ),
+                                                  sched( sched )
+      {
+      }
+
+      raft::kernel         *k        = nullptr;
+      /** worker whose deque the task goes back to **/
+      const std::size_t     home     = 0;
+      work_steal_schedule  *sched    = nullptr;
+      volatile bool         finished = false;
+      /** per task so the kernel can hop workers between runs **/
+      Buffer::Reclaimer     reclaimer;
+      raft::ready_set       ready;
+      /** parked -> queued by whoever wins the CAS, see wake() **/
+      std::atomic< int >    state    = { queued };
+      /** runs the slices, nullptr without fiber support **/
+      std::unique_ptr< raft::fiber > body;
+      /** set by the fiber, some run in the last turn did work **/
+      bool                  ran      = false;
+      /** set by help(), the fiber yielded inside a FIFO **/
+      bool                  blocked  = false;
+      /** worker whose thread has the fiber mid-slice **/
+      std::size_t           pinned   = unpinned;
+   };
+
+
+   struct worker
+   {
+      std::mutex            lock;
+      std::deque< task* >   queue;
+      core_id_t             core    = -1;
+      /** kernels running on this thread, > 1 while helping **/
+      int                   depth   = 0;
+      /** task whose fiber this thread is in, for help() **/
+      task                 *current = nullptr;
+   };
+
+   /** work - worker main loop **/
+   void work( const std::size_t id );
+
+   /**
+    * run_one - pick a kernel (own deque first, then steal), run
+    * a slice of it and put it back unless it finished.
+    * @param   id - const std::size_t, calling worker
+    * @return  bool - true if a kernel did work
+    */
+   bool run_one( const std::size_t id );
+
+   task* take( const std::size_t id );
+
+   void push( task * const t );
+
+   /**
+    * park - take t off the deques until its ready set fires,
+    * queues it right away if that happened while parking.
+    * @param   t - task*, just ran, not finished
+    */
+   void park( task * const t );
+
+   /** wake - ready set listener, arg is the task **/
+   static void wake( void * const arg );
+
+   /** sweep - queue parked tasks that have data, by asking the ports **/
+   void sweep();
+
+   /**
+    * slice - fiber body of t, runs t until it blocks, runs out
+    * of data or slice_runs is up, yields and starts over.
+    */
+   static void slice( task * const t );
+
+   /** hook for raft::blocked_hook, runs on a blocked worker **/
+   static bool help();
+
+   std::vector< std::unique_ptr< worker > >  pool;
+   std::mutex                                tasks_mutex;
+   std::vector< std::unique_ptr< task > >    tasks;
+   /** round robin home for kernels without a core **/
+   std::size_t                               next_home = 0;
+
+   std::mutex                                done_mutex;
+   std::condition_variable                   done_cv;
+   std::size_t                               remaining = 0;
+   std::atomic< bool >                       done      = { false };
+   /** workers run on raft::thread_cache threads, counted out here **/
+   raft::latch                               stopped;
+};
+#endif /* END RAFTWORKSTEALSCHEDULE_HPP */
@@ -27,6 +27,7 @@
 #include <functional>
 #include <type_traits>
 #include <cassert>
+#include <algorithm>
 
 namespace raft{
 
@@ -58,21 +59,45 @@ public:
                             "avail_data size must be unsigned" );
             if( avail_data != 0 )
             {
-                auto alldata( port.template peek_range< T >( avail_data ) );
-
-                using index_type = std::remove_const_t<decltype(avail_data)>;
-                for( index_type index( 0 ); index < avail_data; index++ )
-                {
-                   (*inserter) = alldata[ index ].ele;
-                   /** hope the iterator defined overloaded ++ **/
-                   ++inserter;
-                }
-                port.recycle( avail_data  );
+                drain( port, avail_data );
             }
         }
         return( raft::proceed );
     }
 private:
+    /**
+     * drain - inline types are copied out straight from the
+     * buffer, one contiguous run on either side of the wrap.
+     */
+    template < class U = T,
+               typename std::enable_if< inline_alloc< U >::value >::type* = nullptr >
+    void drain( FIFO &port, const std::size_t avail_data )
+    {
+        const auto alldata( port.template peek_span< T >( avail_data ) );
+        inserter = std::copy( alldata.first.begin(),
+                              alldata.first.end(),
+                              inserter );
+        inserter = std::copy( alldata.second.begin(),
+                              alldata.second.end(),
+                              inserter );
+        port.unpeek();
+        port.recycle( avail_data );
+    }
+
+    template < class U = T,
+               typename std::enable_if< ! inline_alloc< U >::value >::type* = nullptr >
+    void drain( FIFO &port, const std::size_t avail_data )
+    {
+        auto alldata( port.template peek_range< T >( avail_data ) );
+        for( std::size_t index( 0 ); index < avail_data; index++ )
+        {
+           (*inserter) = alldata[ index ].ele;
+           /** hope the iterator defined overloaded ++ **/
+           ++inserter;
+        }
+        port.recycle( avail_data );
+    }
+
     BackInsert inserter;
 };
 
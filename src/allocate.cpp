@@ -17,6 +17,7 @@
  * See the License for the specific language governing permissions and
  * limitations under the License.
  */
+#include <algorithm>
 #include <cassert>
 #include <thread>
 
@@ -26,11 +27,24 @@
 #include "port_info.hpp"
 #include "map.hpp"
 #include "portexception.hpp"
+#include "shmsegment.hpp"
+#include "socketlink.hpp"
+#include "numaplace.hpp"
+#include "cacheinfo.hpp"
+#include "pagemap.hpp"
+#include "graphtools.hpp"
 
 Allocate::Allocate( raft::map &map, volatile bool &exit_alloc ) :
    source_kernels( map.source_kernels ),
    all_kernels(    map.all_kernels ),
-   exit_alloc( exit_alloc )
+   exit_alloc( exit_alloc ),
+   wait_policy( map.wait_policy ),
+   huge_pages( map.huge_pages ),
+   spill( map.spill ),
+   memory_budget( map.fifo_budget ),
+   memory_used( map.fifo_used ),
+   memory_peak( map.fifo_peak ),
+   warm( map.warm_profile )
 {
 }
 
@@ -45,7 +59,143 @@ Allocate::~Allocate()
 void
 Allocate::waitTillReady()
 {
-   while( ! ready );
+   while( ! ready )
+   {
+      std::this_thread::yield();
+   }
+}
+
+void
+Allocate::wake()
+{
+   std::lock_guard< std::mutex > guard( idle_mutex );
+   idle_cv.notify_all();
+}
+
+void
+Allocate::idle( const std::chrono::microseconds dura )
+{
+   std::unique_lock< std::mutex > guard( idle_mutex );
+   idle_cv.wait_for( guard, dura, [&](){ return( exit_alloc ); } );
+}
+
+void
+Allocate::report_placement( std::ostream &stream )
+{
+   auto report_func( [ &stream ]( PortInfo &a, PortInfo &b, void *data )
+   {
+      UNUSED( data );
+      auto * const fifo( a.getFIFO() );
+      if( fifo == nullptr )
+      {
+         return;
+      }
+      Placement::Info info;
+      fifo->get_placement( info );
+      stream << a.my_kernel->get_id() << ":" <<
+         a.my_kernel->output.getPortName( a.my_name ) << " -> " <<
+         b.my_kernel->get_id() << ":" <<
+         b.my_kernel->input.getPortName( b.my_name ) <<
+         " home_node " << info.home_node <<
+         " resident_node " << info.resident_node <<
+         " bytes " << info.bytes;
+      /** Type::Infinite edges, see ringbufferinfinite.tcc **/
+      Buffer::SpillStats spill;
+      fifo->get_spill_stats( spill );
+      if( spill.spill_segments > 0 )
+      {
+         stream << " spilled_bytes " << spill.spilled_bytes <<
+            " spill_segments " << spill.spill_segments;
+      }
+      stream << "\n";
+   } );
+   auto &container( source_kernels.acquire() );
+   GraphTools::BFS( container, report_func );
+   source_kernels.release();
+}
+
+void
+Allocate::profile( Profile &learned )
+{
+   auto profile_func( [ & ]( PortInfo &a, PortInfo &b, void *data )
+   {
+      UNUSED( data );
+      auto * const fifo( a.getFIFO() );
+      if( fifo == nullptr )
+      {
+         return;
+      }
+      Profile::Edge edge;
+      (this)->describe( fifo, edge );
+      learned.set_edge( a, b, edge );
+   } );
+   auto &container( source_kernels.acquire() );
+   GraphTools::BFS( container, profile_func );
+   source_kernels.release();
+}
+
+void
+Allocate::describe( FIFO * const fifo, Profile::Edge &edge )
+{
+   edge.capacity = fifo->capacity();
+}
+
+std::size_t
+Allocate::initial_capacity( PortInfo &a, PortInfo &b )
+{
+   if( a.item_size == 0 )
+   {
+      return( INITIAL_ALLOC_SIZE );
+   }
+   const auto producer( a.my_kernel->getCoreAssignment() );
+   const auto consumer( b.my_kernel->getCoreAssignment() );
+   const auto level( Cache::shared_level( producer, consumer ) );
+   auto bytes( Cache::data( consumer, level > 0 ? level : 1 ).share() / 2 );
+   if( bytes == 0 )
+   {
+      bytes = INITIAL_ALLOC_SIZE * a.item_size;
+   }
+   if( memory_budget != 0 )
+   {
+      if( edge_count == 0 )
+      {
+         auto &container( all_kernels.acquire() );
+         for( auto * const k : container )
+         {
+            edge_count += k->output.count();
+         }
+         all_kernels.release();
+      }
+      bytes = std::min( bytes, memory_budget / std::max< std::size_t >( edge_count, 1 ) );
+   }
+   /** a few items even when one is bigger than the cache **/
+   static constexpr std::size_t min_items( 4 );
+   static constexpr std::size_t max_items( INITIAL_ALLOC_SIZE << 10 );
+   std::size_t items( min_items );
+   while( items < max_items && ( items << 1 ) * a.item_size <= bytes )
+   {
+      items <<= 1;
+   }
+   return( items );
+}
+
+std::size_t
+Allocate::account()
+{
+   std::size_t used( 0 );
+   for( auto * const fifo : allocated_fifo )
+   {
+      if( shared_fifo.find( fifo ) == shared_fifo.end() )
+      {
+         used += fifo->get_storage_bytes();
+      }
+   }
+   memory_used.store( used, std::memory_order_relaxed );
+   if( used > memory_peak.load( std::memory_order_relaxed ) )
+   {
+      memory_peak.store( used, std::memory_order_relaxed );
+   }
+   return( used );
 }
 
 void
@@ -87,11 +237,54 @@ void
 Allocate::allocate( PortInfo &a, PortInfo &b, void *data )
 {
    UNUSED( data );
+   if( share( a, b ) )
+   {
+      return;
+   }
    FIFO *fifo( nullptr );
-   auto &func_map( a.const_map[ Type::Heap ] );
+   /**
+    * FIFO type is picked by the link, else the producer kernel,
+    * fall back to the heap FIFO if there's no builder for it.
+    */
+   auto type( a.fifo_type != Type::N ? a.fifo_type : a.my_kernel->getBufferType() );
+   if( a.const_map.find( type ) == a.const_map.end() )
+   {
+      type = Type::Heap;
+   }
+   auto &func_map( a.const_map[ type ] );
    auto test_func( (*func_map)[ false ] );
 
-   if( a.existing_buffer != nullptr )
+   if( ! a.shm_key.empty() || ! b.shm_key.empty() )
+   {
+      /**
+       * edge into raft::shm_out holds the producer end of a FIFO
+       * to another process, the edge out of raft::shm_in the
+       * consumer end
+       */
+      Buffer::SHMSegment::endpoint_t endpoint{
+         b.shm_key.empty() ? a.shm_key : b.shm_key,
+         b.shm_key.empty() ? Direction::Consumer : Direction::Producer };
+      auto shm_func( (*a.const_map[ Type::SharedMemory ])[ false ] );
+      fifo = shm_func( a.fixed_buffer_size != 0 ? a.fixed_buffer_size :
+                                                  INITIAL_ALLOC_SIZE,
+                       ALLOC_ALIGN_WIDTH,
+                       &endpoint );
+   }
+   else if( ! a.socket_address.empty() || ! b.socket_address.empty() )
+   {
+      /** same for raft::socket_out/raft::socket_in **/
+      const auto &remote( b.socket_address.empty() ? a : b );
+      Buffer::SocketLink::endpoint_t endpoint{
+         remote.socket_address,
+         remote.socket_channel,
+         b.socket_address.empty() ? Direction::Consumer : Direction::Producer };
+      auto socket_func( (*a.const_map[ Type::TCP ])[ false ] );
+      fifo = socket_func( a.fixed_buffer_size != 0 ? a.fixed_buffer_size :
+                                                     INITIAL_ALLOC_SIZE,
+                          ALLOC_ALIGN_WIDTH,
+                          &endpoint );
+   }
+   else if( a.existing_buffer != nullptr )
    {
       fifo = test_func( a.nitems,
                         a.start_index,
@@ -99,14 +292,75 @@ Allocate::allocate( PortInfo &a, PortInfo &b, void *data )
    }
    else
    {
-      /** if fixed buffer size, use that, else use INITIAL_ALLOC_SIZE **/
+      /** 
+       * if fixed buffer size, use that, else what the last run 
+       * learned (see MapBase::setProfileInput), else size it from 
+       * the caches
+       */
+      const auto learned( warm.capacity( a, b ) );
       const auto alloc_size( 
-         a.fixed_buffer_size != 0 ? a.fixed_buffer_size : INITIAL_ALLOC_SIZE 
+         a.fixed_buffer_size != 0 ? a.fixed_buffer_size : 
+            ( learned != 0 ? learned : (this)->initial_capacity( a, b ) ) 
       );
+      /** huge page alignment selects a huge page mapping, see pagemap.hpp **/
+      const auto align( huge_pages || a.my_kernel->getHugePages() ?
+                        Buffer::huge_page_size : ALLOC_ALIGN_WIDTH );
       fifo = test_func( alloc_size            /* items */,
-                        ALLOC_ALIGN_WIDTH     /* align */,
-                        nullptr );
+                        align                 /* align */,
+                        type == Type::Infinite ? &spill : nullptr );
+   }
+   /** producer picks the wait policy too, else the map default **/
+   const auto policy( a.my_kernel->getWaitPolicy() );
+   fifo->set_wait_policy( policy != Wait::N ? policy : wait_policy );
+   /**
+    * storage goes to the node the consumer is pinned on, else the
+    * producer's, huge page storage is faulted in here too, before
+    * the scheduler starts
+    */
+   auto node( Placement::node_of_core( b.my_kernel->getCoreAssignment() ) );
+   if( node < 0 )
+   {
+      node = Placement::node_of_core( a.my_kernel->getCoreAssignment() );
    }
+   fifo->set_home_node( node );
    initialize( &a, &b, fifo );
    return;
 }
+
+bool
+Allocate::share( PortInfo &a, PortInfo &b )
+{
+   auto * const src_fifo( a.getFIFO() );
+   auto * const dst_fifo( b.getFIFO() );
+   if( ( src_fifo == nullptr ) == ( dst_fifo == nullptr ) )
+   {
+      /** neither built yet, or both which initialize reports **/
+      return( false );
+   }
+   /** fan-out if the producer's FIFO exists, else fan-in **/
+   auto * const view( src_fifo != nullptr ? src_fifo->share( Consumer ) :
+                                            dst_fifo->share( Producer ) );
+   if( view == nullptr )
+   {
+      throw PortDoubleInitializeException(
+         "Port \"" + ( src_fifo != nullptr ?
+            a.my_kernel->output.getPortName( a.my_name ) :
+            b.my_kernel->input.getPortName( b.my_name ) ) +
+               "\" already initialized and its FIFO can't be shared!" );
+   }
+   /** same storage, same home **/
+   Placement::Info info;
+   ( src_fifo != nullptr ? src_fifo : dst_fifo )->get_placement( info );
+   view->set_home_node( info.home_node );
+   if( src_fifo != nullptr )
+   {
+      b.setFIFO( view );
+   }
+   else
+   {
+      a.setFIFO( view );
+   }
+   allocated_fifo.insert( view );
+   shared_fifo.insert( view );
+   return( true );
+}
@@ -0,0 +1,240 @@
+/**
+ * cacheinfo.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "cacheinfo.hpp"
+
+/** set by the build from the cache_info helper, see helpers/ **/
+#ifndef L1D_CACHE_SIZE
+#define L1D_CACHE_SIZE 32768
+#endif
+#ifndef L2_CACHE_SIZE
+#define L2_CACHE_SIZE 1048576
+#endif
+#ifndef LLC_CACHE_SIZE
+#define LLC_CACHE_SIZE 8388608
+#endif
+
+namespace
+{
+
+/** cache - one data cache of one cpu **/
+struct cache
+{
+    int                         level = 0;
+    std::size_t                 bytes = 0;
+    /** sorted **/
+    std::vector< core_id_t >    cpus;
+};
+
+/** parse_size - "48K", "2048K", "105M" **/
+std::size_t parse_size( const std::string &text )
+{
+    std::size_t bytes( 0 );
+    char        unit( '\0' );
+    std::istringstream( text ) >> bytes >> unit;
+    switch( unit )
+    {
+        case( 'K' ): return( bytes << 10 );
+        case( 'M' ): return( bytes << 20 );
+        case( 'G' ): return( bytes << 30 );
+        default:     return( bytes );
+    }
+}
+
+/** parse_list - "0-3,8,10-11" **/
+std::vector< core_id_t > parse_list( const std::string &text )
+{
+    std::vector< core_id_t > cpus;
+    std::istringstream stream( text );
+    std::string range;
+    while( std::getline( stream, range, ',' ) )
+    {
+        if( range.empty() )
+        {
+            continue;
+        }
+        const auto dash( range.find( '-' ) );
+        const core_id_t first( std::atoll( range.c_str() ) );
+        const core_id_t last( dash == std::string::npos ? first :
+                              std::atoll( range.c_str() + dash + 1 ) );
+        for( auto cpu( first ); cpu <= last; cpu++ )
+        {
+            cpus.push_back( cpu );
+        }
+    }
+    std::sort( cpus.begin(), cpus.end() );
+    return( cpus );
+}
+
+/** topology - cpu -> its data caches innermost first, read once **/
+struct topology
+{
+    topology()
+    {
+#if defined( __linux__ )
+        const std::string base( "/sys/devices/system/cpu/cpu" );
+        for( std::size_t cpu( 0 );; cpu++ )
+        {
+            const std::string dir( base + std::to_string( cpu ) + "/cache/index" );
+            std::vector< cache > caches;
+            for( int index( 0 );; index++ )
+            {
+                const auto path( dir + std::to_string( index ) + "/" );
+                std::ifstream level_file( path + "level" );
+                if( ! level_file.is_open() )
+                {
+                    break;
+                }
+                cache c;
+                level_file >> c.level;
+                std::string type, size, list;
+                std::ifstream( path + "type" ) >> type;
+                std::ifstream( path + "size" ) >> size;
+                std::ifstream( path + "shared_cpu_list" ) >> list;
+                if( type == "Instruction" )
+                {
+                    continue;
+                }
+                c.bytes = parse_size( size );
+                c.cpus  = parse_list( list );
+                if( c.bytes > 0 )
+                {
+                    caches.push_back( c );
+                }
+            }
+            if( caches.empty() )
+            {
+                break;
+            }
+            std::sort( caches.begin(), caches.end(),
+                       []( const cache &a, const cache &b )
+                       {
+                           return( a.level < b.level );
+                       } );
+            deepest = std::max( deepest, caches.back().level );
+            cpus.push_back( std::move( caches ) );
+        }
+#endif
+    }
+
+    const cache* find( const core_id_t core, const int level ) const noexcept
+    {
+        const auto cpu( core < 0 ? 0 : static_cast< std::size_t >( core ) );
+        if( cpu >= cpus.size() )
+        {
+            return( nullptr );
+        }
+        for( const auto &c : cpus[ cpu ] )
+        {
+            if( c.level == level )
+            {
+                return( &c );
+            }
+        }
+        return( nullptr );
+    }
+
+    std::vector< std::vector< cache > > cpus;
+    int                                 deepest = 0;
+};
+
+const topology& get_topology()
+{
+    static const topology t;
+    return( t );
+}
+
+} /** end anonymous namespace **/
+
+Cache::Level
+Cache::data( const core_id_t core, const int level ) noexcept
+{
+    Level out;
+    const auto &t( get_topology() );
+    if( t.deepest > 0 )
+    {
+        if( const auto * const c = t.find( core, level ) )
+        {
+            out.bytes = c->bytes;
+            out.cpus  = std::max< std::size_t >( c->cpus.size(), 1 );
+        }
+        return( out );
+    }
+    /** nothing in sysfs, what the build machine had **/
+    switch( level )
+    {
+        case( 1 ):
+        {
+            out.bytes = L1D_CACHE_SIZE;
+        }
+        break;
+        case( 2 ):
+        {
+            out.bytes = L2_CACHE_SIZE;
+        }
+        break;
+        case( 3 ):
+        {
+            out.bytes = LLC_CACHE_SIZE;
+            out.cpus  = std::max( std::thread::hardware_concurrency(), 1u );
+        }
+        break;
+        default:
+        break;
+    }
+    return( out );
+}
+
+int
+Cache::last_level() noexcept
+{
+    const auto deepest( get_topology().deepest );
+    return( deepest > 0 ? deepest : 3 );
+}
+
+int
+Cache::shared_level( const core_id_t a, const core_id_t b ) noexcept
+{
+    if( a < 0 || b < 0 )
+    {
+        return( 0 );
+    }
+    if( a == b )
+    {
+        return( 1 );
+    }
+    const auto &t( get_topology() );
+    for( int level( 1 ); level <= t.deepest; level++ )
+    {
+        const auto * const c( t.find( a, level ) );
+        if( c != nullptr &&
+            std::binary_search( c->cpus.begin(), c->cpus.end(), b ) )
+        {
+            return( level );
+        }
+    }
+    return( 0 );
+}
@@ -0,0 +1,77 @@
+/**
+ * doorbell.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <climits>
+#include <thread>
+#include "doorbell.hpp"
+
+#ifdef __linux
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+using namespace Buffer;
+
+bool
+Doorbell::spin() noexcept
+{
+    static const bool cores( std::thread::hardware_concurrency() > 1 );
+    return( cores );
+}
+
+void
+Doorbell::sleep( const std::uint32_t e )
+{
+#if defined __linux && ! defined USEQTHREADS
+    struct timespec ts;
+    ts.tv_sec  = 0;
+    ts.tv_nsec = std::chrono::duration_cast< std::chrono::nanoseconds >(
+        timeout ).count();
+    /** returns right away if rung since e was read **/
+    syscall( SYS_futex,
+             reinterpret_cast< std::uint32_t* >( &epoch ),
+             FUTEX_WAIT_PRIVATE,
+             e,
+             &ts,
+             nullptr,
+             0 );
+#else
+    if( epoch.load( std::memory_order_acquire ) == e )
+    {
+        std::this_thread::sleep_for( timeout );
+    }
+#endif
+}
+
+void
+Doorbell::wake() noexcept
+{
+    epoch.fetch_add( 1, std::memory_order_release );
+#if defined __linux && ! defined USEQTHREADS
+    syscall( SYS_futex,
+             reinterpret_cast< std::uint32_t* >( &epoch ),
+             FUTEX_WAKE_PRIVATE,
+             INT_MAX,
+             nullptr,
+             nullptr,
+             0 );
+#endif
+}
@@ -22,7 +22,11 @@
 #include <iostream>
 #include <iomanip>
 #include <map>
+#include <set>
+#include <vector>
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 
 #include "graphtools.hpp"
 #include "dynalloc.hpp"
@@ -44,22 +48,175 @@ dynalloc::~dynalloc()
 }
 
 std::size_t
-dynalloc::hash( PortInfo &a, PortInfo &b )
+dynalloc::target_capacity( const double      load,
+                           const double      loss,
+                           const std::size_t floor,
+                           const std::size_t ceiling )
 {
-   union{
-      std::size_t      all;
-      struct a_and_b{
-         std::uint32_t a;
-         std::uint32_t b;
-      } ab;
-   } u;
-   const auto ta( (std::uint64_t)(& a ) );
-   const auto tb( (std::uint64_t)(& b ) );
-   u.ab.a = ta & 0xffff;
-   u.ab.b = tb & 0xffff;
-   return( u.all );
+   double items( 0.0 );
+   /** load is rho, arrival over service rate **/
+   const auto rho( load );
+   if( rho > 0.0 )
+   {
+      if( rho >= 1.0 )
+      {
+         /** P( full ) = 1 / ( K + 1 ) at rho = 1 **/
+         items = 1.0 / loss;
+      }
+      else
+      {
+         /**
+          * P( full ) = ( 1 - rho ) rho^K / ( 1 - rho^( K + 1 ) ) <= loss
+          * rearranges to rho^K ( 1 - rho + loss * rho ) <= loss
+          */
+         items = std::ceil( std::log( loss / ( 1.0 - rho + loss * rho ) ) /
+                            std::log( rho ) );
+      }
+   }
+   std::size_t capacity( 1 );
+   while( capacity < floor || 
+          ( static_cast< double >( capacity ) < items && capacity < ceiling ) )
+   {
+      capacity <<= 1;
+   }
+   return( std::min( capacity, ceiling ) );
+}
+
+std::set< FIFO* >
+dynalloc::critical_path()
+{
+   struct edge
+   {
+      raft::kernel *src;
+      raft::kernel *dst;
+      FIFO         *fifo;
+   };
+   std::vector< edge > links;
+   auto edge_func = [&]( PortInfo &a, PortInfo &b, void *data )
+   {
+      (void) data;
+      links.push_back( { a.my_kernel, b.my_kernel, a.getFIFO() } );
+   };
+   auto &container( (this)->source_kernels.acquire() );
+   GraphTools::BFS( container, edge_func );
+   (this)->source_kernels.release();
+   /**
+    * longest path from any source to each kernel (depth) and from
+    * each kernel to any sink (height), at most one relaxation round
+    * per edge so feedback loops don't keep it going
+    */
+   std::map< raft::kernel*, std::size_t > depth, height;
+   for( std::size_t round( 0 ); round < links.size(); round++ )
+   {
+      bool changed( false );
+      for( const auto &e : links )
+      {
+         if( depth[ e.src ] + 1 > depth[ e.dst ] )
+         {
+            depth[ e.dst ] = depth[ e.src ] + 1;
+            changed = true;
+         }
+         if( height[ e.dst ] + 1 > height[ e.src ] )
+         {
+            height[ e.src ] = height[ e.dst ] + 1;
+            changed = true;
+         }
+      }
+      if( ! changed )
+      {
+         break;
+      }
+   }
+   std::size_t longest( 0 );
+   for( const auto &e : links )
+   {
+      longest = std::max( longest, depth[ e.src ] + 1 + height[ e.dst ] );
+   }
+   std::set< FIFO* > critical;
+   for( const auto &e : links )
+   {
+      if( depth[ e.src ] + 1 + height[ e.dst ] == longest )
+      {
+         critical.insert( e.fifo );
+      }
+   }
+   return( critical );
+}
+
+void
+dynalloc::describe( FIFO * const fifo, Profile::Edge &edge )
+{
+   Allocate::describe( fifo, edge );
+   const auto found( edges.find( fifo ) );
+   if( found == edges.end() )
+   {
+      /** fixed size, or the run ended before the first pass **/
+      return;
+   }
+   edge.capacity = std::max( edge.capacity, found->second.largest );
+   edge.arrival  = found->second.arrival.rate();
+   edge.service  = found->second.departure.rate();
 }
 
+void
+dynalloc::grow_within_budget( std::vector< candidate > &wanted,
+                              std::vector< candidate > &spare )
+{
+   auto used( (this)->account() );
+   std::sort( wanted.begin(), wanted.end(),
+              []( const candidate &x, const candidate &y )
+              {
+                 if( x.critical != y.critical )
+                 {
+                    return( x.critical );
+                 }
+                 return( x.load > y.load );
+              } );
+   std::sort( spare.begin(), spare.end(),
+              []( const candidate &x, const candidate &y )
+              {
+                 return( x.fifo->capacity() > y.fifo->capacity() );
+              } );
+   auto next_spare( spare.begin() );
+   const auto shrink( [ & ]()
+   {
+      next_spare->fifo->resize( next_spare->target, ALLOC_ALIGN_WIDTH, exit_alloc );
+      edges[ next_spare->fifo ].shrink = 0;
+      ++next_spare;
+      used = (this)->account();
+   } );
+   for( const auto &w : wanted )
+   {
+      const auto cap( w.fifo->capacity() );
+      const auto item_bytes( std::max< std::size_t >( w.fifo->get_storage_bytes() / cap, 1 ) );
+      const auto cost( [ & ]( const std::size_t to )
+      {
+         return( ( to - cap ) * item_bytes );
+      } );
+      auto to( w.target );
+      while( used + cost( to ) > memory_budget && next_spare != spare.end() )
+      {
+         shrink();
+      }
+      if( used + cost( to ) > memory_budget )
+      {
+         /** the whole way doesn't fit, a step might **/
+         to = cap * 2;
+      }
+      if( used + cost( to ) > memory_budget )
+      {
+         continue;
+      }
+      w.fifo->resize( to, ALLOC_ALIGN_WIDTH, exit_alloc );
+      edges[ w.fifo ].grow = 0;
+      used = (this)->account();
+   }
+   /** over budget without anybody growing, e.g., fixed initial sizes **/
+   while( used > memory_budget && next_spare != spare.end() )
+   {
+      shrink();
+   }
+}
 
 void
 dynalloc::run()
@@ -74,13 +231,16 @@ dynalloc::run()
    auto &container( (this)->source_kernels.acquire() );
    GraphTools::BFS( container, alloc_func );
    (this)->source_kernels.release();
+   (this)->account();
    (this)->setReady();
-   std::map< std::size_t, int > size_map;
-
-   /**
-    * make this a fixed quantity right now, if size > .75% at
-    * montor interval three times or more then increase size.
-    */
+   /** with a budget, FIFOs to grow and FIFOs that could shrink each pass **/
+   const auto critical( memory_budget != 0 ? (this)->critical_path() :
+                                             std::set< FIFO* >() );
+   std::vector< candidate > wanted, spare;
+   /** no queue gets more than this from the model **/
+   const std::size_t max_capacity( INITIAL_ALLOC_SIZE << 16 );
+   auto frame_start( std::chrono::steady_clock::now() );
+   double frame_width( 0.0 );
 
    auto mon_func = [&]( PortInfo &a, PortInfo &b, void *data ) -> void
    {
@@ -95,36 +255,120 @@ dynalloc::run()
          /** skip this one **/
          return;
       }
+      /** both ends on one thread, the cache sized start is plenty **/
+      if( a.fused )
+      {
+         return;
+      }
 
-      const auto hash_val( dynalloc::hash( a, b ) );
-      /** TODO, the values might wrap if no monitoring on **/
-      const auto realized_ratio( a.getFIFO()->get_frac_write_blocked() );
-      const auto ratio( 0.8 );
-      if( realized_ratio >= ratio )
-      {
-         const auto curr_count( size_map[ hash_val ]++ );
-         if( curr_count  > 2 )
+      auto * const buff_ptr( a.getFIFO() );
+      auto &edge( edges[ buff_ptr ] );
+      if( edge.floor == 0 )
+      {
+         edge.floor = (this)->initial_capacity( a, b );
+      }
+      edge.arrival.sample( *buff_ptr, frame_width );
+      edge.departure.sample( *buff_ptr, frame_width );
+      edge.occupancy.sample( *buff_ptr, frame_width );
+      /** M/M/1 has L = rho / ( 1 - rho ) items in the queue **/
+      const auto l( edge.occupancy.mean() );
+      auto load( l / ( 1.0 + l ) );
+      if( edge.arrival.blocked() )
+      {
+         /** 
+          * a full queue hides how far behind the consumer is, busy
+          * the whole frame its reads are its service rate
+          */
+         const auto arrival( edge.arrival.estimate() );
+         const auto service( edge.departure.estimate() );
+         load = std::max( load, ( service > 0.0 ? arrival / service : 1.0 ) );
+      }
+      /** what the queue needs, before the cache sized floor **/
+      const auto needed( dynalloc::target_capacity( load,
+                                                    loss,
+                                                    1,
+                                                    max_capacity ) );
+      const auto target( std::max( needed, edge.floor ) );
+      const auto cap( buff_ptr->capacity() );
+      edge.largest = std::max( edge.largest, cap );
+      if( target > cap )
+      {
+         edge.shrink = 0;
+         if( ++edge.grow >= grow_passes )
          {
-            /** get initializer function **/
-            auto * const buff_ptr( a.getFIFO() );
-            const auto cap( buff_ptr->capacity() );
-            buff_ptr->resize( cap * 2, ALLOC_ALIGN_WIDTH, exit_alloc );
-            size_map[ hash_val ] = 0;
+            if( memory_budget != 0 )
+            {
+               wanted.push_back( { buff_ptr,
+                                   target,
+                                   load,
+                                   critical.count( buff_ptr ) > 0 } );
+               return;
+            }
+            /** power of two targets keep POW2_BUFFER capacities masked **/
+            buff_ptr->resize( target, ALLOC_ALIGN_WIDTH, exit_alloc );
+            edge.grow = 0;
          }
       }
+      else if( needed <= cap / 4 && target < cap )
+      {
+         edge.grow = 0;
+         /** 
+          * twice what's needed leaves as much room below before 
+          * it moves again, never below where it started 
+          */
+         const auto to( std::max( needed * 2, edge.floor ) );
+         if( buff_ptr->size() > to / 2 )
+         {
+            /** 
+             * a backlog the producer stopped adding to, it has to 
+             * drain first 
+             */
+            edge.shrink = 0;
+         }
+         else if( ++edge.shrink >= shrink_passes )
+         {
+            buff_ptr->resize( to, ALLOC_ALIGN_WIDTH, exit_alloc );
+            /** items didn't fit the smaller buffer, back off and retry **/
+            edge.shrink = ( buff_ptr->capacity() == cap ? shrink_passes / 2 : 0 );
+         }
+         else if( memory_budget != 0 )
+         {
+            spare.push_back( { buff_ptr, to, load, false } );
+         }
+      }
+      else
+      {
+         edge.grow   = 0;
+         edge.shrink = 0;
+      }
       return;
    };
    /** start monitor loop **/
    while( ! exit_alloc )
    {
       /** monitor fifo's **/
-      std::chrono::microseconds dura( 3000 );
-      std::this_thread::sleep_for( dura );
+      (this)->idle( std::chrono::microseconds( 3000 ) );
+      if( exit_alloc )
+      {
+         break;
+      }
+      const auto now( std::chrono::steady_clock::now() );
+      frame_width = std::chrono::duration< double >( now - frame_start ).count();
+      frame_start = now;
 
       auto &container( (this)->source_kernels.acquire() );
       GraphTools::BFS( container, mon_func );
       (this)->source_kernels.release();
-
+      if( memory_budget != 0 )
+      {
+         grow_within_budget( wanted, spare );
+         wanted.clear();
+         spare.clear();
+      }
+      else
+      {
+         (this)->account();
+      }
    }
    return;
 }
@@ -0,0 +1,168 @@
+/**
+ * fiber.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cassert>
+#include <cstdlib>
+#include <exception>
+#include <iostream>
+#include <utility>
+#include "fiber.hpp"
+
+#if (! defined _WIN64) && (! defined _WIN32)
+#define RAFT_FIBERS 1
+#include <sys/mman.h>
+#include <ucontext.h>
+#include <unistd.h>
+#endif
+
+using namespace raft;
+
+#ifdef RAFT_FIBERS
+
+struct fiber::context
+{
+    ucontext_t          self;
+    ucontext_t          caller;
+    void               *stack  = nullptr;
+    body_t              body;
+    bool                done   = false;
+    std::exception_ptr  error;
+    /** the fiber that resumed this one, if any **/
+    context            *prev   = nullptr;
+};
+
+thread_local fiber::context *fiber::current = nullptr;
+
+/** the body can't throw across swapcontext, caught and handed back **/
+void
+fiber::trampoline()
+{
+    auto * const c( current );
+    try
+    {
+        c->body();
+    }
+    catch( ... )
+    {
+        c->error = std::current_exception();
+    }
+    c->done = true;
+    /** returns to uc_link, i.e., c->caller **/
+}
+
+fiber::fiber( body_t body ) : ctx( new context() )
+{
+    ctx->body = std::move( body );
+    ctx->stack = mmap( nullptr,
+                       stack_size,
+                       PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                       -1,
+                       0 );
+    if( ctx->stack == MAP_FAILED )
+    {
+        std::cerr << "failed to map a fiber stack, exiting!\n";
+        exit( EXIT_FAILURE );
+    }
+    /** stacks grow down, overflow faults instead of scribbling **/
+    mprotect( ctx->stack, sysconf( _SC_PAGESIZE ), PROT_NONE );
+    getcontext( &ctx->self );
+    ctx->self.uc_stack.ss_sp   = ctx->stack;
+    ctx->self.uc_stack.ss_size = stack_size;
+    ctx->self.uc_link          = &ctx->caller;
+    makecontext( &ctx->self, trampoline, 0 );
+}
+
+fiber::~fiber()
+{
+    /** a body that never finished is dropped with its stack **/
+    munmap( ctx->stack, stack_size );
+}
+
+bool
+fiber::resume()
+{
+    if( ctx->done )
+    {
+        return( false );
+    }
+    ctx->prev = current;
+    current   = ctx.get();
+    swapcontext( &ctx->caller, &ctx->self );
+    current   = ctx->prev;
+    if( ctx->error )
+    {
+        std::rethrow_exception( std::exchange( ctx->error, nullptr ) );
+    }
+    return( ! ctx->done );
+}
+
+bool
+fiber::yield()
+{
+    auto * const c( current );
+    if( c == nullptr )
+    {
+        return( false );
+    }
+    swapcontext( &c->self, &c->caller );
+    return( true );
+}
+
+bool
+fiber::supported() noexcept
+{
+    return( true );
+}
+
+#else /** no ucontext, fusion stays off **/
+
+struct fiber::context
+{
+    body_t body;
+};
+
+thread_local fiber::context *fiber::current = nullptr;
+
+fiber::fiber( body_t body ) : ctx( new context() )
+{
+    ctx->body = std::move( body );
+}
+
+fiber::~fiber() = default;
+
+bool
+fiber::resume()
+{
+    assert( false );
+    return( false );
+}
+
+bool
+fiber::yield()
+{
+    return( false );
+}
+
+bool
+fiber::supported() noexcept
+{
+    return( false );
+}
+#endif
@@ -36,30 +36,49 @@ FIFO::get_zero_write_stats( Blocked &copy )
    return;
 }
 
+FIFO*
+FIFO::share( const Direction side )
+{
+   /** default version, one producer and one consumer only **/
+   UNUSED( side );
+   return( nullptr );
+}
+
+bool
+FIFO::is_shared( const Direction side )
+{
+   /** default version, one producer and one consumer only **/
+   UNUSED( side );
+   return( false );
+}
+
 void
-FIFO::setPtrMap( ptr_map_t * const in )
+FIFO::get_spill_stats( Buffer::SpillStats &copy )
 {
-    UNUSED( in );
-    return;
+   /** default version, nothing ever spills **/
+   copy = Buffer::SpillStats();
 }
 
 void
-FIFO::setPtrSet( ptr_set_t * const out )
+FIFO::setReclaimer( Buffer::Reclaimer * const reclaimer,
+                    const Direction side )
 {
-    UNUSED( out );
+    UNUSED( reclaimer );
+    UNUSED( side );
     return;
 }
 
 void
-FIFO::setInPeekSet( ptr_set_t * const peekset )
+FIFO::setReadySet( raft::ready_set * const ready,
+                   const std::size_t bit )
 {
-    UNUSED( peekset );
+    UNUSED( ready );
+    UNUSED( bit );
     return;
 }
 
 void
-FIFO::setOutPeekSet( ptr_set_t * const peekset )
+FIFO::quiesce()
 {
-    UNUSED( peekset );
     return;
 }
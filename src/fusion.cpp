@@ -0,0 +1,95 @@
+/**
+ * fusion.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "fusion.hpp"
+#include "fiber.hpp"
+#include "graphtools.hpp"
+#include "port_info.hpp"
+#include "ringbuffertypes.hpp"
+
+void
+raft::fusion::mark( kernelkeeper &source,
+                    kernelkeeper &all,
+                    const bool   enabled )
+{
+    auto &all_k( all.acquire() );
+    for( auto * const k : all_k )
+    {
+        k->fused_prev = nullptr;
+        k->fused_next = nullptr;
+    }
+    all.release();
+
+    const bool fuse( enabled && raft::fiber::supported() );
+    auto link_func = [&]( PortInfo &a, PortInfo &b, void *data ) -> void
+    {
+        (void) data;
+        a.fused = b.fused = ( fuse && fusable( a, b ) );
+        if( a.fused )
+        {
+            a.my_kernel->fused_next = b.my_kernel;
+            b.my_kernel->fused_prev = a.my_kernel;
+        }
+    };
+    /**
+     * only kernels reachable from a source are linked, a ring of
+     * single in/out kernels isn't, so every chain has a head
+     */
+    auto &source_k( source.acquire() );
+    GraphTools::BFS( source_k, link_func );
+    source.release();
+    return;
+}
+
+bool
+raft::fusion::fusable( const PortInfo &a, const PortInfo &b )
+{
+    auto * const producer( a.my_kernel );
+    auto * const consumer( b.my_kernel );
+    if( producer == nullptr || consumer == nullptr || producer == consumer )
+    {
+        return( false );
+    }
+    if( ! producer->fusion || ! consumer->fusion )
+    {
+        return( false );
+    }
+    if( producer->output.count() != 1 || consumer->input.count() != 1 )
+    {
+        return( false );
+    }
+    if( ! a.fan_out.empty() || a.out_of_order || b.out_of_order )
+    {
+        return( false );
+    }
+    /** the other end of these is in another process **/
+    if( ! a.shm_key.empty() || ! b.shm_key.empty() ||
+        ! a.socket_address.empty() || ! b.socket_address.empty() )
+    {
+        return( false );
+    }
+    const auto type( a.fifo_type != Type::N ? a.fifo_type :
+                                              producer->getBufferType() );
+    if( type == Type::SharedMemory || type == Type::TCP || type == Type::MPMC )
+    {
+        return( false );
+    }
+    return( producer->affinity_group == consumer->affinity_group &&
+            producer->core_assign    == consumer->core_assign );
+}
@@ -30,9 +30,12 @@
 #include "map.hpp"
 #include "graphtools.hpp"
 #include "ringbuffertypes.hpp"
+#include "waittypes.hpp"
+#include "fusion.hpp"
 
 raft::make_dot::make_dot( raft::map &map ) : all_kernels( map.all_kernels ),
-                                             source_kernels( map.source_kernels )
+                                             source_kernels( map.source_kernels ),
+                                             wait_policy( map.wait_policy )
 {
     auto *height_env( std::getenv( "GEN_DOT_HEIGHT" ) );
     if( height_env != nullptr )
@@ -87,6 +90,24 @@ raft::make_dot::generate_vertex_list( std::ostream &stream )
         stream << raft::make_dot::generate_field( "fontname", "Helvetica" );
         stream << "];\n";
     }
+    /** one dashed box per fused chain, see fusion.hpp **/
+    for( auto * const k : c )
+    {
+        if( ! raft::fusion::fused( k ) || ! raft::fusion::head( k ) )
+        {
+            continue;
+        }
+        stream << "\tsubgraph cluster_fused_" << k->get_id() << "{\n";
+        stream << "\t\t" << raft::make_dot::generate_field( "label", "fused" );
+        stream << ";\n";
+        stream << "\t\t" << raft::make_dot::generate_field( "style", "dashed" );
+        stream << ";\n";
+        for( auto *stage( k ); stage != nullptr; stage = raft::fusion::next( stage ) )
+        {
+            stream << "\t\t" << stage->get_id() << ";\n";
+        }
+        stream << "\t}\n";
+    }
     all_kernels.release();
     return;
 }
@@ -109,7 +130,12 @@ raft::make_dot::generate_edge_list( std::ostream &stream )
         ss << "\n";
         ss << "OoO=" << std::boolalpha  << a.out_of_order << "\n";
         ss << "custom allocator=" << std::boolalpha << a.use_my_allocator << "\n";
-        ss << "queue type=" << Type::type_prints[ a.mem ] << "\n";
+        ss << "fused=" << std::boolalpha << a.fused << "\n";
+        ss << "queue type=" << Type::type_prints[ 
+            a.fifo_type != Type::N ? a.fifo_type : a.my_kernel->getBufferType() ] << "\n";
+        const auto policy( a.my_kernel->getWaitPolicy() );
+        ss << "wait policy=" << 
+            Wait::policy_prints[ policy != Wait::N ? policy : wait_policy ] << "\n";
         if( a.existing_buffer != nullptr )
         {
             ss << "existing_buffer\n";
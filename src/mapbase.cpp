@@ -27,6 +27,7 @@
 #include <string>
 #include <cstdlib>
 #include <cstring>
+#include <iostream>
 
 #include "common.hpp"
 #include "mapbase.hpp"
@@ -78,21 +79,60 @@ MapBase::join( raft::kernel &a, const raft::port_key_type name_a, PortInfo &a_in
          " -and- " << common::printClassNameFromStr( b_info.type.name() ) << ")."; 
       throw PortTypeMismatchException( ss.str() );
    }
-   if( a_info.other_kernel != nullptr )
+   if( a_info.other_kernel != nullptr && b_info.other_kernel != nullptr )
    {
-    //FIXME
+      //FIXME
       throw PortDoubleInitializeException( "port double initialized with: " ); //+ std::to_string( name_b ) );
    }
+   if( a_info.other_kernel != nullptr )
+   {
+      /** fan-out, every consumer of a_info shares its MPMC FIFO **/
+      if( edge_type( a_info ) != Type::MPMC )
+      {
+         std::stringstream ss;
+         ss << "Output port [" << a.output.getPortName( name_a ) << "] of kernel \"" <<
+            common::printClassName( a ) << "\" is already linked, only Type::MPMC " <<
+            "links can share a port.";
+         throw PortDoubleInitializeException( ss.str() );
+      }
+      a_info.fan_out.emplace_back( &b, name_b );
+      b_info.other_kernel = &a;
+      b_info.other_name   = name_a;
+      return;
+   }
    if( b_info.other_kernel != nullptr )
    {
-      //FIXME
-      throw PortDoubleInitializeException( "port double initialized with: " ); //+ std::to_string( name_a ) );
+      /** fan-in, both producers have to agree on the MPMC FIFO **/
+      PortInfo &first( 
+         b_info.other_kernel->output.getPortInfoFor( b_info.other_name ) );
+      if( edge_type( a_info ) != Type::MPMC || edge_type( first ) != Type::MPMC )
+      {
+         std::stringstream ss;
+         ss << "Input port [" << b.input.getPortName( name_b ) << "] of kernel \"" <<
+            common::printClassName( b ) << "\" is already linked, only Type::MPMC " <<
+            "links can share a port.";
+         throw PortDoubleInitializeException( ss.str() );
+      }
+      a_info.other_kernel = &b;
+      a_info.other_name   = name_b;
+      return;
    }
    a_info.other_kernel = &b;
    a_info.other_name   = name_b;
    b_info.other_kernel = &a;
    b_info.other_name   = name_a;
 }
+
+Type::RingBufferType
+MapBase::edge_type( PortInfo &src )
+{
+   if( src.fifo_type != Type::N )
+   {
+      return( src.fifo_type );
+   }
+   assert( src.my_kernel != nullptr );
+   return( src.my_kernel->getBufferType() );
+}
    
 void 
 MapBase::insert( raft::kernel *a,  PortInfo &a_out, 
@@ -133,3 +173,44 @@ void MapBase::portNotFound( const bool src,
       }
       throw AmbiguousPortAssignmentException( ss.str() );
 }
+
+void
+MapBase::loadProfile()
+{
+   auto path( profile_input );
+   const auto * const env( std::getenv( "RAFT_PROFILE_LOAD" ) );
+   if( path.empty() && env != nullptr )
+   {
+      path = env;
+   }
+   if( path.empty() || ! warm_profile.load( path ) )
+   {
+      /** cold start **/
+      return;
+   }
+   warm_profile.bind( all_kernels );
+   warm_profile.apply_cores( all_kernels );
+}
+
+void
+MapBase::saveProfile( Allocate &alloc )
+{
+   auto path( profile_output );
+   const auto * const env( std::getenv( "RAFT_PROFILE_SAVE" ) );
+   if( path.empty() && env != nullptr )
+   {
+      path = env;
+   }
+   if( path.empty() )
+   {
+      return;
+   }
+   Profile learned;
+   learned.bind( all_kernels );
+   learned.record_cores( all_kernels );
+   alloc.profile( learned );
+   if( ! learned.save( path ) )
+   {
+      std::cerr << "couldn't write profile \"" << path << "\"\n";
+   }
+}
@@ -0,0 +1,172 @@
+/**
+ * numaplace.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "numaplace.hpp"
+
+#if defined( __linux__ )
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
+
+/**
+ * go straight to the system calls, the few constants needed are
+ * part of the kernel ABI, libnuma isn't a dependency.
+ */
+#if defined( __linux__ ) && defined( SYS_mbind ) && defined( SYS_get_mempolicy )
+#define RAFT_NUMA_SYSCALLS 1
+static constexpr int           mpol_preferred  = 1;
+static constexpr unsigned      mpol_mf_move    = ( 1 << 1 );
+static constexpr unsigned long mpol_f_node     = ( 1 << 0 );
+static constexpr unsigned long mpol_f_addr     = ( 1 << 1 );
+#endif
+
+/** mbind node masks are sized for this many nodes **/
+static constexpr std::size_t max_nodes = 1024;
+
+namespace
+{
+
+/** topology - core -> node, read from sysfs once **/
+struct topology
+{
+    topology()
+    {
+#if defined( __linux__ )
+        const std::string base( "/sys/devices/system/cpu/" );
+        for( std::size_t cpu( 0 );; cpu++ )
+        {
+            auto *dir( opendir( ( base + "cpu" + std::to_string( cpu ) ).c_str() ) );
+            if( dir == nullptr )
+            {
+                break;
+            }
+            int node( -1 );
+            while( auto *ent = readdir( dir ) )
+            {
+                if( std::strncmp( ent->d_name, "node", 4 ) == 0 &&
+                    ent->d_name[ 4 ] >= '0' && ent->d_name[ 4 ] <= '9' )
+                {
+                    node = std::atoi( ent->d_name + 4 );
+                    break;
+                }
+            }
+            closedir( dir );
+            core_node.push_back( node );
+            if( node + 1 > nodes )
+            {
+                nodes = node + 1;
+            }
+        }
+#endif
+    }
+
+    std::vector< int > core_node;
+    int                nodes = 0;
+};
+
+const topology& get_topology()
+{
+    static const topology t;
+    return( t );
+}
+
+} /** end anonymous namespace **/
+
+int
+Placement::node_of_core( const core_id_t core ) noexcept
+{
+    const auto &t( get_topology() );
+    if( core < 0 || static_cast< std::size_t >( core ) >= t.core_node.size() )
+    {
+        return( -1 );
+    }
+    return( t.core_node[ core ] );
+}
+
+int
+Placement::node_count() noexcept
+{
+    return( get_topology().nodes );
+}
+
+bool
+Placement::place( void * const addr, const std::size_t length, const int node ) noexcept
+{
+#ifdef RAFT_NUMA_SYSCALLS
+    if( addr == nullptr || node < 0 || static_cast< std::size_t >( node ) >= max_nodes )
+    {
+        return( false );
+    }
+    static const auto page( static_cast< std::uintptr_t >( sysconf( _SC_PAGESIZE ) ) );
+    const auto start( reinterpret_cast< std::uintptr_t >( addr ) );
+    const auto begin( ( start + page - 1 ) & ~( page - 1 ) );
+    const auto end( ( start + length ) & ~( page - 1 ) );
+    if( end <= begin )
+    {
+        return( false );
+    }
+    constexpr auto bits( sizeof( unsigned long ) * 8 );
+    unsigned long mask[ max_nodes / bits ] = { 0 };
+    mask[ node / bits ] = 1UL << ( node % bits );
+    /** the kernel reads one bit less than maxnode says **/
+    return( syscall( SYS_mbind,
+                     begin,
+                     end - begin,
+                     mpol_preferred,
+                     mask,
+                     max_nodes + 1,
+                     mpol_mf_move ) == 0 );
+#else
+    UNUSED( addr );
+    UNUSED( length );
+    UNUSED( node );
+    return( false );
+#endif
+}
+
+int
+Placement::node_of( const void * const addr ) noexcept
+{
+#ifdef RAFT_NUMA_SYSCALLS
+    if( addr == nullptr )
+    {
+        return( -1 );
+    }
+    int node( -1 );
+    if( syscall( SYS_get_mempolicy,
+                 &node,
+                 nullptr,
+                 0,
+                 addr,
+                 mpol_f_node | mpol_f_addr ) != 0 )
+    {
+        return( -1 );
+    }
+    return( node );
+#else
+    UNUSED( addr );
+    return( -1 );
+#endif
+}
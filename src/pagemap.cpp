@@ -0,0 +1,127 @@
+/**
+ * pagemap.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include "pagemap.hpp"
+
+#if (defined __linux ) || (defined __APPLE__ )
+#include <sys/mman.h>
+#include <unistd.h>
+#define RAFT_PAGEMAP_MMAP 1
+#endif
+
+using namespace Buffer;
+
+bool
+PageMap::map( const std::size_t bytes ) noexcept
+{
+#ifdef RAFT_PAGEMAP_MMAP
+    const auto rounded( ( bytes + huge_page_size - 1 ) & ~( huge_page_size - 1 ) );
+#ifdef MAP_HUGETLB
+    /** only succeeds if huge pages are reserved (vm.nr_hugepages) **/
+    auto *ptr( mmap( nullptr,
+                     rounded,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB,
+                     -1,
+                     0 ) );
+    if( ptr != MAP_FAILED )
+    {
+        base    = ptr;
+        length  = rounded;
+        hugetlb = true;
+        return( true );
+    }
+#endif
+    /**
+     * THP only backs huge page aligned ranges, over-map by one
+     * huge page and trim both ends back to an aligned window
+     */
+    auto *raw( mmap( nullptr,
+                     rounded + huge_page_size,
+                     PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS,
+                     -1,
+                     0 ) );
+    if( raw == MAP_FAILED )
+    {
+        return( false );
+    }
+    const auto start( reinterpret_cast< std::uintptr_t >( raw ) );
+    const auto aligned( ( start + huge_page_size - 1 ) & ~( huge_page_size - 1 ) );
+    if( aligned > start )
+    {
+        munmap( raw, aligned - start );
+    }
+    const auto tail( start + huge_page_size - aligned );
+    if( tail > 0 )
+    {
+        munmap( reinterpret_cast< void* >( aligned + rounded ), tail );
+    }
+    base   = reinterpret_cast< void* >( aligned );
+    length = rounded;
+#ifdef MADV_HUGEPAGE
+    madvise( base, length, MADV_HUGEPAGE );
+#endif
+    return( true );
+#else
+    (void) bytes;
+    return( false );
+#endif
+}
+
+void
+PageMap::prefault() noexcept
+{
+    if( base == nullptr || prefaulted )
+    {
+        return;
+    }
+    prefaulted = true;
+#if defined( RAFT_PAGEMAP_MMAP ) && defined( MADV_POPULATE_WRITE )
+    if( madvise( base, length, MADV_POPULATE_WRITE ) == 0 )
+    {
+        return;
+    }
+#endif
+    /**
+     * older kernels, write every base page, the mapping is fresh and
+     * zero filled so writing zero doesn't change anything
+     */
+    auto * const bytes( reinterpret_cast< volatile char* >( base ) );
+    for( std::size_t off( 0 ); off < length; off += 4096 )
+    {
+        bytes[ off ] = 0;
+    }
+}
+
+void
+PageMap::unmap() noexcept
+{
+#ifdef RAFT_PAGEMAP_MMAP
+    if( base != nullptr )
+    {
+        munmap( base, length );
+    }
+#endif
+    base       = nullptr;
+    length     = 0;
+    hugetlb    = false;
+    prefaulted = false;
+}
@@ -25,6 +25,15 @@
 Pointer::Pointer(const std::size_t cap, 
                  const wrap_t wrap_set ) : Pointer( cap )
 {
+    if( mask != 0 )
+    {
+        /** masked mode, wraps are part of the counter **/
+        a = wrap_set * cap;
+#ifdef JVEC_MACHINE
+        b = a;
+#endif
+        return;
+    }
     wrap_a = wrap_set;
 #ifdef JVEC_MACHINE
     wrap_b = wrap_set;
@@ -35,6 +44,11 @@ Pointer::Pointer(const std::size_t cap,
 Pointer::Pointer( Pointer &other, 
                   const std::size_t new_cap ) : Pointer( new_cap )
 {
+    /**
+     * NOTE: the resize only happens when read < write, so
+     * restarting both counters at their current index keeps
+     * the distance between them in masked mode too
+     */
     const auto val(  Pointer::val( other ) );
     a = val;
 #ifdef JVEC_MACHINE
@@ -42,80 +56,3 @@ Pointer::Pointer( Pointer &other,
 #endif
     return;
 }
-
-std::size_t 
-Pointer::val( Pointer &ptr ) 
-{
-#ifdef JVEC_MACHINE
-   struct{
-      std::uint64_t a;
-      std::uint64_t b;
-   }copy;
-   do{
-      copy.a = ptr.a;
-      copy.b = ptr.b;
-   }while( copy.a !=  copy.b );
-   return( copy.b );
-#else
-   return( ptr.a );
-#endif
-}
-
-void
-Pointer::inc( Pointer &ptr ) 
-{
-#ifdef JVEC_MACHINE
-   ptr.a = ( ptr.a + 1 ) % ptr.max_cap;
-   ptr.b = ( ptr.b + 1 ) % ptr.max_cap;
-   if( ptr.b == 0 )
-   {
-      ptr.wrap_a++;
-      ptr.wrap_b++;
-   }
-#else
-   ptr.a = ( ptr.a + 1 ) % ptr.max_cap;
-   if( ptr.a == 0 )
-   {
-      ptr.wrap_a++;
-   }
-#endif
-}
-
-void
-Pointer::incBy( Pointer &ptr, 
-                const std::size_t in )
-{
-#ifdef JVEC_MACHINE
-   ptr.a = ( ptr.a + in ) % ptr.max_cap;
-   ptr.b = ( ptr.b + in ) % ptr.max_cap;
-   if( ptr.b < in )
-   {
-      ptr.wrap_a++;
-      ptr.wrap_b++;
-   }
-#else
-   ptr.a = ( ptr.a + in ) % ptr.max_cap;
-   if( ptr.a < in )
-   {
-      ptr.wrap_a++;
-   }
-#endif
-}
-
-std::size_t 
-Pointer::wrapIndicator( Pointer &ptr ) 
-{
-#ifdef JVEC_MACHINE
-    struct{
-       std::uint64_t a;
-       std::uint64_t b;
-    }copy;
-    do{
-       copy.a = ptr.wrap_a;
-       copy.b = ptr.wrap_b;
-    }while( copy.a != copy.b );
-    return( copy.b );
-#else
-    return( ptr.wrap_a );
-#endif
-}
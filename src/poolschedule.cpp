@@ -70,12 +70,8 @@ pool_schedule::handleSchedule( raft::kernel * const kernel )
     thread_data_mutex.lock();
     thread_data_pool.emplace_back( td );
     thread_data_mutex.unlock();
-    if( ! kernel->output.hasPorts() /** has no outputs, only 0 > inputs **/ )
-    {
-        std::lock_guard< std::mutex > tail_lock( tail_mutex );
-        /** destination kernel **/
-        tail.emplace_back( td );
-    }
+    td->done = &running;
+    running.add();
     qthread_spawn( pool_schedule::pool_run,
                    (void*) td,
                    0,
@@ -96,29 +92,9 @@ pool_schedule::start()
     {  
         (this)->handleSchedule( k );
     }
-    /**
-     * NOTE: can't quite get the sync object behavior to work 
-     * quite well enough for this application. Should theoretically
-     * work according to the documentation here:
-     * http://www.cs.sandia.gov/qthreads/man/qthread_spawn.html
-     * however it seems that the wait segfaults. Adding on the
-     * TODO list I'll implement a better mwait monitor vs. spinning
-     * which is relatively bad.
-     */
     kernel_set.release();
-START:        
-    std::chrono::milliseconds dura( 3 );
-    std::this_thread::sleep_for( dura );
-    tail_mutex.lock();
-    for( auto * const td : tail )
-    {
-        if( ! td->finished  )
-        {
-            tail_mutex.unlock();
-            goto START;
-        }
-    }
-    tail_mutex.unlock();
+    /** each pool_run counts down as its kernel finishes **/
+    running.wait();
     return;
 }
 
@@ -126,14 +102,9 @@ aligned_t pool_schedule::pool_run( void *data )
 {
    assert( data != nullptr );
    auto * const thread_d( reinterpret_cast< thread_data* >( data ) );
-   ptr_map_t in;
-   ptr_set_t out;
-   ptr_set_t peekset;
+   Buffer::Reclaimer reclaimer;
 
-   Schedule::setPtrSets( thread_d->k, 
-                        &in, 
-                        &out,
-                        &peekset );
+   Schedule::setReclaimer( thread_d->k, &reclaimer );
 #if 0 //figure out pinning later                        
    if( thread_d->loc != -1 )
    {
@@ -165,11 +136,12 @@ aligned_t pool_schedule::pool_run( void *data )
       {
         run_count = 0;
         //takes care of peekset clearing too
-        Schedule::fifo_gc( &in, &out, &peekset );
+        Schedule::fifo_gc( &reclaimer );
         qthread_yield();
       }
    }
    thread_d->finished = true;
+   thread_d->done->count_down();
    return( 1 );
 }
 
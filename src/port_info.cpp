@@ -28,6 +28,7 @@ PortInfo::PortInfo( const PortInfo &other ) : type( other.type )
    my_name        = other.my_name;
    other_kernel   = other.other_kernel;
    other_name     = other.other_name;
+   fan_out        = other.fan_out;
    out_of_order   = other.out_of_order;
    existing_buffer= other.existing_buffer;
    nitems         = other.nitems;
@@ -35,6 +36,12 @@ PortInfo::PortInfo( const PortInfo &other ) : type( other.type )
    split_func      = other.split_func;
    join_func       = other.join_func;
    fixed_buffer_size = other.fixed_buffer_size;
+   item_size         = other.item_size;
+   fused             = other.fused;
+   fifo_type         = other.fifo_type;
+   shm_key           = other.shm_key;
+   socket_address    = other.socket_address;
+   socket_channel    = other.socket_channel;
    const_map      = other.const_map;
 }
 
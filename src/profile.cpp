@@ -0,0 +1,182 @@
+/**
+ * profile.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+#include <vector>
+#include "profile.hpp"
+#include "kernel.hpp"
+#include "port_info.hpp"
+#include "demangle.hpp"
+
+bool
+Profile::load( const std::string &path )
+{
+    std::ifstream in( path );
+    if( ! in.is_open() )
+    {
+        return( false );
+    }
+    edges.clear();
+    cores.clear();
+    std::string line;
+    while( std::getline( in, line ) )
+    {
+        std::vector< std::string > field;
+        std::istringstream ss( line );
+        std::string f;
+        while( std::getline( ss, f, '\t' ) )
+        {
+            field.push_back( f );
+        }
+        /** comments, blank and malformed lines are skipped **/
+        try
+        {
+            if( field.size() == 3 && field[ 0 ] == "kernel" )
+            {
+                cores[ field[ 1 ] ] = std::stoll( field[ 2 ] );
+            }
+            else if( field.size() == 8 && field[ 0 ] == "edge" )
+            {
+                Edge edge;
+                edge.capacity = std::stoull( field[ 5 ] );
+                edge.arrival  = std::stod( field[ 6 ] );
+                edge.service  = std::stod( field[ 7 ] );
+                edges[ field[ 1 ] + '\t' + field[ 2 ] + '\t' + 
+                       field[ 3 ] + '\t' + field[ 4 ] ] = edge;
+            }
+        }
+        catch( std::exception & )
+        {
+            continue;
+        }
+    }
+    return( true );
+}
+
+bool
+Profile::save( const std::string &path ) const
+{
+    std::ofstream out( path );
+    if( ! out.is_open() )
+    {
+        return( false );
+    }
+    out << "# raft profile\n";
+    for( const auto &core : cores )
+    {
+        out << "kernel\t" << core.first << "\t" << core.second << "\n";
+    }
+    for( const auto &edge : edges )
+    {
+        out << "edge\t" << edge.first << "\t" << 
+            edge.second.capacity << "\t" << 
+            edge.second.arrival  << "\t" << 
+            edge.second.service  << "\n";
+    }
+    out.close();
+    return( out.good() );
+}
+
+void
+Profile::bind( kernelkeeper &kernels )
+{
+    names.clear();
+    std::map< std::string, std::vector< raft::kernel* > > by_class;
+    auto &container( kernels.acquire() );
+    for( auto * const k : container )
+    {
+        by_class[ raft::demangle( typeid( *k ).name() ) ].push_back( k );
+    }
+    kernels.release();
+    for( auto &c : by_class )
+    {
+        /** construction order, the same every run of the same code **/
+        std::sort( c.second.begin(), c.second.end(),
+                   []( raft::kernel * const x, raft::kernel * const y )
+                   {
+                      return( x->get_id() < y->get_id() );
+                   } );
+        for( std::size_t i( 0 ); i < c.second.size(); i++ )
+        {
+            names[ c.second[ i ] ] = c.first + "#" + std::to_string( i );
+        }
+    }
+}
+
+std::size_t
+Profile::capacity( PortInfo &a, PortInfo &b ) const
+{
+    const auto found( edges.find( key( a, b ) ) );
+    return( found != edges.end() ? found->second.capacity : 0 );
+}
+
+void
+Profile::set_edge( PortInfo &a, PortInfo &b, const Edge &edge )
+{
+    edges[ key( a, b ) ] = edge;
+}
+
+void
+Profile::record_cores( kernelkeeper &kernels )
+{
+    auto &container( kernels.acquire() );
+    for( auto * const k : container )
+    {
+        const auto n( name( k ) );
+        if( ! n.empty() )
+        {
+            cores[ n ] = k->getCoreAssignment();
+        }
+    }
+    kernels.release();
+}
+
+void
+Profile::apply_cores( kernelkeeper &kernels ) const
+{
+    auto &container( kernels.acquire() );
+    for( auto * const k : container )
+    {
+        const auto found( cores.find( name( k ) ) );
+        if( found != cores.end() && found->second >= 0 )
+        {
+            k->setCore( found->second );
+        }
+    }
+    kernels.release();
+}
+
+std::string
+Profile::name( raft::kernel * const k ) const
+{
+    const auto found( names.find( k ) );
+    return( found != names.end() ? found->second : std::string() );
+}
+
+std::string
+Profile::key( PortInfo &a, PortInfo &b ) const
+{
+    return( name( a.my_kernel ) + '\t' + 
+            a.my_kernel->output.getPortName( a.my_name ) + '\t' +
+            name( b.my_kernel ) + '\t' + 
+            b.my_kernel->input.getPortName( b.my_name ) );
+}
@@ -0,0 +1,96 @@
+/**
+ * readyset.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "readyset.hpp"
+#include "kernel.hpp"
+#include "fifo.hpp"
+
+using namespace raft;
+
+void
+ready_set::bind( raft::kernel * const k )
+{
+    fifos.clear();
+    for( auto &port : k->input )
+    {
+        fifos.emplace_back( &port );
+    }
+    ports = fifos.size();
+    if( ! tracked() )
+    {
+        for( auto * const fifo : fifos )
+        {
+            fifo->setReadySet( nullptr, 0 );
+        }
+        used_words = 0;
+        return;
+    }
+    used_words = ( ports + 63 ) / 64;
+    for( std::size_t i( 0 ); i < ports; i++ )
+    {
+        fifos[ i ]->setReadySet( this, i );
+    }
+    /** items pushed before the bits were handed out **/
+    sync();
+}
+
+void
+ready_set::sync()
+{
+    for( std::size_t i( 0 ); i < ports; i++ )
+    {
+        if( fifos[ i ]->size() > 0 )
+        {
+            set( i );
+        }
+    }
+}
+
+bool
+ready_set::stale( raft::kernel * const k )
+{
+    return( k->input.count() != ports );
+}
+
+void
+ready_set::refresh()
+{
+    for( std::size_t w( 0 ); w < used_words; w++ )
+    {
+        auto bits( words[ w ].load( std::memory_order_relaxed ) );
+        while( bits != 0 )
+        {
+            const auto i( static_cast< std::size_t >( __builtin_ctzll( bits ) ) );
+            bits &= bits - 1;
+            const auto bit( ( w << 6 ) + i );
+            auto * const fifo( fifos[ bit ] );
+            if( fifo->size() > 0 )
+            {
+                continue;
+            }
+            words[ w ].fetch_and( ~( std::uint64_t( 1 ) << i ),
+                                  std::memory_order_seq_cst );
+            /** a push between the check and the clear **/
+            if( fifo->size() > 0 )
+            {
+                set( bit );
+            }
+        }
+    }
+}
@@ -0,0 +1,65 @@
+/**
+ * reclaimer.cpp - 
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ * 
+ * Copyright 2026 Jonathan Beard
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <functional>
+#include "reclaimer.hpp"
+
+using namespace Buffer;
+
+Reclaimer::Reclaimer()
+{
+    retired.reserve( initial_capacity );
+    peeks.reserve( initial_capacity );
+    kept.reserve( initial_capacity );
+}
+
+Reclaimer::~Reclaimer()
+{
+    end_epoch();
+}
+
+void
+Reclaimer::end_epoch()
+{
+    current++;
+    if( ! kept.empty() && ! retired.empty() )
+    {
+        /** usually a few entries, sorted once per epoch **/
+        const std::less< const void* > order;
+        std::sort( kept.begin(), kept.end(), order );
+        for( const auto &r : retired )
+        {
+            if( ! std::binary_search( kept.cbegin(), kept.cend(), r.ptr, order ) )
+            {
+                r.reclaim( r.ptr );
+            }
+        }
+    }
+    else
+    {
+        for( const auto &r : retired )
+        {
+            r.reclaim( r.ptr );
+        }
+    }
+    retired.clear();
+    peeks.clear();
+    kept.clear();
+}
@@ -1,3 +1,4 @@
+#include <cassert>
 #include <iostream>
 
 #include "kernel.hpp"
@@ -5,12 +6,16 @@
 #include "schedule.hpp"
 #include "defs.hpp"
 #include "sysschedutil.hpp"
+#include "portexception.hpp"
 
 
+thread_local raft::blocked_hook_t raft::blocked_hook = nullptr;
+
 Schedule::Schedule( raft::map &map ) :  kernel_set( map.all_kernels ),
                                         source_kernels( map.source_kernels ),
                                         dst_kernels( map.dst_kernels ),
-                                        internally_created_kernels( map.internally_created_kernels )
+                                        internally_created_kernels( map.internally_created_kernels ),
+                                        scheduler_threads( map.scheduler_threads )
 {
    //TODO, see if we want to keep this
    handlers.addHandler( raft::quit, Schedule::quitHandler );
@@ -208,6 +213,19 @@ Schedule::kernelHasNoInputPorts( raft::kernel *kernel )
    return( true );
 }
 
+bool
+Schedule::kernelHasSharedInput( raft::kernel *kernel )
+{
+   for( auto &port : kernel->input )
+   {
+      if( port.is_shared( Direction::Consumer ) )
+      {
+         return( true );
+      }
+   }
+   return( false );
+}
+
 
 bool
 Schedule::kernelRun( raft::kernel * const kernel,
@@ -216,7 +234,26 @@ Schedule::kernelRun( raft::kernel * const kernel,
    bool retCode {true};
    if( kernelHasInputData( kernel ) )
    {
-      const auto sig_status( kernel->run() );
+      raft::kstatus sig_status( raft::proceed );
+      try
+      {
+         sig_status = kernel->run();
+      }
+      catch( ClosedPortAccessException &ex )
+      {
+         /**
+          * input had data when checked above but it's gone now, i.e.,
+          * another consumer of a shared (MPMC) FIFO took the last
+          * items, nothing more is coming so the kernel is done. On 
+          * any other input it's a real error.
+          */
+         if( ! kernelHasSharedInput( kernel ) )
+         {
+            throw;
+         }
+         UNUSED( ex );
+         sig_status = raft::stop;
+      }
       if( sig_status == raft::stop )
       {
          invalidateOutputPorts( kernel );
@@ -241,62 +278,112 @@ Schedule::kernelRun( raft::kernel * const kernel,
 }
 
 void
-Schedule::setPtrSets( raft::kernel * const kernel,
-                      ptr_map_t    * const in,
-                      ptr_set_t    * const out,
-                      ptr_set_t    * const peekset )
+Schedule::setReclaimer( raft::kernel      * const kernel,
+                        Buffer::Reclaimer * const reclaimer )
 {
-    assert( in  != nullptr );
-    assert( out != nullptr );
-    assert( peekset != nullptr );
+    assert( reclaimer != nullptr );
     /**
      * looks a bit odd initially, but the same
-     * peekset is set for each kernel's FIFO's
+     * reclaimer is set for each kernel's FIFO's
      * within the view of the kernel they'll be
      * accessed sequentially so no contention
      */
     for( auto &port : kernel->input )
     {
-        port.setPtrMap( in );
-        port.setInPeekSet( peekset );
+        port.setReclaimer( reclaimer, Direction::Consumer );
     }
     for( auto &port : kernel->output )
     {
-        port.setPtrSet( out );
-        port.setOutPeekSet( peekset );
+        port.setReclaimer( reclaimer, Direction::Producer );
+    }
+    return;
+}
+
+void
+Schedule::fifo_gc( Buffer::Reclaimer * const reclaimer )
+{
+    reclaimer->end_epoch();
+    return;
+}
+
+bool
+Schedule::kernelRun( raft::kernel    * const kernel,
+                     volatile bool   &finished,
+                     raft::ready_set &ready )
+{
+   if( R_UNLIKELY( ready.stale( kernel ) ) )
+   {
+      /** ports added since the last run, e.g., by the monitor **/
+      ready.bind( kernel );
+   }
+   if( R_UNLIKELY( ! ready.tracked() ) )
+   {
+      return( kernelRun( kernel, finished ) );
+   }
+   /** whatever it was for is looked at below **/
+   ready.was_poked();
+   if( ! kernel->input.hasPorts() ||
+       ready.runnable( kernel->sched_behav ) )
+   {
+      const auto ran( kernelRun( kernel, finished ) );
+      ready.refresh();
+      return( ran );
+   }
+   /** nothing according to the set, ask the ports to be sure **/
+   if( kernelHasInputData( kernel ) )
+   {
+      ready.sync();
+      const auto ran( kernelRun( kernel, finished ) );
+      ready.refresh();
+      return( ran );
+   }
+   if( kernelHasNoInputPorts( kernel ) && ! kernelHasInputData( kernel ) )
+   {
+      invalidateOutputPorts( kernel );
+      finished = true;
+   }
+   return( false );
+}
+
+bool
+Schedule::kernelReady( raft::kernel    * const kernel,
+                       raft::ready_set &ready )
+{
+   return( ! kernel->input.hasPorts() ||
+           ! ready.tracked() ||
+           ready.runnable( kernel->sched_behav ) ||
+           ready.poke_pending() );
+}
+
+void
+Schedule::kernelQuiesce( raft::kernel * const kernel )
+{
+    for( auto &port : kernel->input )
+    {
+        /** a resize pokes the set, check in on the way back **/
+        port.quiesce();
     }
     return;
 }
 
 void
-Schedule::fifo_gc( ptr_map_t * const in,
-                   ptr_set_t * const out,
-                   ptr_set_t * const peekset )
+Schedule::kernelWaitForData( raft::kernel     * const kernel,
+                             raft::ready_set  &ready,
+                             Buffer::Doorbell &bell,
+                             volatile bool    &finished )
 {
-    auto in_begin( in->begin() ), in_end( in->end() );
-    auto out_beg( out->begin() ), out_end( out->end() );
-    while( out_beg != out_end )
+    kernelQuiesce( kernel );
+    bell.wait_for( [&]()
     {
-        if( (*out_beg) != (*in_begin).first )
-        {
-            void * const ptr = reinterpret_cast< void* >( (*in_begin).first );
-            (*in_begin).second( ptr );
-            ++in_begin;
-        }
-        else
+        if( R_UNLIKELY( ! ready.tracked() ) )
         {
-            ++out_beg;
-            ++in_begin;
+            return( finished ||
+                    kernelHasInputData( kernel ) ||
+                    kernelHasNoInputPorts( kernel ) );
         }
-    }
-    while( in_begin != in_end )
-    {
-            void * const ptr = reinterpret_cast< void* >( (*in_begin).first );
-            (*in_begin).second( ptr );
-            ++in_begin;
-    }
-    in->clear();
-    out->clear();
-    peekset->clear();
+        return( finished ||
+                ready.runnable( kernel->sched_behav ) ||
+                ready.poke_pending() );
+    } );
     return;
 }
@@ -0,0 +1,266 @@
+/**
+ * shmsegment.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include <thread>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "shmsegment.hpp"
+
+using namespace Buffer;
+
+namespace
+{
+/**
+ * open file description locks conflict with other descriptors in
+ * the same process too, so both ends can live in one process (or
+ * a forked pair that shares nothing but the name)
+ */
+#ifdef F_OFD_SETLK
+constexpr int shm_setlk = F_OFD_SETLK;
+constexpr int shm_getlk = F_OFD_GETLK;
+#else
+constexpr int shm_setlk = F_SETLK;
+constexpr int shm_getlk = F_GETLK;
+#endif
+
+bool lock( const int fd, const off_t byte ) noexcept
+{
+    struct flock fl;
+    std::memset( &fl, 0, sizeof( fl ) );
+    fl.l_type   = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+    fl.l_start  = byte;
+    fl.l_len    = 1;
+    return( fcntl( fd, shm_setlk, &fl ) == 0 );
+}
+
+/** is_locked - when in doubt the holder is assumed alive **/
+bool is_locked( const int fd, const off_t byte ) noexcept
+{
+    struct flock fl;
+    std::memset( &fl, 0, sizeof( fl ) );
+    fl.l_type   = F_WRLCK;
+    fl.l_whence = SEEK_SET;
+    fl.l_start  = byte;
+    fl.l_len    = 1;
+    if( fcntl( fd, shm_getlk, &fl ) != 0 )
+    {
+        return( true );
+    }
+    return( fl.l_type != F_UNLCK );
+}
+
+[[noreturn]] void fail( const std::string &name, const char * const what )
+{
+    std::cerr << "shared memory FIFO \"" << name << "\": " << what;
+    if( errno != 0 )
+    {
+        std::cerr << " (" << std::strerror( errno ) << ")";
+    }
+    std::cerr << ", exiting!\n";
+    exit( EXIT_FAILURE );
+}
+
+} /** end anonymous namespace **/
+
+SHMSegment::SHMSegment( const std::string &key,
+                        const Direction    dir,
+                        const std::size_t  item_size,
+                        const std::size_t  max_cap ) : seg_name( name( key ) ),
+                                                       dir( dir )
+{
+    if( dir == Direction::Producer )
+    {
+        create( item_size, max_cap );
+    }
+    else
+    {
+        attach( item_size );
+    }
+}
+
+SHMSegment::~SHMSegment()
+{
+    if( dir == Direction::Producer && header != nullptr &&
+        header->attached.load( std::memory_order_acquire ) == 0 )
+    {
+        /** nobody ever showed up, don't leave it behind **/
+        shm_unlink( seg_name.c_str() );
+    }
+    if( base != nullptr )
+    {
+        munmap( base, length );
+    }
+    if( fd >= 0 )
+    {
+        /** drops our lock, the peer now sees us as gone **/
+        close( fd );
+    }
+}
+
+bool
+SHMSegment::peer_alive() const noexcept
+{
+    if( dir == Direction::Producer &&
+        header->attached.load( std::memory_order_acquire ) == 0 )
+    {
+        return( true );
+    }
+    const auto peer( dir == Direction::Producer ? Direction::Consumer :
+                                                  Direction::Producer );
+    return( is_locked( fd, lock_byte( peer ) ) );
+}
+
+std::string
+SHMSegment::name( const std::string &key )
+{
+    return( "/raft_" + key );
+}
+
+void
+SHMSegment::create( const std::size_t item_size, const std::size_t max_cap )
+{
+    /** whatever an earlier (crashed) run left under this key **/
+    shm_unlink( seg_name.c_str() );
+    errno = 0;
+    fd = shm_open( seg_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600 );
+    if( fd < 0 )
+    {
+        fail( seg_name, "couldn't create segment" );
+    }
+    if( ! lock( fd, lock_byte( Direction::Producer ) ) )
+    {
+        fail( seg_name, "couldn't lock segment" );
+    }
+    map( max_cap, item_size );
+    new ( header ) header_t();
+    header->item_size = item_size;
+    header->max_cap   = max_cap;
+    for( std::size_t i( 0 ); i < max_cap; i++ )
+    {
+        signals[ i ] = raft::none;
+    }
+    header->ready.store( ready_magic, std::memory_order_release );
+}
+
+void
+SHMSegment::attach( const std::size_t item_size )
+{
+    const auto deadline( std::chrono::steady_clock::now() + attach_timeout );
+    std::size_t max_cap( 0 );
+    for( ;; )
+    {
+        errno = 0;
+        fd = shm_open( seg_name.c_str(), O_RDWR, 0600 );
+        if( fd < 0 && errno != ENOENT )
+        {
+            fail( seg_name, "couldn't open segment" );
+        }
+        if( fd >= 0 )
+        {
+            struct stat st;
+            if( fstat( fd, &st ) == 0 &&
+                static_cast< std::size_t >( st.st_size ) >= sizeof( header_t ) )
+            {
+                auto *h( reinterpret_cast< header_t* >(
+                    mmap( nullptr, sizeof( header_t ),
+                          PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) ) );
+                if( h != MAP_FAILED )
+                {
+                    /**
+                     * ready but unlocked means the producer that made
+                     * it is gone, wait for its replacement
+                     */
+                    const bool usable(
+                        h->ready.load( std::memory_order_acquire ) == ready_magic &&
+                        h->attached.load( std::memory_order_acquire ) == 0 &&
+                        is_locked( fd, lock_byte( Direction::Producer ) ) );
+                    if( usable )
+                    {
+                        if( h->item_size != item_size )
+                        {
+                            errno = 0;
+                            fail( seg_name, "item size differs from the producer's" );
+                        }
+                        max_cap = h->max_cap;
+                    }
+                    munmap( h, sizeof( header_t ) );
+                    if( usable )
+                    {
+                        break;
+                    }
+                }
+            }
+            close( fd );
+            fd = -1;
+        }
+        if( std::chrono::steady_clock::now() > deadline )
+        {
+            errno = 0;
+            fail( seg_name, "timed out waiting for the producer" );
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    if( ! lock( fd, lock_byte( Direction::Consumer ) ) )
+    {
+        fail( seg_name, "another consumer is attached" );
+    }
+    map( max_cap, item_size );
+    header->attached.store( 1, std::memory_order_release );
+    /** both ends have it mapped, the name isn't needed anymore **/
+    shm_unlink( seg_name.c_str() );
+}
+
+void
+SHMSegment::map( const std::size_t max_cap, const std::size_t item_size )
+{
+    const auto sig_offset( sizeof( header_t ) );
+    auto store_offset( sig_offset + ( max_cap * sizeof( raft::signal ) ) );
+    store_offset = ( store_offset + L1D_CACHE_LINE_SIZE - 1 ) &
+        ~static_cast< std::size_t >( L1D_CACHE_LINE_SIZE - 1 );
+    length = store_offset + ( max_cap * item_size );
+    if( dir == Direction::Producer &&
+        ftruncate( fd, static_cast< off_t >( length ) ) != 0 )
+    {
+        fail( seg_name, "couldn't size segment" );
+    }
+    base = mmap( nullptr, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+    if( base == MAP_FAILED )
+    {
+        base = nullptr;
+        fail( seg_name, "couldn't map segment" );
+    }
+    auto * const bytes( reinterpret_cast< char* >( base ) );
+    header  = reinterpret_cast< header_t* >( bytes );
+    signals = reinterpret_cast< raft::signal* >( bytes + sig_offset );
+    store   = reinterpret_cast< void* >( bytes + store_offset );
+}
+
+off_t
+SHMSegment::lock_byte( const Direction d ) noexcept
+{
+    return( d == Direction::Producer ? 0 : 1 );
+}
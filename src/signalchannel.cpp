@@ -0,0 +1,136 @@
+/**
+ * signalchannel.cpp - 
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ * 
+ * Copyright 2026 Jonathan Beard
+ * 
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include "signalchannel.hpp"
+
+using namespace Buffer;
+
+SignalChannel::SignalChannel()
+{
+    /** producer and consumer start out sharing one segment **/
+    producer.seg = new segment();
+    consumer.seg = producer.seg;
+}
+
+SignalChannel::~SignalChannel()
+{
+    /** everything not yet consumed hangs off the consumer segment **/
+    auto *seg( consumer.seg );
+    while( seg != nullptr )
+    {
+        auto * const next( seg->next );
+        delete( seg );
+        seg = next;
+    }
+}
+
+void
+SignalChannel::append( const position_t pos, const raft::signal sig )
+{
+    if( producer.index == seg_entries )
+    {
+        /**
+         * link before publishing the entry that lives in the new
+         * segment, the release store below makes next visible to
+         * the consumer before it can try to follow it.
+         */
+        auto * const seg( new segment() );
+        producer.seg->next = seg;
+        producer.seg       = seg;
+        producer.index     = 0;
+    }
+    auto &e( producer.seg->entries[ producer.index++ ] );
+    e.pos = pos;
+    e.sig = sig;
+    producer.published.store(
+        producer.published.load( std::memory_order_relaxed ) + 1,
+        std::memory_order_release );
+}
+
+const SignalChannel::entry&
+SignalChannel::head() noexcept
+{
+    if( consumer.index == seg_entries )
+    {
+        /**
+         * there's an unconsumed entry so the producer has already
+         * moved on to the next segment, nobody else touches this one
+         */
+        auto * const old( consumer.seg );
+        consumer.seg   = old->next;
+        consumer.index = 0;
+        delete( old );
+    }
+    return( consumer.seg->entries[ consumer.index ] );
+}
+
+raft::signal
+SignalChannel::take( const position_t pos ) noexcept
+{
+    while( ! empty() )
+    {
+        const auto &e( head() );
+        if( R_UNLIKELY( e.pos < pos ) )
+        {
+            /** element already gone without a pop, drop the entry **/
+            consumer.index++;
+            consumer.count++;
+            continue;
+        }
+        if( e.pos != pos )
+        {
+            return( raft::none );
+        }
+        const auto sig( e.sig );
+        consumer.index++;
+        consumer.count++;
+        return( sig );
+    }
+    return( raft::none );
+}
+
+std::size_t
+SignalChannel::fill( const position_t pos,
+                     const std::size_t n,
+                     Signal * const out ) noexcept
+{
+    std::size_t written( 0 );
+    const auto avail( producer.published.load( std::memory_order_acquire ) );
+    auto *seg( consumer.seg );
+    auto index( consumer.index );
+    for( auto count( consumer.count ); count < avail; count++, index++ )
+    {
+        if( index == seg_entries )
+        {
+            seg   = seg->next;
+            index = 0;
+        }
+        const auto &e( seg->entries[ index ] );
+        if( e.pos >= pos + n )
+        {
+            break;
+        }
+        if( e.pos >= pos )
+        {
+            out[ e.pos - pos ] = e.sig;
+            written = e.pos - pos + 1;
+        }
+    }
+    return( written );
+}
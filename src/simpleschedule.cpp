@@ -45,6 +45,8 @@
 extern std::map< std::uintptr_t, int > *core_assign;
 #endif
 
+thread_local simple_schedule::stage *simple_schedule::fused_stage = nullptr;
+
 simple_schedule::simple_schedule( raft::map &map ) : Schedule( map )
 {
 }
@@ -64,81 +66,40 @@ simple_schedule::~simple_schedule()
 void
 simple_schedule::start()
 {
-   /** 
-    * NOTE: this section is the same as the code in the "handleSchedule"
-    * function so that it doesn't call the lock for the thread map.
-    */
    auto &container( kernel_set.acquire() );
    for( auto * const k : container )
    {  
       handleSchedule( k );
    }
    kernel_set.release();
-   
-   bool keep_going( true );
-   while( keep_going )
-   {
-      while( ! thread_map_mutex.try_lock() )
-      {
-         std::this_thread::yield();
-      }     
-      //exit, we have a lock
-      keep_going = false;
-      for( auto  *t_info : thread_map )
-      {
-         if( ! t_info->term )
-         {
-            //loop over each thread and check if done
-            if( t_info->finished )
-            {
-               /**
-                * FIXME: the list could get huge for long running apps,
-                * need to delete these entries...especially since we have
-                * a lock on the list now 
-                */
-               t_info->th.join();
-               t_info->term = true;
-            }
-            else /* a kernel ! finished */
-            {
-               keep_going =  true;
-            }
-         }
-      }
-      //if we're here we have a lock and need to unlock
-      thread_map_mutex.unlock();
-      /**
-       * NOTE: added to keep from having to unlock these so frequently
-       * might need to make the interval adjustable dep. on app
-       */
-      std::chrono::milliseconds dura( 3 );
-      std::this_thread::sleep_for( dura );
-   }
+   /** kernels added while this waits count up first **/
+   running.wait();
    return;
 }
 
 void
 simple_schedule::handleSchedule( raft::kernel * const kernel )
 {
+      if( ! raft::fusion::head( kernel ) )
+      {
+         /** runs on the thread of its chain's head **/
+         return;
+      }
       /** 
        * TODO: lets add the affinity dynamically here
        */
       auto * const th_info( new thread_info_t( kernel ) );
       th_info->data.loc = kernel->getCoreAssignment();
-
-      /** 
-       * thread function takes a reference back to the scheduler
-       * accessible done boolean flag, essentially when the 
-       * kernel is done, it can be rescheduled...and this
-       * handles that.
-       */
-      while( ! thread_map_mutex.try_lock() )
       {
-         std::this_thread::yield();
+         std::lock_guard< std::mutex > guard( thread_map_mutex );
+         thread_map.emplace_back( th_info );
       }
-      thread_map.emplace_back( th_info );
-      /** we got here, unlock **/
-      thread_map_mutex.unlock();
+      running.add();
+      raft::thread_cache::run( [ this, th_info ]()
+      {
+         simple_run( reinterpret_cast< void* >( &th_info->data ) );
+         running.count_down();
+      } );
       return;
 }
 
@@ -147,14 +108,6 @@ simple_schedule::simple_run( void * data )
 {
    assert( data != nullptr );
    auto * const thread_d( reinterpret_cast< thread_data* >( data ) );
-   ptr_map_t in;
-   ptr_set_t out;
-   ptr_set_t peekset;
-
-   Schedule::setPtrSets( thread_d->k, 
-                        &in, 
-                        &out,
-                        &peekset );
    if( thread_d->loc != -1 )
    {
       /** call does nothing if not available **/
@@ -166,16 +119,156 @@ simple_schedule::simple_run( void * data )
        assert( false );
 #endif
    }
+   if( thread_d->stages->size() > 1 )
+   {
+      fused_run( thread_d );
+      return;
+   }
+   auto &s( *thread_d->stages->front() );
+   auto &bell( *thread_d->bell );
+
+   Schedule::setReclaimer( s.k, &s.reclaimer );
+   s.ready.set_doorbell( &bell );
+   s.ready.bind( s.k );
    while( ! *(thread_d->finished) )
    {
-      bool validScheduling = Schedule::kernelRun( thread_d->k, *(thread_d->finished) );
+      bool validScheduling = Schedule::kernelRun( s.k,
+                                                  *(thread_d->finished),
+                                                  s.ready );
       //takes care of peekset clearing too
-      Schedule::fifo_gc( &in, &out, &peekset );
+      Schedule::fifo_gc( &s.reclaimer );
 
-      if(validScheduling == false)
+      if( ! validScheduling )
       {
-        std::chrono::milliseconds dura( 5 );
-        std::this_thread::sleep_for( dura );
+         /** woken by the next push to any input, or invalidate **/
+         Schedule::kernelWaitForData( s.k,
+                                      s.ready,
+                                      bell,
+                                      *(thread_d->finished) );
       }
    }
 }
+
+void
+simple_schedule::fused_run( thread_data * const thread_d )
+{
+   auto &stages( *thread_d->stages );
+   auto &bell( *thread_d->bell );
+   for( auto &p : stages )
+   {
+      auto * const s( p.get() );
+      Schedule::setReclaimer( s->k, &s->reclaimer );
+      s->ready.set_doorbell( &bell );
+      s->ready.bind( s->k );
+      s->body.reset( new raft::fiber( [ s ]()
+      {
+         std::size_t runs( 0 );
+         while( ! s->finished )
+         {
+            const auto ran( Schedule::kernelRun( s->k, s->finished, s->ready ) );
+            Schedule::fifo_gc( &s->reclaimer );
+            s->ran = s->ran || ran;
+            /** 
+             * drained, or had its slice (a kernel that never blocks,
+             * e.g., one that checks for space first, would keep the
+             * thread), let the next stage at what this one made
+             */
+            if( ! s->finished &&
+                ( ! ran || ++runs == fused_slice ||
+                  ! Schedule::kernelReady( s->k, s->ready ) ) )
+            {
+               runs = 0;
+               raft::fiber::yield();
+            }
+         }
+      } ) );
+   }
+   raft::blocked_hook = &simple_schedule::help;
+   /** first pass and after every sleep, whatever the ready sets say **/
+   bool sweep( true );
+   while( ! *(thread_d->finished) )
+   {
+      bool progress( false );
+      bool blocked( false );
+      bool done( true );
+      for( auto &p : stages )
+      {
+         auto * const s( p.get() );
+         if( s->finished )
+         {
+            continue;
+         }
+         if( sweep || s->blocked || Schedule::kernelReady( s->k, s->ready ) )
+         {
+            s->ran      = false;
+            fused_stage = s;
+            s->body->resume();
+            fused_stage = nullptr;
+            progress    = progress || s->ran;
+         }
+         blocked = blocked || s->blocked;
+         done    = done && s->finished;
+      }
+      sweep = false;
+      if( done )
+      {
+         *(thread_d->finished) = true;
+      }
+      else if( ! progress )
+      {
+         if( blocked )
+         {
+            /** on a FIFO to or from outside the chain **/
+            std::this_thread::yield();
+         }
+         else
+         {
+            /** woken by the next push to any input, or invalidate **/
+            wait_for_data( stages, bell );
+         }
+         sweep = true;
+      }
+   }
+   raft::blocked_hook = nullptr;
+   for( auto &p : stages )
+   {
+      p->body.reset();
+   }
+}
+
+void
+simple_schedule::wait_for_data( stages_t &stages, Buffer::Doorbell &bell )
+{
+   for( auto &s : stages )
+   {
+      if( ! s->finished )
+      {
+         Schedule::kernelQuiesce( s->k );
+      }
+   }
+   bell.wait_for( [&]()
+   {
+      for( auto &s : stages )
+      {
+         if( ! s->finished && Schedule::kernelReady( s->k, s->ready ) )
+         {
+            return( true );
+         }
+      }
+      return( false );
+   } );
+}
+
+bool
+simple_schedule::help()
+{
+   auto * const s( fused_stage );
+   if( s == nullptr )
+   {
+      return( false );
+   }
+   s->blocked = true;
+   raft::fiber::yield();
+   s->blocked = false;
+   return( true );
+}
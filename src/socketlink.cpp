@@ -0,0 +1,761 @@
+/**
+ * socketlink.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "socketlink.hpp"
+
+using namespace Buffer;
+
+namespace
+{
+
+#ifdef MSG_NOSIGNAL
+constexpr int send_flags = MSG_NOSIGNAL;
+#else
+constexpr int send_flags = 0;
+#endif
+
+#ifdef IOV_MAX
+constexpr std::size_t max_iov = IOV_MAX;
+#else
+constexpr std::size_t max_iov = 1024;
+#endif
+
+/** receiver staging buffer, small frames are served from it **/
+constexpr std::size_t staging_size = 1 << 16;
+
+using clock_type = std::chrono::steady_clock;
+
+/** parsed "unix:/path", "/path" or "tcp:host:port" **/
+struct address_t
+{
+    bool        is_unix = true;
+    std::string path;
+    std::string host;
+    std::string port;
+};
+
+bool parse( const std::string &address, address_t &out )
+{
+    const std::string unix_prefix( "unix:" );
+    const std::string tcp_prefix( "tcp:" );
+    if( address.compare( 0, unix_prefix.size(), unix_prefix ) == 0 )
+    {
+        out.path = address.substr( unix_prefix.size() );
+        return( ! out.path.empty() );
+    }
+    if( ! address.empty() && address[ 0 ] == '/' )
+    {
+        out.path = address;
+        return( true );
+    }
+    if( address.compare( 0, tcp_prefix.size(), tcp_prefix ) == 0 )
+    {
+        const auto rest( address.substr( tcp_prefix.size() ) );
+        const auto colon( rest.rfind( ':' ) );
+        if( colon == std::string::npos || colon == 0 || colon + 1 == rest.size() )
+        {
+            return( false );
+        }
+        out.is_unix = false;
+        out.host    = rest.substr( 0, colon );
+        out.port    = rest.substr( colon + 1 );
+        return( true );
+    }
+    return( false );
+}
+
+/** advance iov past n bytes, returns the first iovec not yet done **/
+std::size_t consume( struct iovec * const iov,
+                     const std::size_t    n_iov,
+                     std::size_t          n )
+{
+    std::size_t i( 0 );
+    while( i < n_iov && n >= iov[ i ].iov_len )
+    {
+        n -= iov[ i ].iov_len;
+        i++;
+    }
+    if( i < n_iov )
+    {
+        iov[ i ].iov_base = reinterpret_cast< char* >( iov[ i ].iov_base ) + n;
+        iov[ i ].iov_len -= n;
+    }
+    return( i );
+}
+
+std::mutex &registry_lock()
+{
+    static std::mutex m;
+    return( m );
+}
+
+std::map< std::pair< std::string, int >, std::weak_ptr< SocketLink > >& registry()
+{
+    static std::map< std::pair< std::string, int >,
+                     std::weak_ptr< SocketLink > > links;
+    return( links );
+}
+
+} /** end anonymous namespace **/
+
+std::shared_ptr< SocketLink >
+SocketLink::get( const std::string &address, const Direction dir )
+{
+    std::lock_guard< std::mutex > lk( registry_lock() );
+    auto &entry( registry()[ std::make_pair( address, static_cast< int >( dir ) ) ] );
+    auto link( entry.lock() );
+    if( link == nullptr )
+    {
+        link.reset( new SocketLink( address, dir ) );
+        entry = link;
+    }
+    return( link );
+}
+
+SocketLink::SocketLink( const std::string &address,
+                        const Direction    dir ) : address( address ),
+                                                   dir( dir )
+{
+    if( dir == Direction::Consumer )
+    {
+        staging.resize( staging_size );
+        /** listen right away so the sender can connect **/
+        open_listener();
+        io = std::thread( &SocketLink::run_receiver, this );
+    }
+    else
+    {
+        io = std::thread( &SocketLink::run_sender, this );
+    }
+}
+
+SocketLink::~SocketLink()
+{
+    stop.store( true, std::memory_order_release );
+    if( dir == Direction::Consumer && fd >= 0 )
+    {
+        /** wake a receiver blocked in read **/
+        shutdown( fd, SHUT_RDWR );
+    }
+    if( io.joinable() )
+    {
+        io.join();
+    }
+    if( fd >= 0 )
+    {
+        close( fd );
+    }
+    if( listen_fd >= 0 )
+    {
+        close( listen_fd );
+    }
+    if( ! unix_path.empty() )
+    {
+        unlink( unix_path.c_str() );
+    }
+}
+
+void
+SocketLink::add( const std::uint32_t id, SocketChannel * const channel )
+{
+    std::lock_guard< std::mutex > lk( lock );
+    auto ret( channels.emplace( id, channel_t() ) );
+    if( ! ret.second )
+    {
+        errno = 0;
+        fail( "channel used twice" );
+    }
+    ret.first->second.channel = channel;
+    if( dead.load( std::memory_order_acquire ) )
+    {
+        channel->disconnect( true );
+    }
+}
+
+void
+SocketLink::remove( const std::uint32_t id )
+{
+    for( ;; )
+    {
+        {
+            std::lock_guard< std::mutex > lk( lock );
+            auto it( channels.find( id ) );
+            if( it == channels.end() )
+            {
+                return;
+            }
+            if( dir == Direction::Consumer || it->second.done ||
+                dead.load( std::memory_order_acquire ) )
+            {
+                channels.erase( it );
+                return;
+            }
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+}
+
+void
+SocketLink::run_sender()
+{
+    connect_peer();
+    std::vector< struct iovec >             iov;
+    std::vector< frame_t >                  frames;
+    std::vector< std::vector< socket_signal_t > > sigs;
+    /** channel, items, close frame **/
+    struct pending_t
+    {
+        channel_t   *ch;
+        std::size_t n;
+        bool        close;
+    };
+    std::vector< pending_t >                batch;
+    std::uint32_t                           idle( 0 );
+    while( ! stop.load( std::memory_order_acquire ) )
+    {
+        if( dead.load( std::memory_order_acquire ) )
+        {
+            /** nobody listens anymore, keep the producers from blocking **/
+            {
+                std::lock_guard< std::mutex > lk( lock );
+                for( auto &pair : channels )
+                {
+                    auto * const c( pair.second.channel );
+                    c->sent( c->outbound() );
+                }
+            }
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            continue;
+        }
+        iov.clear();
+        batch.clear();
+        {
+            std::lock_guard< std::mutex > lk( lock );
+            /** reserve up front, iov holds pointers into frames/sigs **/
+            frames.resize( channels.size() );
+            sigs.resize( channels.size() );
+            iov.reserve( channels.size() * 4 );
+            const auto now( clock_type::now() );
+            for( auto &pair : channels )
+            {
+                auto &st( pair.second );
+                if( st.done || iov.size() + 4 > max_iov )
+                {
+                    continue;
+                }
+                auto * const c( st.channel );
+                /** closed first, every item pushed before close is counted **/
+                const bool closing( c->closed() );
+                const auto avail( c->outbound() );
+                if( avail == 0 && ! closing )
+                {
+                    st.waiting = false;
+                    continue;
+                }
+                if( ! st.waiting )
+                {
+                    st.waiting = true;
+                    st.first   = now;
+                }
+                const bool full( avail >= st.batch );
+                if( ! full && ! closing && now - st.first < linger )
+                {
+                    continue;
+                }
+                const auto limit( std::max( std::size_t( 1 ),
+                    std::min( max_batch, c->channel_capacity() / 2 ) ) );
+                if( full )
+                {
+                    st.batch = std::min( st.batch * 2, limit );
+                }
+                else if( avail < st.batch / 2 )
+                {
+                    st.batch = std::max( st.batch / 2, std::size_t( 1 ) );
+                }
+                const auto n( std::min( avail, max_batch ) );
+                const auto index( batch.size() );
+                auto &s( sigs[ index ] );
+                s.clear();
+                struct iovec data[ 2 ];
+                const auto n_data( n > 0 ? c->gather( n, data, s ) : 0 );
+                auto &f( frames[ index ] );
+                f.channel   = pair.first;
+                f.items     = static_cast< std::uint32_t >( n );
+                f.signals   = static_cast< std::uint32_t >( s.size() );
+                f.item_size = static_cast< std::uint16_t >( c->item_size() );
+                f.flags     = ( closing && n == avail ) ? close_flag : 0;
+                iov.push_back( { &f, sizeof( f ) } );
+                if( ! s.empty() )
+                {
+                    iov.push_back( { s.data(), s.size() * sizeof( socket_signal_t ) } );
+                }
+                for( std::size_t i( 0 ); i < n_data; i++ )
+                {
+                    iov.push_back( data[ i ] );
+                }
+                st.waiting = false;
+                batch.push_back( { &st, n, f.flags == close_flag } );
+            }
+        }
+        if( batch.empty() )
+        {
+            /** short spin, then sleep a fraction of linger **/
+            if( idle++ < 64 )
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for( linger / 4 );
+            }
+            continue;
+        }
+        idle = 0;
+        if( ! write_all( iov ) )
+        {
+            peer_gone();
+            continue;
+        }
+        std::lock_guard< std::mutex > lk( lock );
+        for( auto &p : batch )
+        {
+            if( p.n > 0 )
+            {
+                p.ch->channel->sent( p.n );
+            }
+            if( p.close )
+            {
+                p.ch->done = true;
+            }
+        }
+    }
+    if( fd >= 0 )
+    {
+        shutdown( fd, SHUT_WR );
+    }
+}
+
+void
+SocketLink::run_receiver()
+{
+    accept_peer();
+    std::vector< socket_signal_t > sigs;
+    frame_t f;
+    while( read_exact( &f, sizeof( f ) ) )
+    {
+        sigs.resize( f.signals );
+        if( f.signals > 0 &&
+            ! read_exact( sigs.data(), f.signals * sizeof( socket_signal_t ) ) )
+        {
+            break;
+        }
+        std::unique_lock< std::mutex > lk( lock );
+        auto *st( lookup( f.channel, lk ) );
+        if( st == nullptr )
+        {
+            break;
+        }
+        if( st->channel->item_size() != f.item_size )
+        {
+            errno = 0;
+            fail( "item size differs from the sender's" );
+        }
+        bool ok( true );
+        std::size_t done( 0 );
+        std::size_t next_sig( 0 );
+        while( ok && done < f.items )
+        {
+            auto k( std::min( static_cast< std::size_t >( f.items ) - done,
+                              st->channel->channel_capacity() ) );
+            /** consumer is behind, wait for room without the lock **/
+            while( st != nullptr && ! st->channel->closed() &&
+                   st->channel->inbound_space() < k )
+            {
+                lk.unlock();
+                std::this_thread::yield();
+                lk.lock();
+                const auto it( channels.find( f.channel ) );
+                st = ( it == channels.end() || stop.load() ? nullptr : &it->second );
+            }
+            if( st == nullptr || st->channel->closed() )
+            {
+                /** channel went away, drop the rest of the frame **/
+                ok = discard( ( f.items - done ) * f.item_size );
+                break;
+            }
+            struct iovec iov[ 2 ];
+            const auto n_iov( st->channel->scatter( k, iov ) );
+            ok = read_items( iov, n_iov );
+            const auto first_sig( next_sig );
+            while( next_sig < sigs.size() && sigs[ next_sig ].offset < done + k )
+            {
+                sigs[ next_sig ].offset -= static_cast< std::uint32_t >( done );
+                next_sig++;
+            }
+            if( ok )
+            {
+                st->channel->received( k, sigs.data() + first_sig, next_sig - first_sig );
+            }
+            done += k;
+        }
+        if( ! ok )
+        {
+            break;
+        }
+        if( st != nullptr && ( f.flags & close_flag ) != 0 )
+        {
+            st->done = true;
+            st->channel->disconnect( false );
+        }
+    }
+    peer_gone();
+}
+
+SocketLink::channel_t*
+SocketLink::lookup( const std::uint32_t id, std::unique_lock< std::mutex > &lk )
+{
+    const auto deadline( clock_type::now() + connect_timeout );
+    for( ;; )
+    {
+        const auto it( channels.find( id ) );
+        if( it != channels.end() )
+        {
+            return( &it->second );
+        }
+        if( stop.load( std::memory_order_acquire ) )
+        {
+            return( nullptr );
+        }
+        if( clock_type::now() > deadline )
+        {
+            errno = 0;
+            fail( "data for a channel that was never opened" );
+        }
+        lk.unlock();
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        lk.lock();
+    }
+}
+
+void
+SocketLink::peer_gone()
+{
+    dead.store( true, std::memory_order_release );
+    std::lock_guard< std::mutex > lk( lock );
+    for( auto &pair : channels )
+    {
+        if( ! pair.second.done )
+        {
+            pair.second.channel->disconnect( true );
+        }
+    }
+}
+
+bool
+SocketLink::write_all( std::vector< struct iovec > &iov )
+{
+    std::size_t first( 0 );
+    while( first < iov.size() )
+    {
+        struct msghdr msg;
+        std::memset( &msg, 0, sizeof( msg ) );
+        msg.msg_iov    = iov.data() + first;
+        msg.msg_iovlen = iov.size() - first;
+        const auto n( sendmsg( fd, &msg, send_flags ) );
+        if( n < 0 )
+        {
+            if( errno == EINTR )
+            {
+                continue;
+            }
+            return( false );
+        }
+        first += consume( iov.data() + first, iov.size() - first,
+                          static_cast< std::size_t >( n ) );
+    }
+    return( true );
+}
+
+bool
+SocketLink::read_exact( void *dst, const std::size_t n )
+{
+    auto *out( reinterpret_cast< char* >( dst ) );
+    std::size_t got( 0 );
+    while( got < n )
+    {
+        if( staged_begin == staged_end )
+        {
+            staged_begin = staged_end = 0;
+            const auto r( read( fd, staging.data(), staging.size() ) );
+            if( r < 0 && errno == EINTR )
+            {
+                continue;
+            }
+            if( r <= 0 )
+            {
+                return( false );
+            }
+            staged_end = static_cast< std::size_t >( r );
+        }
+        const auto k( std::min( n - got, staged_end - staged_begin ) );
+        std::memcpy( out + got, staging.data() + staged_begin, k );
+        staged_begin += k;
+        got          += k;
+    }
+    return( true );
+}
+
+bool
+SocketLink::read_items( struct iovec * const iov, const std::size_t n_iov )
+{
+    /** whatever is already staged first, then straight into the ring **/
+    std::size_t first( 0 );
+    while( first < n_iov && staged_begin < staged_end )
+    {
+        const auto k( std::min( iov[ first ].iov_len, staged_end - staged_begin ) );
+        std::memcpy( iov[ first ].iov_base, staging.data() + staged_begin, k );
+        staged_begin += k;
+        first += consume( iov + first, n_iov - first, k );
+    }
+    while( first < n_iov )
+    {
+        const auto r( readv( fd, iov + first, static_cast< int >( n_iov - first ) ) );
+        if( r < 0 && errno == EINTR )
+        {
+            continue;
+        }
+        if( r <= 0 )
+        {
+            return( false );
+        }
+        first += consume( iov + first, n_iov - first, static_cast< std::size_t >( r ) );
+    }
+    return( true );
+}
+
+bool
+SocketLink::discard( std::size_t n )
+{
+    char sink[ 4096 ];
+    while( n > 0 )
+    {
+        const auto k( std::min( n, sizeof( sink ) ) );
+        if( ! read_exact( sink, k ) )
+        {
+            return( false );
+        }
+        n -= k;
+    }
+    return( true );
+}
+
+void
+SocketLink::open_listener()
+{
+    address_t a;
+    if( ! parse( address, a ) )
+    {
+        errno = 0;
+        fail( "malformed address" );
+    }
+    if( a.is_unix )
+    {
+        struct sockaddr_un sa;
+        std::memset( &sa, 0, sizeof( sa ) );
+        if( a.path.size() >= sizeof( sa.sun_path ) )
+        {
+            errno = 0;
+            fail( "socket path too long" );
+        }
+        sa.sun_family = AF_UNIX;
+        std::strncpy( sa.sun_path, a.path.c_str(), sizeof( sa.sun_path ) - 1 );
+        listen_fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+        /** left behind by an earlier run **/
+        unlink( a.path.c_str() );
+        if( listen_fd < 0 ||
+            bind( listen_fd, reinterpret_cast< struct sockaddr* >( &sa ),
+                  sizeof( sa ) ) != 0 )
+        {
+            fail( "couldn't bind" );
+        }
+        unix_path = a.path;
+    }
+    else
+    {
+        struct addrinfo hints;
+        std::memset( &hints, 0, sizeof( hints ) );
+        hints.ai_family   = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        hints.ai_flags    = AI_PASSIVE;
+        struct addrinfo *res( nullptr );
+        if( getaddrinfo( a.host.c_str(), a.port.c_str(), &hints, &res ) != 0 ||
+            res == nullptr )
+        {
+            errno = 0;
+            fail( "couldn't resolve" );
+        }
+        listen_fd = socket( res->ai_family, res->ai_socktype, res->ai_protocol );
+        const int on( 1 );
+        if( listen_fd >= 0 )
+        {
+            setsockopt( listen_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof( on ) );
+        }
+        const bool bound( listen_fd >= 0 &&
+                          bind( listen_fd, res->ai_addr, res->ai_addrlen ) == 0 );
+        freeaddrinfo( res );
+        if( ! bound )
+        {
+            fail( "couldn't bind" );
+        }
+    }
+    if( listen( listen_fd, 1 ) != 0 )
+    {
+        fail( "couldn't listen" );
+    }
+}
+
+void
+SocketLink::accept_peer()
+{
+    const auto deadline( clock_type::now() + connect_timeout );
+    while( ! stop.load( std::memory_order_acquire ) )
+    {
+        struct pollfd p = { listen_fd, POLLIN, 0 };
+        const auto r( poll( &p, 1, 100 ) );
+        if( r > 0 )
+        {
+            fd = accept( listen_fd, nullptr, nullptr );
+            if( fd < 0 )
+            {
+                fail( "couldn't accept" );
+            }
+            break;
+        }
+        if( r < 0 && errno != EINTR )
+        {
+            fail( "couldn't accept" );
+        }
+        if( clock_type::now() > deadline )
+        {
+            errno = 0;
+            fail( "timed out waiting for the sender" );
+        }
+    }
+    close( listen_fd );
+    listen_fd = -1;
+    if( ! unix_path.empty() )
+    {
+        /** connected, the name isn't needed anymore **/
+        unlink( unix_path.c_str() );
+        unix_path.clear();
+    }
+}
+
+void
+SocketLink::connect_peer()
+{
+    address_t a;
+    if( ! parse( address, a ) )
+    {
+        errno = 0;
+        fail( "malformed address" );
+    }
+    const auto deadline( clock_type::now() + connect_timeout );
+    for( ;; )
+    {
+        bool connected( false );
+        if( a.is_unix )
+        {
+            struct sockaddr_un sa;
+            std::memset( &sa, 0, sizeof( sa ) );
+            if( a.path.size() >= sizeof( sa.sun_path ) )
+            {
+                errno = 0;
+                fail( "socket path too long" );
+            }
+            sa.sun_family = AF_UNIX;
+            std::strncpy( sa.sun_path, a.path.c_str(), sizeof( sa.sun_path ) - 1 );
+            fd = socket( AF_UNIX, SOCK_STREAM, 0 );
+            connected = fd >= 0 &&
+                connect( fd, reinterpret_cast< struct sockaddr* >( &sa ),
+                         sizeof( sa ) ) == 0;
+        }
+        else
+        {
+            struct addrinfo hints;
+            std::memset( &hints, 0, sizeof( hints ) );
+            hints.ai_family   = AF_UNSPEC;
+            hints.ai_socktype = SOCK_STREAM;
+            struct addrinfo *res( nullptr );
+            if( getaddrinfo( a.host.c_str(), a.port.c_str(), &hints, &res ) == 0 &&
+                res != nullptr )
+            {
+                fd = socket( res->ai_family, res->ai_socktype, res->ai_protocol );
+                connected = fd >= 0 &&
+                    connect( fd, res->ai_addr, res->ai_addrlen ) == 0;
+                freeaddrinfo( res );
+            }
+            if( connected )
+            {
+                /** batching is done here, don't let the kernel hold frames **/
+                const int on( 1 );
+                setsockopt( fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof( on ) );
+            }
+        }
+        if( connected )
+        {
+            return;
+        }
+        if( fd >= 0 )
+        {
+            close( fd );
+            fd = -1;
+        }
+        if( clock_type::now() > deadline )
+        {
+            fail( "couldn't connect" );
+        }
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+}
+
+void
+SocketLink::fail( const char * const what ) const
+{
+    std::cerr << "socket FIFO \"" << address << "\": " << what;
+    if( errno != 0 )
+    {
+        std::cerr << " (" << std::strerror( errno ) << ")";
+    }
+    std::cerr << ", exiting!\n";
+    exit( EXIT_FAILURE );
+}
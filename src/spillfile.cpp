@@ -0,0 +1,174 @@
+/**
+ * spillfile.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "spillfile.hpp"
+
+using namespace Buffer;
+
+SpillFile::SpillFile( const std::string &directory ) : directory( directory )
+{
+}
+
+SpillFile::~SpillFile()
+{
+    if( fd >= 0 )
+    {
+        close( fd );
+    }
+}
+
+void*
+SpillFile::map( const std::size_t bytes,
+                std::size_t &offset,
+                std::size_t &length )
+{
+    static const auto page( static_cast< std::size_t >( sysconf( _SC_PAGESIZE ) ) );
+    std::lock_guard< std::mutex > guard( lock );
+    if( fd < 0 )
+    {
+        create();
+    }
+    length = ( bytes + page - 1 ) & ~( page - 1 );
+    offset = end;
+    /**
+     * reserve the blocks now, stores to a sparse region of a full
+     * disk would SIGBUS in the producer instead of failing here
+     */
+    if( posix_fallocate( fd,
+                         static_cast< off_t >( offset ),
+                         static_cast< off_t >( length ) ) != 0 )
+    {
+        /** drop whatever got allocated, the caller waits and retries **/
+        if( ftruncate( fd, static_cast< off_t >( end ) ) != 0 )
+        {
+            /** blocks stay allocated until the FIFO goes away, harmless **/
+        }
+        return( nullptr );
+    }
+    auto *base( mmap( nullptr,
+                      length,
+                      PROT_READ | PROT_WRITE,
+                      MAP_SHARED,
+                      fd,
+                      static_cast< off_t >( offset ) ) );
+    if( base == MAP_FAILED )
+    {
+        fail( "can't map spill file" );
+    }
+    end  += length;
+    live += length;
+    return( base );
+}
+
+void
+SpillFile::release( void * const base,
+                    const std::size_t offset,
+                    const std::size_t length ) noexcept
+{
+    munmap( base, length );
+    std::lock_guard< std::mutex > guard( lock );
+    live -= length;
+    if( live == 0 )
+    {
+        /** nothing left, start over at the beginning **/
+        end = 0;
+        if( ftruncate( fd, 0 ) != 0 )
+        {
+            /** blocks stay allocated until the FIFO goes away, harmless **/
+        }
+        return;
+    }
+#if defined( FALLOC_FL_PUNCH_HOLE ) && defined( FALLOC_FL_KEEP_SIZE )
+    fallocate( fd,
+               FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE,
+               static_cast< off_t >( offset ),
+               static_cast< off_t >( length ) );
+#else
+    (void) offset;
+#endif
+}
+
+std::size_t
+SpillFile::mapped() noexcept
+{
+    std::lock_guard< std::mutex > guard( lock );
+    return( live );
+}
+
+void
+SpillFile::write_back( void * const base, const std::size_t length ) noexcept
+{
+#ifdef MADV_PAGEOUT
+    if( madvise( base, length, MADV_PAGEOUT ) == 0 )
+    {
+        return;
+    }
+#endif
+    msync( base, length, MS_ASYNC );
+}
+
+void
+SpillFile::read_back( void * const base, const std::size_t length ) noexcept
+{
+    madvise( base, length, MADV_SEQUENTIAL );
+    madvise( base, std::min( length, readahead_bytes ), MADV_WILLNEED );
+}
+
+void
+SpillFile::create()
+{
+    std::string dir( directory );
+    if( dir.empty() )
+    {
+        const auto * const tmp( std::getenv( "TMPDIR" ) );
+        dir = ( tmp != nullptr && *tmp != '\0' ? tmp : "/tmp" );
+    }
+    path = dir + "/raftspill.XXXXXX";
+    std::vector< char > name( path.begin(), path.end() );
+    name.push_back( '\0' );
+    fd = mkstemp( name.data() );
+    path = name.data();
+    if( fd < 0 )
+    {
+        fail( "can't create spill file" );
+    }
+    /** nothing to clean up if we crash **/
+    unlink( name.data() );
+}
+
+void
+SpillFile::fail( const char * const what )
+{
+    std::cerr << "spill file \"" << path << "\": " << what;
+    if( errno != 0 )
+    {
+        std::cerr << " (" << std::strerror( errno ) << ")";
+    }
+    std::cerr << ", exiting!\n";
+    exit( EXIT_FAILURE );
+}
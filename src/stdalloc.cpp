@@ -50,6 +50,7 @@ stdalloc::run()
    auto &container( (this)->source_kernels.acquire() );
    GraphTools::BFS( container, alloc_func );
    (this)->source_kernels.release();
+   (this)->account();
    (this)->setReady();
    return;
 }
@@ -0,0 +1,158 @@
+/**
+ * threadcache.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <deque>
+#include <thread>
+#include <utility>
+#include "threadcache.hpp"
+
+#ifdef __linux
+#include <sched.h>
+#endif
+#if (! defined _WIN64) && (! defined _WIN32)
+#include <pthread.h>
+#endif
+
+using namespace raft;
+
+namespace
+{
+
+struct cache_state
+{
+    std::mutex                         lock;
+    std::condition_variable            cv;
+    /** handed out, not picked up by an idle thread yet **/
+    std::deque< thread_cache::job_t >  pending;
+    /** idle threads nobody has handed a job to **/
+    std::size_t                        idle    = 0;
+    std::uint64_t                      created = 0;
+};
+
+cache_state *cache = nullptr;
+
+#if (! defined _WIN64) && (! defined _WIN32)
+/**
+ * a forked child has none of the cached threads, it starts over
+ * with an empty cache (the parent's lock is held across the fork
+ * so the copy is consistent, the child's copy is just dropped)
+ */
+void fork_prepare()
+{
+    cache->lock.lock();
+}
+
+void fork_parent()
+{
+    cache->lock.unlock();
+}
+
+void fork_child()
+{
+    cache = new cache_state();
+}
+#endif
+
+/**
+ * never destroyed, idle threads may still be waiting on it
+ * while static destructors run at exit
+ */
+cache_state& state()
+{
+    static const bool init( [](){
+        cache = new cache_state();
+#if (! defined _WIN64) && (! defined _WIN32)
+        pthread_atfork( fork_prepare, fork_parent, fork_child );
+#endif
+        return( true );
+    }() );
+    (void) init;
+    return( *cache );
+}
+
+void worker( thread_cache::job_t job )
+{
+#ifdef __linux
+    cpu_set_t mask;
+    const bool have_mask( sched_getaffinity( 0, sizeof( mask ), &mask ) == 0 );
+#endif
+    auto &s( state() );
+    for( ;; )
+    {
+        job();
+        job = nullptr;
+#ifdef __linux
+        if( have_mask )
+        {
+            /** the job may have pinned us **/
+            sched_setaffinity( 0, sizeof( mask ), &mask );
+        }
+#endif
+        std::unique_lock< std::mutex > guard( s.lock );
+        s.idle++;
+        s.cv.wait_for( guard,
+                       thread_cache::linger,
+                       [&](){ return( ! s.pending.empty() ); } );
+        if( s.pending.empty() )
+        {
+            /** timed out, nobody counted on us **/
+            s.idle--;
+            return;
+        }
+        /** run() took us out of idle when it queued this **/
+        job = std::move( s.pending.front() );
+        s.pending.pop_front();
+    }
+}
+
+} /** end anonymous namespace **/
+
+void
+thread_cache::run( job_t job )
+{
+    auto &s( state() );
+    {
+        std::lock_guard< std::mutex > guard( s.lock );
+        if( s.idle > 0 )
+        {
+            s.idle--;
+            s.pending.emplace_back( std::move( job ) );
+            s.cv.notify_one();
+            return;
+        }
+        s.created++;
+    }
+    std::thread( worker, std::move( job ) ).detach();
+}
+
+std::uint64_t
+thread_cache::created() noexcept
+{
+    auto &s( state() );
+    std::lock_guard< std::mutex > guard( s.lock );
+    return( s.created );
+}
+
+std::size_t
+thread_cache::idle() noexcept
+{
+    auto &s( state() );
+    std::lock_guard< std::mutex > guard( s.lock );
+    return( s.idle );
+}
@@ -0,0 +1,133 @@
+/**
+ * waitstrategy.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <climits>
+#include <thread>
+#include "waitstrategy.hpp"
+
+#ifdef __linux
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#endif
+
+using namespace Buffer;
+
+void
+WaitStrategy::sys_yield() noexcept
+{
+#ifdef USEQTHREADS
+    raft::yield();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+void
+WaitStrategy::park( side_t &self )
+{
+    if( ! self.armed )
+    {
+        /** register first, then let the caller re-check its condition **/
+        self.sleepers.fetch_add( 1, std::memory_order_seq_cst );
+        self.armed_epoch = self.epoch.load( std::memory_order_acquire );
+        self.armed       = true;
+        return;
+    }
+    self.parks++;
+#if defined __linux && ! defined USEQTHREADS
+    const auto secs( std::chrono::duration_cast< std::chrono::seconds >(
+        park_timeout ) );
+    struct timespec ts;
+    ts.tv_sec  = secs.count();
+    ts.tv_nsec = std::chrono::duration_cast< std::chrono::nanoseconds >(
+        park_timeout - secs ).count();
+    /** returns right away if epoch moved since we armed **/
+    syscall( SYS_futex,
+             reinterpret_cast< std::uint32_t* >( &self.epoch ),
+             FUTEX_WAIT_PRIVATE,
+             self.armed_epoch,
+             &ts,
+             nullptr,
+             0 );
+#else
+    const auto deadline( std::chrono::steady_clock::now() + park_timeout );
+    while( self.epoch.load( std::memory_order_acquire ) == self.armed_epoch &&
+           std::chrono::steady_clock::now() < deadline )
+    {
+        std::this_thread::sleep_for( park_nap );
+    }
+#endif
+    /** woken or timed out, re-arm on the next failed attempt **/
+    disarm( self );
+}
+
+void
+WaitStrategy::disarm( side_t &self ) noexcept
+{
+    if( self.armed )
+    {
+        self.sleepers.fetch_sub( 1, std::memory_order_relaxed );
+        self.armed = false;
+    }
+}
+
+void
+WaitStrategy::wake( side_t &s ) noexcept
+{
+    s.epoch.fetch_add( 1, std::memory_order_release );
+#if defined __linux && ! defined USEQTHREADS
+    syscall( SYS_futex,
+             reinterpret_cast< std::uint32_t* >( &s.epoch ),
+             FUTEX_WAKE_PRIVATE,
+             INT_MAX,
+             nullptr,
+             nullptr,
+             0 );
+#endif
+}
+
+void
+WaitStrategy::wake_all() noexcept
+{
+    /** nothing to read, the consumer has to see why **/
+    auto * const r( ready.load( std::memory_order_acquire ) );
+    if( r != nullptr )
+    {
+        r->poke();
+    }
+    if( policy != Wait::Park )
+    {
+        return;
+    }
+    std::atomic_thread_fence( std::memory_order_seq_cst );
+    wake( producer );
+    wake( consumer );
+}
+
+void
+WaitStrategy::get_stats( Wait::Stats &copy ) const noexcept
+{
+    copy.policy          = policy;
+    copy.producer_yields = producer.yields;
+    copy.producer_parks  = producer.parks;
+    copy.consumer_yields = consumer.yields;
+    copy.consumer_parks  = consumer.parks;
+}
@@ -0,0 +1,348 @@
+/**
+ * workstealschedule.cpp -
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iterator>
+#include <affinity>
+
+#include "kernel.hpp"
+#include "map.hpp"
+#include "workstealschedule.hpp"
+#include "sysschedutil.hpp"
+#include "defs.hpp"
+
+namespace
+{
+   /** the pool and worker this thread belongs to, for the blocked hook **/
+   thread_local work_steal_schedule *self_sched = nullptr;
+   thread_local std::size_t          self_id    = 0;
+}
+
+work_steal_schedule::work_steal_schedule( raft::map &map ) : Schedule( map )
+{
+   std::size_t n( scheduler_threads );
+   if( n == 0 )
+   {
+      n = std::max( std::thread::hardware_concurrency(), 1u );
+   }
+   const auto cores( std::max( std::thread::hardware_concurrency(), 1u ) );
+   for( std::size_t i( 0 ); i < n; i++ )
+   {
+      pool.emplace_back( new worker() );
+      pool.back()->core = static_cast< core_id_t >( i % cores );
+   }
+}
+
+void
+work_steal_schedule::start()
+{
+   auto &container( kernel_set.acquire() );
+   for( auto * const k : container )
+   {
+      handleSchedule( k );
+   }
+   kernel_set.release();
+
+   stopped.add( pool.size() );
+   for( std::size_t i( 0 ); i < pool.size(); i++ )
+   {
+      raft::thread_cache::run( [ this, i ]()
+      {
+         work( i );
+         stopped.count_down();
+      } );
+   }
+   {
+      std::unique_lock< std::mutex > lock( done_mutex );
+      done_cv.wait( lock, [&](){ return( remaining == 0 ); } );
+   }
+   done = true;
+   stopped.wait();
+   return;
+}
+
+void
+work_steal_schedule::handleSchedule( raft::kernel * const kernel )
+{
+   const auto core( kernel->getCoreAssignment() );
+   task *t( nullptr );
+   {
+      std::lock_guard< std::mutex > guard( tasks_mutex );
+      const auto home( core >= 0 ?
+         static_cast< std::size_t >( core ) % pool.size() :
+         next_home++ % pool.size() );
+      tasks.emplace_back( new task( kernel, home, this ) );
+      t = tasks.back().get();
+   }
+   Schedule::setReclaimer( kernel, &t->reclaimer );
+   if( raft::fiber::supported() )
+   {
+      t->body.reset( new raft::fiber( [ t ](){ slice( t ); } ) );
+   }
+   /** bound on the first run, by whichever worker takes it **/
+   t->ready.set_listener( &work_steal_schedule::wake, t );
+   {
+      std::lock_guard< std::mutex > guard( done_mutex );
+      remaining++;
+   }
+   push( t );
+   return;
+}
+
+void
+work_steal_schedule::work( const std::size_t id )
+{
+   auto &self( *pool[ id ] );
+   /** call does nothing if not available **/
+   raft::affinity::set( self.core );
+   self_sched = this;
+   self_id    = id;
+   raft::blocked_hook = &work_steal_schedule::help;
+   std::uint32_t idle( 0 );
+   while( ! done.load( std::memory_order_acquire ) )
+   {
+      if( run_one( id ) )
+      {
+         idle = 0;
+         continue;
+      }
+      if( ++idle < spin_picks )
+      {
+         continue;
+      }
+      sweep();
+      if( idle < yield_picks )
+      {
+         std::this_thread::yield();
+      }
+      else
+      {
+         std::this_thread::sleep_for( std::chrono::microseconds( 100 ) );
+      }
+   }
+   raft::blocked_hook = nullptr;
+   self_sched = nullptr;
+}
+
+bool
+work_steal_schedule::run_one( const std::size_t id )
+{
+   auto * const t( take( id ) );
+   if( t == nullptr )
+   {
+      return( false );
+   }
+   auto &self( *pool[ id ] );
+   t->state.store( running, std::memory_order_relaxed );
+   bool ran( false );
+   if( t->body )
+   {
+      t->ran       = false;
+      t->blocked   = false;
+      self.current = t;
+      const auto more( t->body->resume() );
+      /**
+       * help() finds the running task through this worker's
+       * thread_locals, a slice that came back with some other
+       * current has been marking the wrong task as blocked
+       */
+      assert( self.current == t );
+      self.current = nullptr;
+      ran = t->ran;
+      if( more && t->blocked )
+      {
+         /** the fiber's stack is on this thread until the slice ends **/
+         t->pinned = id;
+         push( t );
+         return( ran );
+      }
+      t->pinned = unpinned;
+   }
+   else
+   {
+      self.depth++;
+      ran = Schedule::kernelRun( t->k, t->finished, t->ready );
+      self.depth--;
+      /** nothing of this kernel is peeked at between runs **/
+      Schedule::fifo_gc( &t->reclaimer );
+   }
+   if( t->finished )
+   {
+      std::lock_guard< std::mutex > guard( done_mutex );
+      if( --remaining == 0 )
+      {
+         done_cv.notify_all();
+      }
+   }
+   else if( Schedule::kernelReady( t->k, t->ready ) )
+   {
+      push( t );
+   }
+   else
+   {
+      park( t );
+   }
+   return( ran );
+}
+
+work_steal_schedule::task*
+work_steal_schedule::take( const std::size_t id )
+{
+   {
+      auto &own( *pool[ id ] );
+      std::lock_guard< std::mutex > guard( own.lock );
+      if( ! own.queue.empty() )
+      {
+         auto * const t( own.queue.front() );
+         own.queue.pop_front();
+         return( t );
+      }
+   }
+   /**
+    * steal from the back, those are the ones the owner gets to last,
+    * skipping any the owner has a fiber stack of
+    */
+   for( std::size_t i( 1 ); i < pool.size(); i++ )
+   {
+      auto &victim( *pool[ ( id + i ) % pool.size() ] );
+      std::lock_guard< std::mutex > guard( victim.lock );
+      for( auto it( victim.queue.rbegin() ); it != victim.queue.rend(); ++it )
+      {
+         if( (*it)->pinned == unpinned )
+         {
+            auto * const t( *it );
+            victim.queue.erase( std::next( it ).base() );
+            return( t );
+         }
+      }
+   }
+   return( nullptr );
+}
+
+void
+work_steal_schedule::push( task * const t )
+{
+   auto &home( *pool[ t->pinned == unpinned ? t->home : t->pinned ] );
+   std::lock_guard< std::mutex > guard( home.lock );
+   home.queue.emplace_back( t );
+}
+
+void
+work_steal_schedule::park( task * const t )
+{
+   /** store before the re-check, pairs with set()'s fetch_or **/
+   t->state.store( parked, std::memory_order_seq_cst );
+   if( Schedule::kernelReady( t->k, t->ready ) )
+   {
+      int expected( parked );
+      if( t->state.compare_exchange_strong( expected, queued ) )
+      {
+         push( t );
+      }
+   }
+}
+
+void
+work_steal_schedule::wake( void * const arg )
+{
+   auto * const t( reinterpret_cast< task* >( arg ) );
+   int expected( parked );
+   if( t->state.load( std::memory_order_relaxed ) == parked &&
+       t->state.compare_exchange_strong( expected, queued ) )
+   {
+      t->sched->push( t );
+   }
+}
+
+void
+work_steal_schedule::sweep()
+{
+   std::lock_guard< std::mutex > guard( tasks_mutex );
+   for( auto &t : tasks )
+   {
+      if( t->state.load( std::memory_order_acquire ) != parked )
+      {
+         continue;
+      }
+      /** parked, nobody else looks at its ports right now **/
+      if( Schedule::kernelHasInputData( t->k ) ||
+          Schedule::kernelHasNoInputPorts( t->k ) ||
+          t->ready.poke_pending() )
+      {
+         int expected( parked );
+         if( t->state.compare_exchange_strong( expected, queued ) )
+         {
+            push( t.get() );
+         }
+      }
+   }
+}
+
+void
+work_steal_schedule::slice( task * const t )
+{
+   /**
+    * the fiber may resume on another worker between slices, keep
+    * thread_local variables out of this frame
+    */
+   while( ! t->finished )
+   {
+      for( std::size_t i( 0 ); i < slice_runs; i++ )
+      {
+         const auto ran( Schedule::kernelRun( t->k, t->finished, t->ready ) );
+         /** nothing of this kernel is peeked at between runs **/
+         Schedule::fifo_gc( &t->reclaimer );
+         t->ran = t->ran || ran;
+         if( ! ran || t->finished ||
+             ! Schedule::kernelReady( t->k, t->ready ) )
+         {
+            break;
+         }
+      }
+      if( ! t->finished )
+      {
+         raft::fiber::yield();
+      }
+   }
+}
+
+bool
+work_steal_schedule::help()
+{
+   auto * const sched( self_sched );
+   if( sched == nullptr )
+   {
+      return( false );
+   }
+   auto &self( *sched->pool[ self_id ] );
+   if( self.current != nullptr )
+   {
+      /** back to run_one, which queues it again **/
+      self.current->blocked = true;
+      raft::fiber::yield();
+      return( true );
+   }
+   if( self.depth >= help_depth )
+   {
+      return( false );
+   }
+   return( sched->run_one( self_id ) );
+}
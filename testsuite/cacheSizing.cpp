@@ -0,0 +1,142 @@
+/**
+ * cacheSizing.cpp - new FIFOs are sized in bytes from the cache
+ * topology, a char edge gets many more items than an edge of large
+ * items, and none of them start out bigger than the last level cache.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <raft>
+#include "cacheinfo.hpp"
+#include "testutil.tcc"
+
+static const int count = 100;
+
+/** one of these per item is a lot more than a cache line **/
+struct chunk
+{
+    chunk() = default;
+    chunk( const int value ) : value( value )
+    {
+    }
+
+    int  value = 0;
+    char data[ 1 << 14 ];
+};
+
+using raft::test::fail;
+
+template < class T >
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.template addPort< T >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( T( curr ) );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    int curr = 0;
+};
+
+template < class T >
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.template addPort< T >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        T v;
+        input[ "0" ].pop( v );
+        if( first == 0 )
+        {
+            first = input[ "0" ].capacity();
+        }
+        seen++;
+        return( raft::proceed );
+    }
+
+    int         seen  = 0;
+    std::size_t first = 0;
+};
+
+/** capacity the edge started with **/
+template < class T >
+static std::size_t initial( const bool pinned )
+{
+    source< T > s;
+    sink< T >   k;
+    if( pinned )
+    {
+        s.setCore( 0 );
+        k.setCore( 0 );
+    }
+    raft::map m;
+    m += s >> k;
+    m.exe();
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+    return( k.first );
+}
+
+int
+main()
+{
+    const auto l1d( Cache::data( -1, 1 ) );
+    const auto llc( Cache::data( -1, Cache::last_level() ) );
+    if( l1d.bytes == 0 || llc.bytes < l1d.bytes || l1d.cpus == 0 )
+    {
+        fail( "no cache sizes" );
+    }
+    if( Cache::shared_level( 0, 0 ) != 1 || Cache::shared_level( -1, 0 ) != 0 )
+    {
+        fail( "wrong shared cache level" );
+    }
+    const auto small( initial< char  >( false ) );
+    const auto large( initial< chunk >( false ) );
+    const auto pinned( initial< char >( true ) );
+    if( small <= INITIAL_ALLOC_SIZE || large >= INITIAL_ALLOC_SIZE )
+    {
+        fail( "not sized in bytes, char edge " + std::to_string( small ) +
+              " items, large item edge " + std::to_string( large ) );
+    }
+    if( small * sizeof( char ) > llc.bytes || pinned * sizeof( char ) > llc.bytes )
+    {
+        fail( "edge doesn't fit the last level cache" );
+    }
+    if( large == 0 || ( large & ( large - 1 ) ) != 0 )
+    {
+        fail( "capacity not a power of two" );
+    }
+    return( EXIT_SUCCESS );
+}
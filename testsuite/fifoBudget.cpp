@@ -0,0 +1,305 @@
+/**
+ * fifoBudget.cpp - FIFO memory budget. A heap FIFO shrinks once its
+ * items fit the smaller buffer (and gives up when they don't), heap and
+ * lock-free FIFOs shrunk between a producer's bursts keep every item,
+ * and the dynamic allocator keeps a map whose sink can't keep up within
+ * its budget while reporting what it uses.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <raft>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 20000;
+static const type_t slow = 300;
+/** both FIFOs start at 64 items, room for one of them to double **/
+static const std::size_t budget = 3 * 64 * sizeof( type_t );
+
+using raft::test::fail;
+
+/** FIFO is a protected base of the queue itself **/
+template < Type::RingBufferType type = Type::Heap >
+class queue : public RingBuffer< type_t, type >
+{
+public:
+    queue( const std::size_t n ) : RingBuffer< type_t, type >( n, 16 )
+    {
+    }
+
+    FIFO& fifo()
+    {
+        return( *this );
+    }
+
+    /** what the consumer's thread does while it waits on the scheduler **/
+    void idle()
+    {
+        (this)->quiesce();
+    }
+};
+
+/** only once every item sits below the new capacity **/
+static void shrink()
+{
+    queue<> buffer( 64 );
+    auto &fifo( buffer.fifo() );
+    volatile bool exit_alloc( false );
+    type_t in( 0 ), out( 0 );
+    /** heap resizes need read < write **/
+    for( int i( 0 ); i < 4; i++ )
+    {
+        fifo.push( in++ );
+    }
+    type_t v( 0 );
+    fifo.pop( v );
+    out++;
+    fifo.resize( 256, 16, exit_alloc );
+    if( fifo.capacity() != 256 )
+    {
+        fail( "didn't grow" );
+    }
+    /** write index is past 64 now **/
+    while( in < 100 )
+    {
+        fifo.push( in++ );
+    }
+    fifo.resize( 64, 16, exit_alloc );
+    if( fifo.capacity() != 256 )
+    {
+        fail( "shrank below its contents" );
+    }
+    fifo.resize( 128, 16, exit_alloc );
+    if( fifo.capacity() != 128 )
+    {
+        fail( "didn't shrink" );
+    }
+    while( fifo.size() > 0 )
+    {
+        fifo.pop( v );
+        if( v != out++ )
+        {
+            fail( "lost items across a shrink" );
+        }
+    }
+}
+
+/**
+ * a producer that has been writing into a large buffer knows it
+ * has plenty of room, once the buffer shrinks underneath it that
+ * has to be forgotten or its next burst writes over unread items.
+ */
+template < Type::RingBufferType type >
+static void shrink_under_load()
+{
+    const type_t items( 4000 );
+    queue< type > buffer( 256 );
+    auto &fifo( buffer.fifo() );
+    volatile bool exit_alloc( false );
+    std::atomic< bool > shrunk( false );
+    type_t in( 0 ), out( 0 );
+    auto next( [ & ]()
+    {
+        type_t v( 0 );
+        fifo.pop( v );
+        if( v != out++ )
+        {
+            fail( "expected " + std::to_string( out - 1 ) + ", got " +
+                  std::to_string( v ) + " after a shrink" );
+        }
+    } );
+    /**
+     * the producer has seen the read side once, it has room for
+     * 157 more against the 256 slots, the 10 items left sit at
+     * 34..43 so they fit a 64 item buffer
+     */
+    while( in < 200 )
+    {
+        fifo.push( in++ );
+    }
+    while( out < 200 )
+    {
+        next();
+    }
+    while( in < 300 )
+    {
+        fifo.push( in++ );
+    }
+    while( out < 290 )
+    {
+        next();
+    }
+    /**
+     * the lock-free FIFO needs both sides to acknowledge a shrink,
+     * the producer sits in the queue without adding anything and
+     * the consumer holds at 290 until the shrink is in
+     */
+    std::thread resizer( [ & ]()
+    {
+        while( ! exit_alloc && fifo.capacity() != 64 )
+        {
+            fifo.resize( 64, 16, exit_alloc );
+        }
+        shrunk = ( fifo.capacity() == 64 );
+    } );
+    std::thread producer( [ & ]()
+    {
+        while( ! shrunk && ! exit_alloc )
+        {
+            fifo.template allocate< type_t >();
+            fifo.deallocate();
+            std::this_thread::yield();
+        }
+        for( type_t i( in ); i < items; i++ )
+        {
+            fifo.push( i );
+        }
+    } );
+    const auto give_up( std::chrono::steady_clock::now() +
+                        std::chrono::seconds( 10 ) );
+    while( fifo.capacity() != 64 )
+    {
+        if( std::chrono::steady_clock::now() > give_up )
+        {
+            fail( "never shrank under load" );
+        }
+        buffer.idle();
+        std::this_thread::yield();
+    }
+    while( out < items )
+    {
+        next();
+        /** fall behind so a producer that thinks it has room laps us **/
+        if( out % 64 == 0 )
+        {
+            std::this_thread::sleep_for( std::chrono::microseconds( 20 ) );
+        }
+    }
+    exit_alloc = true;
+    producer.join();
+    resizer.join();
+}
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+class pass : public raft::kernel
+{
+public:
+    pass() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        output[ "0" ].push( v );
+        return( raft::proceed );
+    }
+};
+
+/** can't keep up, the FIFOs in front of it want to grow **/
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        if( v != seen++ )
+        {
+            fail( "out of order" );
+        }
+        /**
+         * about one item per allocator pass, the producers are
+         * blocked on nearly every write
+         */
+        if( seen < slow )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 3 ) );
+        }
+        return( raft::proceed );
+    }
+
+    type_t seen = 0;
+};
+
+int
+main()
+{
+    shrink();
+    shrink_under_load< Type::Heap >();
+    shrink_under_load< Type::LockFreeSPSC >();
+
+    source s;
+    pass   p;
+    sink   k;
+    raft::map m;
+    m.setFIFOMemoryBudget( budget );
+    m += s >> p >> k;
+    m.exe();
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+    const auto usage( m.getFIFOMemoryUsage() );
+    if( usage.budget != budget )
+    {
+        fail( "budget not reported" );
+    }
+    if( usage.used == 0 || usage.peak < usage.used )
+    {
+        fail( "usage not reported" );
+    }
+    if( usage.peak > budget )
+    {
+        fail( "FIFOs grew to " + std::to_string( usage.peak ) +
+              " bytes, over the " + std::to_string( budget ) + " byte budget" );
+    }
+    return( EXIT_SUCCESS );
+}
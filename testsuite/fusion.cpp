@@ -0,0 +1,202 @@
+/**
+ * fusion.cpp - linear chains run on one thread under simple_schedule,
+ * including stages that push or pop more than the FIFO between them
+ * holds, a kernel that opts out splits the chain, and fused links are
+ * marked in the GEN_DOT output.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <raft>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count  = 100000;
+/** more than any FIFO starts out with, the push has to block **/
+static const type_t burst  = 1 << 16;
+static const int    stages = 6;
+
+using raft::test::fail;
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        thread = std::this_thread::get_id();
+        /** all of it in bursts, blocks until the chain drains **/
+        for( type_t i( 0 ); i < burst && curr < count; i++ )
+        {
+            output[ "0" ].push( curr++ );
+        }
+        return( curr == count ? raft::stop : raft::proceed );
+    }
+
+    std::thread::id thread;
+
+private:
+    type_t curr = 0;
+};
+
+class pass : public raft::kernel
+{
+public:
+    pass() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        thread = std::this_thread::get_id();
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        output[ "0" ].push( v );
+        return( raft::proceed );
+    }
+
+    std::thread::id thread;
+};
+
+/** pops two per run, waits on its producer for the second **/
+class pairs : public raft::kernel
+{
+public:
+    pairs() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        thread = std::this_thread::get_id();
+        type_t a( 0 ), b( 0 );
+        input[ "0" ].pop( a );
+        input[ "0" ].pop( b );
+        output[ "0" ].push( a );
+        output[ "0" ].push( b );
+        return( raft::proceed );
+    }
+
+    std::thread::id thread;
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        thread = std::this_thread::get_id();
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        if( v != seen++ )
+        {
+            fail( "out of order" );
+        }
+        return( raft::proceed );
+    }
+
+    type_t          seen = 0;
+    std::thread::id thread;
+};
+
+/** source >> pass... >> pairs >> sink, opt_out stage on its own **/
+static void chain( const int opt_out, const std::string &dot )
+{
+    source s;
+    pass   p[ stages ];
+    pairs  q;
+    sink   k;
+    if( opt_out >= 0 )
+    {
+        p[ opt_out ].setFusion( false );
+    }
+    raft::map m;
+    m += s >> p[ 0 ];
+    for( int i( 1 ); i < stages; i++ )
+    {
+        m += p[ i - 1 ] >> p[ i ];
+    }
+    m += p[ stages - 1 ] >> q >> k;
+    if( ! dot.empty() )
+    {
+        setenv( "GEN_DOT", dot.c_str(), 1 );
+    }
+    m.exe();
+    unsetenv( "GEN_DOT" );
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+    for( int i( 0 ); i < stages; i++ )
+    {
+        const bool same( p[ i ].thread == s.thread );
+        if( opt_out < 0 && ! same )
+        {
+            fail( "stage " + std::to_string( i ) + " not fused" );
+        }
+        if( i == opt_out && same )
+        {
+            fail( "stage that opted out was fused" );
+        }
+    }
+    if( q.thread != k.thread || ( opt_out < 0 && q.thread != s.thread ) )
+    {
+        fail( "tail not fused" );
+    }
+}
+
+int
+main()
+{
+    const std::string dot( "fusion_test.dot" );
+    chain( -1, dot );
+    chain( stages / 2, "" );
+
+    std::ifstream in( dot );
+    std::stringstream ss;
+    ss << in.rdbuf();
+    in.close();
+    std::remove( dot.c_str() );
+    const auto graph( ss.str() );
+    if( graph.find( "subgraph cluster_fused_" ) == std::string::npos ||
+        graph.find( "fused=true" ) == std::string::npos )
+    {
+        fail( "fusion missing from the dot output" );
+    }
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,219 @@
+/**
+ * hugePages.cpp - huge page backed FIFO storage. The mapping itself
+ * is huge page aligned and sized, a heap FIFO grown within its
+ * mapping keeps the storage it has (and its contents), one grown past
+ * it gets a new mapping, and opted in edges of each resizable FIFO
+ * type still deliver every item in order while dynalloc grows them.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <raft>
+#include <raftmanip>
+#include "pagemap.hpp"
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 30000;
+
+using raft::test::fail;
+
+/** exposes the storage address of a heap FIFO **/
+class probe : public RingBuffer< type_t, Type::Heap >
+{
+public:
+    probe( const std::size_t n ) : RingBuffer< type_t, Type::Heap >(
+        n, Buffer::huge_page_size )
+    {
+    }
+
+    const void* store()
+    {
+        return( (this)->datamanager.get()->store );
+    }
+
+    std::size_t mapped()
+    {
+        return( (this)->datamanager.get()->pages.length );
+    }
+
+    FIFO& fifo()
+    {
+        return( *this );
+    }
+};
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        if( v != seen++ )
+        {
+            fail( "out of order" );
+        }
+        return( raft::proceed );
+    }
+
+    type_t seen = 0;
+};
+
+template < Type::RingBufferType type > static void run_map()
+{
+    source s;
+    sink   k;
+    raft::manip< raft::fifo::type< type >, raft::fifo::huge_pages >::bind( s );
+    raft::map m;
+    m += s >> k;
+    m.exe();
+    if( k.seen != count )
+    {
+        fail( std::string( Type::type_prints[ type ] ) + ": missing items" );
+    }
+}
+
+int
+main()
+{
+    {
+        Buffer::PageMap pm;
+        if( ! pm.map( 3 << 20 ) )
+        {
+            /** nothing to test without mmap **/
+            return( EXIT_SUCCESS );
+        }
+        if( pm.length != ( 4 << 20 ) ||
+            reinterpret_cast< std::uintptr_t >( pm.base ) %
+                Buffer::huge_page_size != 0 )
+        {
+            fail( "mapping not huge page aligned" );
+        }
+        pm.prefault();
+        if( ! pm.prefaulted )
+        {
+            fail( "not prefaulted" );
+        }
+        pm.unmap();
+        if( pm.base != nullptr )
+        {
+            fail( "not unmapped" );
+        }
+    }
+
+    {
+        probe buffer( 64 );
+        auto &fifo( buffer.fifo() );
+        fifo.set_home_node( -1 );
+        if( buffer.mapped() != Buffer::huge_page_size )
+        {
+            fail( "FIFO storage isn't a huge page mapping" );
+        }
+        volatile bool exit_alloc( false );
+        type_t in( 0 ), out( 0 );
+        const auto drain( [ & ]()
+        {
+            while( fifo.size() > 0 )
+            {
+                type_t v( 0 );
+                fifo.pop( v );
+                if( v != out++ )
+                {
+                    fail( "lost items across a resize" );
+                }
+            }
+        } );
+        /** grows from 64 to 1 << 20 items, 2 MiB hold 1 << 18 **/
+        for( std::size_t cap( 128 ); cap <= ( 1 << 20 ); cap <<= 1 )
+        {
+            /** resize needs read < write, without wrapping around **/
+            for( int i( 0 ); i < 3; i++ )
+            {
+                fifo.push( in++ );
+            }
+            type_t v( 0 );
+            fifo.pop( v );
+            if( v != out++ )
+            {
+                fail( "lost items across a resize" );
+            }
+            const auto * const before( buffer.store() );
+            fifo.resize( cap, 64, exit_alloc );
+            if( fifo.capacity() != cap )
+            {
+                fail( "resize to " + std::to_string( cap ) + " didn't happen" );
+            }
+            const bool fits( cap * sizeof( type_t ) <= Buffer::huge_page_size );
+            if( fits != ( buffer.store() == before ) )
+            {
+                fail( "capacity " + std::to_string( cap ) +
+                      ( fits ? " should have grown in place" :
+                               " can't have grown in place" ) );
+            }
+            if( buffer.mapped() < cap * sizeof( type_t ) )
+            {
+                fail( "storage not mapped after resize" );
+            }
+        }
+        /** all of it, wrapping around **/
+        for( int round( 0 ); round < 3; round++ )
+        {
+            while( fifo.space_avail() > 0 )
+            {
+                fifo.push( in++ );
+            }
+            drain();
+        }
+        if( out != in )
+        {
+            fail( "items missing after resizes" );
+        }
+    }
+
+    run_map< Type::Heap >();
+    run_map< Type::LockFreeSPSC >();
+    run_map< Type::Segmented >();
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,95 @@
+/**
+ * lockFreeSPSC.cpp - push enough through lock-free SPSC FIFOs
+ * to get them resized a few times, check that every item
+ * arrives, in order, for both a non-class and an inline
+ * class type.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <raft>
+#include <raftmanip>
+#include "generate.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 100000;
+
+class tostring : public raft::kernel
+{
+public:
+    tostring() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+        output.addPort< std::string >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t val( 0 );
+        input[ "0" ].pop( val );
+        output[ "0" ].push( std::to_string( val ) );
+        return( raft::proceed );
+    }
+};
+
+class check : public raft::kernel
+{
+public:
+    check() : raft::kernel()
+    {
+        input.addPort< std::string >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        std::string val;
+        input[ "0" ].pop( val );
+        /** generate counts down to zero **/
+        if( val != std::to_string( --expected ) )
+        {
+            std::cerr << "expected " << expected << ", got " << val << "\n";
+            exit( EXIT_FAILURE );
+        }
+        return( raft::proceed );
+    }
+
+    type_t expected = count;
+};
+
+int
+main()
+{
+    raft::test::generate< type_t > gen( count );
+    tostring ts;
+    check    c;
+    raft::manip< raft::fifo::type< Type::LockFreeSPSC > >::bind( gen, ts );
+
+    raft::map m;
+    m += gen >> ts >> c;
+    m.exe();
+
+    if( c.expected != 0 )
+    {
+        std::cerr << "missing " << c.expected << " items\n";
+        return( EXIT_FAILURE );
+    }
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,151 @@
+/**
+ * movePush.cpp - rvalues are moved through the FIFOs, not copied:
+ * push( T&& ) moves in, pop moves out, emplace builds the item in
+ * its slot and pop_s().steal() takes the head over. Checked for an
+ * item that fits a slot and one that lives out of line.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <raft>
+#include "reclaimer.hpp"
+#include "testutil.tcc"
+
+static int copies = 0;
+
+using raft::test::fail;
+
+/** counts deep copies, moves hand the vector over **/
+template < std::size_t pad > struct tracked
+{
+    tracked() = default;
+
+    tracked( const std::size_t n, const int v ) : data( n, v )
+    {
+    }
+
+    tracked( const tracked &other ) : data( other.data )
+    {
+        copies++;
+    }
+
+    tracked( tracked &&other ) = default;
+
+    tracked& operator = ( const tracked &other )
+    {
+        data = other.data;
+        copies++;
+        return( *this );
+    }
+
+    tracked& operator = ( tracked &&other ) = default;
+
+    std::vector< int > data;
+    char               extra[ pad ];
+};
+
+/** fits a cache line, stored in the slot **/
+using small_t = tracked< 8 >;
+/** doesn't, the slot points to it **/
+using large_t = tracked< 128 >;
+
+/** 
+ * FIFO is a protected base of the queue itself, out of line items 
+ * need a reclaimer, the scheduler sets one for each kernel thread
+ */
+template < class T, Type::RingBufferType type >
+class queue : public RingBuffer< T, type, false >
+{
+public:
+    queue() : RingBuffer< T, type, false >( 16 )
+    {
+        (this)->setReclaimer( &reclaim, Direction::Producer );
+        (this)->setReclaimer( &reclaim, Direction::Consumer );
+    }
+
+    FIFO& fifo()
+    {
+        return( *this );
+    }
+
+private:
+    Buffer::Reclaimer reclaim;
+};
+
+template < class T, Type::RingBufferType type >
+static void check( const std::string &name )
+{
+    queue< T, type > buffer;
+    auto *fifo( &buffer.fifo() );
+    copies = 0;
+    T item( 1000, 7 );
+    const auto *storage( item.data.data() );
+    fifo->push( std::move( item ) );
+    fifo->template emplace< T >( 1000, 8 );
+    fifo->push( T( 1000, 9 ) );
+    T out;
+    fifo->pop( out );
+    if( out.data.size() != 1000 || out.data[ 0 ] != 7 )
+    {
+        fail( name + ": wrong item" );
+    }
+    /** moved in and out again, still the same vector **/
+    if( out.data.data() != storage )
+    {
+        fail( name + ": pushed storage didn't make it through" );
+    }
+    {
+        auto head( fifo->template pop_s< T >() );
+        const auto stolen( head.steal() );
+        if( stolen.data.size() != 1000 || stolen.data[ 0 ] != 8 )
+        {
+            fail( name + ": wrong emplaced item" );
+        }
+    }
+    fifo->pop( out );
+    if( out.data[ 0 ] != 9 || fifo->size() != 0 )
+    {
+        fail( name + ": wrong temporary" );
+    }
+    if( copies != 0 )
+    {
+        fail( name + ": " + std::to_string( copies ) + " deep copies" );
+    }
+    /** lvalues still copy **/
+    fifo->push( out );
+    fifo->pop( out );
+    if( copies != 1 )
+    {
+        fail( name + ": lvalue push didn't copy" );
+    }
+}
+
+int
+main()
+{
+    check< small_t, Type::Heap         >( "heap" );
+    check< small_t, Type::LockFreeSPSC >( "spsc" );
+    check< small_t, Type::Segmented    >( "segmented" );
+    check< small_t, Type::MPMC         >( "mpmc" );
+    check< large_t, Type::Heap         >( "heap, out of line" );
+    check< large_t, Type::LockFreeSPSC >( "spsc, out of line" );
+    return( EXIT_SUCCESS );
+}
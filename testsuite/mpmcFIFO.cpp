@@ -0,0 +1,208 @@
+/**
+ * mpmcFIFO.cpp - fan-in (two sources into one input port) and
+ * fan-out (one output port drained by two kernels) over a shared
+ * Type::MPMC FIFO. Every item has to arrive exactly once, fan-in
+ * keeps each producer's order, only fan-out consumers count as
+ * sharing their FIFO. Linking a port twice without MPMC must still
+ * throw.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include <raft>
+#include <raftmanip>
+
+using type_t = std::int64_t;
+/** multiple of the peek_range width below **/
+static const type_t count = 40000;
+
+class source : public raft::kernel
+{
+public:
+    source( const type_t id ) : raft::kernel(), curr( id * count ),
+                                last( ( id + 1 ) * count )
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        if( ++curr == last )
+        {
+            return( raft::stop );
+        }
+        return( raft::proceed );
+    }
+
+private:
+    type_t       curr;
+    const type_t last;
+};
+
+/** records what it popped, checks per-producer order **/
+class sink : public raft::kernel
+{
+public:
+    sink( const std::size_t producers ) : raft::kernel(),
+                                          next( producers )
+    {
+        input.addPort< type_t >( "0" );
+        for( std::size_t i( 0 ); i < producers; i++ )
+        {
+            next[ i ] = i * count;
+        }
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t val( 0 );
+        input[ "0" ].pop( val );
+        record( val );
+        return( raft::proceed );
+    }
+
+    void record( const type_t val )
+    {
+        shared = input[ "0" ].is_shared( Direction::Consumer );
+        const auto id( static_cast< std::size_t >( val / count ) );
+        if( id >= next.size() || val < next[ id ] )
+        {
+            std::cerr << "sink: item " << val << " out of order\n";
+            exit( EXIT_FAILURE );
+        }
+        next[ id ] = val + 1;
+        seen.push_back( val );
+    }
+
+    std::vector< type_t > seen;
+    /** another consumer reads the same FIFO **/
+    bool                  shared = false;
+
+protected:
+    std::vector< type_t > next;
+};
+
+/** same, but takes its items through peek_range/recycle **/
+class range_sink : public sink
+{
+public:
+    range_sink() : sink( 1 )
+    {
+    }
+
+    virtual raft::kstatus run()
+    {
+        auto &port( input[ "0" ] );
+        auto range( port.peek_range< type_t >( width ) );
+        for( std::size_t i( 0 ); i < width; i++ )
+        {
+            record( range[ i ].ele );
+        }
+        port.recycle( width );
+        return( raft::proceed );
+    }
+
+private:
+    static constexpr std::size_t width = 4;
+};
+
+static void check_all( const std::vector< sink* > &sinks,
+                       const std::size_t producers,
+                       const char * const name )
+{
+    std::vector< bool > got( producers * count, false );
+    std::size_t total( 0 );
+    for( auto *s : sinks )
+    {
+        for( const auto val : s->seen )
+        {
+            if( got[ val ] )
+            {
+                std::cerr << name << ": item " << val << " seen twice\n";
+                exit( EXIT_FAILURE );
+            }
+            got[ val ] = true;
+        }
+        total += s->seen.size();
+    }
+    if( total != producers * count )
+    {
+        std::cerr << name << ": missing " << ( producers * count - total )
+            << " items\n";
+        exit( EXIT_FAILURE );
+    }
+}
+
+int
+main()
+{
+    /** fan-in, type picked by binding the producers **/
+    {
+        source s0( 0 ), s1( 1 );
+        sink   k( 2 );
+        raft::manip< raft::fifo::type< Type::MPMC > >::bind( s0 );
+        raft::manip< raft::fifo::type< Type::MPMC > >::bind( s1 );
+        raft::map m;
+        m.link( &s0, "0", &k, "0" );
+        m.link( &s1, "0", &k, "0" );
+        m.exe();
+        check_all( { &k }, 2, "fan-in" );
+        if( k.shared )
+        {
+            std::cerr << "fan-in: lone consumer reported as shared\n";
+            return( EXIT_FAILURE );
+        }
+    }
+    /** fan-out, type picked on the link, one pop and one range consumer **/
+    {
+        source     s( 0 );
+        sink       k0( 1 );
+        range_sink k1;
+        raft::map m;
+        m.link( &s, "0", &k0, "0", 64, Type::MPMC );
+        m.link( &s, "0", &k1, "0", 64, Type::MPMC );
+        m.exe();
+        check_all( { &k0, &k1 }, 1, "fan-out" );
+        if( ! k0.shared || ! k1.shared )
+        {
+            std::cerr << "fan-out: consumers not reported as shared\n";
+            return( EXIT_FAILURE );
+        }
+    }
+    /** anything else still can't share a port **/
+    {
+        source s0( 0 ), s1( 1 );
+        sink   k( 2 );
+        raft::map m;
+        m.link( &s0, "0", &k, "0" );
+        try
+        {
+            m.link( &s1, "0", &k, "0" );
+        }
+        catch( PortDoubleInitializeException &ex )
+        {
+            return( EXIT_SUCCESS );
+        }
+        std::cerr << "heap FIFO linked twice without an exception\n";
+        return( EXIT_FAILURE );
+    }
+}
@@ -0,0 +1,198 @@
+/**
+ * numaPlacement.cpp - FIFO storage follows the consumer kernel's core:
+ * every edge of a map gets the consumer's node as its home, the
+ * storage is on that node, a resize keeps it there and the per-edge
+ * report (RAFT_FIFO_PLACEMENT) says so. On a machine without NUMA
+ * information every node is -1, which is checked for as well.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <raft>
+#include <raftmanip>
+#include "numaplace.hpp"
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 20000;
+
+/** set once we know the OS honors placement requests **/
+static bool placement_works = false;
+
+using raft::test::fail;
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        if( v != seen )
+        {
+            fail( "out of order" );
+        }
+        if( ++seen == count )
+        {
+            input[ "0" ].get_placement( info );
+        }
+        return( raft::proceed );
+    }
+
+    type_t          seen = 0;
+    Placement::Info info;
+};
+
+/** check - info is what we expect for storage homed at node **/
+static void check( const Placement::Info &info,
+                   const int node,
+                   const std::string &where )
+{
+    if( info.home_node != node )
+    {
+        fail( where + ": home node " + std::to_string( info.home_node ) +
+              ", expected " + std::to_string( node ) );
+    }
+    if( node >= 0 && placement_works && info.resident_node != node )
+    {
+        fail( where + ": storage on node " +
+              std::to_string( info.resident_node ) + ", expected " +
+              std::to_string( node ) );
+    }
+}
+
+template < Type::RingBufferType type > static Placement::Info run_map()
+{
+    source s;
+    sink   k;
+    raft::manip< raft::fifo::type< type > >::bind( s );
+    raft::map m;
+    m += s >> k;
+    m.exe();
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+    check( k.info,
+           Placement::node_of_core( k.getCoreAssignment() ),
+           std::string( Type::type_prints[ type ] ) + " map" );
+    return( k.info );
+}
+
+int
+main()
+{
+    if( Placement::node_of_core( -1 ) != -1 )
+    {
+        fail( "unassigned core has a node" );
+    }
+    const auto node( Placement::node_of_core( 0 ) );
+    if( ( Placement::node_count() > 0 ) != ( node >= 0 ) )
+    {
+        fail( "core 0 and the node count disagree" );
+    }
+
+    /** raw placement of a few pages, tells us if the OS plays along **/
+    {
+        constexpr std::size_t length = 1 << 20;
+        void *ptr( nullptr );
+        if( posix_memalign( &ptr, 1 << 12, length ) != 0 )
+        {
+            fail( "posix_memalign" );
+        }
+        placement_works = Placement::place( ptr, length, node );
+        reinterpret_cast< char* >( ptr )[ 0 ] = 1;
+        if( placement_works && Placement::node_of( ptr ) != node )
+        {
+            fail( "page not on the node it was bound to" );
+        }
+        free( ptr );
+    }
+
+    /** a resize installs new storage, it has to land on the home node too **/
+    {
+        auto *fifo( RingBuffer< type_t, Type::Heap >::make_new_fifo(
+            64, 64, nullptr ) );
+        fifo->set_home_node( node );
+        fifo->push( type_t( 1 ) );
+        volatile bool exit_alloc( false );
+        fifo->resize( 1 << 17, 64, exit_alloc );
+        Placement::Info info;
+        fifo->get_placement( info );
+        if( info.bytes < ( 1 << 17 ) * sizeof( type_t ) )
+        {
+            fail( "resize didn't happen" );
+        }
+        check( info, node, "resize" );
+        delete( fifo );
+    }
+
+    run_map< Type::Heap >();
+    run_map< Type::LockFreeSPSC >();
+    run_map< Type::Segmented >();
+
+    /** and the report, one line for the one edge **/
+    const std::string report( "numaPlacement." +
+                              std::to_string( getpid() ) + ".txt" );
+    setenv( "RAFT_FIFO_PLACEMENT", report.c_str(), 1 );
+    const auto info( run_map< Type::Heap >() );
+    unsetenv( "RAFT_FIFO_PLACEMENT" );
+    std::ifstream in( report );
+    std::string line;
+    std::getline( in, line );
+    in.close();
+    std::remove( report.c_str() );
+    std::stringstream expected;
+    expected << "home_node " << info.home_node << " resident_node " <<
+        info.resident_node << " bytes ";
+    if( line.find( expected.str() ) == std::string::npos )
+    {
+        fail( "bad report line \"" + line + "\"" );
+    }
+    return( EXIT_SUCCESS );
+}
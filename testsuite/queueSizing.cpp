@@ -0,0 +1,296 @@
+/**
+ * queueSizing.cpp - sizing FIFOs from their arrival and service
+ * rates. The M/M/1/K target meets the blocking probability asked
+ * for, the rate samplers measure what goes through a FIFO and flag a
+ * throttled producer, and the dynamic allocator grows an edge whose
+ * consumer can't keep up and shrinks it back once it can, without
+ * losing or mangling the bursts sent through it after the shrink.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <raft>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t slow_sink   = 100;
+/** enough to keep the queue full while the sink is slow **/
+static const type_t fast        = 2000;
+/** 
+ * then a trickle, long enough for the allocator to shrink the edge,
+ * and a burst well over the shrunk capacity, a few times
+ */
+static const type_t trickle     = 100;
+static const type_t burst       = 1000;
+static const type_t count       = fast + 4 * ( trickle + burst );
+
+/** 
+ * a cache line per item, the edge starts out sized from the cache 
+ * (see Allocate::initial_capacity) well below what a full queue needs
+ */
+struct item
+{
+    item() = default;
+    item( const type_t value ) : value( value )
+    {
+        std::memset( pad, static_cast< int >( value & 0x7f ), sizeof( pad ) );
+    }
+
+    /** false if anything but value was overwritten **/
+    bool intact() const
+    {
+        for( const auto c : pad )
+        {
+            if( c != static_cast< char >( value & 0x7f ) )
+            {
+                return( false );
+            }
+        }
+        return( true );
+    }
+
+    type_t value = 0;
+    char   pad[ 64 - sizeof( type_t ) ];
+};
+
+using raft::test::fail;
+
+/** M/M/1/K probability an arriving item finds the queue full **/
+static double blocking( const double rho, const std::size_t k )
+{
+    return( ( 1.0 - rho ) * std::pow( rho, k ) / 
+            ( 1.0 - std::pow( rho, k + 1 ) ) );
+}
+
+static void model()
+{
+    const auto loss( dynalloc::loss );
+    if( dynalloc::target_capacity( 0.0, loss, 64, 1 << 20 ) != 64 )
+    {
+        fail( "idle edge should sit at the floor" );
+    }
+    std::size_t prev( 0 );
+    for( const auto rho : { 0.1, 0.5, 0.9, 0.99 } )
+    {
+        const auto k( dynalloc::target_capacity( rho, loss, 1, 1 << 20 ) );
+        if( ( k & ( k - 1 ) ) != 0 )
+        {
+            fail( "target not a power of two" );
+        }
+        if( blocking( rho, k ) > loss )
+        {
+            fail( "target blocks too often at rho " + std::to_string( rho ) );
+        }
+        if( k > 1 && blocking( rho, k / 4 ) <= loss )
+        {
+            fail( "target much larger than needed at rho " + std::to_string( rho ) );
+        }
+        if( k < prev )
+        {
+            fail( "target shrank with more load" );
+        }
+        prev = k;
+    }
+    const auto saturated( dynalloc::target_capacity( 2.0, loss, 1, 1 << 20 ) );
+    if( saturated < prev || saturated != dynalloc::target_capacity( 1000.0, loss, 1, 1 << 20 ) )
+    {
+        fail( "saturated edges should all get the same bounded target" );
+    }
+    if( dynalloc::target_capacity( 2.0, loss, 1, 256 ) != 256 )
+    {
+        fail( "target above the ceiling" );
+    }
+}
+
+/** FIFO is a protected base of the queue itself **/
+class queue : public RingBuffer< type_t, Type::Heap >
+{
+public:
+    queue( const std::size_t n ) : RingBuffer< type_t, Type::Heap >( n )
+    {
+    }
+
+    FIFO& fifo()
+    {
+        return( *this );
+    }
+};
+
+static void samplers()
+{
+    queue buffer( 64 );
+    auto &fifo( buffer.fifo() );
+    ArrivalRateSampleType   arrival;
+    DepartureRateSampleType departure;
+    /** the producer starts inside the first frame **/
+    fifo.push( 0 );
+    arrival.sample( fifo, 0.1 );
+    for( type_t i( 0 ); i < 40; i++ )
+    {
+        fifo.push( i );
+    }
+    type_t v( 0 );
+    for( int i( 0 ); i < 20; i++ )
+    {
+        fifo.pop( v );
+    }
+    arrival.sample( fifo, 0.1 );
+    departure.sample( fifo, 0.1 );
+    if( ! arrival.valid() || std::fabs( arrival.rate() - 400.0 ) > 1e-6 )
+    {
+        fail( "arrival rate " + std::to_string( arrival.rate() ) );
+    }
+    if( ! departure.valid() || std::fabs( departure.rate() - 200.0 ) > 1e-6 )
+    {
+        fail( "departure rate " + std::to_string( departure.rate() ) );
+    }
+    /** fill it up, the producer waits on the consumer **/
+    std::thread producer( [ & ]()
+    {
+        for( type_t i( 0 ); i < 64; i++ )
+        {
+            fifo.push( i );
+        }
+    } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) );
+    while( fifo.size() > 0 )
+    {
+        fifo.pop( v );
+    }
+    producer.join();
+    arrival.sample( fifo, 0.1 );
+    if( ! arrival.blocked() || arrival.estimate() < 640.0 || arrival.rate() != 400.0 )
+    {
+        fail( "throttled frame folded into the arrival rate" );
+    }
+}
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< item >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        /** 
+         * the producer has to keep coming back to the queue for a
+         * lock-free edge to shrink, so slow down rather than stop
+         */
+        if( curr >= fast && ( curr - fast ) % ( trickle + burst ) < trickle )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+        }
+        output[ "0" ].push( item( curr ) );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+/** can't keep up at first **/
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< item >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        item v;
+        input[ "0" ].pop( v );
+        if( v.value != seen++ )
+        {
+            fail( "expected " + std::to_string( seen - 1 ) + ", got " +
+                  std::to_string( v.value ) );
+        }
+        if( ! v.intact() )
+        {
+            fail( "item " + std::to_string( v.value ) + " overwritten" );
+        }
+        const auto cap( input[ "0" ].capacity() );
+        if( first == 0 )
+        {
+            first = cap;
+        }
+        if( shrunk_at == 0 && cap < largest )
+        {
+            shrunk_at = seen;
+        }
+        largest = std::max( largest, cap );
+        last    = cap;
+        if( seen < slow_sink )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 3 ) );
+        }
+        return( raft::proceed );
+    }
+
+    type_t      seen    = 0;
+    std::size_t first   = 0;
+    std::size_t largest = 0;
+    std::size_t last    = 0;
+    /** items read when the first shrink showed up **/
+    type_t      shrunk_at = 0;
+};
+
+int
+main()
+{
+    model();
+    samplers();
+
+    source s;
+    sink   k;
+    raft::map m;
+    /** fused edges are never resized, this one has to grow **/
+    m.setFusion( false );
+    m.link( &s, "0", &k, "0", 0, Type::LockFreeSPSC );
+    m.exe();
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+    if( k.largest <= k.first )
+    {
+        fail( "edge with a slow consumer didn't grow past " + 
+              std::to_string( k.first ) );
+    }
+    if( k.last >= k.largest || k.shrunk_at == 0 )
+    {
+        fail( "edge didn't shrink once the consumer kept up, still at " + 
+              std::to_string( k.last ) );
+    }
+    if( count - k.shrunk_at < burst )
+    {
+        fail( "no burst went through the shrunk edge" );
+    }
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,169 @@
+/**
+ * readySet.cpp - wide joins, where a kernel's ready set decides when
+ * it runs, on both the thread per kernel and the work stealing
+ * scheduler. Covers any_port and all_port joins and a join with more
+ * inputs than a ready set tracks, which falls back to asking ports.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <raft>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 2000;
+static const std::size_t wide = 64;
+
+using raft::test::fail;
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+/** any_port, takes whatever is there **/
+class join_any : public raft::kernel
+{
+public:
+    join_any( const std::size_t n ) : raft::kernel()
+    {
+        for( std::size_t i( 0 ); i < n; i++ )
+        {
+            input.addPort< type_t >( std::to_string( i ) );
+        }
+    }
+
+    virtual raft::kstatus run()
+    {
+        for( auto &port : input )
+        {
+            if( port.size() > 0 )
+            {
+                type_t v( 0 );
+                port.pop( v );
+                seen++;
+            }
+        }
+        return( raft::proceed );
+    }
+
+    type_t seen = 0;
+};
+
+/** all_port, only runs with an item on every input **/
+class join_all : public raft::kernel_all
+{
+public:
+    join_all( const std::size_t n ) : raft::kernel_all()
+    {
+        for( std::size_t i( 0 ); i < n; i++ )
+        {
+            input.addPort< type_t >( std::to_string( i ) );
+        }
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t first( -1 );
+        for( auto &port : input )
+        {
+            type_t v( 0 );
+            port.pop( v );
+            if( first == -1 )
+            {
+                first = v;
+            }
+            else if( v != first )
+            {
+                fail( "all_port join ran on a partial set" );
+            }
+        }
+        rounds++;
+        return( raft::proceed );
+    }
+
+    type_t rounds = 0;
+};
+
+template < class JOIN, class SCHED >
+static void wide_join( const std::size_t n, JOIN &join )
+{
+    std::vector< std::unique_ptr< source > > sources;
+    raft::map m;
+    for( std::size_t i( 0 ); i < n; i++ )
+    {
+        sources.emplace_back( new source() );
+        m += ( *sources.back() ) >> join[ std::to_string( i ) ];
+    }
+    m.exe< partition_dummy, SCHED >();
+}
+
+template < class SCHED >
+static void run_all( const std::string &name )
+{
+    {
+        join_any j( wide );
+        wide_join< join_any, SCHED >( wide, j );
+        if( j.seen != count * static_cast< type_t >( wide ) )
+        {
+            fail( name + ": any_port join missed items" );
+        }
+    }
+    {
+        join_all j( wide );
+        wide_join< join_all, SCHED >( wide, j );
+        if( j.rounds != count )
+        {
+            fail( name + ": all_port join missed rounds" );
+        }
+    }
+}
+
+int
+main()
+{
+    run_all< simple_schedule >( "simple_schedule" );
+    run_all< work_steal_schedule >( "work_steal_schedule" );
+    /** past raft::ready_set::max_ports, polled port by port **/
+    const auto past( raft::ready_set::max_ports + 4 );
+    join_any j( past );
+    wide_join< join_any, work_steal_schedule >( past, j );
+    if( j.seen != count * static_cast< type_t >( past ) )
+    {
+        fail( "untracked join missed items" );
+    }
+    return( EXIT_SUCCESS );
+}
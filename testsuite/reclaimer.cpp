@@ -0,0 +1,93 @@
+/**
+ * reclaimer.cpp - epoch rules of Buffer::Reclaimer: nothing retired
+ * is freed before the epoch ends, forwarded items are never freed
+ * by it, everything else exactly once, and forwarding only counts
+ * for the epoch it happened in.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdlib>
+#include <iostream>
+#include "reclaimer.hpp"
+
+static int freed[ 8 ] = { 0 };
+static int items[ 8 ] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+
+static void reclaim( void *ptr )
+{
+    freed[ *reinterpret_cast< int* >( ptr ) ]++;
+}
+
+static bool expect( const int * const counts, const char * const what )
+{
+    for( int i( 0 ); i < 8; i++ )
+    {
+        if( freed[ i ] != counts[ i ] )
+        {
+            std::cerr << what << ": item " << i << " freed " << freed[ i ]
+                << " times, expected " << counts[ i ] << "\n";
+            return( false );
+        }
+    }
+    return( true );
+}
+
+int
+main()
+{
+    Buffer::Reclaimer r;
+    /** peek 0..3, forward 1 and 3, recycle all of them **/
+    for( int i( 0 ); i < 4; i++ )
+    {
+        r.peeked( &items[ i ] );
+    }
+    if( ! r.was_peeked( &items[ 2 ] ) || r.was_peeked( &items[ 5 ] ) )
+    {
+        std::cerr << "peek tracking wrong\n";
+        return( EXIT_FAILURE );
+    }
+    r.forwarded( &items[ 3 ] );
+    r.forwarded( &items[ 1 ] );
+    for( int i( 0 ); i < 4; i++ )
+    {
+        r.retire( &items[ i ], reclaim );
+    }
+    const int none[ 8 ] = { 0 };
+    if( ! expect( none, "before epoch end" ) )
+    {
+        return( EXIT_FAILURE );
+    }
+    r.end_epoch();
+    const int first[ 8 ] = { 1, 0, 1, 0, 0, 0, 0, 0 };
+    if( ! expect( first, "first epoch" ) || r.was_peeked( &items[ 0 ] ) )
+    {
+        return( EXIT_FAILURE );
+    }
+    /** forward of 4 happened last epoch, doesn't protect it now **/
+    r.forwarded( &items[ 4 ] );
+    r.end_epoch();
+    r.retire( &items[ 4 ], reclaim );
+    r.retire( &items[ 5 ], reclaim );
+    r.end_epoch();
+    const int second[ 8 ] = { 1, 0, 1, 0, 1, 1, 0, 0 };
+    if( ! expect( second, "later epochs" ) || r.epoch() != 3 )
+    {
+        return( EXIT_FAILURE );
+    }
+    return( EXIT_SUCCESS );
+}
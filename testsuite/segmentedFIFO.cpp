@@ -0,0 +1,123 @@
+/**
+ * segmentedFIFO.cpp - drive a segmented FIFO directly, first
+ * growing it while a peek_range straddles the old and new
+ * segment, then with a producer, consumer and a thread growing
+ * it underneath them. Every item has to come out once, in order.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <raft>
+#include "testutil.tcc"
+
+using fifo_t = RingBuffer< std::string, Type::Segmented, false >;
+
+using raft::test::fail;
+
+static void straddle()
+{
+    volatile bool exit_alloc( false );
+    auto *fifo( fifo_t::make_new_fifo( 4, 16, nullptr ) );
+    const auto cap( fifo->capacity() );
+    for( int i( 0 ); i < 3; i++ )
+    {
+        fifo->push( std::to_string( i ) );
+    }
+    fifo->resize( cap * 2, 16, exit_alloc );
+    /** picked up on the next push, not before **/
+    if( fifo->capacity() != cap )
+    {
+        fail( "segment linked before the producer came back" );
+    }
+    for( int i( 3 ); i < 6; i++ )
+    {
+        fifo->push( std::to_string( i ) );
+    }
+    if( fifo->capacity() != cap * 2 || fifo->size() != 6 )
+    {
+        fail( "segment not linked" );
+    }
+    {
+        auto range( fifo->peek_range< std::string >( 5 ) );
+        for( int i( 0 ); i < 5; i++ )
+        {
+            if( range[ i ].ele != std::to_string( i ) )
+            {
+                fail( "peek_range across segments returned " + range[ i ].ele );
+            }
+        }
+    }
+    fifo->recycle( 5 );
+    std::string val;
+    fifo->pop( val );
+    if( val != "5" || fifo->size() != 0 )
+    {
+        fail( "bad tail item " + val );
+    }
+    delete( fifo );
+}
+
+static void threaded()
+{
+    const std::int64_t count( 200000 );
+    volatile bool exit_alloc( false );
+    auto *fifo( fifo_t::make_new_fifo( 2, 16, nullptr ) );
+    std::atomic< bool > done( false );
+    std::thread producer( [&]()
+    {
+        for( std::int64_t i( 0 ); i < count; i++ )
+        {
+            fifo->push( std::to_string( i ) );
+        }
+    } );
+    std::thread grower( [&]()
+    {
+        while( ! done && fifo->capacity() < ( 1 << 16 ) )
+        {
+            fifo->resize( fifo->capacity() * 2, 16, exit_alloc );
+            std::this_thread::sleep_for( std::chrono::microseconds( 500 ) );
+        }
+    } );
+    std::string val;
+    for( std::int64_t i( 0 ); i < count; i++ )
+    {
+        fifo->pop( val );
+        if( val != std::to_string( i ) )
+        {
+            fail( "expected " + std::to_string( i ) + ", got " + val );
+        }
+    }
+    done = true;
+    producer.join();
+    grower.join();
+    delete( fifo );
+}
+
+int
+main()
+{
+    straddle();
+    threaded();
+    return( EXIT_SUCCESS );
+}
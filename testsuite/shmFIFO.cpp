@@ -0,0 +1,100 @@
+/**
+ * shmFIFO.cpp - one graph split across two processes with
+ * raft::shm_out/raft::shm_in. The child runs the source half, the
+ * parent the sink half, every item and user signal has to arrive
+ * in order. Then the producer process is killed mid-stream, the
+ * consumer's graph must see the edge close and finish.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <raft>
+#include "signalpattern.tcc"
+
+using type_t = raft::test::signal_t;
+using raft::test::signal_sink;
+static const type_t count = 100000;
+
+static void produce( const std::string &key, const type_t last )
+{
+    raft::test::signal_source s( last );
+    raft::shm_out< type_t > out( key );
+    raft::map m;
+    m.link( &s, "0", &out, "0", 1024 );
+    m.exe();
+}
+
+static pid_t spawn_producer( const std::string &key, const type_t last )
+{
+    return( raft::test::spawn_producer( [ & ]()
+    {
+        produce( key, last );
+    } ) );
+}
+
+int
+main()
+{
+    const auto base( "shmFIFO_" + std::to_string( getpid() ) );
+    /** whole stream across the process boundary **/
+    {
+        const auto key( base + "_all" );
+        const auto pid( spawn_producer( key, count ) );
+        raft::shm_in< type_t > in( key );
+        signal_sink k;
+        raft::map m;
+        m.link( &in, "0", &k, "0" );
+        m.exe();
+        int status( 0 );
+        waitpid( pid, &status, 0 );
+        if( ! WIFEXITED( status ) || WEXITSTATUS( status ) != EXIT_SUCCESS )
+        {
+            std::cerr << "producer process failed\n";
+            return( EXIT_FAILURE );
+        }
+        if( k.next != count )
+        {
+            std::cerr << "sink got " << k.next << " of " << count << " items\n";
+            return( EXIT_FAILURE );
+        }
+    }
+    /** producer dies mid-stream, consumer has to finish anyway **/
+    {
+        const auto key( base + "_kill" );
+        const auto pid( spawn_producer( key, -1 ) );
+        raft::shm_in< type_t > in( key );
+        signal_sink k( pid );
+        raft::map m;
+        m.link( &in, "0", &k, "0" );
+        m.exe();
+        int status( 0 );
+        waitpid( pid, &status, 0 );
+        if( ! WIFSIGNALED( status ) || k.next < signal_sink::kill_at )
+        {
+            std::cerr << "producer wasn't killed mid-stream\n";
+            return( EXIT_FAILURE );
+        }
+    }
+    return( EXIT_SUCCESS );
+}
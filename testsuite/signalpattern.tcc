@@ -0,0 +1,134 @@
+/**
+ * signalpattern.tcc - a stream of counting integers with a user
+ * signal on every stride'th item, a source that sends it and a sink
+ * that checks each item and its signal arrive in order. Shared by the
+ * tests that carry signals across a FIFO implementation or a process
+ * boundary.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef SIGNALPATTERN_TCC
+#define SIGNALPATTERN_TCC  1
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sys/types.h>
+#include <unistd.h>
+#include <raft>
+
+namespace raft
+{
+
+namespace test
+{
+
+using signal_t = std::int64_t;
+
+static const signal_t stride = 97;
+static const auto     user_signal(
+    static_cast< raft::signal >( raft::MAX_SYSTEM_SIGNAL + 1 ) );
+
+static inline raft::signal expected_signal( const signal_t val )
+{
+    return( val % stride == 0 ? user_signal : raft::none );
+}
+
+/** counts up from zero, last < 0 means run till killed **/
+class signal_source : public raft::kernel
+{
+public:
+    signal_source( const signal_t last ) : raft::kernel(), last( last )
+    {
+        output.addPort< signal_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr, expected_signal( curr ) );
+        if( ++curr == last )
+        {
+            return( raft::stop );
+        }
+        return( raft::proceed );
+    }
+
+private:
+    signal_t       curr = 0;
+    const signal_t last;
+};
+
+/** kills victim (if set) once it has seen kill_at items **/
+class signal_sink : public raft::kernel
+{
+public:
+    static constexpr signal_t kill_at = 10000;
+
+    signal_sink( const pid_t victim = 0 ) : raft::kernel(), victim( victim )
+    {
+        input.addPort< signal_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        signal_t val( 0 );
+        raft::signal sig( raft::none );
+        input[ "0" ].pop( val, &sig );
+        if( val != next || sig != expected_signal( val ) )
+        {
+            std::cerr << "sink: got " << val << " (signal " << sig
+                << "), expected " << next << "\n";
+            exit( EXIT_FAILURE );
+        }
+        if( ++next == kill_at && victim != 0 )
+        {
+            kill( victim, SIGKILL );
+        }
+        return( raft::proceed );
+    }
+
+    signal_t next = 0;
+
+private:
+    const pid_t victim;
+};
+
+/**
+ * spawn_producer - fork, run produce() in the child and exit,
+ * returns the child's pid
+ */
+template < class F > static pid_t spawn_producer( F &&produce )
+{
+    const auto pid( fork() );
+    if( pid < 0 )
+    {
+        std::cerr << "fork failed\n";
+        exit( EXIT_FAILURE );
+    }
+    if( pid == 0 )
+    {
+        produce();
+        _exit( EXIT_SUCCESS );
+    }
+    return( pid );
+}
+
+} //end namespace test
+
+} //end namespace raft
+#endif /* END SIGNALPATTERN_TCC */
@@ -0,0 +1,229 @@
+/**
+ * slabPool.cpp - 4 KiB records through a chain that allocates them
+ * in place, forwards them zero copy from a peek and pops them at the
+ * end, every record has to arrive intact and every one constructed
+ * has to be destroyed. Then the pool itself: slots returned from two
+ * other threads while one keeps taking, once the working set is
+ * covered no more slabs may be allocated.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <raft>
+#include "slabpool.tcc"
+
+static std::atomic< std::int64_t > live = { 0 };
+
+struct record
+{
+    record( const std::uint64_t v = 0 )
+    {
+        for( auto &w : words )
+        {
+            w = v;
+        }
+        live++;
+    }
+
+    record( const record &other )
+    {
+        for( std::size_t i( 0 ); i < n_words; i++ )
+        {
+            words[ i ] = other.words[ i ];
+        }
+        live++;
+    }
+
+    record& operator = ( const record &other ) = default;
+
+    ~record()
+    {
+        live--;
+    }
+
+    bool holds( const std::uint64_t v ) const
+    {
+        for( const auto w : words )
+        {
+            if( w != v )
+            {
+                return( false );
+            }
+        }
+        return( true );
+    }
+
+    static constexpr std::size_t n_words = 4096 / sizeof( std::uint64_t );
+    std::uint64_t words[ n_words ];
+};
+
+static const std::uint64_t count = 20000;
+
+class start : public raft::kernel
+{
+public:
+    start() : raft::kernel()
+    {
+        output.addPort< record >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].allocate< record >( curr );
+        output[ "0" ].send();
+        if( ++curr == count )
+        {
+            return( raft::stop );
+        }
+        return( raft::proceed );
+    }
+
+private:
+    std::uint64_t curr = 0;
+};
+
+/** forwards the peeked record, the runtime must not free it here **/
+class middle : public raft::kernel
+{
+public:
+    middle() : raft::kernel()
+    {
+        input.addPort< record >( "0" );
+        output.addPort< record >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        auto &r( input[ "0" ].peek< record >() );
+        output[ "0" ].push( r );
+        input[ "0" ].unpeek();
+        input[ "0" ].recycle( 1 );
+        return( raft::proceed );
+    }
+};
+
+class last : public raft::kernel
+{
+public:
+    last() : raft::kernel()
+    {
+        input.addPort< record >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        record r;
+        input[ "0" ].pop( r );
+        if( ! r.holds( next ) )
+        {
+            std::cerr << "record " << next << " corrupted\n";
+            exit( EXIT_FAILURE );
+        }
+        next++;
+        return( raft::proceed );
+    }
+
+    std::uint64_t next = 0;
+};
+
+static bool pool_reuses()
+{
+    using pool_t = Buffer::SlabPool< record >;
+    pool_t pool;
+    constexpr std::size_t in_flight = 100;
+    constexpr std::size_t rounds    = 2000;
+    std::atomic< std::size_t > head = { 0 };
+    std::vector< std::atomic< record* > > ring( in_flight * 2 );
+    for( auto &r : ring )
+    {
+        r.store( nullptr );
+    }
+    /** two returners, each frees every other slot of the ring **/
+    auto returner = [ & ]( const std::size_t parity )
+    {
+        for( std::size_t i( parity ); i < in_flight * rounds; i += 2 )
+        {
+            record *r( nullptr );
+            auto &slot( ring[ i % ring.size() ] );
+            while( ( r = slot.exchange( nullptr ) ) == nullptr )
+            {
+                std::this_thread::yield();
+            }
+            pool_t::destroy( r );
+            head++;
+        }
+    };
+    std::thread even( returner, 0 );
+    std::thread odd( returner, 1 );
+    std::size_t after_warmup( 0 );
+    for( std::size_t i( 0 ); i < in_flight * rounds; i++ )
+    {
+        /** at most in_flight outstanding **/
+        while( i - head.load() >= in_flight )
+        {
+            std::this_thread::yield();
+        }
+        ring[ i % ring.size() ].store( new ( pool.get() ) record( i ) );
+        if( i == in_flight * 10 )
+        {
+            after_warmup = pool.slab_count();
+        }
+    }
+    even.join();
+    odd.join();
+    if( pool.slab_count() != after_warmup )
+    {
+        std::cerr << "pool kept growing, " << after_warmup << " slabs after "
+            << "warmup, " << pool.slab_count() << " at the end\n";
+        return( false );
+    }
+    return( true );
+}
+
+int
+main()
+{
+    {
+        start s;
+        middle m;
+        last l;
+        raft::map M;
+        M += s >> m >> l;
+        M.exe();
+        if( l.next != count )
+        {
+            std::cerr << "got " << l.next << " of " << count << " records\n";
+            return( EXIT_FAILURE );
+        }
+    }
+    if( live.load() != 0 )
+    {
+        std::cerr << live.load() << " records never destroyed\n";
+        return( EXIT_FAILURE );
+    }
+    if( ! pool_reuses() )
+    {
+        return( EXIT_FAILURE );
+    }
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,140 @@
+/**
+ * socketFIFO.cpp - graphs split across two processes with
+ * raft::socket_out/raft::socket_in. The child runs the source half,
+ * the parent the sink half: two edges multiplexed over one AF_UNIX
+ * connection, one edge over loopback TCP, every item and user signal
+ * has to arrive in order on its own edge. Then the sending process
+ * is killed mid-stream, the receiver's graph must see the edge close
+ * and finish.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <raft>
+#include "signalpattern.tcc"
+
+using type_t = raft::test::signal_t;
+using raft::test::signal_source;
+using raft::test::signal_sink;
+static const type_t count = 100000;
+
+/** one source per channel, all on address **/
+static void produce( const std::string &address,
+                     const std::uint32_t channels,
+                     const type_t last )
+{
+    std::vector< std::unique_ptr< signal_source > >             src;
+    std::vector< std::unique_ptr< raft::socket_out< type_t > > > out;
+    raft::map m;
+    for( std::uint32_t c( 0 ); c < channels; c++ )
+    {
+        src.emplace_back( new signal_source( last ) );
+        out.emplace_back( new raft::socket_out< type_t >( address, c ) );
+        m.link( src.back().get(), "0", out.back().get(), "0", 1024 );
+    }
+    m.exe();
+}
+
+static pid_t spawn_producer( const std::string &address,
+                             const std::uint32_t channels,
+                             const type_t last )
+{
+    return( raft::test::spawn_producer( [ & ]()
+    {
+        produce( address, channels, last );
+    } ) );
+}
+
+/** receive channels edges from address, false on any mismatch **/
+static bool consume( const std::string &address, const std::uint32_t channels )
+{
+    const auto pid( spawn_producer( address, channels, count ) );
+    std::vector< std::unique_ptr< raft::socket_in< type_t > > > in;
+    std::vector< std::unique_ptr< signal_sink > >               snk;
+    {
+        raft::map m;
+        for( std::uint32_t c( 0 ); c < channels; c++ )
+        {
+            in.emplace_back( new raft::socket_in< type_t >( address, c ) );
+            snk.emplace_back( new signal_sink() );
+            m.link( in.back().get(), "0", snk.back().get(), "0" );
+        }
+        m.exe();
+    }
+    int status( 0 );
+    waitpid( pid, &status, 0 );
+    if( ! WIFEXITED( status ) || WEXITSTATUS( status ) != EXIT_SUCCESS )
+    {
+        std::cerr << address << ": producer process failed\n";
+        return( false );
+    }
+    for( const auto &k : snk )
+    {
+        if( k->next != count )
+        {
+            std::cerr << address << ": sink got " << k->next << " of "
+                << count << " items\n";
+            return( false );
+        }
+    }
+    return( true );
+}
+
+int
+main()
+{
+    const auto base( "/tmp/socketFIFO_" + std::to_string( getpid() ) );
+    /** two edges sharing one connection **/
+    if( ! consume( "unix:" + base + "_all", 2 ) )
+    {
+        return( EXIT_FAILURE );
+    }
+    /** loopback TCP, port picked from the pid to keep parallel runs apart **/
+    if( ! consume( "tcp:127.0.0.1:" + std::to_string( 20000 + getpid() % 20000 ), 1 ) )
+    {
+        return( EXIT_FAILURE );
+    }
+    /** sender dies mid-stream, receiver has to finish anyway **/
+    {
+        const auto address( "unix:" + base + "_kill" );
+        const auto pid( spawn_producer( address, 1, -1 ) );
+        raft::socket_in< type_t > in( address );
+        signal_sink k( pid );
+        {
+            raft::map m;
+            m.link( &in, "0", &k, "0" );
+            m.exe();
+        }
+        int status( 0 );
+        waitpid( pid, &status, 0 );
+        if( ! WIFSIGNALED( status ) || k.next < signal_sink::kill_at )
+        {
+            std::cerr << "producer wasn't killed mid-stream\n";
+            return( EXIT_FAILURE );
+        }
+    }
+    return( EXIT_SUCCESS );
+}
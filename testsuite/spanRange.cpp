@@ -0,0 +1,254 @@
+/**
+ * spanRange.cpp - move a sequence through allocate_span /
+ * allocate_contiguous and peek_span / peek_contiguous with
+ * widths that don't divide the buffer size, so ranges regularly
+ * straddle the wrap point, on each of the FIFO types that
+ * support spans. The signal given to send_range has to come out
+ * with the first item of the range whatever the FIFO type.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include <raft>
+#include <raftmanip>
+
+using type_t = std::int64_t;
+static const type_t count = 100003;
+static const auto   user_signal(
+    static_cast< raft::signal >( raft::MAX_SYSTEM_SIGNAL + 1 ) );
+
+/** FIFO is a protected base of the queue itself **/
+template < Type::RingBufferType type >
+class queue : public RingBuffer< type_t, type >
+{
+public:
+    queue( const std::size_t n ) : RingBuffer< type_t, type >( n, 16 )
+    {
+    }
+
+    FIFO& fifo()
+    {
+        return( *this );
+    }
+};
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        auto &port( output[ "0" ] );
+        const auto n( std::min( static_cast< type_t >( width ), count - curr ) );
+        if( contiguous )
+        {
+            auto s( port.allocate_contiguous< type_t >( n ) );
+            for( auto &ele : s )
+            {
+                ele = curr++;
+            }
+        }
+        else
+        {
+            auto s( port.allocate_span< type_t >( n ) );
+            if( s.size() != static_cast< std::size_t >( n ) )
+            {
+                std::cerr << "allocate_span returned " << s.size() << "\n";
+                exit( EXIT_FAILURE );
+            }
+            for( auto &ele : s.first )
+            {
+                ele = curr++;
+            }
+            for( auto &ele : s.second )
+            {
+                ele = curr++;
+            }
+        }
+        port.send_range();
+        contiguous = ! contiguous;
+        return( curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    static constexpr std::size_t width = 7;
+    type_t curr       = 0;
+    bool   contiguous = false;
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        auto &port( input[ "0" ] );
+        const auto n( std::min( static_cast< type_t >( width ), count - seen ) );
+        std::size_t consumed( 0 );
+        if( contiguous )
+        {
+            const auto s( port.peek_contiguous< type_t >( n ) );
+            if( s.empty() )
+            {
+                std::cerr << "peek_contiguous returned no items\n";
+                exit( EXIT_FAILURE );
+            }
+            for( const auto ele : s )
+            {
+                check( ele );
+            }
+            consumed = s.size();
+        }
+        else
+        {
+            const auto s( port.peek_span< type_t >( n ) );
+            for( std::size_t i( 0 ); i < s.size(); i++ )
+            {
+                check( s[ i ] );
+            }
+            consumed = s.size();
+        }
+        port.unpeek();
+        port.recycle( consumed );
+        contiguous = ! contiguous;
+        return( seen == count ? raft::stop : raft::proceed );
+    }
+
+    type_t seen = 0;
+
+private:
+    void check( const type_t val )
+    {
+        if( val != seen )
+        {
+            std::cerr << "expected " << seen << ", got " << val << "\n";
+            exit( EXIT_FAILURE );
+        }
+        seen++;
+    }
+
+    static constexpr std::size_t width = 5;
+    bool contiguous = false;
+};
+
+template < Type::RingBufferType type > static void run()
+{
+    source s;
+    sink   k;
+    raft::manip< raft::fifo::type< type > >::bind( s );
+    raft::map m;
+    m += s >> k;
+    m.exe();
+    if( k.seen != count )
+    {
+        std::cerr << Type::type_prints[ type ] << ": missing "
+            << ( count - k.seen ) << " items\n";
+        exit( EXIT_FAILURE );
+    }
+}
+
+/** 
+ * range_signal - ranges sent on in, each with a signal, have to
+ * come out of out with the signal on their first item
+ */
+static void range_signal( const Type::RingBufferType type, 
+                          FIFO &in, 
+                          FIFO &out )
+{
+    const std::size_t width( 5 ), ranges( 3 );
+    type_t curr( 0 );
+    for( std::size_t r( 0 ); r < ranges; r++ )
+    {
+        auto s( in.allocate_span< type_t >( width ) );
+        for( auto &ele : s.first )
+        {
+            ele = curr++;
+        }
+        for( auto &ele : s.second )
+        {
+            ele = curr++;
+        }
+        in.send_range( user_signal );
+    }
+    for( type_t i( 0 ); i < curr; i++ )
+    {
+        type_t val( 0 );
+        raft::signal sig( raft::none );
+        out.pop( val, &sig );
+        const auto expected( i % width == 0 ? user_signal : raft::none );
+        if( val != i || sig != expected )
+        {
+            std::cerr << Type::type_prints[ type ] << ": item " << val 
+                << " has signal " << sig << ", expected " << expected << "\n";
+            exit( EXIT_FAILURE );
+        }
+    }
+}
+
+template < Type::RingBufferType type > static void range_signal()
+{
+    queue< type > buffer( 64 );
+    range_signal( type, buffer.fifo(), buffer.fifo() );
+}
+
+/** both ends of the segment in this process **/
+class shm_end : public RingBuffer< type_t, Type::SharedMemory >
+{
+public:
+    shm_end( const std::string &key, const Direction dir ) :
+        RingBuffer< type_t, Type::SharedMemory >( 64, key, dir )
+    {
+    }
+
+    FIFO& fifo()
+    {
+        return( *this );
+    }
+};
+
+int
+main()
+{
+    range_signal< Type::Heap >();
+    range_signal< Type::LockFreeSPSC >();
+    range_signal< Type::Segmented >();
+    range_signal< Type::MPMC >();
+    {
+        const auto key( "spanRange_" + std::to_string( getpid() ) );
+        shm_end producer( key, Direction::Producer );
+        shm_end consumer( key, Direction::Consumer );
+        range_signal( Type::SharedMemory, producer.fifo(), consumer.fifo() );
+    }
+    run< Type::Heap >();
+    run< Type::LockFreeSPSC >();
+    run< Type::Segmented >();
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,118 @@
+/**
+ * sparseSignal.cpp - tag every few items with a user signal and
+ * make sure each one comes out attached to the right item, via
+ * pop, peek and peek_range, across both heap and lock-free SPSC
+ * FIFOs (signals are carried out of band, not per slot).
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <raft>
+#include <raftmanip>
+#include "signalpattern.tcc"
+
+using type_t = raft::test::signal_t;
+using raft::test::expected_signal;
+/** multiple of the peek_range width below **/
+static const type_t count = 40000;
+
+/** peek first, then pop, both must see the signal **/
+class relay : public raft::kernel
+{
+public:
+    relay() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        auto &port( input[ "0" ] );
+        raft::signal peeked( raft::none );
+        const auto val( port.peek< type_t >( &peeked ) );
+        port.unpeek();
+        raft::signal popped( raft::none );
+        type_t out( 0 );
+        port.pop( out, &popped );
+        if( val != out || peeked != popped ||
+            popped != expected_signal( out ) )
+        {
+            std::cerr << "relay: bad signal (" << popped << ") on item "
+                << out << "\n";
+            exit( EXIT_FAILURE );
+        }
+        output[ "0" ].push( out, popped );
+        return( raft::proceed );
+    }
+};
+
+class check : public raft::kernel
+{
+public:
+    check() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        auto &port( input[ "0" ] );
+        auto range( port.peek_range< type_t >( width ) );
+        for( std::size_t i( 0 ); i < width; i++ )
+        {
+            const auto val( range[ i ].ele );
+            if( val != seen ||
+                range[ i ].sig != expected_signal( val ) )
+            {
+                std::cerr << "check: bad item/signal at " << val << "\n";
+                exit( EXIT_FAILURE );
+            }
+            seen++;
+        }
+        port.recycle( width );
+        return( raft::proceed );
+    }
+
+    type_t seen = 0;
+
+private:
+    static constexpr std::size_t width = 4;
+};
+
+int
+main()
+{
+    raft::test::signal_source s( count );
+    relay r;
+    check c;
+    raft::manip< raft::fifo::type< Type::LockFreeSPSC > >::bind( r );
+
+    raft::map m;
+    m += s >> r >> c;
+    m.exe();
+
+    if( c.seen != count )
+    {
+        std::cerr << "missing " << ( count - c.seen ) << " items\n";
+        return( EXIT_FAILURE );
+    }
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,260 @@
+/**
+ * spillFIFO.cpp - Type::Infinite FIFO, the producer never waits on a
+ * consumer that isn't reading, past the RAM budget segments go to the
+ * spill file, and everything comes back out in order. Once it has
+ * been drained the producer is back in memory. On a full disk the
+ * producer waits instead.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <sys/resource.h>
+#include <raft>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 200000;
+/** 200000 items are 1.6 MB, a quarter of that stays in memory **/
+static const std::size_t budget = ( 1 << 18 );
+
+static std::atomic< bool > produced = { false };
+
+using raft::test::fail;
+
+/** FIFO is a protected base of the queue itself **/
+class queue : public RingBuffer< type_t, Type::Infinite >
+{
+public:
+    queue( const Buffer::SpillConfig &config ) :
+        RingBuffer< type_t, Type::Infinite >( 64, 16, config )
+    {
+    }
+
+    FIFO& fifo()
+    {
+        return( *this );
+    }
+};
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        if( ++curr == count )
+        {
+            produced = true;
+            return( raft::stop );
+        }
+        return( raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+/** doesn't read anything until the source is done **/
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        if( seen == 0 )
+        {
+            while( ! produced )
+            {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            }
+            input[ "0" ].get_spill_stats( stats );
+        }
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        if( v != seen++ )
+        {
+            fail( "out of order" );
+        }
+        return( raft::proceed );
+    }
+
+    type_t              seen = 0;
+    Buffer::SpillStats  stats;
+};
+
+/**
+ * disk_full - the spill file can't grow past a quarter of what the
+ * producer pushes, it has to wait for the consumer rather than die
+ * storing into pages the disk has no room for.
+ */
+static void
+disk_full()
+{
+    const std::size_t file_limit( budget );
+    std::signal( SIGXFSZ, SIG_IGN );
+    struct rlimit limit;
+    getrlimit( RLIMIT_FSIZE, &limit );
+    limit.rlim_cur = file_limit;
+    if( setrlimit( RLIMIT_FSIZE, &limit ) != 0 )
+    {
+        fail( "can't limit the file size" );
+    }
+    Buffer::SpillConfig config;
+    config.ram_budget = budget / 4;
+    queue buffer( config );
+    auto &fifo( buffer.fifo() );
+    std::thread producer( [ &fifo ]()
+    {
+        for( type_t i( 0 ); i < count; i++ )
+        {
+            fifo.push( i );
+        }
+    } );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 100 ) );
+    for( type_t i( 0 ); i < count; i++ )
+    {
+        if( ( i & 1023 ) == 0 )
+        {
+            Buffer::SpillStats stats;
+            fifo.get_spill_stats( stats );
+            if( stats.file_bytes > file_limit )
+            {
+                fail( "spill file past the limit" );
+            }
+        }
+        type_t v( 0 );
+        fifo.pop( v );
+        if( v != i )
+        {
+            fail( "lost items on a full disk" );
+        }
+    }
+    producer.join();
+}
+
+int
+main()
+{
+    {
+        Buffer::SpillConfig config;
+        config.ram_budget = budget;
+        queue buffer( config );
+        auto &fifo( buffer.fifo() );
+        for( type_t i( 0 ); i < count; i++ )
+        {
+            fifo.push( i );
+        }
+        if( fifo.size() != static_cast< std::size_t >( count ) )
+        {
+            fail( "items missing before the consumer started" );
+        }
+        Buffer::SpillStats stats;
+        fifo.get_spill_stats( stats );
+        if( stats.spill_segments == 0 || stats.spilled_bytes == 0 ||
+            stats.file_bytes == 0 )
+        {
+            fail( "nothing spilled" );
+        }
+        if( stats.ram_bytes > budget )
+        {
+            fail( "over the RAM budget" );
+        }
+        for( type_t i( 0 ); i < count; i++ )
+        {
+            type_t v( 0 );
+            fifo.pop( v );
+            if( v != i )
+            {
+                fail( "lost items in the spill file" );
+            }
+        }
+        fifo.get_spill_stats( stats );
+        if( stats.file_bytes > 0 && fifo.capacity() * sizeof( type_t ) < stats.file_bytes )
+        {
+            fail( "drained segments not released" );
+        }
+        if( fifo.capacity() * sizeof( type_t ) > budget / 4 )
+        {
+            fail( "segments kept growing past the limit" );
+        }
+        /**
+         * a consumer that keeps up, the producer leaves the file once
+         * the budget has room again, ranges straddle the links
+         */
+        const auto spilled( stats.spill_segments );
+        const type_t chunk( 1000 );
+        type_t next( 0 );
+        for( type_t round( 0 ); round < 40; round++ )
+        {
+            for( type_t i( 0 ); i < chunk; i++ )
+            {
+                fifo.push( next + i );
+            }
+            auto range( fifo.peek_range< type_t >( chunk ) );
+            for( type_t i( 0 ); i < chunk; i++ )
+            {
+                if( range[ i ].ele != next + i )
+                {
+                    fail( "range across segments out of order" );
+                }
+            }
+            fifo.recycle( chunk );
+            next += chunk;
+        }
+        fifo.get_spill_stats( stats );
+        if( stats.spill_segments != spilled || stats.file_bytes != 0 )
+        {
+            fail( "producer stayed in the spill file" );
+        }
+    }
+
+    source s;
+    sink   k;
+    /** waits for the source outside the FIFO, needs its own thread **/
+    k.setFusion( false );
+    raft::map m;
+    m.setSpillBudget( budget );
+    m.link( &s, "0", &k, "0", 64, Type::Infinite );
+    m.exe();
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+    if( k.stats.spill_segments == 0 || k.stats.spilled_bytes == 0 )
+    {
+        fail( "map edge didn't spill" );
+    }
+    disk_full();
+    return( EXIT_SUCCESS );
+}
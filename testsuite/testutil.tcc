@@ -0,0 +1,43 @@
+/**
+ * testutil.tcc - small helpers shared by the test programs.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef TESTUTIL_TCC
+#define TESTUTIL_TCC  1
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+namespace raft
+{
+
+namespace test
+{
+
+/** fail - report what went wrong and end the test **/
+[[noreturn]] static inline void fail( const std::string &what )
+{
+    std::cerr << what << "\n";
+    exit( EXIT_FAILURE );
+}
+
+} //end namespace test
+
+} //end namespace raft
+#endif /* END TESTUTIL_TCC */
@@ -0,0 +1,165 @@
+/**
+ * threadReuse.cpp - jobs on the thread cache signal completion through
+ * a latch and the threads of one wave are reused by the next, and the
+ * same holds for back to back maps, whose threads are reused by the
+ * next run instead of started again.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <raft>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 100;
+static const int    runs  = 200;
+
+using raft::test::fail;
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        if( v != seen++ )
+        {
+            fail( "out of order" );
+        }
+        return( raft::proceed );
+    }
+
+    type_t seen = 0;
+};
+
+static void tiny()
+{
+    source s;
+    sink   k;
+    raft::map m;
+    m += s >> k;
+    m.exe();
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+}
+
+/**
+ * jobs on the cache only count as done through the latch, wait()
+ * can't return before every one of them has, and once they are
+ * back in the cache the next wave starts no threads
+ */
+static void waves()
+{
+    const std::size_t n( 4 );
+    std::atomic< bool >        go( false );
+    std::atomic< std::size_t > finished( 0 );
+    auto wave( [ & ]()
+    {
+        raft::latch done( n );
+        for( std::size_t i( 0 ); i < n; i++ )
+        {
+            raft::thread_cache::run( [ & ]()
+            {
+                while( ! go )
+                {
+                    std::this_thread::yield();
+                }
+                finished++;
+                done.count_down();
+            } );
+        }
+        go = true;
+        done.wait();
+        if( finished != n )
+        {
+            fail( "latch released with " + std::to_string( finished ) +
+                  " of " + std::to_string( n ) + " jobs done" );
+        }
+        go       = false;
+        finished = 0;
+    } );
+    wave();
+    /** a thread goes back to the cache just after its count_down **/
+    const auto give_up( std::chrono::steady_clock::now() +
+                        std::chrono::seconds( 10 ) );
+    while( raft::thread_cache::idle() < n )
+    {
+        if( std::chrono::steady_clock::now() > give_up )
+        {
+            fail( "threads never went back to the cache" );
+        }
+        std::this_thread::yield();
+    }
+    const auto before( raft::thread_cache::created() );
+    wave();
+    if( raft::thread_cache::created() != before )
+    {
+        fail( "second wave started new threads" );
+    }
+}
+
+int
+main()
+{
+    waves();
+    tiny();
+    const auto warm( raft::thread_cache::created() );
+    for( int i( 0 ); i < runs; i++ )
+    {
+        tiny();
+    }
+    /** a thread can be a moment late getting back to the cache **/
+    const auto extra( raft::thread_cache::created() - warm );
+    if( extra > static_cast< std::uint64_t >( runs / 10 ) )
+    {
+        fail( std::to_string( extra ) + " threads started after the first run" );
+    }
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,193 @@
+/**
+ * waitPolicy.cpp - bursty producer, so the consumer regularly
+ * sits on an empty queue, run with each wait policy on each
+ * FIFO type that supports it. Checks the data, that the policy
+ * set through the manipulator or the map ends up on the FIFO
+ * and that the stats show the blocked side yielding/parking.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <raft>
+#include <raftmanip>
+
+using type_t = std::int64_t;
+/** 
+ * the sink reads width items at a time, bursts aren't a multiple
+ * of it so the sink blocks inside the FIFO (rather than in the
+ * scheduler) waiting for the next burst
+ */
+static const type_t      width = 7;
+static const type_t      count = width * 3000;
+static const type_t      burst = 2000;
+
+class source : public raft::kernel
+{
+public:
+    source( const Wait::Policy policy ) : raft::kernel(), policy( policy )
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        if( curr % burst == 0 )
+        {
+            pause();
+        }
+        output[ "0" ].push( curr );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    /**
+     * between bursts the sink waits inside the FIFO for the rest
+     * of its range. Spinning doesn't show in the stats so just
+     * sleep, otherwise hold the next burst until the consumer has
+     * yielded or parked (bounded, the checks below catch a policy
+     * that never does), a busy machine might not get to it during
+     * a fixed sleep.
+     */
+    void pause()
+    {
+        if( curr == 0 )
+        {
+            give_up = std::chrono::steady_clock::now() +
+                      std::chrono::seconds( 10 );
+        }
+        if( policy == Wait::Spin || curr == 0 )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+            return;
+        }
+        Wait::Stats stats;
+        do
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+            output[ "0" ].get_wait_stats( stats );
+        }
+        while( ( policy == Wait::Park ? stats.consumer_parks :
+                                        stats.consumer_yields ) == 0 &&
+               std::chrono::steady_clock::now() < give_up );
+    }
+
+    type_t             curr = 0;
+    const Wait::Policy policy;
+    std::chrono::steady_clock::time_point give_up;
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        auto &port( input[ "0" ] );
+        auto range( port.peek_range< type_t >( width ) );
+        for( type_t i( 0 ); i < width; i++ )
+        {
+            if( range[ i ].ele != seen + i )
+            {
+                std::cerr << "expected " << ( seen + i ) << ", got " 
+                    << range[ i ].ele << "\n";
+                exit( EXIT_FAILURE );
+            }
+        }
+        port.recycle( width );
+        seen += width;
+        if( seen == count )
+        {
+            port.get_wait_stats( stats );
+            return( raft::stop );
+        }
+        return( raft::proceed );
+    }
+
+    type_t      seen = 0;
+    Wait::Stats stats;
+};
+
+template < Type::RingBufferType type, Wait::Policy policy, bool map_wide >
+static void run()
+{
+    source s( policy );
+    sink   k;
+    raft::manip< raft::fifo::type< type > >::bind( s );
+    raft::map m;
+    /** the policies are about two threads meeting at the FIFO **/
+    m.setFusion( false );
+    if( map_wide )
+    {
+        m.setWaitPolicy( policy );
+    }
+    else
+    {
+        raft::manip< raft::fifo::wait< policy > >::bind( s );
+    }
+    m += s >> k;
+    m.exe();
+    const auto fail( [&]( const char * const what )
+    {
+        std::cerr << Type::type_prints[ type ] << "/" 
+            << Wait::policy_prints[ policy ] << ": " << what << "\n";
+        exit( EXIT_FAILURE );
+    } );
+    if( k.seen != count )
+    {
+        fail( "missing items" );
+    }
+    if( k.stats.policy != policy )
+    {
+        fail( "policy not applied to the FIFO" );
+    }
+    if( policy == Wait::Spin && 
+        ( k.stats.consumer_yields != 0 || k.stats.consumer_parks != 0 ) )
+    {
+        fail( "spin policy yielded or parked" );
+    }
+    if( policy == Wait::Yield && 
+        ( k.stats.consumer_yields == 0 || k.stats.consumer_parks != 0 ) )
+    {
+        fail( "consumer never yielded, or parked" );
+    }
+    if( policy == Wait::Park && k.stats.consumer_parks == 0 )
+    {
+        fail( "consumer never parked" );
+    }
+}
+
+int
+main()
+{
+    run< Type::Heap,         Wait::Spin,  false >();
+    run< Type::Heap,         Wait::Yield, false >();
+    run< Type::Heap,         Wait::Park,  false >();
+    run< Type::Heap,         Wait::Park,  true  >();
+    run< Type::LockFreeSPSC, Wait::Yield, true  >();
+    run< Type::LockFreeSPSC, Wait::Park,  false >();
+    run< Type::Segmented,    Wait::Park,  true  >();
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,160 @@
+/**
+ * warmProfile.cpp - a run saves the capacity its edge grew to and
+ * the cores its kernels ran on, the next run of the same graph loads
+ * that and starts from there.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <raft>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 2000;
+
+/** 
+ * a cache line per item, the edge starts out sized from the cache 
+ * (see Allocate::initial_capacity) well below what a full queue needs
+ */
+struct item
+{
+    item() = default;
+    item( const type_t value ) : value( value )
+    {
+    }
+
+    type_t value = 0;
+    char   pad[ 64 - sizeof( type_t ) ];
+};
+
+using raft::test::fail;
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< item >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( item( curr ) );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink( const type_t slow ) : raft::kernel(), slow( slow )
+    {
+        input.addPort< item >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        item v;
+        input[ "0" ].pop( v );
+        if( v.value != seen++ )
+        {
+            fail( "out of order" );
+        }
+        if( first == 0 )
+        {
+            first = input[ "0" ].capacity();
+        }
+        largest = std::max( largest, input[ "0" ].capacity() );
+        if( seen < slow )
+        {
+            std::this_thread::sleep_for( std::chrono::milliseconds( 3 ) );
+        }
+        return( raft::proceed );
+    }
+
+    const type_t    slow;
+    type_t          seen    = 0;
+    std::size_t     first   = 0;
+    std::size_t     largest = 0;
+};
+
+int
+main()
+{
+    char path[] = "/tmp/raftprofile.XXXXXX";
+    const auto fd( mkstemp( path ) );
+    if( fd < 0 )
+    {
+        fail( "can't create the profile file" );
+    }
+    close( fd );
+    std::size_t learned( 0 );
+    {
+        /** can't keep up at first, the edge grows **/
+        source s;
+        sink   k( 50 );
+        s.setCore( 0 );
+        raft::map m;
+        m.setProfileOutput( path );
+        /** resizes a full queue, the heap FIFO waits for it to drain **/
+        m.link( &s, "0", &k, "0", 0, Type::LockFreeSPSC );
+        m.exe();
+        if( k.seen != count )
+        {
+            fail( "missing items" );
+        }
+        if( k.largest <= k.first )
+        {
+            fail( "edge didn't grow, nothing to learn" );
+        }
+        learned = k.largest;
+    }
+    {
+        source s;
+        sink   k( 0 );
+        raft::map m;
+        m.setProfileInput( path );
+        m.link( &s, "0", &k, "0", 0, Type::LockFreeSPSC );
+        m.exe();
+        if( k.seen != count )
+        {
+            fail( "missing items on the warm run" );
+        }
+        if( k.first != learned )
+        {
+            fail( "warm run started at " + std::to_string( k.first ) + 
+                  " items, the last run got to " + std::to_string( learned ) );
+        }
+        if( s.getCoreAssignment() != 0 )
+        {
+            fail( "core assignment not restored" );
+        }
+    }
+    std::remove( path );
+    return( EXIT_SUCCESS );
+}
@@ -0,0 +1,194 @@
+/**
+ * workSteal.cpp - work_steal_schedule runs graphs with more kernels
+ * than worker threads, down to a single worker where every blocked
+ * kernel has to let the others run on its thread.
+ *
+ * @author: Jonathan Beard
+ * @version: Sun Oct 18 09:12:44 2026
+ *
+ * Copyright 2026 Jonathan Beard
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at:
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <raft>
+#include <raftmanip>
+#include "testutil.tcc"
+
+using type_t = std::int64_t;
+static const type_t count = 50000;
+static const int stages = 8;
+
+using raft::test::fail;
+
+class source : public raft::kernel
+{
+public:
+    source() : raft::kernel()
+    {
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        output[ "0" ].push( curr );
+        return( ++curr == count ? raft::stop : raft::proceed );
+    }
+
+private:
+    type_t curr = 0;
+};
+
+class pass : public raft::kernel
+{
+public:
+    pass() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+        output.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        output[ "0" ].push( v );
+        return( raft::proceed );
+    }
+};
+
+class sink : public raft::kernel
+{
+public:
+    sink() : raft::kernel()
+    {
+        input.addPort< type_t >( "0" );
+    }
+
+    virtual raft::kstatus run()
+    {
+        type_t v( 0 );
+        input[ "0" ].pop( v );
+        if( v != seen++ )
+        {
+            fail( "out of order" );
+        }
+        return( raft::proceed );
+    }
+
+    type_t seen = 0;
+};
+
+/** two chains of stages + 2 kernels each on n workers **/
+static void chains( const std::size_t n )
+{
+    source s0, s1;
+    pass   p0[ stages ], p1[ stages ];
+    sink   k0, k1;
+    raft::map m;
+    m.setSchedulerThreads( n );
+    m += s0 >> p0[ 0 ];
+    m += s1 >> p1[ 0 ];
+    for( int i( 1 ); i < stages; i++ )
+    {
+        m += p0[ i - 1 ] >> p0[ i ];
+        m += p1[ i - 1 ] >> p1[ i ];
+    }
+    m += p0[ stages - 1 ] >> k0;
+    m += p1[ stages - 1 ] >> k1;
+    m.exe< partition_dummy, work_steal_schedule >();
+    if( k0.seen != count || k1.seen != count )
+    {
+        fail( "missing items with " + std::to_string( n ) + " workers" );
+    }
+}
+
+/** pass that notes whether it ever ran on more than one worker **/
+class roam : public pass
+{
+public:
+    roam() : pass(){}
+
+    virtual raft::kstatus run()
+    {
+        const auto me( std::this_thread::get_id() );
+        if( first == std::thread::id() )
+        {
+            first = me;
+        }
+        else if( me != first )
+        {
+            moved = true;
+        }
+        return( pass::run() );
+    }
+
+    bool moved = false;
+
+private:
+    std::thread::id first;
+};
+
+/**
+ * more kernels than workers, all homed on worker 0, so the other
+ * worker only gets work by stealing it between slices
+ */
+static void steal()
+{
+    source s;
+    roam   r[ stages ];
+    sink   k;
+    raft::map m;
+    m.setSchedulerThreads( 2 );
+    using home = raft::manip< raft::parallel::device< raft::parallel::cpu, 0 > >;
+    home::bind( s );
+    home::bind( k );
+    m += s >> r[ 0 ];
+    for( int i( 0 ); i < stages; i++ )
+    {
+        home::bind( r[ i ] );
+        if( i > 0 )
+        {
+            m += r[ i - 1 ] >> r[ i ];
+        }
+    }
+    m += r[ stages - 1 ] >> k;
+    m.exe< partition_dummy, work_steal_schedule >();
+    if( k.seen != count )
+    {
+        fail( "missing items with stolen kernels" );
+    }
+    for( const auto &k : r )
+    {
+        if( k.moved )
+        {
+            return;
+        }
+    }
+    fail( "no kernel was stolen between slices" );
+}
+
+int
+main()
+{
+    chains( 1 );
+    chains( 2 );
+    /** one per core **/
+    chains( 0 );
+    steal();
+    return( EXIT_SUCCESS );
+}